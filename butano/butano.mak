@@ -1,3 +1,10 @@
+#---------------------------------------------------------------------------------------------------------------------
+# Headless host backend (make BNHOST=1):
+#---------------------------------------------------------------------------------------------------------------------
+ifneq ($(strip $(BNHOST)),)
+    include $(LIBBUTANOABS)/butano_host.mak
+else
+
 #---------------------------------------------------------------------------------------------------------------------
 .SUFFIXES:
 #---------------------------------------------------------------------------------------------------------------------
@@ -53,6 +60,10 @@ CFLAGS      :=	$(CWARNINGS) -g -O2 -mcpu=arm7tdmi -mtune=arm7tdmi -ffast-math -f
 CFLAGS      +=	$(INCLUDE)
 CFLAGS      +=	$(USERFLAGS)
 
+ifeq ($(strip $(AUDIOBACKEND)),native)
+    CFLAGS  +=	-DBN_CFG_AUDIO_BACKEND=BN_AUDIO_BACKEND_NATIVE
+endif
+
 CPPWARNINGS	:=	-Wuseless-cast -Wnon-virtual-dtor -Woverloaded-virtual
 CXXFLAGS    :=	$(CFLAGS) $(CPPWARNINGS) -std=c++20 -fno-rtti -fno-exceptions
 
@@ -151,7 +162,7 @@ export LIBPATHS         :=  $(foreach dir,$(LIBDIRS),-L$(dir)/lib)
 $(BUILD):
 	@[ -d $@ ] || mkdir -p $@
 	@$(EXTTOOL)
-	@$(PYTHON) -B $(LIBBUTANOABS)/tools/butano-audio-tool.py --audio="$(AUDIO)" --build=$(BUILD)
+	@$(PYTHON) -B $(LIBBUTANOABS)/tools/butano-audio-tool.py --audio="$(AUDIO)" --backend="$(AUDIOBACKEND)" --build=$(BUILD)
 	@$(PYTHON) -B $(LIBBUTANOABS)/tools/butano-graphics-tool.py --graphics="$(GRAPHICS)" --build=$(BUILD)
 	@$(MAKE) --no-print-directory -C $(BUILD) -f $(CURDIR)/Makefile
 
@@ -197,3 +208,7 @@ $(OFILES_SOURCES)   :   $(HFILES)
 #---------------------------------------------------------------------------------------------------------------------
 endif
 #---------------------------------------------------------------------------------------------------------------------
+
+#---------------------------------------------------------------------------------------------------------------------
+endif
+#---------------------------------------------------------------------------------------------------------------------
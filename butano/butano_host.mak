@@ -0,0 +1,118 @@
+#---------------------------------------------------------------------------------------------------------------------
+# Headless host backend makefile, included by butano.mak when BNHOST is defined (make BNHOST=1).
+#
+# It builds the project and butano with the host compiler, replacing the GBA hw layer with the sources of
+# hw/host/src, which emulate VRAM, OAM, PAL and IO registers as plain memory.
+#
+# The generated executable runs the project without video or audio output, so it can be profiled with perf,
+# valgrind, etc. Set the BN_HOST_FRAMES environment variable to exit after the given number of frames.
+#---------------------------------------------------------------------------------------------------------------------
+.SUFFIXES:
+
+#---------------------------------------------------------------------------------------------------------------------
+# Options for code generation:
+#---------------------------------------------------------------------------------------------------------------------
+CWARNINGS   :=	-Wall -Wextra -Wpedantic -Wshadow -Wundef -Wunused-parameter -Wmisleading-indentation \
+				-Wduplicated-cond -Wduplicated-branches -Wlogical-op -Wnull-dereference -Wswitch-default \
+				-Wno-int-to-pointer-cast -Wno-attributes
+
+CFLAGS      :=	$(CWARNINGS) -g -O2 -ffast-math -ffunction-sections -fdata-sections -DBN_HW_HOST=1
+CFLAGS      +=	$(INCLUDE)
+CFLAGS      +=	$(USERFLAGS)
+
+ifeq ($(strip $(AUDIOBACKEND)),native)
+    CFLAGS  +=	-DBN_CFG_AUDIO_BACKEND=BN_AUDIO_BACKEND_NATIVE
+endif
+
+CPPWARNINGS	:=	-Wuseless-cast -Wnon-virtual-dtor -Woverloaded-virtual
+CXXFLAGS    :=	$(CFLAGS) $(CPPWARNINGS) -std=c++20 -fno-rtti -fno-exceptions
+
+LDFLAGS     =	-g -Wl,--gc-sections $(USERFLAGS)
+
+#---------------------------------------------------------------------------------------------------------------------
+# List of directories containing libraries, this must be the top level containing include and lib directories:
+#---------------------------------------------------------------------------------------------------------------------
+LIBDIRS     :=	$(LIBBUTANOABS) $(LIBBUTANOABS)/hw/3rd_party/libtonc
+
+#---------------------------------------------------------------------------------------------------------------------
+# List of directories containing all butano source files (host sources replace GBA sources with the same name):
+#---------------------------------------------------------------------------------------------------------------------
+BNSOURCES	:=	$(LIBBUTANOABS)/hw/host/src $(LIBBUTANOABS)/src $(LIBBUTANOABS)/hw/src
+
+#---------------------------------------------------------------------------------------------------------------------
+# GBA only butano source files:
+#---------------------------------------------------------------------------------------------------------------------
+BNEXCLUDED	:=	bn_hw_common.bn_noflto.cpp bn_hw_cstdlib.cpp bn_hw_audio_native.cpp
+
+#---------------------------------------------------------------------------------------------------------------------
+# Host object files are placed in their own build directory:
+#---------------------------------------------------------------------------------------------------------------------
+BUILD       :=	$(BUILD)_host
+
+#---------------------------------------------------------------------------------------------------------------------
+# Don't remove intermediary files (avoid rebuilding graphics files more than once):
+#---------------------------------------------------------------------------------------------------------------------
+.SECONDARY:
+
+ifneq ($(BUILD),$(notdir $(CURDIR)))
+#---------------------------------------------------------------------------------------------------------------------
+
+export OUTPUT	:=	$(CURDIR)/$(TARGET)
+
+export VPATH	:=  $(foreach dir,	$(SOURCES),	$(CURDIR)/$(dir)) \
+                        $(foreach dir,	$(BNSOURCES),	$(dir))
+
+export DEPSDIR	:=  $(CURDIR)/$(BUILD)
+
+CFILES          :=  $(foreach dir,	$(SOURCES),	$(notdir $(wildcard $(dir)/*.c)))
+
+CPPFILES        :=	$(foreach dir,	$(SOURCES),	$(notdir $(wildcard $(dir)/*.cpp))) \
+						$(sort $(filter-out $(BNEXCLUDED), \
+								$(foreach dir,	$(BNSOURCES),	$(notdir $(wildcard $(dir)/*.cpp)))))
+
+export OFILES           :=  $(CPPFILES:.cpp=.o) $(CFILES:.c=.o)
+
+export INCLUDE          :=  $(foreach dir,$(INCLUDES),-iquote $(CURDIR)/$(dir)) \
+                                $(foreach dir,$(LIBDIRS),-I$(dir)/include) \
+                                -I$(CURDIR)/$(BUILD)
+
+.PHONY: $(BUILD) clean
+
+#---------------------------------------------------------------------------------------------------------------------
+$(BUILD):
+	@[ -d $@ ] || mkdir -p $@
+	@$(EXTTOOL)
+	@$(PYTHON) -B $(LIBBUTANOABS)/tools/butano-audio-tool.py --audio="$(AUDIO)" --backend="$(AUDIOBACKEND)" --build=$(BUILD)
+	@$(PYTHON) -B $(LIBBUTANOABS)/tools/butano-graphics-tool.py --graphics="$(GRAPHICS)" --build=$(BUILD)
+	@$(MAKE) --no-print-directory -C $(BUILD) -f $(CURDIR)/Makefile
+
+#---------------------------------------------------------------------------------------------------------------------
+clean:
+	@echo clean ...
+	@rm -fr $(BUILD) $(TARGET)
+
+#---------------------------------------------------------------------------------------------------------------------
+else
+
+#---------------------------------------------------------------------------------------------------------------------
+# Main targets:
+#---------------------------------------------------------------------------------------------------------------------
+
+$(OUTPUT)           :	$(OFILES)
+	@echo Linking $(notdir $@) ...
+	@$(CXX) $(LDFLAGS) $(OFILES) -o $@
+	@echo Output file: $(notdir $@)
+
+%.o : %.cpp
+	@echo $(notdir $<)
+	@$(CXX) -MMD -MP -MF $(DEPSDIR)/$*.d $(CXXFLAGS) -c $< -o $@
+
+%.o : %.c
+	@echo $(notdir $<)
+	@$(CC) -MMD -MP -MF $(DEPSDIR)/$*.d $(CFLAGS) -c $< -o $@
+
+-include $(DEPSDIR)/*.d
+
+#---------------------------------------------------------------------------------------------------------------------
+endif
+#---------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_audio.h"
+
+#include "../../include/bn_hw_irq.h"
+
+namespace bn::hw::audio
+{
+
+namespace
+{
+    // Host audio is not mixed, only music state is tracked:
+    class static_data
+    {
+
+    public:
+        func_type hp_vblank_function = nullptr;
+        func_type lp_vblank_function = nullptr;
+        func_type vblank_handler = nullptr;
+        int music_position = 0;
+        bool music_playing = false;
+    };
+
+    static_data data;
+
+
+    void _update_frame()
+    {
+        data.lp_vblank_function();
+    }
+
+    void _update_frame_with_hp_vblank_function()
+    {
+        data.hp_vblank_function();
+        _update_frame();
+    }
+
+    void _vblank_intr()
+    {
+        if(func_type vblank_handler = data.vblank_handler)
+        {
+            vblank_handler();
+        }
+    }
+}
+
+void init(func_type hp_vblank_function, func_type lp_vblank_function)
+{
+    data.hp_vblank_function = hp_vblank_function;
+    data.lp_vblank_function = lp_vblank_function;
+
+    irq::replace_or_push_back(irq::id::VBLANK, _vblank_intr);
+}
+
+void enable()
+{
+    irq::enable(irq::id::VBLANK);
+}
+
+void disable()
+{
+    irq::disable(irq::id::VBLANK);
+}
+
+bool music_playing()
+{
+    return data.music_playing;
+}
+
+void play_music(int, int, bool)
+{
+    data.music_position = 0;
+    data.music_playing = true;
+}
+
+void stop_music()
+{
+    data.music_playing = false;
+}
+
+void pause_music()
+{
+}
+
+void resume_music()
+{
+}
+
+int music_position()
+{
+    return data.music_position;
+}
+
+void set_music_position(int position)
+{
+    data.music_position = position;
+}
+
+void set_music_volume(int)
+{
+}
+
+void play_sound(int, int)
+{
+}
+
+void play_sound(int, int, int, int, int)
+{
+}
+
+void stop_all_sounds()
+{
+}
+
+void disable_vblank_handler()
+{
+    data.vblank_handler = data.hp_vblank_function;
+}
+
+void mix()
+{
+}
+
+void commit()
+{
+    _update_frame();
+}
+
+void enable_vblank_handler()
+{
+    data.vblank_handler = _update_frame_with_hp_vblank_function;
+}
+
+}
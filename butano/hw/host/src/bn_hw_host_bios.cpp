@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_core.h"
+#include "../../include/bn_hw_math.h"
+#include "../../3rd_party/dldi/include/io_scsd.h"
+
+#include <cstdlib>
+
+namespace
+{
+    [[nodiscard]] int _uncompressed_size(const u8* src)
+    {
+        return src[1] | (src[2] << 8) | (src[3] << 16);
+    }
+
+    void _lz77_uncompress(const void* src, void* dst)
+    {
+        auto src_ptr = static_cast<const u8*>(src);
+        auto dst_ptr = static_cast<u8*>(dst);
+        u8* dst_end = dst_ptr + _uncompressed_size(src_ptr);
+        src_ptr += 4;
+
+        while(dst_ptr < dst_end)
+        {
+            unsigned flags = *src_ptr++;
+
+            for(int index = 0; index < 8 && dst_ptr < dst_end; ++index)
+            {
+                if(flags & 0x80)
+                {
+                    unsigned block = unsigned(src_ptr[0] << 8) | src_ptr[1];
+                    src_ptr += 2;
+
+                    int count = int(block >> 12) + 3;
+                    const u8* copy_ptr = dst_ptr - (block & 0xFFF) - 1;
+
+                    while(count-- && dst_ptr < dst_end)
+                    {
+                        *dst_ptr++ = *copy_ptr++;
+                    }
+                }
+                else
+                {
+                    *dst_ptr++ = *src_ptr++;
+                }
+
+                flags <<= 1;
+            }
+        }
+    }
+
+    void _rl_uncompress(const void* src, void* dst)
+    {
+        auto src_ptr = static_cast<const u8*>(src);
+        auto dst_ptr = static_cast<u8*>(dst);
+        u8* dst_end = dst_ptr + _uncompressed_size(src_ptr);
+        src_ptr += 4;
+
+        while(dst_ptr < dst_end)
+        {
+            unsigned flag = *src_ptr++;
+
+            if(flag & 0x80)
+            {
+                int count = int(flag & 0x7F) + 3;
+                u8 value = *src_ptr++;
+
+                while(count-- && dst_ptr < dst_end)
+                {
+                    *dst_ptr++ = value;
+                }
+            }
+            else
+            {
+                int count = int(flag) + 1;
+
+                while(count-- && dst_ptr < dst_end)
+                {
+                    *dst_ptr++ = *src_ptr++;
+                }
+            }
+        }
+    }
+
+    // Same polynomial than the GBA BIOS ArcTan function:
+    [[nodiscard]] int _arc_tan(int i)
+    {
+        int a = -((i * i) >> 14);
+        int b = ((0xA9 * a) >> 14) + 0x390;
+        b = ((b * a) >> 14) + 0x91C;
+        b = ((b * a) >> 14) + 0xFB6;
+        b = ((b * a) >> 14) + 0x16AA;
+        b = ((b * a) >> 14) + 0x2081;
+        b = ((b * a) >> 14) + 0x3651;
+        b = ((b * a) >> 14) + 0xA2F9;
+        return (i * b) >> 16;
+    }
+}
+
+extern "C"
+{
+    void LZ77UnCompWram(const void* src, void* dst)
+    {
+        _lz77_uncompress(src, dst);
+    }
+
+    void LZ77UnCompVram(const void* src, void* dst)
+    {
+        _lz77_uncompress(src, dst);
+    }
+
+    void RLUnCompWram(const void* src, void* dst)
+    {
+        _rl_uncompress(src, dst);
+    }
+
+    void RLUnCompVram(const void* src, void* dst)
+    {
+        _rl_uncompress(src, dst);
+    }
+
+    s16 ArcTan2(s16 x, s16 y)
+    {
+        if(! y)
+        {
+            return x >= 0 ? 0 : s16(0x8000);
+        }
+
+        if(! x)
+        {
+            return y >= 0 ? 0x4000 : s16(0xC000);
+        }
+
+        if(y >= 0)
+        {
+            if(x >= 0)
+            {
+                if(x >= y)
+                {
+                    return s16(_arc_tan((y << 14) / x));
+                }
+            }
+            else if(-x >= y)
+            {
+                return s16(_arc_tan((y << 14) / x) + 0x8000);
+            }
+
+            return s16(0x4000 - _arc_tan((x << 14) / y));
+        }
+
+        if(x <= 0)
+        {
+            if(-x > -y)
+            {
+                return s16(_arc_tan((y << 14) / x) + 0x8000);
+            }
+        }
+        else if(x >= -y)
+        {
+            return s16(_arc_tan((y << 14) / x) + 0x10000);
+        }
+
+        return s16(0xC000 - _arc_tan((x << 14) / y));
+    }
+
+    unsigned isqrt32(unsigned x)
+    {
+        unsigned result = 0;
+        unsigned bit = 1U << 30;
+
+        while(bit > x)
+        {
+            bit >>= 2;
+        }
+
+        while(bit)
+        {
+            if(x >= result + bit)
+            {
+                x -= result + bit;
+                result = (result >> 1) + bit;
+            }
+            else
+            {
+                result >>= 1;
+            }
+
+            bit >>= 2;
+        }
+
+        return result;
+    }
+
+    void bn_hw_soft_reset(unsigned)
+    {
+        std::exit(EXIT_SUCCESS);
+    }
+}
+
+bool _SCSD_isInserted()
+{
+    return false;
+}
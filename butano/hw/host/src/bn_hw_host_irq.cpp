@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_tonc.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    constexpr const int screen_lines = 160;
+    constexpr const int total_lines = 228;
+
+
+    class sender_type
+    {
+
+    public:
+        u16 reg_ofs;
+        u16 flag;
+    };
+
+    // Same senders than libtonc tonc_irq.c:
+    constexpr const sender_type senders[] = {
+        { 0x0004, 0x0008 },     // REG_DISPSTAT,    DSTAT_VBL_IRQ
+        { 0x0004, 0x0010 },     // REG_DISPSTAT,    DSTAT_VHB_IRQ
+        { 0x0004, 0x0020 },     // REG_DISPSTAT,    DSTAT_VCT_IRQ
+        { 0x0102, 0x0040 },     // REG_TM0CNT,      TM_IRQ
+        { 0x0106, 0x0040 },     // REG_TM1CNT,      TM_IRQ
+        { 0x010A, 0x0040 },     // REG_TM2CNT,      TM_IRQ
+        { 0x010E, 0x0040 },     // REG_TM3CNT,      TM_IRQ
+        { 0x0128, 0x4000 },     // REG_SIOCNT,      SIO_IRQ
+        { 0x00BA, 0x4000 },     // REG_DMA0CNT_H,   DMA_IRQ>>16
+        { 0x00C6, 0x4000 },     // REG_DMA1CNT_H,   DMA_IRQ>>16
+        { 0x00D2, 0x4000 },     // REG_DMA2CNT_H,   DMA_IRQ>>16
+        { 0x00DE, 0x4000 },     // REG_DMA3CNT_H,   DMA_IRQ>>16
+        { 0x0132, 0x4000 },     // REG_KEYCNT,      KCNT_IRQ
+        { 0x0000, 0x0000 },     // cart: none
+    };
+
+
+    class static_data
+    {
+
+    public:
+        fnptr isrs[II_MAX] = {};
+        long long frames_counter = 0;
+        long long max_frames = -1;
+        bool max_frames_loaded = false;
+    };
+
+    static_data data;
+
+
+    [[nodiscard]] vu16& _sender_register(eIrqIndex irq_id)
+    {
+        return *reinterpret_cast<vu16*>(REG_BASE + senders[irq_id].reg_ofs);
+    }
+
+    void _raise(eIrqIndex irq_id)
+    {
+        u16 irq_flag = BIT(irq_id);
+
+        // Like on the GBA, interrupts are not requested if their sender flag is disabled:
+        if(u16 sender_flag = senders[irq_id].flag; sender_flag && ! (_sender_register(irq_id) & sender_flag))
+        {
+            return;
+        }
+
+        if(REG_IME && (REG_IE & irq_flag))
+        {
+            if(fnptr isr = data.isrs[irq_id])
+            {
+                REG_IF = irq_flag;
+                REG_IME = 0;
+                isr();
+                REG_IME = 1;
+                REG_IF = 0;
+            }
+        }
+    }
+
+    // Emulates the H-Blank DMA transfers of a screen line (only incrementing source addresses are supported):
+    void _hblank_dmas()
+    {
+        for(int channel = 0; channel < 4; ++channel)
+        {
+            volatile DMA_REC& dma = REG_DMA[channel];
+            u32 cnt = dma.cnt;
+
+            if((cnt & DMA_ENABLE) && (cnt & DMA_AT_SPECIAL) == DMA_AT_HBLANK)
+            {
+                int bytes = int(cnt & DMA_COUNT_MASK) * ((cnt & DMA_32) ? 4 : 2);
+                auto src = static_cast<const u8*>(dma.src);
+                auto dst = static_cast<u8*>(dma.dst);
+                std::memcpy(dst, src, std::size_t(bytes));
+                dma.src = src + bytes;
+
+                if((cnt & DMA_DST_RELOAD) != DMA_DST_RELOAD)
+                {
+                    dma.dst = dst + bytes;
+                }
+
+                if(! (cnt & DMA_REPEAT))
+                {
+                    dma.cnt = cnt & ~DMA_ENABLE;
+                }
+            }
+        }
+    }
+
+    void _check_max_frames()
+    {
+        if(! data.max_frames_loaded)
+        {
+            if(const char* max_frames = std::getenv("BN_HOST_FRAMES"))
+            {
+                data.max_frames = std::atoll(max_frames);
+            }
+
+            data.max_frames_loaded = true;
+        }
+
+        ++data.frames_counter;
+
+        if(data.max_frames >= 0 && data.frames_counter > data.max_frames)
+        {
+            std::exit(EXIT_SUCCESS);
+        }
+    }
+}
+
+extern "C"
+{
+    void irq_init(fnptr)
+    {
+        REG_IME = 0;
+
+        for(fnptr& isr : data.isrs)
+        {
+            isr = nullptr;
+        }
+
+        REG_IME = 1;
+    }
+
+    fnptr irq_add(eIrqIndex irq_id, fnptr isr)
+    {
+        fnptr old_isr = data.isrs[irq_id];
+        data.isrs[irq_id] = isr;
+        irq_enable(irq_id);
+        return old_isr;
+    }
+
+    fnptr irq_delete(eIrqIndex irq_id)
+    {
+        fnptr old_isr = data.isrs[irq_id];
+        data.isrs[irq_id] = nullptr;
+        irq_disable(irq_id);
+        return old_isr;
+    }
+
+    void irq_enable(eIrqIndex irq_id)
+    {
+        vu16& sender_register = _sender_register(irq_id);
+        sender_register = sender_register | senders[irq_id].flag;
+        REG_IE = REG_IE | BIT(irq_id);
+    }
+
+    void irq_disable(eIrqIndex irq_id)
+    {
+        vu16& sender_register = _sender_register(irq_id);
+        sender_register = sender_register & ~senders[irq_id].flag;
+        REG_IE = REG_IE & ~BIT(irq_id);
+    }
+
+    // Emulates a full frame, from the start of the previous V-Blank period to the start of the next one:
+    void VBlankIntrWait()
+    {
+        _check_max_frames();
+
+        int line = REG_VCOUNT;
+
+        for(int index = 0; index < total_lines; ++index)
+        {
+            REG_DISPSTAT = (REG_DISPSTAT & ~(DSTAT_IN_VBL | DSTAT_IN_VCT)) | DSTAT_IN_HBL;
+
+            if(line < screen_lines)
+            {
+                _hblank_dmas();
+            }
+
+            _raise(II_HBLANK);
+
+            line = (line + 1) % total_lines;
+            REG_VCOUNT = line;
+            REG_DISPSTAT = REG_DISPSTAT & ~DSTAT_IN_HBL;
+
+            if(line >= screen_lines && line < total_lines - 1)
+            {
+                REG_DISPSTAT = REG_DISPSTAT | DSTAT_IN_VBL;
+            }
+
+            if(line == (REG_DISPSTAT >> DSTAT_VCT_SHIFT))
+            {
+                REG_DISPSTAT = REG_DISPSTAT | DSTAT_IN_VCT;
+                _raise(II_VCOUNT);
+            }
+        }
+
+        _raise(II_VBLANK);
+    }
+
+    void Stop()
+    {
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_tonc.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sys/mman.h>
+
+namespace
+{
+    class region
+    {
+
+    public:
+        uintptr_t address;
+        size_t size;
+        const char* name;
+    };
+
+    // GBA memory regions are mapped at the same addresses than on the GBA, so tonc register macros work as is.
+    // IWRAM and IO regions are bigger than on the GBA to cover mirrors and debug registers,
+    // and only the first ROM page is mapped to provide GPIO registers:
+    constexpr const region regions[] = {
+        { MEM_EWRAM,    EWRAM_SIZE,     "EWRAM" },
+        { MEM_IWRAM,    0x01000000,     "IWRAM" },
+        { MEM_IO,       0x01000000,     "IO" },
+        { MEM_PAL,      0x1000,         "PAL" },
+        { MEM_VRAM,     0x20000,        "VRAM" },
+        { MEM_OAM,      0x1000,         "OAM" },
+        { MEM_ROM,      0x1000,         "ROM" },
+        { MEM_SRAM,     SRAM_SIZE,      "SRAM" },
+    };
+
+
+    // Regions must be mapped before any static constructor reads or writes a register:
+    __attribute__((constructor(101))) void _map_regions()
+    {
+        for(const region& region : regions)
+        {
+            auto address = reinterpret_cast<void*>(region.address);
+            void* result = mmap(address, region.size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+            if(result != address)
+            {
+                std::fprintf(stderr, "%s region mapping failed at 0x%08lx\n", region.name,
+                             static_cast<unsigned long>(region.address));
+                std::exit(EXIT_FAILURE);
+            }
+        }
+
+        // Keys are released and the display is at the start of the V-Blank period:
+        REG_KEYINPUT = KEY_MASK;
+        REG_VCOUNT = 160;
+        REG_DISPSTAT = DSTAT_IN_VBL;
+    }
+}
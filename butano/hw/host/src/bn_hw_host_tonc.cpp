@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_tonc.h"
+
+#include <cstring>
+
+// Host replacements of the libtonc functions used by butano which are written in assembly or
+// which assume 32-bit pointers:
+
+namespace
+{
+    constexpr const u32 rb_mask = RED_MASK | BLUE_MASK;
+    constexpr const u32 g_mask = GREEN_MASK;
+    constexpr const u32 rb_half = 0x4010;
+    constexpr const u32 g_half = 0x0200;
+
+
+    [[nodiscard]] COLOR _blend(u32 clra, u32 clrb, u32 alpha)
+    {
+        u32 parta = clra & rb_mask;
+        u32 partb = clrb & rb_mask;
+        u32 part = (partb - parta) * alpha + parta * 32 + rb_half;
+        u32 clr = (part / 32) & rb_mask;
+
+        parta = clra & g_mask;
+        partb = clrb & g_mask;
+        part = (partb - parta) * alpha + parta * 32 + g_half;
+        clr |= (part / 32) & g_mask;
+        return COLOR(clr);
+    }
+
+    [[nodiscard]] COLOR _clamped_rgb15(int red, int green, int blue)
+    {
+        return RGB15(bf_clamp(red, 5), bf_clamp(green, 5), bf_clamp(blue, 5));
+    }
+}
+
+extern "C"
+{
+    const u8 oam_sizes[3][4][2] =
+    {
+        { { 8, 8}, {16,16}, {32,32}, {64,64} },
+        { {16, 8}, {32, 8}, {32,16}, {64,32} },
+        { { 8,16}, { 8,32}, {16,32}, {32,64} },
+    };
+
+    void memcpy16(void* dst, const void* src, uint hwcount)
+    {
+        std::memcpy(dst, src, hwcount * 2);
+    }
+
+    void memcpy32(void* dst, const void* src, uint wdcount)
+    {
+        std::memcpy(dst, src, wdcount * 4);
+    }
+
+    void memset16(void* dst, u16 hw, uint hwcount)
+    {
+        auto dst_ptr = static_cast<u16*>(dst);
+
+        for(uint index = 0; index < hwcount; ++index)
+        {
+            dst_ptr[index] = hw;
+        }
+    }
+
+    void memset32(void* dst, u32 wd, uint wdcount)
+    {
+        auto dst_ptr = static_cast<u32*>(dst);
+
+        for(uint index = 0; index < wdcount; ++index)
+        {
+            dst_ptr[index] = wd;
+        }
+    }
+
+    void* tonccpy(void* dst, const void* src, uint size)
+    {
+        return std::memcpy(dst, src, size);
+    }
+
+    void* __toncset(void* dst, u32 fill, uint size)
+    {
+        // Fill bytes depend on destination address alignment, like on the GBA:
+        auto dst_ptr = static_cast<u8*>(dst);
+        auto dst_address = reinterpret_cast<uintptr_t>(dst);
+
+        for(uint index = 0; index < size; ++index)
+        {
+            dst_ptr[index] = u8(fill >> (((dst_address + index) & 3) * 8));
+        }
+
+        return dst;
+    }
+
+    void clr_rotate(COLOR* clrs, uint nclrs, int ror)
+    {
+        if(ror && nclrs)
+        {
+            int count = int(nclrs);
+            int rotation = ((ror % count) + count) % count;
+
+            for(int iteration = 0; iteration < rotation; ++iteration)
+            {
+                COLOR last = clrs[count - 1];
+                std::memmove(clrs + 1, clrs, size_t(count - 1) * sizeof(COLOR));
+                clrs[0] = last;
+            }
+        }
+    }
+
+    void clr_blend_fast(COLOR* srca, COLOR* srcb, COLOR* dst, uint nclrs, u32 alpha)
+    {
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            dst[index] = _blend(srca[index], srcb[index], alpha);
+        }
+    }
+
+    void clr_fade_fast(COLOR* src, COLOR clr, COLOR* dst, uint nclrs, u32 alpha)
+    {
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            dst[index] = _blend(src[index], clr, alpha);
+        }
+    }
+
+    void clr_grayscale(COLOR* dst, const COLOR* src, uint nclrs)
+    {
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            u32 clr = src[index];
+            u32 rr = ((clr) & 31) * 0x4C;
+            u32 gg = ((clr >> 5) & 31) * 0x96;
+            u32 bb = ((clr >> 10) & 31) * 0x1E;
+            u32 gray = (rr + gg + bb + 0x80) >> 8;
+            dst[index] = RGB15(gray, gray, gray);
+        }
+    }
+
+    void clr_adj_brightness(COLOR* dst, const COLOR* src, uint nclrs, FIXED bright)
+    {
+        bright >>= 3;
+
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            int clr = src[index];
+            dst[index] = _clamped_rgb15((clr & 31) + bright, ((clr >> 5) & 31) + bright,
+                                        ((clr >> 10) & 31) + bright);
+        }
+    }
+
+    void clr_adj_contrast(COLOR* dst, const COLOR* src, uint nclrs, FIXED contrast)
+    {
+        FIXED ca = contrast + FIX_ONE;
+        FIXED cb = (-contrast >> 1) * 32;
+
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            int clr = src[index];
+            dst[index] = _clamped_rgb15((ca * (clr & 31) + cb) >> 8, (ca * ((clr >> 5) & 31) + cb) >> 8,
+                                        (ca * ((clr >> 10) & 31) + cb) >> 8);
+        }
+    }
+
+    void clr_adj_intensity(COLOR* dst, const COLOR* src, uint nclrs, FIXED intensity)
+    {
+        FIXED ia = intensity + FIX_ONE;
+
+        for(uint index = 0; index < nclrs; ++index)
+        {
+            int clr = src[index];
+            dst[index] = _clamped_rgb15((ia * (clr & 31)) >> 8, (ia * ((clr >> 5) & 31)) >> 8,
+                                        (ia * ((clr >> 10) & 31)) >> 8);
+        }
+    }
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_log.h"
+
+#if BN_CFG_LOG_ENABLED
+    #include <cstdio>
+    #include "bn_istring_base.h"
+
+    namespace bn::hw
+    {
+        // Host builds ignore the log backend and write to the standard error output:
+        void log(const istring_base& message)
+        {
+            std::fwrite(message.data(), 1, size_t(message.size()), stderr);
+            std::fputc('\n', stderr);
+        }
+    }
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_memory.h"
+
+// Provided by the linker for the sections of BN_CODE_IWRAM functions and BN_DATA_EWRAM variables:
+extern char __start_bn_iwram[] __attribute__((weak));
+extern char __stop_bn_iwram[] __attribute__((weak));
+extern char __start_bn_ewram[] __attribute__((weak));
+extern char __stop_bn_ewram[] __attribute__((weak));
+
+namespace bn::hw::memory
+{
+
+void init()
+{
+}
+
+int used_static_iwram()
+{
+    return __stop_bn_iwram - __start_bn_iwram;
+}
+
+int used_static_ewram()
+{
+    return __stop_bn_ewram - __start_bn_ewram;
+}
+
+char* ewram_heap_start()
+{
+    // Static EWRAM data is not placed in the emulated EWRAM region, so only its size is taken into account:
+    int alignment_bytes = sizeof(intptr_t);
+    int used_bytes = ((used_static_ewram() + alignment_bytes - 1) / alignment_bytes) * alignment_bytes;
+    return reinterpret_cast<char*>(MEM_EWRAM) + used_bytes;
+}
+
+char* ewram_heap_end()
+{
+    return reinterpret_cast<char*>(MEM_EWRAM) + EWRAM_SIZE;
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_show.h"
+
+#if BN_CFG_ASSERT_ENABLED || BN_CFG_PROFILER_ENABLED
+    #include <cstdio>
+    #include <cstdlib>
+    #include "bn_string_view.h"
+#endif
+
+#if BN_CFG_PROFILER_ENABLED
+    #include "bn_vector.h"
+    #include "bn_algorithm.h"
+    #include "bn_profiler.h"
+    #include "bn_unordered_map.h"
+#endif
+
+namespace bn::hw::show
+{
+
+namespace
+{
+    #if BN_CFG_ASSERT_ENABLED || BN_CFG_PROFILER_ENABLED
+        void print(const string_view& text)
+        {
+            std::fwrite(text.data(), 1, size_t(text.size()), stderr);
+        }
+    #endif
+}
+
+#if BN_CFG_ASSERT_ENABLED
+    void error(const string_view& condition, const string_view& file_name, const string_view& function, int line,
+               const string_view& message)
+    {
+        // Errors are written to the standard error output and abort the process, so they can't be ignored:
+        print("ERROR in ");
+        print(file_name.empty() ? string_view("unknown file name") : file_name);
+        print("\n");
+
+        if(! function.empty())
+        {
+            print(function);
+            print("::");
+        }
+        else
+        {
+            print("Line: ");
+        }
+
+        std::fprintf(stderr, "%d\n\n", line);
+
+        if(! condition.empty())
+        {
+            print(condition);
+            print("\n\n");
+        }
+
+        print(message);
+        print("\n");
+        std::abort();
+    }
+#endif
+
+#if BN_CFG_PROFILER_ENABLED
+    void profiler_results()
+    {
+        struct entry
+        {
+            string_view id;
+            int64_t total_ticks;
+            int max_ticks;
+        };
+
+        vector<entry, BN_CFG_PROFILER_MAX_ENTRIES * 2> entries;
+        int64_t total_ticks = 0;
+
+        for(const auto& ticks_per_entry_pair : _bn::profiler::ticks_per_entry())
+        {
+            auto& ticks_entry = ticks_per_entry_pair.second;
+            entries.push_back({ ticks_per_entry_pair.first, ticks_entry.total, ticks_entry.max });
+            total_ticks += ticks_entry.total;
+        }
+
+        sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
+            return a.total_ticks > b.total_ticks;
+        });
+
+        print("PROFILER results\n\n");
+
+        if(entries.empty())
+        {
+            print("No entries found\n");
+        }
+        else
+        {
+            std::fprintf(stderr, "%-32s %16s %8s %12s\n", "ID", "TOTAL ticks", "%", "MAX ticks");
+
+            for(const entry& entry : entries)
+            {
+                int pct = total_ticks ? int((entry.total_ticks * 100) / total_ticks) : 0;
+                std::fprintf(stderr, "%-32.*s %16lld %7d%% %12d\n", int(entry.id.size()), entry.id.data(),
+                             static_cast<long long>(entry.total_ticks), pct, entry.max_ticks);
+            }
+        }
+
+        std::exit(EXIT_SUCCESS);
+    }
+#endif
+
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_text.h"
+
+#include <cstdio>
+#include "bn_array.h"
+
+namespace bn::hw::text
+{
+
+int parse(int value, array<char, 32>& output)
+{
+    return std::snprintf(output.data(), size_t(output.size()), "%d", value);
+}
+
+int parse(long value, array<char, 32>& output)
+{
+    return std::snprintf(output.data(), size_t(output.size()), "%ld", value);
+}
+
+int parse(long long value, array<char, 32>& output)
+{
+    return std::snprintf(output.data(), size_t(output.size()), "%lld", value);
+}
+
+int parse(unsigned value, array<char, 32>& output)
+{
+    return std::snprintf(output.data(), size_t(output.size()), "%u", value);
+}
+
+int parse(unsigned long value, array<char, 32>& output)
+{
+    return std::snprintf(output.data(), size_t(output.size()), "%lu", value);
+}
+
+int parse(unsigned long long value, array<char, 32>& output)
+{
+    return std::snprintf(output.data(), size_t(output.size()), "%llu", value);
+}
+
+int parse(const void* ptr, array<char, 32>& output)
+{
+    return std::snprintf(output.data(), size_t(output.size()), "%p", ptr);
+}
+
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../../include/bn_hw_timer.h"
+
+#include <chrono>
+
+namespace bn::hw::timer
+{
+
+unsigned ticks()
+{
+    // Host time is converted to GBA timer ticks (64 CPU cycles, 262144 ticks per second):
+    using clock = std::chrono::steady_clock;
+    static const clock::time_point start = clock::now();
+
+    auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+    return unsigned((microseconds * 262144) / 1000000);
+}
+
+}
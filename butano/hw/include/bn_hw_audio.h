@@ -42,6 +42,8 @@ namespace bn::hw::audio
 
     void disable_vblank_handler();
 
+    void mix();
+
     void commit();
 
     void enable_vblank_handler();
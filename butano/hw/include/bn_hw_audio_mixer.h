@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_HW_AUDIO_MIXER_H
+#define BN_HW_AUDIO_MIXER_H
+
+#include "bn_assert.h"
+#include "bn_audio_mixing_rate.h"
+
+namespace bn::hw::audio_mixer
+{
+    [[nodiscard]] constexpr int max_channels()
+    {
+        // Accumulated samples of all channels must fit in 16 bits:
+        return 16;
+    }
+
+    // CPU cycles of each frame:
+    [[nodiscard]] constexpr int frame_cycles()
+    {
+        // http://problemkaputt.de/gbatek.htm#lcddimensionsandtimings
+
+        return 280896;
+    }
+
+    // Samples per output channel mixed in each frame.
+    // They divide the CPU cycles of each frame, so timer 0 overflows don't drift from the V-Blank interrupts
+    // which restart the sound DMA transfers.
+    // They are also multiples of the word size, since sound DMA transfers copy words:
+    [[nodiscard]] constexpr int buffer_size(int mixing_rate)
+    {
+        switch(mixing_rate)
+        {
+
+        case BN_AUDIO_MIXING_RATE_8_KHZ:
+            return 132;
+
+        case BN_AUDIO_MIXING_RATE_10_KHZ:
+            return 176;
+
+        case BN_AUDIO_MIXING_RATE_13_KHZ:
+            return 224;
+
+        case BN_AUDIO_MIXING_RATE_16_KHZ:
+            return 264;
+
+        case BN_AUDIO_MIXING_RATE_18_KHZ:
+            return 304;
+
+        case BN_AUDIO_MIXING_RATE_21_KHZ:
+            return 352;
+
+        case BN_AUDIO_MIXING_RATE_27_KHZ:
+            return 448;
+
+        case BN_AUDIO_MIXING_RATE_31_KHZ:
+            return 528;
+
+        default:
+            BN_ERROR("Invalid mixing rate: ", mixing_rate);
+            return 0;
+        }
+    }
+
+    // Timer 0 period in CPU cycles, so a whole buffer is played in each frame:
+    [[nodiscard]] constexpr int timer_period(int mixing_rate)
+    {
+        return frame_cycles() / buffer_size(mixing_rate);
+    }
+
+    // CPU cycles from the start of timer 0 to its first overflow.
+    // Overflows are kept half a period away from the V-Blank interrupts which restart the sound DMA transfers,
+    // so the interrupt latency can change almost half a period without dropping or repeating samples:
+    [[nodiscard]] constexpr int first_overflow_delay(int mixing_rate)
+    {
+        return timer_period(mixing_rate) / 2;
+    }
+
+    // Sound FIFOs hold 32 bytes, and sound DMA transfers refill them with 16 bytes
+    // when they have 16 bytes or less, so they can read up to 32 bytes past the last played sample:
+    [[nodiscard]] constexpr int output_buffer_padding()
+    {
+        return 32;
+    }
+
+    // Words written by the CPU in each sound FIFO before restarting the sound DMA transfers.
+    // Sound FIFOs don't overflow if the hardware requests a sound DMA transfer as soon as it's enabled:
+    [[nodiscard]] constexpr int fifo_prime_words()
+    {
+        return 4;
+    }
+
+    [[nodiscard]] constexpr int position_shift()
+    {
+        return 12;
+    }
+
+    [[nodiscard]] constexpr int max_sample_length()
+    {
+        // Positions must not overflow after the last step:
+        return 1 << (31 - position_shift());
+    }
+
+    enum class sample_format : uint8_t
+    {
+        PCM_8,
+        IMA_ADPCM
+    };
+
+    // Samples are stored one after another, each one with its header followed by its data.
+    // PCM data is signed 8 bits, and IMA ADPCM data is one stream of 4 bits codes (low nibble first)
+    // which starts with a predicted value and a step index of 0:
+    class sample_header
+    {
+
+    public:
+        uint32_t length;
+        uint32_t frequency;
+        sample_format format;
+        uint8_t reserved[3];
+    };
+
+    // The sound bank starts with the number of samples and the offset of each sample from the start of the bank:
+    [[nodiscard]] inline int bank_samples_count(const uint8_t* bank_ptr)
+    {
+        return int(*reinterpret_cast<const uint32_t*>(bank_ptr));
+    }
+
+    [[nodiscard]] inline const sample_header& bank_sample(const uint8_t* bank_ptr, int id)
+    {
+        BN_ASSERT(id >= 0 && id < bank_samples_count(bank_ptr), "Invalid sample id: ", id);
+
+        uint32_t offset = reinterpret_cast<const uint32_t*>(bank_ptr)[id + 1];
+        return *reinterpret_cast<const sample_header*>(bank_ptr + offset);
+    }
+
+    class channel
+    {
+
+    public:
+        const uint8_t* data = nullptr;
+        unsigned position = 0;
+        unsigned step = 0;
+        unsigned end = 0;
+        int left_volume = 0;
+        int right_volume = 0;
+        unsigned decoded_samples = 0;
+        int decoded_value = 0;
+        int decoder_step_index = 0;
+        bool adpcm = false;
+
+        [[nodiscard]] bool active() const
+        {
+            return data;
+        }
+
+        // Volume and panning are in the range [0, 255] (panning 128 is centered),
+        // and speed has 10 fractional bits:
+        void start(const sample_header& sample, int volume, int speed, int panning, int mixing_rate)
+        {
+            BN_ASSERT(sample.length > 0 && sample.length <= unsigned(max_sample_length()),
+                      "Invalid sample length: ", sample.length);
+
+            // Timer period is in CPU cycles (2^24 per second):
+            uint64_t scaled_frequency = uint64_t(sample.frequency) * unsigned(speed) *
+                    unsigned(timer_period(mixing_rate));
+            auto new_step = unsigned(scaled_frequency >> (24 + 10 - position_shift()));
+
+            data = reinterpret_cast<const uint8_t*>(&sample + 1);
+            position = 0;
+            step = new_step ? new_step : 1;
+            end = sample.length << position_shift();
+            left_volume = panning <= 128 ? volume : (volume * (255 - panning)) >> 7;
+            right_volume = panning >= 128 ? volume : (volume * panning) >> 7;
+            decoded_samples = 0;
+            decoded_value = 0;
+            decoder_step_index = 0;
+            adpcm = sample.format == sample_format::IMA_ADPCM;
+        }
+
+        void stop()
+        {
+            data = nullptr;
+        }
+    };
+
+    // Mixes the given number of samples of each active channel into left_output_ptr and right_output_ptr.
+    // Channels are stopped when they reach the end of their sample.
+    // accumulators_ptr must be word aligned and it must point to samples_count * 2 elements:
+    BN_CODE_IWRAM void mix(channel* channels_ptr, int channels_count, int samples_count, int16_t* accumulators_ptr,
+                           int8_t* left_output_ptr, int8_t* right_output_ptr);
+
+    // Stops the sound DMA transfers, resets the sound FIFOs and restarts both transfers from the start
+    // of left_output_ptr (Direct Sound B, DMA channel 2) and right_output_ptr (Direct Sound A, DMA channel 1),
+    // so the samples read ahead from the previous output buffers are discarded.
+    // Output buffers must be word aligned and padded with output_buffer_padding() bytes:
+    BN_CODE_IWRAM void restart_sound_dma(unsigned direct_sound_control, const int8_t* left_output_ptr,
+                                         const int8_t* right_output_ptr);
+}
+
+#endif
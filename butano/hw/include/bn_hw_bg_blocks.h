@@ -7,6 +7,7 @@
 #define BN_HW_BG_BLOCKS_H
 
 #include "bn_assert.h"
+#include "bn_algorithm.h"
 #include "bn_compression_type.h"
 #include "bn_hw_memory.h"
 #include "bn_hw_uncompress.h"
@@ -49,6 +50,21 @@ namespace bn::hw::bg_blocks
         return reinterpret_cast<uint16_t*>(MEM_VRAM) + (block_index * half_words_per_block());
     }
 
+    inline void move_blocks(int source_block_index, int count, int destination_block_index)
+    {
+        BN_ASSERT(destination_block_index < source_block_index, "Invalid destination block index: ",
+                  destination_block_index, " - ", source_block_index);
+
+        // Blocks are moved in chunks which don't overlap:
+        int chunk_count = source_block_index - destination_block_index;
+
+        for(int index = 0; index < count; index += chunk_count)
+        {
+            int words = (min(chunk_count, count - index) * half_words_per_block()) / 2;
+            hw::memory::copy_words(vram(source_block_index + index), words, vram(destination_block_index + index));
+        }
+    }
+
     inline void commit(const uint16_t* source_ptr, compression_type compression, int count, uint16_t* destination_ptr)
     {
         switch(compression)
@@ -72,6 +88,17 @@ namespace bn::hw::bg_blocks
         }
     }
 
+    [[nodiscard]] inline int regular_bg_map_cell_tile_index(unsigned cell)
+    {
+        return int(BFN_GET(cell, SE_ID));
+    }
+
+    [[nodiscard]] inline uint16_t set_regular_bg_map_cell_tile_index(unsigned cell, unsigned tile_index)
+    {
+        BFN_SET(cell, tile_index, SE_ID);
+        return uint16_t(cell);
+    }
+
     inline void copy_regular_bg_map_cell_tiles_offset(unsigned source_cell, unsigned tiles_offset,
                                                       uint16_t& destination_cell)
     {
@@ -105,6 +132,17 @@ namespace bn::hw::bg_blocks
         BFN_SET(source_cell, palette_bank + palette_offset, SE_PALBANK);
         destination_cell = uint16_t(source_cell);
     }
+
+    BN_CODE_IWRAM void copy_regular_bg_map_col(const uint16_t* source_cells_ptr, int source_width, int y_separator,
+                                               unsigned tiles_offset, unsigned palette_offset,
+                                               uint16_t* destination_col_ptr);
+
+    BN_CODE_IWRAM void copy_regular_bg_map_row(const uint16_t* source_cells_ptr, int x_separator,
+                                               unsigned tiles_offset, unsigned palette_offset,
+                                               uint16_t* destination_row_ptr);
+
+    BN_CODE_IWRAM void copy_affine_bg_map_col(const uint8_t* source_cells_ptr, int source_width, int x,
+                                              int y_separator, unsigned tiles_offset, uint16_t* destination_map_ptr);
 }
 
 #endif
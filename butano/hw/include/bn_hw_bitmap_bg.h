@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_HW_BITMAP_BG_H
+#define BN_HW_BITMAP_BG_H
+
+#include "bn_hw_bgs.h"
+
+namespace bn::hw::bitmap_bg
+{
+    [[nodiscard]] constexpr int pages_count()
+    {
+        return 2;
+    }
+
+    [[nodiscard]] constexpr int page_bytes()
+    {
+        return VRAM_PAGE_SIZE;
+    }
+
+    [[nodiscard]] inline uint16_t* page(int index)
+    {
+        return reinterpret_cast<uint16_t*>(MEM_VRAM + (index * page_bytes()));
+    }
+
+    // In bitmap modes, sprites can't use the first half of sprite tiles VRAM:
+    [[nodiscard]] constexpr int reserved_sprite_tiles()
+    {
+        return ((pages_count() * page_bytes()) - VRAM_BG_SIZE) / 32;
+    }
+
+    inline void commit_bg()
+    {
+        REG_BG2CNT = 0;
+        REG_BG_AFFINE[2] = bgs::handle().affine;
+    }
+
+    BN_CODE_IWRAM void fill_rect_16bpp(unsigned color, int x, int y, int width, int height, int pitch,
+                                       uint16_t* pixels_ptr);
+
+    BN_CODE_IWRAM void fill_rect_8bpp(unsigned color_index, int x, int y, int width, int height, int pitch,
+                                      uint16_t* pixels_ptr);
+
+    BN_CODE_IWRAM void blit_16bpp(const uint16_t* source_ptr, int source_width, int x, int y, int width, int height,
+                                  int pitch, uint16_t* pixels_ptr);
+
+    BN_CODE_IWRAM void blit_8bpp(const uint8_t* source_ptr, int source_width, int x, int y, int width, int height,
+                                 int pitch, uint16_t* pixels_ptr);
+
+    BN_CODE_IWRAM void scaled_blit_16bpp(const uint16_t* source_ptr, int source_width, int source_height,
+                                         int x, int y, int width, int height, int pitch, uint16_t* pixels_ptr);
+
+    BN_CODE_IWRAM void scaled_blit_8bpp(const uint8_t* source_ptr, int source_width, int source_height,
+                                        int x, int y, int width, int height, int pitch, uint16_t* pixels_ptr);
+}
+
+#endif
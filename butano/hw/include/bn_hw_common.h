@@ -6,20 +6,36 @@
 #ifndef BN_HW_COMMON_H
 #define BN_HW_COMMON_H
 
-/**
- * @brief Store data in EWRAM.
- */
-#define BN_DATA_EWRAM __attribute__((section(".ewram")))
+#ifndef BN_HW_HOST
+    /**
+     * @brief Indicates if the headless host backend is being used instead of the GBA one.
+     *
+     * It is defined by butano_host.mak, so it shouldn't be defined manually.
+     */
+    #define BN_HW_HOST 0
+#endif
 
-/**
- * @brief Store ARM code in IWRAM.
- */
-#define BN_CODE_IWRAM __attribute__((section(".iwram"), target("arm")))
+#if BN_HW_HOST
+    // Host builds don't have IWRAM nor EWRAM, so only the section names are kept to measure used memory:
+    #define BN_DATA_EWRAM __attribute__((section("bn_ewram")))
+    #define BN_CODE_IWRAM __attribute__((section("bn_iwram")))
+    #define BN_CODE_EWRAM
+#else
+    /**
+     * @brief Store data in EWRAM.
+     */
+    #define BN_DATA_EWRAM __attribute__((section(".ewram")))
 
-/**
- * @brief Store Thumb code in EWRAM.
- */
-#define BN_CODE_EWRAM __attribute__((section(".ewram")))
+    /**
+     * @brief Store ARM code in IWRAM.
+     */
+    #define BN_CODE_IWRAM __attribute__((section(".iwram"), target("arm")))
+
+    /**
+     * @brief Store Thumb code in EWRAM.
+     */
+    #define BN_CODE_EWRAM __attribute__((section(".ewram")))
+#endif
 
 /**
  * @brief Creates a compiler level memory barrier forcing optimizer to not re-order memory accesses across the barrier.
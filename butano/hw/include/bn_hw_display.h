@@ -41,10 +41,15 @@ namespace bn::hw::display
         return 2;
     }
 
-    inline void setup(int mode, const bool* enabled_bgs, const bool* enabled_inside_windows)
+    inline void setup(int mode, bool second_page, const bool* enabled_bgs, const bool* enabled_inside_windows)
     {
         unsigned dispcnt = unsigned(mode) | DCNT_OBJ | DCNT_OBJ_1D;
 
+        if(second_page)
+        {
+            dispcnt |= DCNT_PAGE;
+        }
+
         for(int index = 0; index < bgs::count(); ++index)
         {
             if(enabled_bgs[index])
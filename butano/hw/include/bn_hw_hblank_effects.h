@@ -8,7 +8,10 @@
 
 #include "bn_algorithm.h"
 #include "bn_config_hbes.h"
+#include "bn_config_sprites.h"
 #include "bn_hw_irq.h"
+#include "bn_hw_hdma.h"
+#include "bn_hw_display_constants.h"
 
 namespace bn::hw::hblank_effects
 {
@@ -33,6 +36,31 @@ namespace bn::hw::hblank_effects
         return 4;
     }
 
+    // DMA entries are written by H-Blank DMA transfers.
+    // Their DMA channels are restarted by the H-Blank interrupt which writes the values of the first screen line:
+    class dma_entry
+    {
+
+    public:
+        const uint16_t* src;
+        uint16_t* dest;
+        int channel;
+        bool uint32;
+    };
+
+    // Only the allocatable HDMA channels which are not used by HDMA can be used:
+    [[nodiscard]] constexpr int max_dma_entries()
+    {
+        return hdma::last_allocatable_channel() - hdma::first_allocatable_channel() + 1;
+    }
+
+    // V-Count interrupts are used by the sprites multiplexer if it's enabled.
+    // In that case, the H-Blank interrupt is raised in every screen line:
+    [[nodiscard]] constexpr bool vcount_gating()
+    {
+        return ! BN_CFG_SPRITES_MULTIPLEXING_ENABLED;
+    }
+
     class entries
     {
 
@@ -41,32 +69,107 @@ namespace bn::hw::hblank_effects
         uint16_entry uint16_entries[BN_CFG_HBES_MAX_ITEMS];
         int uint32_entries_count = 0;
         uint32_entry uint32_entries[max_uint32_entries()];
+        int dma_entries_count = 0;
+        dma_entry dma_entries[max_dma_entries()];
+        const uint8_t* lines = nullptr;
+        int lines_count = 0;
+    };
+
+    class state
+    {
+
+    public:
+        const entries* entries_ptr = nullptr;
+        const uint8_t* next_line = nullptr;
+        const uint8_t* first_line = nullptr;
+        const uint8_t* last_line = nullptr;
     };
 
-    extern entries* data;
+    extern state data;
 
-    BN_CODE_IWRAM void _intr();
+    BN_CODE_IWRAM void _hblank_intr();
 
-    inline void commit_entries(entries& entries_ref)
+    BN_CODE_IWRAM void _vcount_intr();
+
+    // Stores in lines_ptr the screen lines where at least one entry value changes (the first line is always 0)
+    // and returns the number of stored lines:
+    BN_CODE_IWRAM int build_lines(const entries& entries_ref, uint8_t* lines_ptr);
+
+    // The values of a line are written in the H-Blank period of the previous line:
+    [[nodiscard]] constexpr int vcount_target(int line)
+    {
+        return line ? line - 1 : 227;
+    }
+
+    inline void _set_vcount_target(int vcount)
     {
-        data = &entries_ref;
+        REG_DISPSTAT = uint16_t((REG_DISPSTAT & ~DSTAT_VCT_MASK) | DSTAT_VCT(vcount));
     }
 
-    inline void init(entries& entries_ref)
+    inline void _restart()
     {
-        commit_entries(entries_ref);
-        irq::replace_or_push_back(irq::id::HBLANK, _intr);
+        const uint8_t* first_line = data.first_line;
+        data.next_line = first_line;
+
+        if(vcount_gating())
+        {
+            REG_DISPSTAT = uint16_t(REG_DISPSTAT & ~DSTAT_HBL_IRQ);
+            _set_vcount_target(vcount_target(*first_line));
+        }
+    }
+
+    inline void commit_entries(const entries& entries_ref)
+    {
+        const uint8_t* lines = entries_ref.lines;
+        data.entries_ptr = &entries_ref;
+        data.first_line = lines;
+        data.last_line = lines + entries_ref.lines_count;
+        _restart();
+    }
+
+    inline void stop_dmas(unsigned channels_mask)
+    {
+        for(int channel = hdma::first_allocatable_channel(); channel <= hdma::last_allocatable_channel(); ++channel)
+        {
+            if(channels_mask & (1U << channel))
+            {
+                hdma::stop(channel);
+            }
+        }
+    }
+
+    inline void init(const entries& entries_ref)
+    {
+        data.entries_ptr = &entries_ref;
+        irq::replace_or_push_back(irq::id::HBLANK, _hblank_intr);
         irq::disable(irq::id::HBLANK);
+
+        if(vcount_gating())
+        {
+            irq::replace_or_push_back(irq::id::VCOUNT, _vcount_intr);
+            irq::disable(irq::id::VCOUNT);
+        }
     }
 
     inline void enable()
     {
         irq::enable(irq::id::HBLANK);
+
+        if(vcount_gating())
+        {
+            _restart();
+            irq::enable(irq::id::VCOUNT);
+        }
     }
 
     inline void disable()
     {
         irq::disable(irq::id::HBLANK);
+
+        if(vcount_gating())
+        {
+            irq::disable(irq::id::VCOUNT);
+        }
     }
 }
 
@@ -7,6 +7,7 @@
 #define BN_HW_HDMA_H
 
 #include "bn_hw_tonc.h"
+#include "bn_config_audio.h"
 
 namespace bn::hw::hdma
 {
@@ -21,11 +22,32 @@ namespace bn::hw::hdma
     return 0;
 }
 
+// DMA channel 1 is used by the audio mixer and channel 0 has more priority than it,
+// so only channels 2 and 3 can be allocated (channel 2 is also used by the native audio mixer):
+[[nodiscard]] constexpr int first_allocatable_channel()
+{
+    #if BN_CFG_AUDIO_BACKEND == BN_AUDIO_BACKEND_NATIVE
+        return 3;
+    #else
+        return 2;
+    #endif
+}
+
+[[nodiscard]] constexpr int last_allocatable_channel()
+{
+    return low_priority_channel();
+}
+
 inline void start(int channel, const uint16_t* source_ptr, int half_words, uint16_t* destination_ptr)
 {
     DMA_TRANSFER(destination_ptr, source_ptr, half_words, channel, DMA_HDMA);
 }
 
+inline void start(int channel, const uint32_t* source_ptr, int words, uint32_t* destination_ptr)
+{
+    DMA_TRANSFER(destination_ptr, source_ptr, words, channel, DMA_HDMA | DMA_32);
+}
+
 inline void stop(int channel)
 {
     REG_DMA[channel].cnt = 0;
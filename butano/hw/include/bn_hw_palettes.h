@@ -86,6 +86,19 @@ namespace bn::hw::palettes
         clr_rotate(tonc_colors_ptr, unsigned(colors_count), rotate_count);
     }
 
+    // Per channel color effects can be fused in 32 entries lookup tables.
+    // Grayscale mixes channels, so it's applied between the channels and the fade_channels tables:
+    class effects_lut
+    {
+
+    public:
+        uint8_t channels[3][32];
+        uint8_t fade_channels[3][32];
+        int grayscale_intensity;
+    };
+
+    BN_CODE_IWRAM void apply_effects_lut(const effects_lut& lut, int count, color* colors_ptr);
+
     inline void commit_sprites(const color* colors_ptr, int offset, int count)
     {
         commit(colors_ptr, offset, count, reinterpret_cast<color*>(MEM_PAL_OBJ));
@@ -8,6 +8,7 @@
 
 #include "bn_tile.h"
 #include "bn_assert.h"
+#include "bn_algorithm.h"
 #include "bn_compression_type.h"
 #include "bn_hw_memory.h"
 #include "bn_hw_uncompress.h"
@@ -30,6 +31,21 @@ namespace bn::hw::sprite_tiles
         hw::memory::copy_words(source_tiles_ptr, count * (sizeof(tile) / 4), destination_tiles_ptr);
     }
 
+    inline void move_tiles(int source_index, int count, int destination_index)
+    {
+        BN_ASSERT(destination_index < source_index, "Invalid destination index: ",
+                  destination_index, " - ", source_index);
+
+        // Tiles are moved in chunks which don't overlap:
+        int chunk_count = source_index - destination_index;
+
+        for(int index = 0; index < count; index += chunk_count)
+        {
+            copy_tiles(tile_vram(source_index + index), min(chunk_count, count - index),
+                       tile_vram(destination_index + index));
+        }
+    }
+
     inline void clear_tiles(int count, tile* tiles_ptr)
     {
         hw::memory::set_words(0, count * (sizeof(tile) / 4), tiles_ptr);
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_HW_SPRITES_MULTIPLEXER_H
+#define BN_HW_SPRITES_MULTIPLEXER_H
+
+#include "bn_hw_irq.h"
+#include "bn_config_sprites.h"
+#include "bn_hw_sprites_constants.h"
+#include "bn_hw_display_constants.h"
+
+namespace bn::hw::sprites_multiplexer
+{
+    class entry
+    {
+
+    public:
+        uint16_t attr0;
+        uint16_t attr1;
+        uint16_t attr2;
+        uint16_t oam_index;
+    };
+
+    class line
+    {
+
+    public:
+        uint8_t vcount;
+        uint8_t entries_count;
+    };
+
+    [[nodiscard]] constexpr int max_scanline_cycles()
+    {
+        return 1210;
+    }
+
+    [[nodiscard]] constexpr int max_entries()
+    {
+        return BN_CFG_SPRITES_MAX_ITEMS > sprites::count() ? BN_CFG_SPRITES_MAX_ITEMS - sprites::count() : 1;
+    }
+
+    [[nodiscard]] constexpr int max_restore_entries()
+    {
+        return max_entries() < sprites::count() ? max_entries() : sprites::count();
+    }
+
+    class schedule
+    {
+
+    public:
+        int lines_count = 0;
+        int restore_entries_count = 0;
+        line lines[display::height()];
+        entry entries[max_entries()];
+        entry restore_entries[max_restore_entries()];
+    };
+
+    class state
+    {
+
+    public:
+        const schedule* committed_schedule = nullptr;
+        const line* next_line = nullptr;
+        const line* last_line = nullptr;
+        const entry* next_entry = nullptr;
+    };
+
+    extern state data;
+
+    BN_CODE_IWRAM void _intr();
+
+    BN_CODE_IWRAM void restore();
+
+    inline void _set_vcount_target(int vcount)
+    {
+        REG_DISPSTAT = uint16_t((REG_DISPSTAT & ~DSTAT_VCT_MASK) | DSTAT_VCT(vcount));
+    }
+
+    inline void init()
+    {
+        irq::replace_or_push_back(irq::id::VCOUNT, _intr);
+        irq::disable(irq::id::VCOUNT);
+    }
+
+    inline void commit(const schedule& schedule_ref)
+    {
+        if(int lines_count = schedule_ref.lines_count)
+        {
+            const line* lines = schedule_ref.lines;
+            data.committed_schedule = &schedule_ref;
+            data.next_line = lines;
+            data.last_line = lines + lines_count;
+            data.next_entry = schedule_ref.entries;
+            _set_vcount_target(lines[0].vcount);
+            irq::enable(irq::id::VCOUNT);
+        }
+        else
+        {
+            irq::disable(irq::id::VCOUNT);
+            data.committed_schedule = nullptr;
+        }
+    }
+}
+
+#endif
@@ -14,13 +14,13 @@ namespace bn::hw::text
 
     [[nodiscard]] int parse(long value, array<char, 32>& output);
 
-    [[nodiscard]] int parse(int64_t value, array<char, 32>& output);
+    [[nodiscard]] int parse(long long value, array<char, 32>& output);
 
     [[nodiscard]] int parse(unsigned value, array<char, 32>& output);
 
     [[nodiscard]] int parse(unsigned long value, array<char, 32>& output);
 
-    [[nodiscard]] int parse(uint64_t value, array<char, 32>& output);
+    [[nodiscard]] int parse(unsigned long long value, array<char, 32>& output);
 
     [[nodiscard]] int parse(const void* ptr, array<char, 32>& output);
 }
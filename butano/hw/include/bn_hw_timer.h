@@ -23,12 +23,16 @@ namespace bn::hw::timer
         REG_TM2CNT = TM_ENABLE | TM_FREQ_64;
     }
 
-    [[nodiscard]] inline unsigned ticks()
-    {
-        BN_BARRIER;
-
-        return (unsigned(REG_TM3D) << 16) | REG_TM2D;
-    }
+    #if BN_HW_HOST
+        [[nodiscard]] unsigned ticks();
+    #else
+        [[nodiscard]] inline unsigned ticks()
+        {
+            BN_BARRIER;
+
+            return (unsigned(REG_TM3D) << 16) | REG_TM2D;
+        }
+    #endif
 }
 
 #endif
@@ -5,9 +5,12 @@
 
 #include "../include/bn_hw_audio.h"
 
+#include "bn_config_audio.h"
+
+#if BN_CFG_AUDIO_BACKEND == BN_AUDIO_BACKEND_MAXMOD
+
 #include "maxmod.h"
 #include "bn_forward_list.h"
-#include "bn_config_audio.h"
 #include "../include/bn_hw_irq.h"
 
 extern const uint8_t _bn_audio_soundbank_bin[];
@@ -120,16 +123,11 @@ namespace
         data.sounds_queue.insert_after(before_it, sound_type{ handle, int16_t(priority) });
     }
 
-    void _update_frame_without_hp_vblank_function()
-    {
-        mmFrame();
-        data.lp_vblank_function();
-    }
-
     void _update_frame_with_hp_vblank_function()
     {
         data.hp_vblank_function();
-        _update_frame_without_hp_vblank_function();
+        mmFrame();
+        data.lp_vblank_function();
     }
 }
 
@@ -246,9 +244,14 @@ void disable_vblank_handler()
     mmSetVBlankHandler(reinterpret_cast<void*>(data.hp_vblank_function));
 }
 
+void mix()
+{
+    mmFrame();
+}
+
 void commit()
 {
-    _update_frame_without_hp_vblank_function();
+    data.lp_vblank_function();
 
     auto before_it = data.sounds_queue.before_begin();
     auto it = data.sounds_queue.begin();
@@ -276,3 +279,5 @@ void enable_vblank_handler()
 }
 
 }
+
+#endif
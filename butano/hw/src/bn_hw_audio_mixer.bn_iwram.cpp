@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../include/bn_hw_audio_mixer.h"
+
+#include "../include/bn_hw_tonc.h"
+
+namespace bn::hw::audio_mixer
+{
+
+namespace
+{
+    constexpr const int16_t adpcm_steps[] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+        107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+        4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+        22385, 24623, 27086, 29794, 32767
+    };
+
+    constexpr const int8_t adpcm_step_index_deltas[] = {
+        -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+    constexpr const int max_adpcm_step_index = int(sizeof(adpcm_steps) / sizeof(adpcm_steps[0])) - 1;
+
+    constexpr const int right_dma_channel = 1;
+    constexpr const int left_dma_channel = 2;
+
+
+    void _mix_pcm(const channel& channel, unsigned position, int samples_count, int16_t* left_accumulators_ptr,
+                  int16_t* right_accumulators_ptr)
+    {
+        auto data = reinterpret_cast<const int8_t*>(channel.data);
+        unsigned step = channel.step;
+        int left_volume = channel.left_volume;
+        int right_volume = channel.right_volume;
+
+        for(int index = 0; index < samples_count; ++index)
+        {
+            int sample = data[position >> position_shift()];
+            left_accumulators_ptr[index] = int16_t(left_accumulators_ptr[index] + ((sample * left_volume) >> 4));
+            right_accumulators_ptr[index] = int16_t(right_accumulators_ptr[index] + ((sample * right_volume) >> 4));
+            position += step;
+        }
+    }
+
+    void _mix_adpcm(channel& channel, unsigned position, int samples_count, int16_t* left_accumulators_ptr,
+                    int16_t* right_accumulators_ptr)
+    {
+        const uint8_t* data = channel.data;
+        unsigned step = channel.step;
+        int left_volume = channel.left_volume;
+        int right_volume = channel.right_volume;
+        unsigned decoded_samples = channel.decoded_samples;
+        int decoded_value = channel.decoded_value;
+        int step_index = channel.decoder_step_index;
+
+        for(int index = 0; index < samples_count; ++index)
+        {
+            unsigned sample_index = position >> position_shift();
+
+            // Codes are decoded until the sample at the current position (several of them if speed is above 1):
+            while(decoded_samples <= sample_index)
+            {
+                unsigned code = data[decoded_samples >> 1] >> ((decoded_samples & 1) * 4);
+                int adpcm_step = adpcm_steps[step_index];
+                int delta = adpcm_step >> 3;
+
+                if(code & 1)
+                {
+                    delta += adpcm_step >> 2;
+                }
+
+                if(code & 2)
+                {
+                    delta += adpcm_step >> 1;
+                }
+
+                if(code & 4)
+                {
+                    delta += adpcm_step;
+                }
+
+                if(code & 8)
+                {
+                    decoded_value = decoded_value - delta < -32768 ? -32768 : decoded_value - delta;
+                }
+                else
+                {
+                    decoded_value = decoded_value + delta > 32767 ? 32767 : decoded_value + delta;
+                }
+
+                step_index += adpcm_step_index_deltas[code & 7];
+                step_index = step_index < 0 ? 0 : step_index > max_adpcm_step_index ? max_adpcm_step_index : step_index;
+                ++decoded_samples;
+            }
+
+            int sample = decoded_value >> 8;
+            left_accumulators_ptr[index] = int16_t(left_accumulators_ptr[index] + ((sample * left_volume) >> 4));
+            right_accumulators_ptr[index] = int16_t(right_accumulators_ptr[index] + ((sample * right_volume) >> 4));
+            position += step;
+        }
+
+        channel.decoded_samples = decoded_samples;
+        channel.decoded_value = decoded_value;
+        channel.decoder_step_index = step_index;
+    }
+
+    void _output(const int16_t* accumulators_ptr, int samples_count, int8_t* output_ptr)
+    {
+        for(int index = 0; index < samples_count; ++index)
+        {
+            int sample = accumulators_ptr[index] >> 4;
+            output_ptr[index] = int8_t(sample < -128 ? -128 : sample > 127 ? 127 : sample);
+        }
+    }
+}
+
+void mix(channel* channels_ptr, int channels_count, int samples_count, int16_t* accumulators_ptr,
+         int8_t* left_output_ptr, int8_t* right_output_ptr)
+{
+    int16_t* left_accumulators_ptr = accumulators_ptr;
+    int16_t* right_accumulators_ptr = accumulators_ptr + samples_count;
+    auto accumulator_pairs_ptr = reinterpret_cast<uint32_t*>(accumulators_ptr);
+
+    for(int index = 0; index < samples_count; ++index)
+    {
+        accumulator_pairs_ptr[index] = 0;
+    }
+
+    for(int index = 0; index < channels_count; ++index)
+    {
+        channel& channel = channels_ptr[index];
+
+        if(channel.active())
+        {
+            // The channel is mixed until the end of its sample without checking it in each output sample:
+            unsigned position = channel.position;
+            unsigned step = channel.step;
+            unsigned remaining_samples = (channel.end - position + step - 1) / step;
+            int channel_samples_count = remaining_samples < unsigned(samples_count) ?
+                        int(remaining_samples) : samples_count;
+
+            if(channel.adpcm)
+            {
+                _mix_adpcm(channel, position, channel_samples_count, left_accumulators_ptr, right_accumulators_ptr);
+            }
+            else
+            {
+                _mix_pcm(channel, position, channel_samples_count, left_accumulators_ptr, right_accumulators_ptr);
+            }
+
+            position += unsigned(channel_samples_count) * step;
+
+            if(position >= channel.end)
+            {
+                channel.stop();
+            }
+            else
+            {
+                channel.position = position;
+            }
+        }
+    }
+
+    _output(left_accumulators_ptr, samples_count, left_output_ptr);
+    _output(right_accumulators_ptr, samples_count, right_output_ptr);
+}
+
+void restart_sound_dma(unsigned direct_sound_control, const int8_t* left_output_ptr, const int8_t* right_output_ptr)
+{
+    auto left_words_ptr = reinterpret_cast<const uint32_t*>(left_output_ptr);
+    auto right_words_ptr = reinterpret_cast<const uint32_t*>(right_output_ptr);
+    REG_DMA[left_dma_channel].cnt = 0;
+    REG_DMA[right_dma_channel].cnt = 0;
+    REG_SNDDSCNT = uint16_t(direct_sound_control | SDS_ARESET | SDS_BRESET);
+
+    // Sound DMA transfers are requested when a sample is played, so the first words are written here:
+    for(int index = 0; index < fifo_prime_words(); ++index)
+    {
+        REG_FIFO_B = left_words_ptr[index];
+        REG_FIFO_A = right_words_ptr[index];
+    }
+
+    REG_DMA[left_dma_channel].src = left_words_ptr + fifo_prime_words();
+    REG_DMA[left_dma_channel].dst = const_cast<uint32_t*>(&REG_FIFO_B);
+    REG_DMA[left_dma_channel].cnt = DMA_DST_FIXED | DMA_REPEAT | DMA_32 | DMA_AT_FIFO | DMA_ENABLE;
+    REG_DMA[right_dma_channel].src = right_words_ptr + fifo_prime_words();
+    REG_DMA[right_dma_channel].dst = const_cast<uint32_t*>(&REG_FIFO_A);
+    REG_DMA[right_dma_channel].cnt = DMA_DST_FIXED | DMA_REPEAT | DMA_32 | DMA_AT_FIFO | DMA_ENABLE;
+}
+
+}
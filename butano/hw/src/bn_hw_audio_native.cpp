@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../include/bn_hw_audio.h"
+
+#include "bn_config_audio.h"
+
+#if BN_CFG_AUDIO_BACKEND == BN_AUDIO_BACKEND_NATIVE
+
+#include "bn_forward_list.h"
+#include "../include/bn_hw_irq.h"
+#include "../include/bn_hw_tonc.h"
+#include "../include/bn_hw_audio_mixer.h"
+
+extern const uint8_t _bn_audio_soundbank_bin[];
+
+namespace bn::hw::audio
+{
+
+namespace
+{
+    static_assert(BN_CFG_AUDIO_MAX_SOUND_CHANNELS > 0, "Invalid max sound channels");
+    static_assert(BN_CFG_AUDIO_MAX_SOUND_CHANNELS <= audio_mixer::max_channels(), "Invalid max sound channels");
+
+    constexpr const int _buffer_size = audio_mixer::buffer_size(BN_CFG_AUDIO_MIXING_RATE);
+    constexpr const int _timer_period = audio_mixer::timer_period(BN_CFG_AUDIO_MIXING_RATE);
+
+    static_assert(_buffer_size * _timer_period == audio_mixer::frame_cycles(), "Invalid buffer size");
+    static_assert(_buffer_size % 4 == 0, "Invalid buffer size");
+
+    // Right output is played by Direct Sound A and left output by Direct Sound B:
+    constexpr const unsigned _direct_sound_control = SDS_A100 | SDS_AR | SDS_ATMR0 | SDS_B100 | SDS_BL | SDS_BTMR0;
+
+
+    class sound_type
+    {
+
+    public:
+        int16_t priority;
+        int8_t channel_index;
+    };
+
+
+    class static_data
+    {
+
+    public:
+        forward_list<sound_type, BN_CFG_AUDIO_MAX_SOUND_CHANNELS> sounds_queue;
+        func_type hp_vblank_function = nullptr;
+        func_type lp_vblank_function = nullptr;
+        volatile func_type vblank_handler = nullptr;
+        uint16_t stat_value = 0;
+        volatile int mix_buffer_index = 0;
+        bool start_timer = true;
+    };
+
+    BN_DATA_EWRAM static_data data;
+
+
+    // Mixer channels, accumulators and output buffers are placed in IWRAM:
+    audio_mixer::channel channels[BN_CFG_AUDIO_MAX_SOUND_CHANNELS];
+
+    alignas(int) int16_t accumulators[_buffer_size * 2];
+
+    alignas(int) int8_t output_buffers[2][2][_buffer_size + audio_mixer::output_buffer_padding()];
+
+
+    [[nodiscard]] int _free_channel_index()
+    {
+        unsigned used_channels_mask = 0;
+
+        for(const sound_type& sound : data.sounds_queue)
+        {
+            used_channels_mask |= 1U << sound.channel_index;
+        }
+
+        for(int index = 0; index < BN_CFG_AUDIO_MAX_SOUND_CHANNELS; ++index)
+        {
+            if(! (used_channels_mask & (1U << index)))
+            {
+                return index;
+            }
+        }
+
+        BN_ERROR("No free channels found");
+        return 0;
+    }
+
+    void _play_sound(int priority, int id, int volume, int speed, int panning)
+    {
+        int channel_index;
+
+        if(data.sounds_queue.full())
+        {
+            channel_index = data.sounds_queue.front().channel_index;
+            data.sounds_queue.pop_front();
+        }
+        else
+        {
+            channel_index = _free_channel_index();
+        }
+
+        const audio_mixer::sample_header& sample = audio_mixer::bank_sample(_bn_audio_soundbank_bin, id);
+        channels[channel_index].start(sample, volume, speed, panning, BN_CFG_AUDIO_MIXING_RATE);
+
+        auto before_it = data.sounds_queue.before_begin();
+        auto it = data.sounds_queue.begin();
+        auto end = data.sounds_queue.end();
+
+        while(it != end)
+        {
+            sound_type& sound = *it;
+
+            if(sound.priority <= priority)
+            {
+                before_it = it;
+                ++it;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        data.sounds_queue.insert_after(before_it, sound_type{ int16_t(priority), int8_t(channel_index) });
+    }
+
+    void _mix()
+    {
+        auto& output_buffer = output_buffers[data.mix_buffer_index];
+        audio_mixer::mix(channels, BN_CFG_AUDIO_MAX_SOUND_CHANNELS, _buffer_size, accumulators, output_buffer[0],
+                         output_buffer[1]);
+    }
+
+    void _update_frame_with_hp_vblank_function()
+    {
+        data.hp_vblank_function();
+        _mix();
+        data.lp_vblank_function();
+    }
+
+    void _vblank_intr()
+    {
+        // The buffers mixed in the previous frame are played in this one:
+        int mix_buffer_index = data.mix_buffer_index;
+        auto& output_buffer = output_buffers[mix_buffer_index];
+        audio_mixer::restart_sound_dma(_direct_sound_control, output_buffer[0], output_buffer[1]);
+        data.mix_buffer_index = mix_buffer_index ^ 1;
+
+        // Timer 0 is started after the first restart, so its overflows stay away from the next restarts:
+        if(data.start_timer)
+        {
+            data.start_timer = false;
+            REG_TM0CNT = 0;
+            REG_TM0D = uint16_t(0x10000 - audio_mixer::first_overflow_delay(BN_CFG_AUDIO_MIXING_RATE));
+            REG_TM0CNT = TM_ENABLE;
+            REG_TM0D = uint16_t(0x10000 - _timer_period);
+        }
+
+        if(func_type vblank_handler = data.vblank_handler)
+        {
+            vblank_handler();
+        }
+    }
+}
+
+void init(func_type hp_vblank_function, func_type lp_vblank_function)
+{
+    data.hp_vblank_function = hp_vblank_function;
+    data.lp_vblank_function = lp_vblank_function;
+    data.vblank_handler = hp_vblank_function;
+
+    irq::replace_or_push_back(irq::id::VBLANK, _vblank_intr);
+
+    REG_SNDSTAT = SSTAT_ENABLE;
+    REG_SNDDSCNT = _direct_sound_control | SDS_ARESET | SDS_BRESET;
+}
+
+void enable()
+{
+    REG_SNDSTAT = data.stat_value;
+    REG_SNDDSCNT = _direct_sound_control | SDS_ARESET | SDS_BRESET;
+    data.start_timer = true;
+    irq::enable(irq::id::VBLANK);
+}
+
+void disable()
+{
+    irq::disable(irq::id::VBLANK);
+    data.stat_value = REG_SNDSTAT;
+    REG_TM0CNT = 0;
+    REG_SNDDSCNT = 0;
+    REG_SNDSTAT = 0;
+}
+
+bool music_playing()
+{
+    return false;
+}
+
+void play_music(int, int, bool)
+{
+    BN_ERROR("Music is not supported by the native audio backend");
+}
+
+void stop_music()
+{
+}
+
+void pause_music()
+{
+}
+
+void resume_music()
+{
+}
+
+int music_position()
+{
+    return 0;
+}
+
+void set_music_position(int)
+{
+}
+
+void set_music_volume(int)
+{
+}
+
+void play_sound(int priority, int id)
+{
+    _play_sound(priority, id, 255, 1 << 10, 128);
+}
+
+void play_sound(int priority, int id, int volume, int speed, int panning)
+{
+    _play_sound(priority, id, volume, speed, panning);
+}
+
+void stop_all_sounds()
+{
+    for(audio_mixer::channel& channel : channels)
+    {
+        channel.stop();
+    }
+
+    data.sounds_queue.clear();
+}
+
+void disable_vblank_handler()
+{
+    data.vblank_handler = data.hp_vblank_function;
+}
+
+void mix()
+{
+    _mix();
+}
+
+void commit()
+{
+    data.lp_vblank_function();
+
+    auto before_it = data.sounds_queue.before_begin();
+    auto it = data.sounds_queue.begin();
+    auto end = data.sounds_queue.end();
+
+    while(it != end)
+    {
+        if(channels[it->channel_index].active())
+        {
+            before_it = it;
+            ++it;
+        }
+        else
+        {
+            it = data.sounds_queue.erase_after(before_it);
+        }
+    }
+}
+
+void enable_vblank_handler()
+{
+    data.vblank_handler = _update_frame_with_hp_vblank_function;
+}
+
+}
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../include/bn_hw_bg_blocks.h"
+
+namespace bn::hw::bg_blocks
+{
+
+namespace
+{
+    constexpr unsigned tile_id_mask = SE_ID_MASK;
+    constexpr unsigned palette_bank_mask = SE_PALBANK_MASK;
+    constexpr unsigned flip_mask = SE_HFLIP | SE_VFLIP;
+
+    class no_offset
+    {
+
+    public:
+        [[nodiscard]] unsigned operator()(unsigned cell) const
+        {
+            return cell;
+        }
+    };
+
+    class tiles_offset_only
+    {
+
+    public:
+        unsigned tiles_offset;
+
+        [[nodiscard]] unsigned operator()(unsigned cell) const
+        {
+            return (cell & ~tile_id_mask) | ((cell + tiles_offset) & tile_id_mask);
+        }
+    };
+
+    class palette_offset_only
+    {
+
+    public:
+        unsigned palette_offset;
+
+        [[nodiscard]] unsigned operator()(unsigned cell) const
+        {
+            return (cell & ~palette_bank_mask) | ((cell + palette_offset) & palette_bank_mask);
+        }
+    };
+
+    class tiles_and_palette_offset
+    {
+
+    public:
+        unsigned tiles_offset;
+        unsigned palette_offset;
+
+        [[nodiscard]] unsigned operator()(unsigned cell) const
+        {
+            return ((cell + tiles_offset) & tile_id_mask) | (cell & flip_mask) |
+                    ((cell + palette_offset) & palette_bank_mask);
+        }
+    };
+
+    template<class CellOp>
+    void _copy_regular_col(const uint16_t* source_cells_ptr, int source_width, int y_separator, CellOp cell_op,
+                           uint16_t* destination_col_ptr)
+    {
+        uint16_t* destination_cells_ptr = destination_col_ptr + (y_separator * 32);
+
+        for(int iy = y_separator; iy < 32; ++iy)
+        {
+            *destination_cells_ptr = uint16_t(cell_op(*source_cells_ptr));
+            destination_cells_ptr += 32;
+            source_cells_ptr += source_width;
+        }
+
+        destination_cells_ptr = destination_col_ptr;
+
+        for(int iy = 0; iy < y_separator; ++iy)
+        {
+            *destination_cells_ptr = uint16_t(cell_op(*source_cells_ptr));
+            destination_cells_ptr += 32;
+            source_cells_ptr += source_width;
+        }
+    }
+
+    template<class CellOp>
+    void _copy_regular_row_run(const uint16_t* source_cells_ptr, int count, CellOp cell_op,
+                               uint16_t* destination_cells_ptr)
+    {
+        if(count && (reinterpret_cast<uintptr_t>(destination_cells_ptr) & 2))
+        {
+            *destination_cells_ptr = uint16_t(cell_op(*source_cells_ptr));
+            ++source_cells_ptr;
+            ++destination_cells_ptr;
+            --count;
+        }
+
+        // VRAM is written with 32-bit stores, two map cells at a time:
+        auto destination_words_ptr = reinterpret_cast<unsigned*>(destination_cells_ptr);
+
+        if(reinterpret_cast<uintptr_t>(source_cells_ptr) & 2)
+        {
+            for(; count >= 2; count -= 2)
+            {
+                unsigned first_cell = uint16_t(cell_op(source_cells_ptr[0]));
+                unsigned second_cell = cell_op(source_cells_ptr[1]);
+                *destination_words_ptr = first_cell | (second_cell << 16);
+                source_cells_ptr += 2;
+                ++destination_words_ptr;
+            }
+        }
+        else
+        {
+            auto source_words_ptr = reinterpret_cast<const unsigned*>(source_cells_ptr);
+
+            for(; count >= 2; count -= 2)
+            {
+                unsigned source_word = *source_words_ptr;
+                unsigned first_cell = uint16_t(cell_op(source_word & 0xFFFF));
+                unsigned second_cell = cell_op(source_word >> 16);
+                *destination_words_ptr = first_cell | (second_cell << 16);
+                ++source_words_ptr;
+                ++destination_words_ptr;
+            }
+
+            source_cells_ptr = reinterpret_cast<const uint16_t*>(source_words_ptr);
+        }
+
+        if(count)
+        {
+            *reinterpret_cast<uint16_t*>(destination_words_ptr) = uint16_t(cell_op(*source_cells_ptr));
+        }
+    }
+
+    template<class CellOp>
+    void _copy_regular_row(const uint16_t* source_cells_ptr, int x_separator, CellOp cell_op,
+                           uint16_t* destination_row_ptr)
+    {
+        int elements = 32 - x_separator;
+        _copy_regular_row_run(source_cells_ptr, elements, cell_op, destination_row_ptr + x_separator);
+        _copy_regular_row_run(source_cells_ptr + elements, x_separator, cell_op, destination_row_ptr);
+    }
+
+    void _copy_affine_col_rows(const uint8_t*& source_cells_ptr, int source_width, int rows, unsigned tiles_offset,
+                               unsigned shift, uint16_t* destination_cells_ptr)
+    {
+        unsigned keep_mask = 0xFF00 >> shift;
+
+        for(int iy = 0; iy < rows; ++iy)
+        {
+            unsigned cell = (*source_cells_ptr + tiles_offset) & 0xFF;
+            *destination_cells_ptr = uint16_t((*destination_cells_ptr & keep_mask) | (cell << shift));
+            destination_cells_ptr += 16;
+            source_cells_ptr += source_width;
+        }
+    }
+}
+
+void copy_regular_bg_map_col(const uint16_t* source_cells_ptr, int source_width, int y_separator,
+                             unsigned tiles_offset, unsigned palette_offset, uint16_t* destination_col_ptr)
+{
+    palette_offset <<= SE_PALBANK_SHIFT;
+
+    if(tiles_offset)
+    {
+        if(palette_offset)
+        {
+            _copy_regular_col(source_cells_ptr, source_width, y_separator,
+                              tiles_and_palette_offset{ tiles_offset, palette_offset }, destination_col_ptr);
+        }
+        else
+        {
+            _copy_regular_col(source_cells_ptr, source_width, y_separator, tiles_offset_only{ tiles_offset },
+                              destination_col_ptr);
+        }
+    }
+    else
+    {
+        if(palette_offset)
+        {
+            _copy_regular_col(source_cells_ptr, source_width, y_separator, palette_offset_only{ palette_offset },
+                              destination_col_ptr);
+        }
+        else
+        {
+            _copy_regular_col(source_cells_ptr, source_width, y_separator, no_offset(), destination_col_ptr);
+        }
+    }
+}
+
+void copy_regular_bg_map_row(const uint16_t* source_cells_ptr, int x_separator, unsigned tiles_offset,
+                             unsigned palette_offset, uint16_t* destination_row_ptr)
+{
+    palette_offset <<= SE_PALBANK_SHIFT;
+
+    if(tiles_offset)
+    {
+        if(palette_offset)
+        {
+            _copy_regular_row(source_cells_ptr, x_separator, tiles_and_palette_offset{ tiles_offset, palette_offset },
+                              destination_row_ptr);
+        }
+        else
+        {
+            _copy_regular_row(source_cells_ptr, x_separator, tiles_offset_only{ tiles_offset }, destination_row_ptr);
+        }
+    }
+    else
+    {
+        if(palette_offset)
+        {
+            _copy_regular_row(source_cells_ptr, x_separator, palette_offset_only{ palette_offset },
+                              destination_row_ptr);
+        }
+        else
+        {
+            _copy_regular_row(source_cells_ptr, x_separator, no_offset(), destination_row_ptr);
+        }
+    }
+}
+
+void copy_affine_bg_map_col(const uint8_t* source_cells_ptr, int source_width, int x, int y_separator,
+                            unsigned tiles_offset, uint16_t* destination_map_ptr)
+{
+    // Affine map rows are 16 half words wide, and VRAM doesn't support 8-bit writes:
+    uint16_t* destination_col_ptr = destination_map_ptr + ((x & 31) / 2);
+    unsigned shift = unsigned(x & 1) * 8;
+    _copy_affine_col_rows(source_cells_ptr, source_width, 32 - y_separator, tiles_offset, shift,
+                          destination_col_ptr + (y_separator * 16));
+    _copy_affine_col_rows(source_cells_ptr, source_width, y_separator, tiles_offset, shift, destination_col_ptr);
+}
+
+}
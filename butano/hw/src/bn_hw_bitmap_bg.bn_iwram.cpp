@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../include/bn_hw_bitmap_bg.h"
+
+namespace bn::hw::bitmap_bg
+{
+
+namespace
+{
+    // VRAM doesn't support byte writes, so 8BPP pixels are written in pairs:
+    [[nodiscard]] unsigned set_low_pixel(unsigned pair, unsigned color_index)
+    {
+        return (pair & 0xFF00) | color_index;
+    }
+
+    [[nodiscard]] unsigned set_high_pixel(unsigned pair, unsigned color_index)
+    {
+        return (pair & 0x00FF) | (color_index << 8);
+    }
+
+    void fill_row_16bpp(unsigned color, int count, uint16_t* dest_ptr)
+    {
+        if(count && (reinterpret_cast<uintptr_t>(dest_ptr) & 2))
+        {
+            *dest_ptr = uint16_t(color);
+            ++dest_ptr;
+            --count;
+        }
+
+        auto dest_words_ptr = reinterpret_cast<uint32_t*>(dest_ptr);
+        uint32_t color_word = color | (color << 16);
+
+        for(int index = 0, limit = count / 2; index < limit; ++index)
+        {
+            dest_words_ptr[index] = color_word;
+        }
+
+        if(count % 2)
+        {
+            dest_ptr[count - 1] = uint16_t(color);
+        }
+    }
+
+    void fill_row_8bpp(unsigned color_index, int x, int count, uint16_t* row_ptr)
+    {
+        uint16_t* dest_ptr = row_ptr + (x / 2);
+
+        if(count && x % 2)
+        {
+            *dest_ptr = uint16_t(set_high_pixel(*dest_ptr, color_index));
+            ++dest_ptr;
+            --count;
+        }
+
+        fill_row_16bpp(color_index | (color_index << 8), count / 2, dest_ptr);
+
+        if(count % 2)
+        {
+            dest_ptr += count / 2;
+            *dest_ptr = uint16_t(set_low_pixel(*dest_ptr, color_index));
+        }
+    }
+
+    void blit_row_16bpp(const uint16_t* source_ptr, int count, uint16_t* dest_ptr)
+    {
+        if((reinterpret_cast<uintptr_t>(source_ptr) ^ reinterpret_cast<uintptr_t>(dest_ptr)) & 2)
+        {
+            for(int index = 0; index < count; ++index)
+            {
+                dest_ptr[index] = source_ptr[index];
+            }
+
+            return;
+        }
+
+        if(count && (reinterpret_cast<uintptr_t>(dest_ptr) & 2))
+        {
+            *dest_ptr = *source_ptr;
+            ++source_ptr;
+            ++dest_ptr;
+            --count;
+        }
+
+        auto source_words_ptr = reinterpret_cast<const uint32_t*>(source_ptr);
+        auto dest_words_ptr = reinterpret_cast<uint32_t*>(dest_ptr);
+
+        for(int index = 0, limit = count / 2; index < limit; ++index)
+        {
+            dest_words_ptr[index] = source_words_ptr[index];
+        }
+
+        if(count % 2)
+        {
+            dest_ptr[count - 1] = source_ptr[count - 1];
+        }
+    }
+
+    void blit_row_8bpp(const uint8_t* source_ptr, int x, int count, uint16_t* row_ptr)
+    {
+        uint16_t* dest_ptr = row_ptr + (x / 2);
+
+        if(count && x % 2)
+        {
+            *dest_ptr = uint16_t(set_high_pixel(*dest_ptr, *source_ptr));
+            ++source_ptr;
+            ++dest_ptr;
+            --count;
+        }
+
+        for(int index = 0, limit = count / 2; index < limit; ++index)
+        {
+            dest_ptr[index] = uint16_t(source_ptr[index * 2] | (source_ptr[(index * 2) + 1] << 8));
+        }
+
+        if(count % 2)
+        {
+            dest_ptr += count / 2;
+            *dest_ptr = uint16_t(set_low_pixel(*dest_ptr, source_ptr[count - 1]));
+        }
+    }
+}
+
+void fill_rect_16bpp(unsigned color, int x, int y, int width, int height, int pitch, uint16_t* pixels_ptr)
+{
+    uint16_t* dest_ptr = pixels_ptr + (y * pitch) + x;
+
+    for(int row = 0; row < height; ++row)
+    {
+        fill_row_16bpp(color, width, dest_ptr);
+        dest_ptr += pitch;
+    }
+}
+
+void fill_rect_8bpp(unsigned color_index, int x, int y, int width, int height, int pitch, uint16_t* pixels_ptr)
+{
+    uint16_t* row_ptr = pixels_ptr + ((y * pitch) / 2);
+
+    for(int row = 0; row < height; ++row)
+    {
+        fill_row_8bpp(color_index, x, width, row_ptr);
+        row_ptr += pitch / 2;
+    }
+}
+
+void blit_16bpp(const uint16_t* source_ptr, int source_width, int x, int y, int width, int height, int pitch,
+                uint16_t* pixels_ptr)
+{
+    uint16_t* dest_ptr = pixels_ptr + (y * pitch) + x;
+
+    for(int row = 0; row < height; ++row)
+    {
+        blit_row_16bpp(source_ptr, width, dest_ptr);
+        source_ptr += source_width;
+        dest_ptr += pitch;
+    }
+}
+
+void blit_8bpp(const uint8_t* source_ptr, int source_width, int x, int y, int width, int height, int pitch,
+               uint16_t* pixels_ptr)
+{
+    uint16_t* row_ptr = pixels_ptr + ((y * pitch) / 2);
+
+    for(int row = 0; row < height; ++row)
+    {
+        blit_row_8bpp(source_ptr, x, width, row_ptr);
+        source_ptr += source_width;
+        row_ptr += pitch / 2;
+    }
+}
+
+void scaled_blit_16bpp(const uint16_t* source_ptr, int source_width, int source_height, int x, int y,
+                       int width, int height, int pitch, uint16_t* pixels_ptr)
+{
+    if(! width || ! height)
+    {
+        return;
+    }
+
+    // Nearest neighbor sampling with 16.16 fixed point steps:
+    unsigned x_step = (unsigned(source_width) << 16) / unsigned(width);
+    unsigned y_step = (unsigned(source_height) << 16) / unsigned(height);
+    unsigned source_y = 0;
+    uint16_t* dest_ptr = pixels_ptr + (y * pitch) + x;
+
+    for(int row = 0; row < height; ++row)
+    {
+        const uint16_t* source_row_ptr = source_ptr + ((source_y >> 16) * unsigned(source_width));
+        unsigned source_x = 0;
+
+        for(int column = 0; column < width; ++column)
+        {
+            dest_ptr[column] = source_row_ptr[source_x >> 16];
+            source_x += x_step;
+        }
+
+        source_y += y_step;
+        dest_ptr += pitch;
+    }
+}
+
+void scaled_blit_8bpp(const uint8_t* source_ptr, int source_width, int source_height, int x, int y,
+                      int width, int height, int pitch, uint16_t* pixels_ptr)
+{
+    if(! width || ! height)
+    {
+        return;
+    }
+
+    unsigned x_step = (unsigned(source_width) << 16) / unsigned(width);
+    unsigned y_step = (unsigned(source_height) << 16) / unsigned(height);
+    unsigned source_y = 0;
+    uint16_t* row_ptr = pixels_ptr + ((y * pitch) / 2);
+
+    for(int row = 0; row < height; ++row)
+    {
+        const uint8_t* source_row_ptr = source_ptr + ((source_y >> 16) * unsigned(source_width));
+        uint16_t* dest_ptr = row_ptr + (x / 2);
+        unsigned source_x = 0;
+        int count = width;
+
+        if(x % 2)
+        {
+            *dest_ptr = uint16_t(set_high_pixel(*dest_ptr, source_row_ptr[source_x >> 16]));
+            source_x += x_step;
+            ++dest_ptr;
+            --count;
+        }
+
+        for(int index = 0, limit = count / 2; index < limit; ++index)
+        {
+            unsigned low_pixel = source_row_ptr[source_x >> 16];
+            source_x += x_step;
+
+            unsigned high_pixel = source_row_ptr[source_x >> 16];
+            source_x += x_step;
+
+            dest_ptr[index] = uint16_t(low_pixel | (high_pixel << 8));
+        }
+
+        if(count % 2)
+        {
+            dest_ptr += count / 2;
+            *dest_ptr = uint16_t(set_low_pixel(*dest_ptr, source_row_ptr[source_x >> 16]));
+        }
+
+        source_y += y_step;
+        row_ptr += pitch / 2;
+    }
+}
+
+}
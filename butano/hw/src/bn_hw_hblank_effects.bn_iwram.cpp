@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../include/bn_hw_hblank_effects.h"
+
+namespace bn::hw::hblank_effects
+{
+
+state data;
+
+namespace
+{
+    void _start_dma(const dma_entry& entry)
+    {
+        int channel = entry.channel;
+
+        // H-Blank DMA transfers don't restart their source address and they are not triggered in V-Blank,
+        // so the first value is written here and each transfer writes the value of the next screen line:
+        if(entry.uint32)
+        {
+            auto src = reinterpret_cast<const uint32_t*>(entry.src);
+            REG_DMA[channel].cnt = 0;
+            *reinterpret_cast<volatile uint32_t*>(entry.dest) = src[0];
+            DMA_TRANSFER(entry.dest, src + 1, 1, channel, DMA_HDMA | DMA_32);
+        }
+        else
+        {
+            const uint16_t* src = entry.src;
+            REG_DMA[channel].cnt = 0;
+            *reinterpret_cast<volatile uint16_t*>(entry.dest) = src[0];
+            DMA_TRANSFER(entry.dest, src + 1, 1, channel, DMA_HDMA | DMA_16);
+        }
+    }
+}
+
+void _hblank_intr()
+{
+    // The H-Blank interrupt of the last V-Blank line writes the values of the first screen line:
+    int line = REG_VCOUNT;
+    line = line > 226 ? 0 : line + 1;
+
+    const uint8_t* line_ptr = data.next_line;
+
+    if(line != *line_ptr)
+    {
+        return;
+    }
+
+    const entries& entries_ref = *data.entries_ptr;
+
+    if(! line)
+    {
+        for(int index = 0, limit = entries_ref.dma_entries_count; index < limit; ++index)
+        {
+            _start_dma(entries_ref.dma_entries[index]);
+        }
+    }
+
+    for(int index = 0, limit = entries_ref.uint16_entries_count; index < limit; ++index)
+    {
+        const uint16_entry& entry = entries_ref.uint16_entries[index];
+        *entry.dest = entry.src[line];
+    }
+
+    for(int index = 0, limit = entries_ref.uint32_entries_count; index < limit; ++index)
+    {
+        const uint32_entry& entry = entries_ref.uint32_entries[index];
+        *entry.dest = entry.src[line];
+    }
+
+    ++line_ptr;
+
+    if(line_ptr == data.last_line)
+    {
+        line_ptr = data.first_line;
+    }
+
+    data.next_line = line_ptr;
+
+    if(vcount_gating())
+    {
+        int next_line = *line_ptr;
+
+        // If the next line doesn't follow this one, the H-Blank interrupt is raised again from a V-Count interrupt:
+        if(next_line != line + 1)
+        {
+            REG_DISPSTAT = uint16_t((REG_DISPSTAT & ~(DSTAT_HBL_IRQ | DSTAT_VCT_MASK)) |
+                                    DSTAT_VCT(vcount_target(next_line)));
+        }
+    }
+}
+
+void _vcount_intr()
+{
+    // V-Count interrupt is raised at the start of the target line, before its H-Blank period:
+    REG_DISPSTAT = uint16_t(REG_DISPSTAT | DSTAT_HBL_IRQ);
+}
+
+int build_lines(const entries& entries_ref, uint8_t* lines_ptr)
+{
+    const uint16_entry* uint16_entries = entries_ref.uint16_entries;
+    const uint32_entry* uint32_entries = entries_ref.uint32_entries;
+    int uint16_entries_count = entries_ref.uint16_entries_count;
+    int uint32_entries_count = entries_ref.uint32_entries_count;
+    int lines_count = 1;
+    lines_ptr[0] = 0;
+
+    for(int line = 1; line < display::height(); ++line)
+    {
+        bool changed = false;
+
+        for(int index = 0; index < uint16_entries_count; ++index)
+        {
+            const uint16_t* src = uint16_entries[index].src;
+
+            if(src[line] != src[line - 1])
+            {
+                changed = true;
+                break;
+            }
+        }
+
+        if(! changed)
+        {
+            for(int index = 0; index < uint32_entries_count; ++index)
+            {
+                const uint32_t* src = uint32_entries[index].src;
+
+                if(src[line] != src[line - 1])
+                {
+                    changed = true;
+                    break;
+                }
+            }
+        }
+
+        if(changed)
+        {
+            lines_ptr[lines_count] = uint8_t(line);
+            ++lines_count;
+        }
+    }
+
+    return lines_count;
+}
+
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../include/bn_hw_palettes.h"
+
+namespace bn::hw::palettes
+{
+
+void apply_effects_lut(const effects_lut& lut, int count, color* colors_ptr)
+{
+    auto data_ptr = reinterpret_cast<uint16_t*>(colors_ptr);
+    const uint8_t* red_lut = lut.channels[0];
+    const uint8_t* green_lut = lut.channels[1];
+    const uint8_t* blue_lut = lut.channels[2];
+
+    if(int grayscale_intensity = lut.grayscale_intensity)
+    {
+        const uint8_t* fade_red_lut = lut.fade_channels[0];
+        const uint8_t* fade_green_lut = lut.fade_channels[1];
+        const uint8_t* fade_blue_lut = lut.fade_channels[2];
+
+        for(int index = 0; index < count; ++index)
+        {
+            unsigned data = data_ptr[index];
+            int red = red_lut[data & 31];
+            int green = green_lut[(data >> 5) & 31];
+            int blue = blue_lut[(data >> 10) & 31];
+
+            // Same weights and rounding as clr_grayscale and clr_blend_fast:
+            int gray = ((red * 0x4C) + (green * 0x96) + (blue * 0x1E) + 0x80) >> 8;
+            red = ((red * 32) + ((gray - red) * grayscale_intensity) + 16) >> 5;
+            green = ((green * 32) + ((gray - green) * grayscale_intensity) + 16) >> 5;
+            blue = ((blue * 32) + ((gray - blue) * grayscale_intensity) + 16) >> 5;
+
+            data_ptr[index] = uint16_t(fade_red_lut[red] | (fade_green_lut[green] << 5) |
+                                       (fade_blue_lut[blue] << 10));
+        }
+    }
+    else
+    {
+        for(int index = 0; index < count; ++index)
+        {
+            unsigned data = data_ptr[index];
+            data_ptr[index] = uint16_t(red_lut[data & 31] | (green_lut[(data >> 5) & 31] << 5) |
+                                       (blue_lut[(data >> 10) & 31] << 10));
+        }
+    }
+}
+
+}
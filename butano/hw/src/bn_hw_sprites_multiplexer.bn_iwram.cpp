@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "../include/bn_hw_sprites_multiplexer.h"
+
+#if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+
+namespace bn::hw::sprites_multiplexer
+{
+
+state data;
+
+void _intr()
+{
+    // V-Count interrupt is raised at the start of the target scanline, so the rewritten OAM entries
+    // must not be displayed in the current and in the next scanline:
+    const line* line_ptr = data.next_line;
+    const line* last_line_ptr = data.last_line;
+    const entry* entry_ptr = data.next_entry;
+    auto oam = reinterpret_cast<volatile uint16_t*>(MEM_OAM);
+
+    do
+    {
+        for(int index = 0, limit = line_ptr->entries_count; index < limit; ++index)
+        {
+            volatile uint16_t* oam_entry = oam + (entry_ptr->oam_index * 4);
+            oam_entry[0] = entry_ptr->attr0;
+            oam_entry[1] = entry_ptr->attr1;
+            oam_entry[2] = entry_ptr->attr2;
+            ++entry_ptr;
+        }
+
+        ++line_ptr;
+    }
+    while(line_ptr != last_line_ptr && line_ptr->vcount <= REG_VCOUNT);
+
+    if(line_ptr != last_line_ptr)
+    {
+        _set_vcount_target(line_ptr->vcount);
+    }
+    else
+    {
+        // VCOUNT never reaches 255, so the interrupt is not raised again until the next commit:
+        _set_vcount_target(255);
+    }
+
+    data.next_line = line_ptr;
+    data.next_entry = entry_ptr;
+}
+
+void restore()
+{
+    const schedule* schedule_ptr = data.committed_schedule;
+
+    if(! schedule_ptr || data.next_line == schedule_ptr->lines)
+    {
+        return;
+    }
+
+    // The last committed frame is displayed again, so the OAM entries of the first band must be restored
+    // and the V-Count interrupts must rewrite them from the first scanline:
+    const entry* entry_ptr = schedule_ptr->restore_entries;
+    const entry* last_entry_ptr = entry_ptr + schedule_ptr->restore_entries_count;
+    auto oam = reinterpret_cast<volatile uint16_t*>(MEM_OAM);
+
+    while(entry_ptr != last_entry_ptr)
+    {
+        volatile uint16_t* oam_entry = oam + (entry_ptr->oam_index * 4);
+        oam_entry[0] = entry_ptr->attr0;
+        oam_entry[1] = entry_ptr->attr1;
+        oam_entry[2] = entry_ptr->attr2;
+        ++entry_ptr;
+    }
+
+    const line* lines = schedule_ptr->lines;
+    data.next_line = lines;
+    data.next_entry = schedule_ptr->entries;
+    _set_vcount_target(lines[0].vcount);
+}
+
+}
+
+#endif
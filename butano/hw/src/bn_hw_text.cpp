@@ -105,7 +105,7 @@ int parse(long value, array<char, 32>& output)
     return size;
 }
 
-int parse(int64_t value, array<char, 32>& output)
+int parse(long long value, array<char, 32>& output)
 {
     char* output_data = output.data();
     int64_t abs_value = abs(value);
@@ -175,7 +175,7 @@ int parse(unsigned long value, array<char, 32>& output)
     return size;
 }
 
-int parse(uint64_t value, array<char, 32>& output)
+int parse(unsigned long long value, array<char, 32>& output)
 {
     char* output_data = output.data();
     int size;
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_ASYNC_LOADS_H
+#define BN_ASYNC_LOADS_H
+
+/**
+ * @file
+ * bn::async_loads header file.
+ *
+ * @ingroup tile
+ */
+
+#include "bn_common.h"
+
+/**
+ * @brief Asynchronous tiles loads related functions.
+ *
+ * @ingroup tile
+ */
+namespace bn::async_loads
+{
+    /**
+     * @brief Returns the number of active asynchronous tiles loads.
+     */
+    [[nodiscard]] int used_count();
+
+    /**
+     * @brief Returns the number of available asynchronous tiles loads that can be created.
+     */
+    [[nodiscard]] int available_count();
+
+    /**
+     * @brief Returns the maximum number of timer ticks that can be spent uncompressing data in each frame.
+     *
+     * One timer tick is equivalent to 64 CPU clock cycles.
+     */
+    [[nodiscard]] int max_ticks_per_frame();
+
+    /**
+     * @brief Sets the maximum number of timer ticks that can be spent uncompressing data in each frame.
+     *
+     * One timer tick is equivalent to 64 CPU clock cycles.
+     *
+     * A few bytes are uncompressed in each frame even if it is 0, so pending loads are always completed.
+     */
+    void set_max_ticks_per_frame(int max_ticks_per_frame);
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_AUDIO_BACKEND_H
+#define BN_AUDIO_BACKEND_H
+
+/**
+ * @file
+ * Available audio backends header file.
+ *
+ * @ingroup audio
+ */
+
+#include "bn_common.h"
+
+/**
+ * @def BN_AUDIO_BACKEND_MAXMOD
+ *
+ * Maxmod (https://maxmod.devkitpro.org) audio backend.
+ *
+ * It plays music and sound effects through a mono output.
+ *
+ * @ingroup audio
+ */
+#define BN_AUDIO_BACKEND_MAXMOD    0
+
+/**
+ * @def BN_AUDIO_BACKEND_NATIVE
+ *
+ * Butano software mixer audio backend.
+ *
+ * It only plays sound effects (8 bits PCM and IMA ADPCM samples) through a stereo output,
+ * using DMA channels 1 and 2.
+ *
+ * Set `AUDIOBACKEND := native` in the project's Makefile to select it.
+ *
+ * @ingroup audio
+ */
+#define BN_AUDIO_BACKEND_NATIVE    1
+
+#endif
@@ -43,6 +43,29 @@ namespace bn::bg_maps
      */
     [[nodiscard]] int available_blocks_count();
 
+    /**
+     * @brief Returns the number of background map cells of the largest block of contiguous available background VRAM.
+     */
+    [[nodiscard]] int largest_available_cells_count();
+
+    /**
+     * @brief Returns the size in background map cell blocks of the largest block
+     * of contiguous available background VRAM.
+     */
+    [[nodiscard]] int largest_available_blocks_count();
+
+    /**
+     * @brief Moves all used background tiles and maps to the beginning of background VRAM.
+     *
+     * See bg_tiles::defragment.
+     */
+    void defragment();
+
+    /**
+     * @brief Indicates if background tiles and maps are being moved by defragment or not.
+     */
+    [[nodiscard]] bool defragmenting();
+
     #if BN_CFG_LOG_ENABLED || BN_DOXYGEN
         /**
          * @brief Logs the current status of the background blocks manager.
@@ -46,6 +46,38 @@ namespace bn::bg_tiles
      */
     [[nodiscard]] int available_blocks_count();
 
+    /**
+     * @brief Returns the number of background tiles of the largest block of contiguous available background VRAM.
+     *
+     * A bg_tiles_ptr with more tiles than this can't be created until defragment is called.
+     */
+    [[nodiscard]] int largest_available_tiles_count();
+
+    /**
+     * @brief Returns the size in background memory blocks (2KB) of the largest block
+     * of contiguous available background VRAM.
+     */
+    [[nodiscard]] int largest_available_blocks_count();
+
+    /**
+     * @brief Moves all used background tiles and maps to the beginning of background VRAM,
+     * so available background VRAM is merged in as few blocks as possible.
+     *
+     * Tiles and maps are moved over several frames (see @ref BN_CFG_BG_BLOCKS_DEFRAGMENT_MAX_BLOCKS)
+     * in core::update calls, and backgrounds are updated to reference them in the same frame they are moved.
+     *
+     * While defragmenting returns `true`, the memory returned by the vram methods of background tiles and maps
+     * must be retrieved again after each core::update call.
+     *
+     * H-Blank effects which reference background tiles or maps must be reloaded after it finishes.
+     */
+    void defragment();
+
+    /**
+     * @brief Indicates if background tiles and maps are being moved by defragment or not.
+     */
+    [[nodiscard]] bool defragmenting();
+
     #if BN_CFG_LOG_ENABLED || BN_DOXYGEN
         /**
          * @brief Logs the current status of the background blocks manager.
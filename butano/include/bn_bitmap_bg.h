@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_BITMAP_BG_H
+#define BN_BITMAP_BG_H
+
+/**
+ * @file
+ * bn::bitmap_bg header file.
+ *
+ * @ingroup bitmap_bg
+ */
+
+#include "bn_size.h"
+#include "bn_span.h"
+#include "bn_color.h"
+#include "bn_vector.h"
+#include "bn_optional.h"
+#include "bn_bitmap_bg_mode.h"
+#include "bn_bg_palette_ptr.h"
+#include "bn_sprite_tiles_ptr.h"
+
+namespace bn
+{
+
+class bg_palette_item;
+
+/**
+ * @brief Displays a framebuffer with one of the GBA bitmap modes.
+ *
+ * Bitmap modes replace tiled backgrounds, so regular and affine backgrounds must not be created
+ * while a bitmap_bg is alive. Also, since the framebuffer overlaps with the first half of sprite tiles VRAM,
+ * it is reserved by the bitmap_bg.
+ *
+ * Pixels are drawn in a back buffer and the frame is presented with present() in the next bn::core::update call:
+ * * In modes 4 and 5, the back buffer is the hidden VRAM page or an EWRAM buffer which is copied to it,
+ * and pages are flipped in V-Blank.
+ * * In mode 3 there's only one VRAM page, so pixels are drawn directly on the screen or in an EWRAM buffer
+ * which is copied to VRAM in V-Blank.
+ *
+ * Only one bitmap_bg can be alive at the same time,
+ * and since released sprite tiles are not available until the next bn::core::update call,
+ * it must be called before creating a new bitmap_bg.
+ *
+ * @ingroup bitmap_bg
+ */
+class bitmap_bg
+{
+
+public:
+    /**
+     * @brief Constructor for modes with direct colors (3 and 5).
+     * @param mode Bitmap display mode.
+     * @param ewram_back_buffer Indicates if pixels must be drawn in an EWRAM buffer instead of in VRAM.
+     */
+    explicit bitmap_bg(bitmap_bg_mode mode, bool ewram_back_buffer = false);
+
+    /**
+     * @brief Constructor for mode 4 (palette indexes).
+     * @param palette_item It creates the color palette of the bitmap background.
+     * @param ewram_back_buffer Indicates if pixels must be drawn in an EWRAM buffer instead of in VRAM.
+     */
+    explicit bitmap_bg(const bg_palette_item& palette_item, bool ewram_back_buffer = false);
+
+    bitmap_bg(const bitmap_bg& other) = delete;
+
+    bitmap_bg& operator=(const bitmap_bg& other) = delete;
+
+    /**
+     * @brief Destructor.
+     */
+    ~bitmap_bg();
+
+    /**
+     * @brief Returns the bitmap display mode.
+     */
+    [[nodiscard]] bitmap_bg_mode mode() const
+    {
+        return _mode;
+    }
+
+    /**
+     * @brief Returns the size in pixels of the framebuffer.
+     */
+    [[nodiscard]] size dimensions() const
+    {
+        return _mode == bitmap_bg_mode::MODE_5 ? size(160, 128) : size(240, 160);
+    }
+
+    /**
+     * @brief Indicates if pixels are drawn in an EWRAM buffer instead of in VRAM.
+     */
+    [[nodiscard]] bool ewram_back_buffer() const
+    {
+        return _ewram_back_buffer;
+    }
+
+    /**
+     * @brief Returns the color palette of the bitmap background if it's in mode 4.
+     */
+    [[nodiscard]] const optional<bg_palette_ptr>& palette() const
+    {
+        return _palette;
+    }
+
+    /**
+     * @brief Returns the color palette of the bitmap background if it's in mode 4.
+     */
+    [[nodiscard]] optional<bg_palette_ptr>& palette()
+    {
+        return _palette;
+    }
+
+    /**
+     * @brief Returns the pixels of the back buffer, stored in row-major order.
+     *
+     * In mode 4 each half word contains two pixels, and VRAM doesn't support byte writes.
+     *
+     * If present() is called, the back buffer is not changed until the next bn::core::update call.
+     */
+    [[nodiscard]] uint16_t* back_buffer();
+
+    /**
+     * @brief Fills the back buffer with the given color (modes 3 and 5).
+     */
+    void clear(color color);
+
+    /**
+     * @brief Fills the back buffer with the given palette index (mode 4).
+     */
+    void clear(int color_index);
+
+    /**
+     * @brief Sets the color of the given pixel of the back buffer (modes 3 and 5).
+     */
+    void plot(int x, int y, color color);
+
+    /**
+     * @brief Sets the palette index of the given pixel of the back buffer (mode 4).
+     */
+    void plot(int x, int y, int color_index);
+
+    /**
+     * @brief Draws a horizontal line in the back buffer (modes 3 and 5).
+     * @param x Horizontal position of the leftmost pixel of the line.
+     * @param y Vertical position of the line.
+     * @param width Line width in pixels.
+     * @param color Line color.
+     */
+    void draw_hline(int x, int y, int width, color color);
+
+    /**
+     * @brief Draws a horizontal line in the back buffer (mode 4).
+     * @param x Horizontal position of the leftmost pixel of the line.
+     * @param y Vertical position of the line.
+     * @param width Line width in pixels.
+     * @param color_index Line palette index.
+     */
+    void draw_hline(int x, int y, int width, int color_index);
+
+    /**
+     * @brief Fills a rectangle of the back buffer (modes 3 and 5).
+     * @param x Horizontal position of the top-left corner of the rectangle.
+     * @param y Vertical position of the top-left corner of the rectangle.
+     * @param width Rectangle width in pixels.
+     * @param height Rectangle height in pixels.
+     * @param color Rectangle color.
+     */
+    void fill_rect(int x, int y, int width, int height, color color);
+
+    /**
+     * @brief Fills a rectangle of the back buffer (mode 4).
+     * @param x Horizontal position of the top-left corner of the rectangle.
+     * @param y Vertical position of the top-left corner of the rectangle.
+     * @param width Rectangle width in pixels.
+     * @param height Rectangle height in pixels.
+     * @param color_index Rectangle palette index.
+     */
+    void fill_rect(int x, int y, int width, int height, int color_index);
+
+    /**
+     * @brief Copies an image to the back buffer (modes 3 and 5).
+     * @param x Horizontal position of the top-left corner of the image in the back buffer.
+     * @param y Vertical position of the top-left corner of the image in the back buffer.
+     * @param pixels Image pixels, stored in row-major order.
+     * @param pixels_dimensions Size in pixels of the image.
+     */
+    void blit(int x, int y, const span<const color>& pixels, const size& pixels_dimensions);
+
+    /**
+     * @brief Copies an image to the back buffer (mode 4).
+     * @param x Horizontal position of the top-left corner of the image in the back buffer.
+     * @param y Vertical position of the top-left corner of the image in the back buffer.
+     * @param pixels Image palette indexes, stored in row-major order.
+     * @param pixels_dimensions Size in pixels of the image.
+     */
+    void blit(int x, int y, const span<const uint8_t>& pixels, const size& pixels_dimensions);
+
+    /**
+     * @brief Copies an image to the back buffer, scaling it with nearest neighbor sampling (modes 3 and 5).
+     * @param x Horizontal position of the top-left corner of the scaled image in the back buffer.
+     * @param y Vertical position of the top-left corner of the scaled image in the back buffer.
+     * @param dimensions Size in pixels of the scaled image.
+     * @param pixels Image pixels, stored in row-major order.
+     * @param pixels_dimensions Size in pixels of the image.
+     */
+    void scaled_blit(int x, int y, const size& dimensions, const span<const color>& pixels,
+                     const size& pixels_dimensions);
+
+    /**
+     * @brief Copies an image to the back buffer, scaling it with nearest neighbor sampling (mode 4).
+     * @param x Horizontal position of the top-left corner of the scaled image in the back buffer.
+     * @param y Vertical position of the top-left corner of the scaled image in the back buffer.
+     * @param dimensions Size in pixels of the scaled image.
+     * @param pixels Image palette indexes, stored in row-major order.
+     * @param pixels_dimensions Size in pixels of the image.
+     */
+    void scaled_blit(int x, int y, const size& dimensions, const span<const uint8_t>& pixels,
+                     const size& pixels_dimensions);
+
+    /**
+     * @brief Presents the back buffer in the next bn::core::update call.
+     *
+     * It does nothing in mode 3 without an EWRAM buffer, since pixels are drawn directly on the screen.
+     */
+    void present();
+
+private:
+    optional<bg_palette_ptr> _palette;
+    vector<sprite_tiles_ptr, 4> _reserved_sprite_tiles;
+    bitmap_bg_mode _mode;
+    bool _ewram_back_buffer;
+
+    [[nodiscard]] bool _direct_colors() const
+    {
+        return _mode != bitmap_bg_mode::MODE_4;
+    }
+
+    void _check_rect(int x, int y, int width, int height) const;
+};
+
+}
+
+#endif
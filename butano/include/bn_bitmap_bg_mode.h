@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_BITMAP_BG_MODE_H
+#define BN_BITMAP_BG_MODE_H
+
+/**
+ * @file
+ * bn::bitmap_bg_mode header file.
+ *
+ * @ingroup bitmap_bg
+ */
+
+#include "bn_common.h"
+
+namespace bn
+{
+
+/**
+ * @brief Specifies the available bitmap display modes.
+ *
+ * @ingroup bitmap_bg
+ */
+enum class bitmap_bg_mode : uint8_t
+{
+    MODE_3 = 3, //!< 240x160 pixels with 16 bits per pixel (direct colors), one page.
+    MODE_4 = 4, //!< 240x160 pixels with 8 bits per pixel (palette indexes), two pages.
+    MODE_5 = 5 //!< 160x128 pixels with 16 bits per pixel (direct colors), two pages.
+};
+
+}
+
+#endif
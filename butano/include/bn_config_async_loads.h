@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_CONFIG_ASYNC_LOADS_H
+#define BN_CONFIG_ASYNC_LOADS_H
+
+/**
+ * @file
+ * Asynchronous tiles loads configuration header file.
+ *
+ * @ingroup tile
+ */
+
+#include "bn_common.h"
+
+/**
+ * @def BN_CFG_ASYNC_LOADS_MAX_ITEMS
+ *
+ * Specifies the maximum number of asynchronous tiles loads that can be active at the same time.
+ *
+ * @ingroup tile
+ */
+#ifndef BN_CFG_ASYNC_LOADS_MAX_ITEMS
+    #define BN_CFG_ASYNC_LOADS_MAX_ITEMS 4
+#endif
+
+/**
+ * @def BN_CFG_ASYNC_LOADS_MAX_TICKS_PER_FRAME
+ *
+ * Specifies the default maximum number of timer ticks that can be spent uncompressing data in each frame.
+ *
+ * One timer tick is equivalent to 64 CPU clock cycles.
+ *
+ * A few bytes are uncompressed in each frame even if it is 0, so pending loads are always completed.
+ *
+ * @ingroup tile
+ */
+#ifndef BN_CFG_ASYNC_LOADS_MAX_TICKS_PER_FRAME
+    #define BN_CFG_ASYNC_LOADS_MAX_TICKS_PER_FRAME 512
+#endif
+
+#endif
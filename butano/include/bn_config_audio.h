@@ -13,8 +13,25 @@
  * @ingroup audio
  */
 
+#include "bn_audio_backend.h"
 #include "bn_audio_mixing_rate.h"
 
+/**
+ * @def BN_CFG_AUDIO_BACKEND
+ *
+ * Specifies the library used to mix and play audio.
+ *
+ * Values not specified in BN_AUDIO_BACKEND_* macros are not allowed.
+ *
+ * It is defined by the `AUDIOBACKEND` variable of the project's Makefile,
+ * since audio files are imported in a different format by each backend.
+ *
+ * @ingroup audio
+ */
+#ifndef BN_CFG_AUDIO_BACKEND
+    #define BN_CFG_AUDIO_BACKEND BN_AUDIO_BACKEND_MAXMOD
+#endif
+
 /**
  * @def BN_CFG_AUDIO_MIXING_RATE
  *
@@ -22,6 +39,10 @@
  *
  * Values not specified in BN_AUDIO_MIXING_RATE_* macros are not allowed.
  *
+ * With the native backend, it also specifies the size of the output buffers mixed each frame:
+ * from 132 samples per channel (7884Hz) with @ref BN_AUDIO_MIXING_RATE_8_KHZ
+ * to 528 samples per channel (31536Hz) with @ref BN_AUDIO_MIXING_RATE_31_KHZ.
+ *
  * @ingroup audio
  */
 #ifndef BN_CFG_AUDIO_MIXING_RATE
@@ -44,6 +65,8 @@
  *
  * Specifies the maximum number of active sound effects.
  *
+ * With the native backend, it also specifies the number of mixer channels, up to 16.
+ *
  * @ingroup sound
  */
 #ifndef BN_CFG_AUDIO_MAX_SOUND_CHANNELS
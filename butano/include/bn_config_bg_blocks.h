@@ -26,6 +26,20 @@
     #define BN_CFG_BG_BLOCKS_MAX_ITEMS 16
 #endif
 
+/**
+ * @def BN_CFG_BG_BLOCKS_DEFRAGMENT_MAX_BLOCKS
+ *
+ * Specifies the maximum number of background memory blocks moved in each frame by bn::bg_tiles::defragment
+ * and bn::bg_maps::defragment.
+ *
+ * Items bigger than this are moved in one frame anyway.
+ *
+ * @ingroup bg
+ */
+#ifndef BN_CFG_BG_BLOCKS_DEFRAGMENT_MAX_BLOCKS
+    #define BN_CFG_BG_BLOCKS_DEFRAGMENT_MAX_BLOCKS 8
+#endif
+
 /**
  * @def BN_CFG_BG_BLOCKS_LOG_ENABLED
  *
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_CONFIG_CORE_H
+#define BN_CONFIG_CORE_H
+
+/**
+ * @file
+ * Core configuration header file.
+ *
+ * @ingroup core
+ */
+
+#include "bn_common.h"
+
+/**
+ * @def BN_CFG_CORE_MAX_FRAME_BREAKDOWNS
+ *
+ * Specifies the maximum number of frame breakdowns stored by bn::core::frame_breakdowns.
+ *
+ * @ingroup core
+ */
+#ifndef BN_CFG_CORE_MAX_FRAME_BREAKDOWNS
+    #define BN_CFG_CORE_MAX_FRAME_BREAKDOWNS 8
+#endif
+
+#endif
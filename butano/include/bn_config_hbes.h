@@ -29,4 +29,22 @@
     #define BN_CFG_HBES_MAX_ITEMS 8
 #endif
 
+/**
+ * @def BN_CFG_HBES_DMA_ENABLED
+ *
+ * Specifies if H-Blank effects can be committed with H-Blank DMA transfers instead of with the H-Blank interrupt.
+ *
+ * If it's enabled, DMA channel 2 is used by the first visible H-Blank effect,
+ * and DMA channel 3 is used by the second one if low priority bn::hdma is not running.
+ *
+ * DMA channel 2 is not used if @ref BN_CFG_AUDIO_BACKEND is @ref BN_AUDIO_BACKEND_NATIVE.
+ *
+ * It's disabled by default, since these DMA channels can be used by user code outside of bn::hdma.
+ *
+ * @ingroup hblank_effect
+ */
+#ifndef BN_CFG_HBES_DMA_ENABLED
+    #define BN_CFG_HBES_DMA_ENABLED false
+#endif
+
 #endif
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_CONFIG_PALETTES_H
+#define BN_CONFIG_PALETTES_H
+
+/**
+ * @file
+ * Color palettes configuration header file.
+ *
+ * @ingroup palette
+ */
+
+#include "bn_common.h"
+
+/**
+ * @def BN_CFG_PALETTES_MAX_CYCLE_RANGES
+ *
+ * Specifies the maximum number of active bn::palette_cycle_range items for sprite palettes,
+ * and the same number for background palettes.
+ *
+ * @ingroup palette
+ */
+#ifndef BN_CFG_PALETTES_MAX_CYCLE_RANGES
+    #define BN_CFG_PALETTES_MAX_CYCLE_RANGES 8
+#endif
+
+#endif
@@ -23,6 +23,8 @@
  * A sprite item which is outside of the screen or hidden is not committed to the GBA,
  * so there can be more than 128 sprite items.
  *
+ * Per frame data of each sprite item (around 32 bytes) is placed in IWRAM.
+ *
  * @ingroup sprite
  */
 #ifndef BN_CFG_SPRITES_MAX_ITEMS
@@ -34,13 +36,56 @@
  *
  * Specifies the maximum number of used sprite sort layers.
  *
- * Sprites are grouped in layers depending of their background priority and z order,
- * so to reduce memory usage and improve performance, please use as less unique z orders as possible.
+ * Sprites are grouped in layers depending of their background priority and z order.
+ *
+ * Sprites are added to existing layers in constant time, but creating a new layer requires a linear search,
+ * so to improve performance, please use as less unique z orders as possible.
+ *
+ * By default there's one layer available for each sprite, so it can't be exhausted.
+ * It can be reduced to save memory.
  *
  * @ingroup sprite
  */
 #ifndef BN_CFG_SPRITES_MAX_SORT_LAYERS
-    #define BN_CFG_SPRITES_MAX_SORT_LAYERS 16
+    #define BN_CFG_SPRITES_MAX_SORT_LAYERS BN_CFG_SPRITES_MAX_ITEMS
+#endif
+
+/**
+ * @def BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+ *
+ * Specifies if more than 128 sprites can be displayed at the same time
+ * by reusing the OAM entries of sprites which are higher on the screen.
+ *
+ * When more than 128 sprites are on screen, the topmost ones are committed in V-Blank as usual,
+ * and the rest are written in V-Count interrupts over the OAM entries of sprites which are no longer displayed.
+ *
+ * If a frame is not committed in time (lag frame), the OAM entries rewritten in the last frame
+ * are restored in V-Blank, so the last frame is displayed again.
+ *
+ * While multiplexing is active:
+ * * Sorting between sprites with the same BG priority is not guaranteed.
+ * * Sprites which don't fit in any OAM entry are not displayed (see bn::sprites::multiplexing_dropped_items_count).
+ * * H-Blank effects of sprites which are not committed in V-Blank are ignored.
+ *
+ * @ingroup sprite
+ */
+#ifndef BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+    #define BN_CFG_SPRITES_MULTIPLEXING_ENABLED false
+#endif
+
+/**
+ * @def BN_CFG_SPRITES_MULTIPLEXING_MAX_LINE_WRITES
+ *
+ * Specifies the maximum number of OAM entries that can be written in the V-Count interrupt of each scanline
+ * when sprites multiplexing is active.
+ *
+ * Higher values allow more sprites to start on the same scanline,
+ * but increase the risk of delaying H-Blank effects.
+ *
+ * @ingroup sprite
+ */
+#ifndef BN_CFG_SPRITES_MULTIPLEXING_MAX_LINE_WRITES
+    #define BN_CFG_SPRITES_MULTIPLEXING_MAX_LINE_WRITES 16
 #endif
 
 #endif
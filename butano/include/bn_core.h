@@ -14,11 +14,14 @@
  */
 
 #include "bn_span_fwd.h"
+#include "bn_deque_fwd.h"
 #include "bn_fixed_fwd.h"
+#include "bn_optional_fwd.h"
 
 namespace bn
 {
     class string_view;
+    class frame_breakdown;
 }
 
 namespace bn::keypad
@@ -103,6 +106,60 @@ namespace bn::core
      * before all of GBA display components being updated.
      */
     [[nodiscard]] fixed last_vblank_usage();
+
+    /**
+     * @brief Returns the maximum number of timer ticks that can be spent committing data to the GBA
+     * in each V-Blank before deferring low priority commits to the next frame,
+     * or bn::nullopt if low priority commits are never deferred.
+     *
+     * Sprite tiles, background tiles and maps, big background maps and asynchronous tiles loads
+     * are low priority commits.
+     *
+     * One timer tick is equivalent to 64 CPU clock cycles.
+     */
+    [[nodiscard]] optional<int> vblank_commit_budget();
+
+    /**
+     * @brief Sets the maximum number of timer ticks that can be spent committing data to the GBA
+     * in each V-Blank before deferring low priority commits to the next frame.
+     *
+     * Sprite tiles, background tiles and maps, big background maps and asynchronous tiles loads
+     * are low priority commits.
+     *
+     * Sprites, color palettes and display registers are always committed.
+     *
+     * At least one pending item of each low priority commit is committed in each V-Blank,
+     * even if the budget has been already spent.
+     *
+     * Sprites and backgrounds can display stale tiles and maps in the frames in which their upload is deferred.
+     *
+     * One timer tick is equivalent to 64 CPU clock cycles.
+     */
+    void set_vblank_commit_budget(int ticks);
+
+    /**
+     * @brief Commits all low priority data in each V-Blank, even if it doesn't fit in it.
+     */
+    void remove_vblank_commit_budget();
+
+    /**
+     * @brief Returns the number of bytes of low priority commits deferred to the next frame
+     * in the last elapsed frame.
+     */
+    [[nodiscard]] int last_deferred_commit_bytes();
+
+    /**
+     * @brief Returns the elapsed timer ticks of each stage of the last elapsed frame.
+     */
+    [[nodiscard]] const frame_breakdown& last_frame_breakdown();
+
+    /**
+     * @brief Returns the elapsed timer ticks of each stage of the last elapsed frames,
+     * sorted from the oldest to the newest one.
+     *
+     * The maximum number of stored frames is specified by @ref BN_CFG_CORE_MAX_FRAME_BREAKDOWNS.
+     */
+    [[nodiscard]] const ideque<frame_breakdown>& frame_breakdowns();
 }
 
 #endif
@@ -109,6 +109,14 @@
  * @ingroup bg
  */
 
+/**
+ * @defgroup bitmap_bg Bitmap backgrounds
+ *
+ * Backgrounds which display a framebuffer instead of tiles and maps.
+ *
+ * @ingroup bg
+ */
+
 /**
  * @defgroup sprite Sprites
  *
@@ -1125,6 +1133,10 @@
  *   * `"lz77"`: LZ77 compressed data.
  *   * `"run_length"`: Run-length compressed data.
  *   * `"auto"`: uses the option which gives the smallest data size.
+ * * `"metatile_size"`: optional field which specifies the width and height in map cells of each metatile
+ * (`2` or `4`). If it is specified, the map is stored as a set of unique metatiles
+ * and one metatile index for each metatile of the map, which is much smaller for big maps with repeated blocks.
+ * Maps built from metatiles can't be compressed.
  *
  * If the conversion process has finished successfully,
  * a bn::regular_bg_item should have been generated in the `build` folder.
@@ -1589,6 +1601,59 @@
  * * EWRAM wait states count can be specified with @ref BN_CFG_EWRAM_WAIT_STATE.
  * * bn::fixed_t::floor_integer and bn::fixed_t::ceil_integer added.
  * * bn::type_id marked as `constexpr`.
+ * * Elapsed ticks of each engine stage of the last frames can be retrieved with bn::core::last_frame_breakdown
+ * and bn::core::frame_breakdowns.
+ * * Low priority commits can be deferred to the next frame with bn::core::set_vblank_commit_budget.
+ * * Compressed tiles can be loaded over several frames with bn::sprite_tiles_async_load_ptr
+ * and bn::regular_bg_tiles_async_load_ptr.
+ * * Headless host (x86-64 Linux) backend added: projects built with `make BNHOST=1` run without video
+ * or audio output, so they can be profiled with host tools.
+ * * Sprites are added to existing sort layers in constant time.
+ * * @ref BN_CFG_SPRITES_MAX_SORT_LAYERS default value is now @ref BN_CFG_SPRITES_MAX_ITEMS.
+ * * bn::unordered_map and bn::unordered_set erase bug fixed: some colliding elements could not be found after it.
+ * * Only modified blocks of 8 sprites are uploaded to OAM.
+ * * More than 128 sprites can be displayed at the same time with sprites multiplexing
+ * (see @ref BN_CFG_SPRITES_MULTIPLEXING_ENABLED).
+ * * Sprites per frame data is stored in contiguous IWRAM arrays to speed up cameras and on screen checks.
+ * * bn::sprite_batch added: it displays a group of sprites which share the same tiles and palette,
+ * updating all of their positions at once.
+ * * Available sprite tiles are found in segregated size lists instead of a sorted vector.
+ * * Sprite tiles VRAM can be defragmented with bn::sprite_tiles::defragment.
+ * * bn::sprite_tiles::largest_available_tiles_count added.
+ * * Background VRAM can be defragmented over several frames with bn::bg_tiles::defragment and bn::bg_maps::defragment
+ * (see @ref BN_CFG_BG_BLOCKS_DEFRAGMENT_MAX_BLOCKS).
+ * * bn::bg_tiles::largest_available_tiles_count and bn::bg_maps::largest_available_cells_count added.
+ * * Regular background maps can be built from 2x2 or 4x4 metatiles (see bn::regular_bg_map_item::metatile_size
+ * and the `"metatile_size"` field in @ref import_regular_bg).
+ * Big maps built from metatiles are expanded on the fly while they are scrolled.
+ * * bn::regular_bg_world added: it displays chunked worlds (bn::regular_bg_world_item)
+ * bigger than what a bn::regular_bg_map_item can describe.
+ * * bn::regular_bg_world dynamic tiles added: only the tiles referenced by the visible map cells are kept in VRAM,
+ * so worlds can reference several bn::regular_bg_tiles_item objects.
+ * * Big maps columns and rows are copied with IWRAM ARM code.
+ * * bn::bitmap_bg added: it displays a framebuffer with bitmap modes 3, 4 and 5,
+ * with page flipping and optional EWRAM back buffers.
+ * * Only the updated 16 colors palette banks are committed to palette RAM.
+ * * Global palette effects are applied in one pass with IWRAM ARM code and lookup tables
+ * which are only rebuilt when effects parameters change.
+ * * bn::palette_cycle added: it cycles several color ranges of a palette, each one with its own period and direction.
+ * * H-Blank effects only raise the H-Blank interrupt in the screen lines in which a value changes
+ * (if sprites multiplexing is disabled).
+ * * The first two visible H-Blank effects can be committed with H-Blank DMA transfers
+ * instead of with the H-Blank interrupt (it must be enabled with @ref BN_CFG_HBES_DMA_ENABLED).
+ * * Regular background position H-Blank effects can generate their values with IWRAM ARM code
+ * from a sine wave (bn::hbe_wave) or from parallax bands (bn::hbe_parallax_band).
+ * * bn::hdma_ptr added: it allocates low priority HDMA channels not used by bn::hdma.
+ * H-Blank effects only use the HDMA channels which are not allocated nor running.
+ * * HDMA supports 32 bits transfers.
+ * * bn::mode_7_bg added: it displays an affine background in perspective from a bn::mode_7_camera,
+ * computing all affine registers of each screen line in one pass and copying them with a single HDMA channel.
+ * * bn::mode_7_camera::project places billboard sprites on the plane displayed by a bn::mode_7_bg.
+ * * HDMA values of the first screen line are not overwritten by display, backgrounds and palettes commits.
+ * * Native audio backend added (`AUDIOBACKEND := native`): a stereo software mixer with IWRAM ARM code
+ * which plays 8 bits PCM and IMA ADPCM sound effects with per channel volume, speed and panning.
+ * * Audio mixing time is reported by the profiler and by bn::frame_breakdown.
+ * * Sprite palette color H-Blank effects reload the sprite palette instead of a BG palette when they are destroyed.
  *
  *
  * @section changelog_6_12_0 6.12.0
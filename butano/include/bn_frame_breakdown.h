@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_FRAME_BREAKDOWN_H
+#define BN_FRAME_BREAKDOWN_H
+
+/**
+ * @file
+ * bn::frame_breakdown header file.
+ *
+ * @ingroup core
+ */
+
+#include "bn_array.h"
+#include "bn_assert.h"
+#include "bn_frame_stage.h"
+
+namespace bn
+{
+
+/**
+ * @brief Stores the elapsed timer ticks of each stage of a bn::core::update call.
+ *
+ * One timer tick is equivalent to 64 CPU clock cycles.
+ *
+ * @ingroup core
+ */
+class frame_breakdown
+{
+
+public:
+    /**
+     * @brief Returns the number of stages measured by a frame breakdown.
+     */
+    [[nodiscard]] constexpr static int stages_count()
+    {
+        return int(frame_stage::KEYPAD_UPDATE) + 1;
+    }
+
+    /**
+     * @brief Returns the first stage executed after waiting for the next V-Blank.
+     */
+    [[nodiscard]] constexpr static frame_stage first_commit_stage()
+    {
+        return frame_stage::HBLANK_EFFECTS_COMMIT;
+    }
+
+    /**
+     * @brief Returns the elapsed timer ticks of the given stage.
+     */
+    [[nodiscard]] constexpr int ticks(frame_stage stage) const
+    {
+        int stage_index = int(stage);
+        BN_ASSERT(stage_index >= 0 && stage_index < stages_count(), "Invalid stage: ", stage_index);
+
+        return _ticks[stage_index];
+    }
+
+    /**
+     * @brief Sets the elapsed timer ticks of the given stage.
+     */
+    constexpr void set_ticks(frame_stage stage, int ticks)
+    {
+        int stage_index = int(stage);
+        BN_ASSERT(stage_index >= 0 && stage_index < stages_count(), "Invalid stage: ", stage_index);
+        BN_ASSERT(ticks >= 0, "Invalid ticks: ", ticks);
+
+        _ticks[stage_index] = ticks;
+    }
+
+    /**
+     * @brief Returns the elapsed timer ticks of all stages executed before waiting for the next V-Blank.
+     */
+    [[nodiscard]] constexpr int update_ticks() const
+    {
+        return _sum_ticks(0, int(first_commit_stage()));
+    }
+
+    /**
+     * @brief Returns the elapsed timer ticks of all stages executed after waiting for the next V-Blank.
+     */
+    [[nodiscard]] constexpr int commit_ticks() const
+    {
+        return _sum_ticks(int(first_commit_stage()), stages_count());
+    }
+
+    /**
+     * @brief Returns the elapsed timer ticks of all stages.
+     */
+    [[nodiscard]] constexpr int total_ticks() const
+    {
+        return _sum_ticks(0, stages_count());
+    }
+
+    /**
+     * @brief Returns the commit stage which took more timer ticks.
+     */
+    [[nodiscard]] constexpr frame_stage slowest_commit_stage() const
+    {
+        int result = int(first_commit_stage());
+
+        for(int index = result + 1; index < stages_count(); ++index)
+        {
+            if(_ticks[index] > _ticks[result])
+            {
+                result = index;
+            }
+        }
+
+        return frame_stage(result);
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const frame_breakdown& a, const frame_breakdown& b) = default;
+
+private:
+    array<int, int(frame_stage::KEYPAD_UPDATE) + 1> _ticks = {};
+
+    [[nodiscard]] constexpr int _sum_ticks(int first_index, int last_index) const
+    {
+        int result = 0;
+
+        for(int index = first_index; index < last_index; ++index)
+        {
+            result += _ticks[index];
+        }
+
+        return result;
+    }
+};
+
+}
+
+#endif
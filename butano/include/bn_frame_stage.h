@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_FRAME_STAGE_H
+#define BN_FRAME_STAGE_H
+
+/**
+ * @file
+ * bn::frame_stage header file.
+ *
+ * @ingroup core
+ */
+
+#include "bn_common.h"
+
+namespace bn
+{
+
+/**
+ * @brief Specifies the stages of a bn::core::update call measured by bn::frame_breakdown.
+ *
+ * Update stages are executed before waiting for the next V-Blank, and commit stages are executed after it.
+ *
+ * @ingroup core
+ */
+enum class frame_stage : uint8_t
+{
+    CAMERAS_UPDATE, //!< Cameras update.
+    SPRITES_UPDATE, //!< Sprites update.
+    SPRITE_TILES_UPDATE, //!< Sprite tiles update.
+    BGS_UPDATE, //!< Backgrounds update.
+    BG_BLOCKS_UPDATE, //!< Background tiles and maps update.
+    PALETTES_UPDATE, //!< Color palettes update.
+    DISPLAY_UPDATE, //!< Display update.
+    HBLANK_EFFECTS_UPDATE, //!< H-Blank effects update.
+    HDMA_UPDATE, //!< H-Blank direct memory access update.
+    ASYNC_LOADS_UPDATE, //!< Asynchronous tiles loads update.
+    HBLANK_EFFECTS_COMMIT, //!< H-Blank effects commit.
+    DISPLAY_COMMIT, //!< Display commit.
+    SPRITES_COMMIT, //!< Sprites commit.
+    BGS_COMMIT, //!< Backgrounds commit.
+    PALETTES_COMMIT, //!< Color palettes commit.
+    SPRITE_TILES_COMMIT, //!< Sprite tiles commit.
+    BIG_MAPS_COMMIT, //!< Big background maps commit.
+    BG_BLOCKS_COMMIT, //!< Background tiles and maps commit.
+    ASYNC_LOADS_COMMIT, //!< Asynchronous tiles loads commit.
+    BITMAP_BG_COMMIT, //!< Bitmap background commit.
+    AUDIO_MIX, //!< Audio software mixing.
+    AUDIO_COMMIT, //!< Audio commit.
+    GPIO_COMMIT, //!< General purpose I/O commit.
+    KEYPAD_UPDATE //!< Keypad update.
+};
+
+}
+
+#endif
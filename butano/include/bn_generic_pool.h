@@ -116,6 +116,7 @@ public:
     [[nodiscard]] Type& create(Args&&... args)
     {
         static_assert(sizeof(Type) <= MaxElementSize);
+        static_assert(alignof(Type) <= alignof(char*), "Type alignment is not supported");
         BN_ASSERT(! full(), "Pool is full");
 
         auto result = reinterpret_cast<Type*>(_allocate());
@@ -259,6 +260,8 @@ public:
     template<typename Type, typename... Args>
     [[nodiscard]] Type& create(Args&&... args)
     {
+        static_assert(alignof(Type) <= alignof(element), "Type alignment is not supported");
+
         auto result = reinterpret_cast<Type*>(base_type::_allocate());
         ::new(result) Type(forward<Args>(args)...);
         return *result;
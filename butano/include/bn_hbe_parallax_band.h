@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_HBE_PARALLAX_BAND_H
+#define BN_HBE_PARALLAX_BAND_H
+
+/**
+ * @file
+ * bn::hbe_parallax_band header file.
+ *
+ * @ingroup hblank_effect
+ */
+
+#include "bn_fixed.h"
+#include "bn_assert.h"
+#include "bn_display.h"
+
+namespace bn
+{
+
+/**
+ * @brief Group of consecutive screen horizontal lines which position is generated by the engine
+ * for a H-Blank effect, instead of reading the values of each screen line from a referenced array.
+ *
+ * The position of each screen horizontal line of the band is the position of the target
+ * (relative to its camera, if it has one) multiplied by the position factor of the band.
+ *
+ * @ingroup hblank_effect
+ */
+class hbe_parallax_band
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param lines Number of screen horizontal lines of the band, in the range [1, display::height()].
+     * @param position_factor Factor to multiply the position of the target in the band lines.
+     */
+    constexpr hbe_parallax_band(int lines, fixed position_factor) :
+        _position_factor(position_factor),
+        _lines(lines)
+    {
+        BN_ASSERT(lines > 0 && lines <= display::height(), "Invalid lines: ", lines);
+    }
+
+    /**
+     * @brief Returns the number of screen horizontal lines of the band.
+     */
+    [[nodiscard]] constexpr int lines() const
+    {
+        return _lines;
+    }
+
+    /**
+     * @brief Sets the number of screen horizontal lines of the band.
+     * @param lines Number of screen horizontal lines in the range [1, display::height()].
+     */
+    constexpr void set_lines(int lines)
+    {
+        BN_ASSERT(lines > 0 && lines <= display::height(), "Invalid lines: ", lines);
+
+        _lines = lines;
+    }
+
+    /**
+     * @brief Returns the factor to multiply the position of the target in the band lines.
+     */
+    [[nodiscard]] constexpr fixed position_factor() const
+    {
+        return _position_factor;
+    }
+
+    /**
+     * @brief Sets the factor to multiply the position of the target in the band lines.
+     */
+    constexpr void set_position_factor(fixed position_factor)
+    {
+        _position_factor = position_factor;
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const hbe_parallax_band& a, const hbe_parallax_band& b) = default;
+
+private:
+    fixed _position_factor;
+    int _lines;
+};
+
+}
+
+#endif
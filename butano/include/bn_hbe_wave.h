@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_HBE_WAVE_H
+#define BN_HBE_WAVE_H
+
+/**
+ * @file
+ * bn::hbe_wave header file.
+ *
+ * @ingroup hblank_effect
+ */
+
+#include "bn_fixed.h"
+#include "bn_assert.h"
+
+namespace bn
+{
+
+/**
+ * @brief Sine wave generated by the engine for a H-Blank effect, instead of reading the values of each screen line
+ * from a referenced array.
+ *
+ * The delta of each screen horizontal line is amplitude * sin(phase + (line * frequency)).
+ *
+ * @ingroup hblank_effect
+ */
+class hbe_wave
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param amplitude Maximum delta in pixels.
+     * @param frequency Angle increment in degrees between each screen horizontal line, in the range [-360, 360].
+     * @param phase_speed Angle increment in degrees of the first screen horizontal line between each frame,
+     * in the range [-360, 360].
+     * @param phase Angle in degrees of the first screen horizontal line, in the range [0, 360).
+     */
+    constexpr hbe_wave(fixed amplitude, fixed frequency, fixed phase_speed, fixed phase = 0) :
+        _amplitude(amplitude),
+        _frequency(frequency),
+        _phase_speed(phase_speed),
+        _phase(phase)
+    {
+        BN_ASSERT(frequency >= -360 && frequency <= 360, "Invalid frequency: ", frequency);
+        BN_ASSERT(phase_speed >= -360 && phase_speed <= 360, "Invalid phase speed: ", phase_speed);
+        BN_ASSERT(phase >= 0 && phase < 360, "Invalid phase: ", phase);
+    }
+
+    /**
+     * @brief Returns the maximum delta in pixels.
+     */
+    [[nodiscard]] constexpr fixed amplitude() const
+    {
+        return _amplitude;
+    }
+
+    /**
+     * @brief Sets the maximum delta in pixels.
+     */
+    constexpr void set_amplitude(fixed amplitude)
+    {
+        _amplitude = amplitude;
+    }
+
+    /**
+     * @brief Returns the angle increment in degrees between each screen horizontal line.
+     */
+    [[nodiscard]] constexpr fixed frequency() const
+    {
+        return _frequency;
+    }
+
+    /**
+     * @brief Sets the angle increment in degrees between each screen horizontal line.
+     * @param frequency Angle increment in degrees in the range [-360, 360].
+     */
+    constexpr void set_frequency(fixed frequency)
+    {
+        BN_ASSERT(frequency >= -360 && frequency <= 360, "Invalid frequency: ", frequency);
+
+        _frequency = frequency;
+    }
+
+    /**
+     * @brief Returns the angle increment in degrees of the first screen horizontal line between each frame.
+     */
+    [[nodiscard]] constexpr fixed phase_speed() const
+    {
+        return _phase_speed;
+    }
+
+    /**
+     * @brief Sets the angle increment in degrees of the first screen horizontal line between each frame.
+     * @param phase_speed Angle increment in degrees in the range [-360, 360].
+     */
+    constexpr void set_phase_speed(fixed phase_speed)
+    {
+        BN_ASSERT(phase_speed >= -360 && phase_speed <= 360, "Invalid phase speed: ", phase_speed);
+
+        _phase_speed = phase_speed;
+    }
+
+    /**
+     * @brief Returns the angle in degrees of the first screen horizontal line.
+     */
+    [[nodiscard]] constexpr fixed phase() const
+    {
+        return _phase;
+    }
+
+    /**
+     * @brief Sets the angle in degrees of the first screen horizontal line.
+     * @param phase Angle in degrees in the range [0, 360).
+     */
+    constexpr void set_phase(fixed phase)
+    {
+        BN_ASSERT(phase >= 0 && phase < 360, "Invalid phase: ", phase);
+
+        _phase = phase;
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const hbe_wave& a, const hbe_wave& b) = default;
+
+private:
+    fixed _amplitude;
+    fixed _frequency;
+    fixed _phase_speed;
+    fixed _phase;
+};
+
+}
+
+#endif
@@ -42,6 +42,21 @@ namespace bn::hdma
      */
     void start(const uint16_t& source_ref, int elements, uint16_t& destination_ref);
 
+    /**
+     * @brief Start copying each frame the given amount of 32 bits elements
+     * from the memory location referenced by source_ref to the memory location referenced by destination_ref.
+     *
+     * The elements are not copied but referenced,
+     * so they should be alive while HDMA is running to avoid dangling references.
+     *
+     * If the elements overlap, the behavior is undefined.
+     *
+     * @param source_ref Const reference to the memory location to copy from.
+     * @param elements Number of elements to copy (not bytes).
+     * @param destination_ref Reference to the memory location to copy to.
+     */
+    void start(const uint32_t& source_ref, int elements, uint32_t& destination_ref);
+
     /**
      * @brief Stops copying elements each frame.
      */
@@ -71,6 +86,23 @@ namespace bn::hdma
      */
     void high_priority_start(const uint16_t& source_ref, int elements, uint16_t& destination_ref);
 
+    /**
+     * @brief Start copying each frame with high priority the given amount of 32 bits elements
+     * from the memory location referenced by source_ref to the memory location referenced by destination_ref.
+     *
+     * The elements are not copied but referenced,
+     * so they should be alive while HDMA is running to avoid dangling references.
+     *
+     * If the elements overlap, the behavior is undefined.
+     *
+     * High priority HDMA can cause issues with audio, so avoid it unless necessary.
+     *
+     * @param source_ref Const reference to the memory location to copy from.
+     * @param elements Number of elements to copy (not bytes).
+     * @param destination_ref Reference to the memory location to copy to.
+     */
+    void high_priority_start(const uint32_t& source_ref, int elements, uint32_t& destination_ref);
+
     /**
      * @brief Stops copying elements each frame with high priority.
      *
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_HDMA_PTR_H
+#define BN_HDMA_PTR_H
+
+/**
+ * @file
+ * bn::hdma_ptr header file.
+ *
+ * @ingroup hdma
+ */
+
+#include "bn_utility.h"
+#include "bn_functional.h"
+#include "bn_optional_fwd.h"
+
+namespace bn
+{
+
+/**
+ * @brief std::shared_ptr like smart pointer that retains shared ownership of a low priority HDMA channel.
+ *
+ * Several hdma_ptr objects may own the same HDMA channel.
+ *
+ * The HDMA channel is stopped and released when the last remaining hdma_ptr owning it is destroyed.
+ *
+ * Two channels can be allocated: DMA channel 2 is allocated first, and DMA channel 3 is only available
+ * if it's not used by bn::hdma::start. Channels not allocated nor used by bn::hdma are used by H-Blank effects.
+ *
+ * DMA channel 2 can't be allocated if @ref BN_CFG_AUDIO_BACKEND is @ref BN_AUDIO_BACKEND_NATIVE,
+ * since it is used by the stereo audio output.
+ *
+ * Each HDMA transfer can copy several consecutive registers (for example, the four affine background
+ * matrix registers, or both windows horizontal boundaries registers) in the H-Blank period of each screen line.
+ *
+ * @ingroup hdma
+ */
+class hdma_ptr
+{
+
+public:
+    /**
+     * @brief Allocates a HDMA channel.
+     * @return The requested hdma_ptr.
+     */
+    [[nodiscard]] static hdma_ptr create();
+
+    /**
+     * @brief Allocates a HDMA channel.
+     * @return The requested hdma_ptr if it could be allocated; bn::nullopt otherwise.
+     */
+    [[nodiscard]] static optional<hdma_ptr> create_optional();
+
+    /**
+     * @brief Copy constructor.
+     * @param other hdma_ptr to copy.
+     */
+    hdma_ptr(const hdma_ptr& other);
+
+    /**
+     * @brief Copy assignment operator.
+     * @param other hdma_ptr to copy.
+     * @return Reference to this.
+     */
+    hdma_ptr& operator=(const hdma_ptr& other);
+
+    /**
+     * @brief Move constructor.
+     * @param other hdma_ptr to move.
+     */
+    hdma_ptr(hdma_ptr&& other) noexcept :
+        _channel(other._channel)
+    {
+        other._channel = -1;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other hdma_ptr to move.
+     * @return Reference to this.
+     */
+    hdma_ptr& operator=(hdma_ptr&& other) noexcept
+    {
+        bn::swap(_channel, other._channel);
+        return *this;
+    }
+
+    /**
+     * @brief Releases the referenced HDMA channel if no more hdma_ptr objects reference to it.
+     */
+    ~hdma_ptr()
+    {
+        if(_channel >= 0)
+        {
+            _destroy();
+        }
+    }
+
+    /**
+     * @brief Returns the DMA channel index of the referenced HDMA channel.
+     */
+    [[nodiscard]] int channel() const
+    {
+        return _channel;
+    }
+
+    /**
+     * @brief Indicates if the referenced HDMA channel is active or not.
+     */
+    [[nodiscard]] bool running() const;
+
+    /**
+     * @brief Start copying each frame the given amount of elements
+     * from the memory location referenced by source_ref to the memory location referenced by destination_ref.
+     *
+     * The elements are not copied but referenced,
+     * so they should be alive while HDMA is running to avoid dangling references.
+     *
+     * If the elements overlap, the behavior is undefined.
+     *
+     * @param source_ref Const reference to the memory location to copy from.
+     * @param elements Number of elements to copy in each screen line (not bytes).
+     * @param destination_ref Reference to the memory location to copy to.
+     */
+    void start(const uint16_t& source_ref, int elements, uint16_t& destination_ref);
+
+    /**
+     * @brief Start copying each frame the given amount of 32 bits elements
+     * from the memory location referenced by source_ref to the memory location referenced by destination_ref.
+     *
+     * The elements are not copied but referenced,
+     * so they should be alive while HDMA is running to avoid dangling references.
+     *
+     * If the elements overlap, the behavior is undefined.
+     *
+     * @param source_ref Const reference to the memory location to copy from.
+     * @param elements Number of elements to copy in each screen line (not bytes).
+     * @param destination_ref Reference to the memory location to copy to.
+     */
+    void start(const uint32_t& source_ref, int elements, uint32_t& destination_ref);
+
+    /**
+     * @brief Stops copying elements each frame.
+     */
+    void stop();
+
+    /**
+     * @brief Exchanges the contents of this hdma_ptr with those of the other one.
+     * @param other hdma_ptr to exchange the contents with.
+     */
+    void swap(hdma_ptr& other)
+    {
+        bn::swap(_channel, other._channel);
+    }
+
+    /**
+     * @brief Exchanges the contents of a hdma_ptr with those of another one.
+     * @param a First hdma_ptr to exchange the contents with.
+     * @param b Second hdma_ptr to exchange the contents with.
+     */
+    friend void swap(hdma_ptr& a, hdma_ptr& b)
+    {
+        bn::swap(a._channel, b._channel);
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] friend bool operator==(const hdma_ptr& a, const hdma_ptr& b) = default;
+
+private:
+    int8_t _channel;
+
+    explicit hdma_ptr(int channel) :
+        _channel(int8_t(channel))
+    {
+    }
+
+    void _destroy();
+};
+
+
+/**
+ * @brief Hash support for hdma_ptr.
+ *
+ * @ingroup hdma
+ * @ingroup functional
+ */
+template<>
+struct hash<hdma_ptr>
+{
+    /**
+     * @brief Returns the hash of the given hdma_ptr.
+     */
+    [[nodiscard]] unsigned operator()(const hdma_ptr& value) const
+    {
+        return make_hash(value.channel());
+    }
+};
+
+}
+
+#endif
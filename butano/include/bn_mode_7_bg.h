@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_MODE_7_BG_H
+#define BN_MODE_7_BG_H
+
+/**
+ * @file
+ * bn::mode_7_bg header file.
+ *
+ * @ingroup affine_bg
+ */
+
+#include "bn_memory.h"
+#include "bn_hdma_ptr.h"
+#include "bn_affine_bg_ptr.h"
+#include "bn_mode_7_camera.h"
+
+namespace bn
+{
+
+/**
+ * @brief Displays the map of an affine background as a plane seen in perspective from a mode_7_camera.
+ *
+ * The affine registers of each screen line (PA, PB, PC, PD, X and Y) are computed in a single pass
+ * and copied in one HDMA burst per screen line, so no H-Blank effects are used.
+ *
+ * It allocates a HDMA channel (see hdma_ptr) and two EWRAM buffers of 2.5KB,
+ * so the values displayed by the HDMA channel are never modified.
+ *
+ * Lines above the horizon reference a position outside of the map,
+ * so nothing is displayed on them if wrapping is disabled.
+ *
+ * Billboard sprites can be placed on the plane with mode_7_camera::project.
+ *
+ * @ingroup affine_bg
+ */
+class mode_7_bg
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param bg Affine background used to display the plane.
+     * @param camera Camera which looks at the plane.
+     */
+    mode_7_bg(affine_bg_ptr bg, const mode_7_camera& camera);
+
+    mode_7_bg(const mode_7_bg& other) = delete;
+
+    mode_7_bg& operator=(const mode_7_bg& other) = delete;
+
+    /**
+     * @brief Returns the affine background used to display the plane.
+     *
+     * Its affine transformation attributes must not be modified.
+     */
+    [[nodiscard]] const affine_bg_ptr& bg() const
+    {
+        return _bg;
+    }
+
+    /**
+     * @brief Returns the affine background used to display the plane.
+     *
+     * Its affine transformation attributes must not be modified.
+     */
+    [[nodiscard]] affine_bg_ptr& bg()
+    {
+        return _bg;
+    }
+
+    /**
+     * @brief Returns the camera which looks at the plane.
+     */
+    [[nodiscard]] const mode_7_camera& camera() const
+    {
+        return _camera;
+    }
+
+    /**
+     * @brief Sets the camera which looks at the plane.
+     *
+     * It is not displayed until update is called.
+     */
+    void set_camera(const mode_7_camera& camera)
+    {
+        _camera = camera;
+        _updated = true;
+    }
+
+    /**
+     * @brief Computes the affine registers of each screen line if the camera or the background have changed.
+     *
+     * It should be called before bn::core::update. If it's called more than once per frame,
+     * the values of the previous calls in the same frame are discarded.
+     */
+    void update();
+
+private:
+    class ewram_deleter
+    {
+
+    public:
+        void operator()(void* ptr) const;
+    };
+
+    unique_ptr<uint32_t, ewram_deleter> _values;
+    affine_bg_ptr _bg;
+    hdma_ptr _hdma;
+    mode_7_camera _camera;
+    int8_t _hw_id = -1;
+    bool _values_index = false;
+    bool _updated = true;
+};
+
+}
+
+#endif
@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_MODE_7_CAMERA_H
+#define BN_MODE_7_CAMERA_H
+
+/**
+ * @file
+ * bn::mode_7_camera header file.
+ *
+ * @ingroup affine_bg
+ */
+
+#include "bn_math.h"
+#include "bn_display.h"
+#include "bn_optional.h"
+#include "bn_mode_7_projection.h"
+
+namespace bn
+{
+
+/**
+ * @brief Camera which looks at the plane displayed by a mode_7_bg.
+ *
+ * The plane is the map of an affine background: x and z coordinates are map pixels
+ * (x from left to right and z from top to bottom), and y is the height above the plane in pixels.
+ *
+ * @ingroup affine_bg
+ */
+class mode_7_camera
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param x Horizontal position of the camera in the map in pixels.
+     * @param y Height of the camera above the plane in pixels (>= 0).
+     * @param z Vertical position of the camera in the map in pixels.
+     * @param yaw Yaw angle in degrees, in the range [0, 360).
+     * With 0 the camera looks at the top of the map, and positive angles rotate it clockwise.
+     * @param pitch Pitch angle in degrees, in the range (-90, 90). Positive angles look down.
+     * @param horizon Screen horizontal line in which the horizon is displayed when the pitch is 0,
+     * in the range [0, display::height()].
+     * @param focal_length Distance in pixels from the camera to the screen (> 0).
+     */
+    constexpr mode_7_camera(fixed x, fixed y, fixed z, fixed yaw = 0, fixed pitch = 0, int horizon = 0,
+                            fixed focal_length = display::height()) :
+        _x(x),
+        _y(y),
+        _z(z),
+        _yaw(yaw),
+        _pitch(pitch),
+        _focal_length(focal_length),
+        _horizon(horizon)
+    {
+        BN_ASSERT(y >= 0, "Invalid y: ", y);
+        BN_ASSERT(yaw >= 0 && yaw < 360, "Yaw must be in the range [0, 360): ", yaw);
+        BN_ASSERT(pitch > -90 && pitch < 90, "Pitch must be in the range (-90, 90): ", pitch);
+        BN_ASSERT(horizon >= 0 && horizon <= display::height(), "Invalid horizon: ", horizon);
+        BN_ASSERT(focal_length > 0, "Invalid focal length: ", focal_length);
+    }
+
+    /**
+     * @brief Returns the horizontal position of the camera in the map in pixels.
+     */
+    [[nodiscard]] constexpr fixed x() const
+    {
+        return _x;
+    }
+
+    /**
+     * @brief Sets the horizontal position of the camera in the map in pixels.
+     */
+    constexpr void set_x(fixed x)
+    {
+        _x = x;
+    }
+
+    /**
+     * @brief Returns the height of the camera above the plane in pixels.
+     */
+    [[nodiscard]] constexpr fixed y() const
+    {
+        return _y;
+    }
+
+    /**
+     * @brief Sets the height of the camera above the plane in pixels.
+     * @param y Height in pixels (>= 0).
+     */
+    constexpr void set_y(fixed y)
+    {
+        BN_ASSERT(y >= 0, "Invalid y: ", y);
+
+        _y = y;
+    }
+
+    /**
+     * @brief Returns the vertical position of the camera in the map in pixels.
+     */
+    [[nodiscard]] constexpr fixed z() const
+    {
+        return _z;
+    }
+
+    /**
+     * @brief Sets the vertical position of the camera in the map in pixels.
+     */
+    constexpr void set_z(fixed z)
+    {
+        _z = z;
+    }
+
+    /**
+     * @brief Returns the yaw angle in degrees.
+     *
+     * With 0 the camera looks at the top of the map, and positive angles rotate it clockwise.
+     */
+    [[nodiscard]] constexpr fixed yaw() const
+    {
+        return _yaw;
+    }
+
+    /**
+     * @brief Sets the yaw angle in degrees.
+     *
+     * With 0 the camera looks at the top of the map, and positive angles rotate it clockwise.
+     *
+     * @param yaw Yaw angle in degrees, in the range [0, 360).
+     */
+    constexpr void set_yaw(fixed yaw)
+    {
+        BN_ASSERT(yaw >= 0 && yaw < 360, "Yaw must be in the range [0, 360): ", yaw);
+
+        _yaw = yaw;
+    }
+
+    /**
+     * @brief Returns the pitch angle in degrees. Positive angles look down.
+     */
+    [[nodiscard]] constexpr fixed pitch() const
+    {
+        return _pitch;
+    }
+
+    /**
+     * @brief Sets the pitch angle in degrees.
+     * @param pitch Pitch angle in degrees, in the range (-90, 90). Positive angles look down.
+     */
+    constexpr void set_pitch(fixed pitch)
+    {
+        BN_ASSERT(pitch > -90 && pitch < 90, "Pitch must be in the range (-90, 90): ", pitch);
+
+        _pitch = pitch;
+    }
+
+    /**
+     * @brief Returns the screen horizontal line in which the horizon is displayed when the pitch is 0.
+     */
+    [[nodiscard]] constexpr int horizon() const
+    {
+        return _horizon;
+    }
+
+    /**
+     * @brief Sets the screen horizontal line in which the horizon is displayed when the pitch is 0.
+     * @param horizon Screen horizontal line in the range [0, display::height()].
+     */
+    constexpr void set_horizon(int horizon)
+    {
+        BN_ASSERT(horizon >= 0 && horizon <= display::height(), "Invalid horizon: ", horizon);
+
+        _horizon = horizon;
+    }
+
+    /**
+     * @brief Returns the distance in pixels from the camera to the screen.
+     */
+    [[nodiscard]] constexpr fixed focal_length() const
+    {
+        return _focal_length;
+    }
+
+    /**
+     * @brief Sets the distance in pixels from the camera to the screen.
+     * @param focal_length Distance in pixels (> 0).
+     */
+    constexpr void set_focal_length(fixed focal_length)
+    {
+        BN_ASSERT(focal_length > 0, "Invalid focal length: ", focal_length);
+
+        _focal_length = focal_length;
+    }
+
+    /**
+     * @brief Returns the sine of the yaw angle.
+     */
+    [[nodiscard]] constexpr fixed yaw_sin() const
+    {
+        return degrees_lut_sin(_yaw);
+    }
+
+    /**
+     * @brief Returns the cosine of the yaw angle.
+     */
+    [[nodiscard]] constexpr fixed yaw_cos() const
+    {
+        return degrees_lut_cos(_yaw);
+    }
+
+    /**
+     * @brief Returns the sine of the pitch angle.
+     */
+    [[nodiscard]] constexpr fixed pitch_sin() const
+    {
+        return _pitch >= 0 ? degrees_lut_sin(_pitch) : -degrees_lut_sin(-_pitch);
+    }
+
+    /**
+     * @brief Returns the cosine of the pitch angle.
+     */
+    [[nodiscard]] constexpr fixed pitch_cos() const
+    {
+        return _pitch >= 0 ? degrees_lut_cos(_pitch) : degrees_lut_cos(-_pitch);
+    }
+
+    /**
+     * @brief Projects a point of the world on the screen.
+     * @param x Horizontal position of the point in the map in pixels.
+     * @param y Height of the point above the plane in pixels.
+     * @param z Vertical position of the point in the map in pixels.
+     * @return Screen position and scale of the given point if it is in front of the camera;
+     * bn::nullopt otherwise.
+     */
+    [[nodiscard]] constexpr optional<mode_7_projection> project(fixed x, fixed y, fixed z) const
+    {
+        fixed yaw_sin_value = yaw_sin();
+        fixed yaw_cos_value = yaw_cos();
+        fixed pitch_sin_value = pitch_sin();
+        fixed pitch_cos_value = pitch_cos();
+        fixed dx = x - _x;
+        fixed dy = y - _y;
+        fixed dz = z - _z;
+        fixed lateral = dx.safe_multiplication(yaw_cos_value) + dz.safe_multiplication(yaw_sin_value);
+        fixed forward = dx.safe_multiplication(yaw_sin_value) - dz.safe_multiplication(yaw_cos_value);
+        fixed depth = forward.safe_multiplication(pitch_cos_value) - dy.safe_multiplication(pitch_sin_value);
+        optional<mode_7_projection> result;
+
+        if(depth >= 1)
+        {
+            fixed up = forward.safe_multiplication(pitch_sin_value) + dy.safe_multiplication(pitch_cos_value);
+            fixed scale = _focal_length.safe_division(depth);
+            fixed_point position(lateral.safe_multiplication(scale),
+                                 fixed(_horizon - (display::height() / 2)) - up.safe_multiplication(scale));
+            result = mode_7_projection(position, scale);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const mode_7_camera& a, const mode_7_camera& b) = default;
+
+private:
+    fixed _x;
+    fixed _y;
+    fixed _z;
+    fixed _yaw;
+    fixed _pitch;
+    fixed _focal_length;
+    int _horizon;
+};
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_MODE_7_PROJECTION_H
+#define BN_MODE_7_PROJECTION_H
+
+/**
+ * @file
+ * bn::mode_7_projection header file.
+ *
+ * @ingroup affine_bg
+ */
+
+#include "bn_fixed_point.h"
+
+namespace bn
+{
+
+/**
+ * @brief Screen position and scale of a point of the world displayed by a mode_7_bg.
+ *
+ * It can be used to place billboard sprites on the plane.
+ *
+ * @ingroup affine_bg
+ */
+class mode_7_projection
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param position Screen position of the projected point (relative to the center of the screen,
+     * like the position of a sprite).
+     * @param scale Screen pixels per world pixel at the projected point.
+     */
+    constexpr mode_7_projection(const fixed_point& position, fixed scale) :
+        _position(position),
+        _scale(scale)
+    {
+    }
+
+    /**
+     * @brief Returns the screen position of the projected point (relative to the center of the screen,
+     * like the position of a sprite).
+     */
+    [[nodiscard]] constexpr const fixed_point& position() const
+    {
+        return _position;
+    }
+
+    /**
+     * @brief Returns the screen pixels per world pixel at the projected point.
+     *
+     * It can be used as the scale of a billboard sprite.
+     */
+    [[nodiscard]] constexpr fixed scale() const
+    {
+        return _scale;
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const mode_7_projection& a, const mode_7_projection& b) = default;
+
+private:
+    fixed_point _position;
+    fixed _scale;
+};
+
+}
+
+#endif
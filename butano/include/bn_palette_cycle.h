@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_PALETTE_CYCLE_H
+#define BN_PALETTE_CYCLE_H
+
+/**
+ * @file
+ * bn::palette_cycle header file.
+ *
+ * @ingroup palette
+ */
+
+#include "bn_span.h"
+#include "bn_config_palettes.h"
+#include "bn_palette_cycle_range.h"
+
+namespace bn
+{
+
+class color;
+
+/**
+ * @brief Describes how the colors of a color palette are cycled.
+ *
+ * It contains one or more color ranges, each one cycled with its own period and direction.
+ *
+ * When it's assigned to a color palette, ranges are stepped by butano in each bn::core::update call,
+ * and only the palette banks which have been changed are committed to the GBA.
+ *
+ * It can also generate the colors of a H-Blank effect, such as bn::bg_palette_color_hbe_ptr.
+ *
+ * @ingroup palette
+ */
+class palette_cycle
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param ranges Ranges of colors to cycle. They must not overlap.
+     *
+     * The ranges are not copied but referenced, so they should outlive the palette_cycle
+     * to avoid dangling references.
+     */
+    constexpr explicit palette_cycle(const span<const palette_cycle_range>& ranges) :
+        _ranges(ranges)
+    {
+        BN_ASSERT(! ranges.empty(), "There's no ranges");
+        BN_ASSERT(ranges.size() <= BN_CFG_PALETTES_MAX_CYCLE_RANGES, "Too many ranges: ", ranges.size());
+
+        for(int index = 0, limit = ranges.size(); index < limit; ++index)
+        {
+            const palette_cycle_range& range = ranges[index];
+
+            for(int other_index = index + 1; other_index < limit; ++other_index)
+            {
+                const palette_cycle_range& other_range = ranges[other_index];
+                BN_ASSERT(range.first_color_index() + range.colors_count() <= other_range.first_color_index() ||
+                          other_range.first_color_index() + other_range.colors_count() <= range.first_color_index(),
+                          "Ranges overlap: ", index, " - ", other_index);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the referenced ranges of colors to cycle.
+     */
+    [[nodiscard]] constexpr const span<const palette_cycle_range>& ranges() const
+    {
+        return _ranges;
+    }
+
+    /**
+     * @brief Returns the range which contains the given color index if there's one; nullptr otherwise.
+     */
+    [[nodiscard]] constexpr const palette_cycle_range* find_range(int color_index) const
+    {
+        for(const palette_cycle_range& range : _ranges)
+        {
+            if(range.contains(color_index))
+            {
+                return &range;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Fills the colors of a palette color H-Blank effect (one color per screen horizontal line)
+     * with a gradient which follows the cycle of the given color.
+     *
+     * Each screen line displays the color shown by the given color index one cycle step later than the previous line.
+     *
+     * @param colors Colors of the palette to cycle.
+     * @param color_index Index of the color modified by the H-Blank effect. It must be inside one of the ranges.
+     * @param frames Number of frames elapsed since the cycle start.
+     * @param lines_per_step Number of screen lines of each gradient step.
+     * @param hblank_effect_colors Destination colors. Its size must be equal to the screen height.
+     */
+    void fill_hblank_effect_colors(const span<const color>& colors, int color_index, int frames, int lines_per_step,
+                                   span<color> hblank_effect_colors) const;
+
+private:
+    span<const palette_cycle_range> _ranges;
+};
+
+}
+
+#endif
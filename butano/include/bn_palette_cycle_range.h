@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_PALETTE_CYCLE_RANGE_H
+#define BN_PALETTE_CYCLE_RANGE_H
+
+/**
+ * @file
+ * bn::palette_cycle_range header file.
+ *
+ * @ingroup palette
+ */
+
+#include "bn_assert.h"
+
+namespace bn
+{
+
+/**
+ * @brief Range of consecutive colors of a color palette which are cycled periodically.
+ *
+ * @ingroup palette
+ */
+class palette_cycle_range
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param first_color_index Index of the first color of the range.
+     * @param colors_count Number of colors of the range.
+     * @param update_frames Number of frames between each cycle step.
+     * @param reverse Indicates if colors are moved to the previous index in each step instead of to the next one.
+     */
+    constexpr palette_cycle_range(int first_color_index, int colors_count, int update_frames, bool reverse = false) :
+        _first_color_index(first_color_index),
+        _colors_count(colors_count),
+        _update_frames(update_frames),
+        _reverse(reverse)
+    {
+        BN_ASSERT(first_color_index >= 0, "Invalid first color index: ", first_color_index);
+        BN_ASSERT(colors_count >= 2, "Invalid colors count: ", colors_count);
+        BN_ASSERT(first_color_index + colors_count <= 256,
+                  "Invalid range: ", first_color_index, " - ", colors_count);
+        BN_ASSERT(update_frames >= 1 && update_frames <= 0xFFFF, "Invalid update frames: ", update_frames);
+    }
+
+    /**
+     * @brief Returns the index of the first color of the range.
+     */
+    [[nodiscard]] constexpr int first_color_index() const
+    {
+        return _first_color_index;
+    }
+
+    /**
+     * @brief Returns the number of colors of the range.
+     */
+    [[nodiscard]] constexpr int colors_count() const
+    {
+        return _colors_count;
+    }
+
+    /**
+     * @brief Returns the number of frames between each cycle step.
+     */
+    [[nodiscard]] constexpr int update_frames() const
+    {
+        return _update_frames;
+    }
+
+    /**
+     * @brief Indicates if colors are moved to the previous index in each step instead of to the next one.
+     */
+    [[nodiscard]] constexpr bool reverse() const
+    {
+        return _reverse;
+    }
+
+    /**
+     * @brief Indicates if the given color index is inside this range or not.
+     */
+    [[nodiscard]] constexpr bool contains(int color_index) const
+    {
+        return color_index >= _first_color_index && color_index < _first_color_index + _colors_count;
+    }
+
+    /**
+     * @brief Returns the index of the color displayed in the given position after the given number of steps.
+     * @param color_index Index of a color inside this range.
+     * @param steps Number of cycle steps.
+     * @return Index of the color displayed in the given position.
+     */
+    [[nodiscard]] constexpr int cycled_color_index(int color_index, int steps) const
+    {
+        BN_ASSERT(contains(color_index), "Color index is outside the range: ", color_index);
+        BN_ASSERT(steps >= 0, "Invalid steps: ", steps);
+
+        int offset = steps % _colors_count;
+        int position = color_index - _first_color_index;
+        position = _reverse ? position + offset : position - offset + _colors_count;
+        return _first_color_index + (position % _colors_count);
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] constexpr friend bool operator==(const palette_cycle_range& a,
+                                                   const palette_cycle_range& b) = default;
+
+private:
+    int _first_color_index;
+    int _colors_count;
+    int _update_frames;
+    bool _reverse;
+};
+
+}
+
+#endif
@@ -123,7 +123,8 @@ public:
     }
 
 private:
-    alignas(Type) char _buffer[sizeof(typename base_type::element) * MaxSize];
+    // Free elements store a pointer to the next one, so the buffer must be aligned for both:
+    alignas(Type) alignas(typename base_type::element) char _buffer[sizeof(typename base_type::element) * MaxSize];
 };
 
 }
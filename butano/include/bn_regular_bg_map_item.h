@@ -82,8 +82,65 @@ public:
                   "Invalid height: ", dimensions.height());
     }
 
+    /**
+     * @brief Constructor for maps built from metatiles.
+     *
+     * A metatile is a square block of map cells referenced by an index, so big maps with a lot of repeated blocks
+     * require much less ROM than storing one map cell per tile.
+     *
+     * @param metatile_cells_ref Reference to the map cells of one or more metatiles.
+     * The map cells of each metatile are stored consecutively in row-major order.
+     * @param metatile_indexes_ref Reference to one metatile index for each metatile of the map,
+     * stored in row-major order.
+     *
+     * The map cells and the metatile indexes are not copied but referenced,
+     * so they should outlive the regular_bg_map_item to avoid dangling references.
+     *
+     * @param metatile_size Width and height in map cells of each metatile (2 or 4).
+     * @param dimensions Size in map cells of the map.
+     */
+    constexpr regular_bg_map_item(const regular_bg_map_cell& metatile_cells_ref,
+                                  const uint8_t& metatile_indexes_ref, int metatile_size, const size& dimensions) :
+        regular_bg_map_item(metatile_cells_ref, dimensions, compression_type::NONE)
+    {
+        BN_ASSERT(metatile_size == 2 || metatile_size == 4, "Invalid metatile size: ", metatile_size);
+
+        _metatile_byte_indexes_ptr = &metatile_indexes_ref;
+        _metatile_size = int8_t(metatile_size);
+    }
+
+    /**
+     * @brief Constructor for maps built from metatiles.
+     *
+     * A metatile is a square block of map cells referenced by an index, so big maps with a lot of repeated blocks
+     * require much less ROM than storing one map cell per tile.
+     *
+     * @param metatile_cells_ref Reference to the map cells of one or more metatiles.
+     * The map cells of each metatile are stored consecutively in row-major order.
+     * @param metatile_indexes_ref Reference to one metatile index for each metatile of the map,
+     * stored in row-major order.
+     *
+     * The map cells and the metatile indexes are not copied but referenced,
+     * so they should outlive the regular_bg_map_item to avoid dangling references.
+     *
+     * @param metatile_size Width and height in map cells of each metatile (2 or 4).
+     * @param dimensions Size in map cells of the map.
+     */
+    constexpr regular_bg_map_item(const regular_bg_map_cell& metatile_cells_ref,
+                                  const uint16_t& metatile_indexes_ref, int metatile_size, const size& dimensions) :
+        regular_bg_map_item(metatile_cells_ref, dimensions, compression_type::NONE)
+    {
+        BN_ASSERT(aligned<alignof(uint16_t)>(&metatile_indexes_ref), "Metatile indexes are not aligned");
+        BN_ASSERT(metatile_size == 2 || metatile_size == 4, "Invalid metatile size: ", metatile_size);
+
+        _metatile_half_word_indexes_ptr = &metatile_indexes_ref;
+        _metatile_size = int8_t(metatile_size);
+    }
+
     /**
      * @brief Returns the referenced map cells.
+     *
+     * If the map is built from metatiles, it returns the map cells of the metatiles.
      */
     [[nodiscard]] constexpr const regular_bg_map_cell& cells_ref() const
     {
@@ -117,11 +174,45 @@ public:
         return _compression;
     }
 
+    /**
+     * @brief Indicates if the map is built from metatiles or not.
+     */
+    [[nodiscard]] constexpr bool metatiles() const
+    {
+        return _metatile_size > 1;
+    }
+
+    /**
+     * @brief Returns the width and height in map cells of each metatile, or 1 if the map is not built from metatiles.
+     */
+    [[nodiscard]] constexpr int metatile_size() const
+    {
+        return _metatile_size;
+    }
+
+    /**
+     * @brief Returns the referenced metatile indexes if they are stored in bytes; nullptr otherwise.
+     */
+    [[nodiscard]] constexpr const uint8_t* metatile_byte_indexes_ptr() const
+    {
+        return _metatile_byte_indexes_ptr;
+    }
+
+    /**
+     * @brief Returns the referenced metatile indexes if they are stored in half words; nullptr otherwise.
+     */
+    [[nodiscard]] constexpr const uint16_t* metatile_half_word_indexes_ptr() const
+    {
+        return _metatile_half_word_indexes_ptr;
+    }
+
     /**
      * @brief Uncompresses the stored data in the map cells referenced by uncompressed_cells_ref.
      *
      * If the source and destination map cells overlap, the behavior is undefined.
      *
+     * If the map is built from metatiles, they are expanded in the destination map cells.
+     *
      * @param uncompressed_cells_ref Destination of the uncompressed map cells.
      * @param uncompressed_dimensions Size in map cells of the destination data.
      * @return A regular_bg_map_item pointing to the uncompressed map cells.
@@ -212,7 +303,10 @@ public:
 private:
     const regular_bg_map_cell* _cells_ptr;
     size _dimensions;
+    const uint8_t* _metatile_byte_indexes_ptr = nullptr;
+    const uint16_t* _metatile_half_word_indexes_ptr = nullptr;
     compression_type _compression;
+    int8_t _metatile_size = 1;
 };
 
 }
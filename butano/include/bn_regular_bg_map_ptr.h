@@ -301,8 +301,8 @@ public:
     [[nodiscard]] compression_type compression() const;
 
     /**
-     * @brief Returns the referenced map cells unless it was created with allocate or allocate_optional.
-     * In that case, it returns bn::nullopt.
+     * @brief Returns the referenced map cells unless it was created with allocate or allocate_optional,
+     * or unless it is built from metatiles. In that case, it returns bn::nullopt.
      */
     [[nodiscard]] optional<span<const regular_bg_map_cell>> cells_ref() const;
 
@@ -14,8 +14,10 @@
  * @ingroup hblank_effect
  */
 
-#include "bn_regular_bg_ptr.h"
 #include "bn_hbe_ptr.h"
+#include "bn_hbe_wave.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_hbe_parallax_band.h"
 
 namespace bn
 {
@@ -91,6 +93,78 @@ public:
     [[nodiscard]] static optional<regular_bg_position_hbe_ptr> create_vertical_optional(
             regular_bg_ptr bg, const span<const fixed>& deltas_ref);
 
+    /**
+     * @brief Creates a regular_bg_position_hbe_ptr which changes the horizontal position of a
+     * regular background in each screen horizontal line following a sine wave generated by the engine.
+     * @param bg Regular background to be modified.
+     * @param wave Sine wave to add to the horizontal position of the given regular background.
+     * @return The requested regular_bg_position_hbe_ptr.
+     */
+    [[nodiscard]] static regular_bg_position_hbe_ptr create_horizontal_wave(
+            regular_bg_ptr bg, const hbe_wave& wave);
+
+    /**
+     * @brief Creates a regular_bg_position_hbe_ptr which changes the vertical position of a
+     * regular background in each screen horizontal line following a sine wave generated by the engine.
+     * @param bg Regular background to be modified.
+     * @param wave Sine wave to add to the vertical position of the given regular background.
+     * @return The requested regular_bg_position_hbe_ptr.
+     */
+    [[nodiscard]] static regular_bg_position_hbe_ptr create_vertical_wave(
+            regular_bg_ptr bg, const hbe_wave& wave);
+
+    /**
+     * @brief Creates a regular_bg_position_hbe_ptr which changes the horizontal position of a
+     * regular background in each screen horizontal line following a sine wave generated by the engine.
+     * @param bg Regular background to be modified.
+     * @param wave Sine wave to add to the horizontal position of the given regular background.
+     * @return The requested regular_bg_position_hbe_ptr if it could be allocated; bn::nullopt otherwise.
+     */
+    [[nodiscard]] static optional<regular_bg_position_hbe_ptr> create_horizontal_wave_optional(
+            regular_bg_ptr bg, const hbe_wave& wave);
+
+    /**
+     * @brief Creates a regular_bg_position_hbe_ptr which changes the vertical position of a
+     * regular background in each screen horizontal line following a sine wave generated by the engine.
+     * @param bg Regular background to be modified.
+     * @param wave Sine wave to add to the vertical position of the given regular background.
+     * @return The requested regular_bg_position_hbe_ptr if it could be allocated; bn::nullopt otherwise.
+     */
+    [[nodiscard]] static optional<regular_bg_position_hbe_ptr> create_vertical_wave_optional(
+            regular_bg_ptr bg, const hbe_wave& wave);
+
+    /**
+     * @brief Creates a regular_bg_position_hbe_ptr which scrolls groups of screen horizontal lines of a
+     * regular background at different speeds.
+     * @param bg Regular background to be modified.
+     * @param bands_ref Reference to an array of parallax bands which lines sum up to 160 at most.
+     * The horizontal position of each band is the horizontal position of the given regular background
+     * multiplied by the position factor of the band.
+     *
+     * The bands are not copied but referenced, so they should outlive the regular_bg_position_hbe_ptr
+     * to avoid dangling references.
+     *
+     * @return The requested regular_bg_position_hbe_ptr.
+     */
+    [[nodiscard]] static regular_bg_position_hbe_ptr create_horizontal_parallax_bands(
+            regular_bg_ptr bg, const span<const hbe_parallax_band>& bands_ref);
+
+    /**
+     * @brief Creates a regular_bg_position_hbe_ptr which scrolls groups of screen horizontal lines of a
+     * regular background at different speeds.
+     * @param bg Regular background to be modified.
+     * @param bands_ref Reference to an array of parallax bands which lines sum up to 160 at most.
+     * The horizontal position of each band is the horizontal position of the given regular background
+     * multiplied by the position factor of the band.
+     *
+     * The bands are not copied but referenced, so they should outlive the regular_bg_position_hbe_ptr
+     * to avoid dangling references.
+     *
+     * @return The requested regular_bg_position_hbe_ptr if it could be allocated; bn::nullopt otherwise.
+     */
+    [[nodiscard]] static optional<regular_bg_position_hbe_ptr> create_horizontal_parallax_bands_optional(
+            regular_bg_ptr bg, const span<const hbe_parallax_band>& bands_ref);
+
     /**
      * @brief Returns the regular background modified by this H-Blank effect.
      */
@@ -101,7 +175,8 @@ public:
 
     /**
      * @brief Returns the referenced array of 160 deltas to add to the horizontal or vertical position
-     * of the managed regular background in each screen horizontal line.
+     * of the managed regular background in each screen horizontal line,
+     * or an empty span if the deltas are generated by the engine.
      *
      * The deltas are not copied but referenced, so they should outlive the regular_bg_position_hbe_ptr
      * to avoid dangling references.
@@ -126,6 +201,49 @@ public:
      */
     void reload_deltas_ref();
 
+    /**
+     * @brief Returns the sine wave added to the horizontal or vertical position of the managed regular background
+     * if it has one; bn::nullopt otherwise.
+     *
+     * The phase of the returned wave is updated each frame with its phase speed.
+     */
+    [[nodiscard]] optional<hbe_wave> wave() const;
+
+    /**
+     * @brief Sets the sine wave to add to the horizontal or vertical position of the managed regular background
+     * in each screen horizontal line.
+     *
+     * The previous deltas or parallax bands are not used anymore.
+     */
+    void set_wave(const hbe_wave& wave);
+
+    /**
+     * @brief Returns the referenced array of parallax bands of the managed regular background,
+     * or an empty span if it doesn't have them.
+     *
+     * The bands are not copied but referenced, so they should outlive the regular_bg_position_hbe_ptr
+     * to avoid dangling references.
+     */
+    [[nodiscard]] span<const hbe_parallax_band> parallax_bands_ref() const;
+
+    /**
+     * @brief Sets the reference to an array of parallax bands of the managed regular background.
+     *
+     * The previous deltas or sine wave are not used anymore.
+     *
+     * The bands are not copied but referenced, so they should outlive the regular_bg_position_hbe_ptr
+     * to avoid dangling references.
+     */
+    void set_parallax_bands_ref(const span<const hbe_parallax_band>& bands_ref);
+
+    /**
+     * @brief Rereads the content of the referenced parallax bands of the managed regular background.
+     *
+     * The bands are not copied but referenced, so they should outlive the regular_bg_position_hbe_ptr
+     * to avoid dangling references.
+     */
+    void reload_parallax_bands_ref();
+
     /**
      * @brief Exchanges the contents of this regular_bg_position_hbe_ptr with those of the other one.
      * @param other regular_bg_position_hbe_ptr to exchange the contents with.
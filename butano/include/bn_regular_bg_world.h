@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_REGULAR_BG_WORLD_H
+#define BN_REGULAR_BG_WORLD_H
+
+/**
+ * @file
+ * bn::regular_bg_world header file.
+ *
+ * @ingroup regular_bg
+ */
+
+#include "bn_point.h"
+#include "bn_memory.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_regular_bg_world_item.h"
+
+namespace bn
+{
+
+/**
+ * @brief Displays a chunked world (see regular_bg_world_item) bigger than what a regular_bg_map_item can describe.
+ *
+ * The world is displayed with a regular background with a 32x32 map.
+ * Only the visible map cells are streamed to this map when the world is scrolled.
+ *
+ * Compressed chunks (and chunks built from metatiles) are uncompressed in an EWRAM cache.
+ * The chunks which are going to become visible soon are loaded before they are needed,
+ * one chunk per set_position call at most.
+ *
+ * With dynamic tiles, only the tiles referenced by the visible map cells are kept in VRAM:
+ * tiles are uploaded to reference counted VRAM slots when the map cells which reference them become visible,
+ * and the least recently released slots are reused first.
+ * Since tiles are uploaded when set_position is called, it should be called only once per frame.
+ *
+ * Map cells are committed to VRAM in the next V-Blank, but tiles are uploaded immediately,
+ * so slots released by a set_position call are not reused by the same call.
+ *
+ * @ingroup regular_bg
+ */
+class regular_bg_world
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param item regular_bg_world_item used to create the world.
+     * @param position Position in pixels of the top-left corner of the screen in the world.
+     * @param max_cached_chunks Maximum number of uncompressed chunks stored in EWRAM at the same time
+     * (each one of them requires 2KB). It must be greater or equal than 4.
+     * @param dynamic_tiles_count Number of VRAM tiles allocated for dynamic tiles,
+     * or 0 to load all tiles of the world in VRAM.
+     *
+     * It must be greater than the number of different tiles referenced by the visible map cells
+     * (by the old and the new visible map cells if the world is moved more than 8 map cells at once),
+     * and it is required if the world references several tiles items.
+     */
+    regular_bg_world(const regular_bg_world_item& item, const point& position, int max_cached_chunks = 6,
+                     int dynamic_tiles_count = 0);
+
+    regular_bg_world(const regular_bg_world& other) = delete;
+
+    regular_bg_world& operator=(const regular_bg_world& other) = delete;
+
+    /**
+     * @brief Returns the regular_bg_world_item used to create the world.
+     */
+    [[nodiscard]] const regular_bg_world_item& item() const
+    {
+        return _item;
+    }
+
+    /**
+     * @brief Returns the regular background used to display the world.
+     *
+     * Its position and its map must not be modified.
+     */
+    [[nodiscard]] const regular_bg_ptr& bg() const
+    {
+        return _bg;
+    }
+
+    /**
+     * @brief Returns the regular background used to display the world.
+     *
+     * Its position and its map must not be modified.
+     */
+    [[nodiscard]] regular_bg_ptr& bg()
+    {
+        return _bg;
+    }
+
+    /**
+     * @brief Returns the position in pixels of the top-left corner of the screen in the world.
+     */
+    [[nodiscard]] const point& position() const
+    {
+        return _position;
+    }
+
+    /**
+     * @brief Sets the position in pixels of the top-left corner of the screen in the world.
+     * @param x Horizontal position in the range [0..item().pixels_dimensions().width() - display::width()].
+     * @param y Vertical position in the range [0..item().pixels_dimensions().height() - display::height()].
+     */
+    void set_position(int x, int y)
+    {
+        set_position(point(x, y));
+    }
+
+    /**
+     * @brief Sets the position in pixels of the top-left corner of the screen in the world.
+     * @param position Position in the range
+     * [(0, 0)..(item().pixels_dimensions().width() - display::width(),
+     * item().pixels_dimensions().height() - display::height())].
+     */
+    void set_position(const point& position);
+
+    /**
+     * @brief Returns the maximum number of uncompressed chunks stored in EWRAM at the same time.
+     */
+    [[nodiscard]] int max_cached_chunks() const
+    {
+        return _max_cached_chunks;
+    }
+
+    /**
+     * @brief Returns the number of uncompressed chunks stored in EWRAM.
+     */
+    [[nodiscard]] int cached_chunks_count() const;
+
+    /**
+     * @brief Returns the number of VRAM tiles allocated for dynamic tiles, or 0 if dynamic tiles are disabled.
+     */
+    [[nodiscard]] int dynamic_tiles_count() const
+    {
+        return _dynamic_tiles_count;
+    }
+
+    /**
+     * @brief Returns the number of VRAM tiles for dynamic tiles referenced by the visible map cells.
+     */
+    [[nodiscard]] int used_dynamic_tiles_count() const;
+
+private:
+    class cached_chunk
+    {
+
+    public:
+        int chunk_index;
+        int last_use;
+    };
+
+    class dynamic_tile
+    {
+
+    public:
+        uint16_t tile;
+        uint16_t usages;
+        int16_t prev;
+        int16_t next;
+    };
+
+    class ewram_deleter
+    {
+
+    public:
+        void operator()(void* ptr) const;
+    };
+
+    regular_bg_world_item _item;
+    unique_ptr<regular_bg_map_cell, ewram_deleter> _cells;
+    unique_ptr<uint16_t, ewram_deleter> _dynamic_tiles_data;
+    cached_chunk* _cached_chunks;
+    dynamic_tile* _dynamic_tiles = nullptr;
+    regular_bg_ptr _bg;
+    point _position;
+    point _map_position;
+    tile* _dynamic_tiles_vram = nullptr;
+    int _max_cached_chunks;
+    int _dynamic_tiles_count;
+    int _first_free_dynamic_tile = 0;
+    int _last_free_dynamic_tile;
+    int _last_reusable_dynamic_tile = -1;
+    int _ticks = 0;
+
+    [[nodiscard]] const regular_bg_map_cell* _chunk_cells(int chunk_x, int chunk_y, bool prefetch);
+
+    [[nodiscard]] const regular_bg_tiles_item& _chunk_tiles_item(int chunk_x, int chunk_y, int& tiles_base) const;
+
+    void _set_dynamic_cell(int ring_index, regular_bg_map_cell cell, const regular_bg_tiles_item& tiles_item,
+                           int tiles_base);
+
+    void _release_dynamic_row(int y);
+
+    void _release_dynamic_tile(int slot);
+
+    void _unlink_free_dynamic_tile(int slot);
+
+    void _load_col(int x, int y);
+
+    void _load_row(int x, int y);
+
+    void _prefetch(const point& old_position);
+};
+
+}
+
+#endif
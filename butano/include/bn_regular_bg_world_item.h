@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_REGULAR_BG_WORLD_ITEM_H
+#define BN_REGULAR_BG_WORLD_ITEM_H
+
+/**
+ * @file
+ * bn::regular_bg_world_item header file.
+ *
+ * @ingroup regular_bg
+ * @ingroup tool
+ */
+
+#include "bn_span.h"
+#include "bn_bg_palette_item.h"
+#include "bn_regular_bg_map_item.h"
+#include "bn_regular_bg_tiles_item.h"
+
+namespace bn
+{
+
+/**
+ * @brief Contains the required information to generate regular_bg_world objects.
+ *
+ * A world is a grid of chunks of 32x32 map cells (256x256 pixels).
+ * Each position of the grid references a chunk by its index, so repeated chunks are stored only once.
+ *
+ * Since each chunk is a regular_bg_map_item, chunks can be compressed or built from metatiles.
+ *
+ * Tiles, colors, chunks and chunk indexes are not copied but referenced,
+ * so they should outlive the regular_bg_world_item to avoid dangling references.
+ *
+ * @ingroup regular_bg
+ * @ingroup tool
+ */
+class regular_bg_world_item
+{
+
+public:
+    /**
+     * @brief Constructor.
+     * @param tiles_item It creates the tiles of the world background.
+     * @param palette_item It creates the color palette of the world background.
+     * @param chunk_items Reference to the unique chunks of the world.
+     *
+     * Each chunk must have 32x32 map cells.
+     *
+     * @param chunk_indexes Reference to one chunk index for each chunk of the world, stored in row-major order.
+     * @param dimensions Size in chunks of the world.
+     */
+    constexpr regular_bg_world_item(const regular_bg_tiles_item& tiles_item, const bg_palette_item& palette_item,
+                                    const span<const regular_bg_map_item>& chunk_items,
+                                    const span<const uint16_t>& chunk_indexes, const size& dimensions) :
+        _tiles_item(tiles_item),
+        _palette_item(palette_item),
+        _chunk_items(chunk_items),
+        _chunk_indexes(chunk_indexes),
+        _dimensions(dimensions)
+    {
+        BN_ASSERT(tiles_item.bpp() == palette_item.bpp(), "Tiles and palette BPP are different");
+        BN_ASSERT(! chunk_items.empty(), "There's no chunks");
+        BN_ASSERT(dimensions.width() > 0, "Invalid width: ", dimensions.width());
+        BN_ASSERT(dimensions.height() > 0, "Invalid height: ", dimensions.height());
+        BN_ASSERT(chunk_indexes.size() == dimensions.width() * dimensions.height(),
+                  "Invalid chunk indexes count: ", chunk_indexes.size(), " - ",
+                  dimensions.width() * dimensions.height());
+
+        for(const regular_bg_map_item& chunk_item : chunk_items)
+        {
+            BN_ASSERT(chunk_item.dimensions() == size(chunk_size(), chunk_size()),
+                      "Invalid chunk dimensions: ", chunk_item.dimensions().width(), " - ",
+                      chunk_item.dimensions().height());
+        }
+    }
+
+    /**
+     * @brief Constructor.
+     *
+     * Worlds created with this constructor can only be displayed with dynamic tiles
+     * (see regular_bg_world::dynamic_tiles_count), so they can reference more tiles than a background can.
+     *
+     * @param tiles_items Reference to the items used to create the tiles of the world background.
+     *
+     * Tiles must not be compressed.
+     *
+     * @param palette_item It creates the color palette of the world background.
+     * @param chunk_items Reference to the unique chunks of the world.
+     *
+     * Each chunk must have 32x32 map cells.
+     *
+     * @param chunk_tiles_indexes Reference to one index of tiles_items for each unique chunk.
+     * Tile indexes of the map cells of each chunk are relative to the referenced tiles item.
+     * @param chunk_indexes Reference to one chunk index for each chunk of the world, stored in row-major order.
+     * @param dimensions Size in chunks of the world.
+     */
+    constexpr regular_bg_world_item(const span<const regular_bg_tiles_item>& tiles_items,
+                                    const bg_palette_item& palette_item,
+                                    const span<const regular_bg_map_item>& chunk_items,
+                                    const span<const uint8_t>& chunk_tiles_indexes,
+                                    const span<const uint16_t>& chunk_indexes, const size& dimensions) :
+        regular_bg_world_item(tiles_items.front(), palette_item, chunk_items, chunk_indexes, dimensions)
+    {
+        BN_ASSERT(chunk_tiles_indexes.size() == chunk_items.size(),
+                  "Invalid chunk tiles indexes count: ", chunk_tiles_indexes.size(), " - ", chunk_items.size());
+
+        for(const regular_bg_tiles_item& tiles_item : tiles_items)
+        {
+            BN_ASSERT(tiles_item.bpp() == palette_item.bpp(), "Tiles and palette BPP are different");
+            BN_ASSERT(tiles_item.compression() == compression_type::NONE, "Compressed tiles not supported");
+        }
+
+        for(uint8_t chunk_tiles_index : chunk_tiles_indexes)
+        {
+            BN_ASSERT(chunk_tiles_index < tiles_items.size(),
+                      "Invalid chunk tiles index: ", chunk_tiles_index, " - ", tiles_items.size());
+        }
+
+        _tiles_items = tiles_items;
+        _chunk_tiles_indexes = chunk_tiles_indexes;
+    }
+
+    /**
+     * @brief Returns the width and height in map cells of each chunk.
+     */
+    [[nodiscard]] static constexpr int chunk_size()
+    {
+        return 32;
+    }
+
+    /**
+     * @brief Returns the item used to create the tiles of the world background
+     * (the first one if the world references several tiles items).
+     */
+    [[nodiscard]] constexpr const regular_bg_tiles_item& tiles_item() const
+    {
+        return _tiles_item;
+    }
+
+    /**
+     * @brief Returns the items used to create the tiles of the world background.
+     */
+    [[nodiscard]] constexpr span<const regular_bg_tiles_item> tiles_items() const
+    {
+        return _tiles_items.empty() ? span<const regular_bg_tiles_item>(&_tiles_item, 1) : _tiles_items;
+    }
+
+    /**
+     * @brief Returns the item used to create the color palette of the world background.
+     */
+    [[nodiscard]] constexpr const bg_palette_item& palette_item() const
+    {
+        return _palette_item;
+    }
+
+    /**
+     * @brief Returns the referenced unique chunks of the world.
+     */
+    [[nodiscard]] constexpr const span<const regular_bg_map_item>& chunk_items() const
+    {
+        return _chunk_items;
+    }
+
+    /**
+     * @brief Returns the referenced index of tiles_items for each unique chunk
+     * (empty if the world references only one tiles item).
+     */
+    [[nodiscard]] constexpr const span<const uint8_t>& chunk_tiles_indexes() const
+    {
+        return _chunk_tiles_indexes;
+    }
+
+    /**
+     * @brief Returns the index of tiles_items referenced by the given unique chunk.
+     * @param chunk_index Index of the unique chunk.
+     */
+    [[nodiscard]] constexpr int chunk_tiles_index(int chunk_index) const
+    {
+        return _chunk_tiles_indexes.empty() ? 0 : _chunk_tiles_indexes[chunk_index];
+    }
+
+    /**
+     * @brief Returns the referenced chunk indexes of the world.
+     */
+    [[nodiscard]] constexpr const span<const uint16_t>& chunk_indexes() const
+    {
+        return _chunk_indexes;
+    }
+
+    /**
+     * @brief Returns the size in chunks of the world.
+     */
+    [[nodiscard]] constexpr const size& dimensions() const
+    {
+        return _dimensions;
+    }
+
+    /**
+     * @brief Returns the size in pixels of the world.
+     */
+    [[nodiscard]] constexpr size pixels_dimensions() const
+    {
+        return size(_dimensions.width() * chunk_size() * 8, _dimensions.height() * chunk_size() * 8);
+    }
+
+    /**
+     * @brief Returns the item of the chunk located at the given position.
+     * @param chunk_x Horizontal position of the chunk in chunks.
+     * @param chunk_y Vertical position of the chunk in chunks.
+     */
+    [[nodiscard]] constexpr const regular_bg_map_item& chunk_item(int chunk_x, int chunk_y) const
+    {
+        BN_ASSERT(chunk_x >= 0 && chunk_x < _dimensions.width(), "Invalid chunk x: ", chunk_x);
+        BN_ASSERT(chunk_y >= 0 && chunk_y < _dimensions.height(), "Invalid chunk y: ", chunk_y);
+
+        return _chunk_items[chunk_index(chunk_x, chunk_y)];
+    }
+
+    /**
+     * @brief Returns the index of the chunk located at the given position.
+     * @param chunk_x Horizontal position of the chunk in chunks.
+     * @param chunk_y Vertical position of the chunk in chunks.
+     */
+    [[nodiscard]] constexpr int chunk_index(int chunk_x, int chunk_y) const
+    {
+        int result = _chunk_indexes[(chunk_y * _dimensions.width()) + chunk_x];
+        BN_ASSERT(result < _chunk_items.size(), "Invalid chunk index: ", result, " - ", _chunk_items.size());
+
+        return result;
+    }
+
+private:
+    regular_bg_tiles_item _tiles_item;
+    bg_palette_item _palette_item;
+    span<const regular_bg_tiles_item> _tiles_items;
+    span<const regular_bg_map_item> _chunk_items;
+    span<const uint8_t> _chunk_tiles_indexes;
+    span<const uint16_t> _chunk_indexes;
+    size _dimensions;
+};
+
+}
+
+#endif
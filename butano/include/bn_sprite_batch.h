@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_SPRITE_BATCH_H
+#define BN_SPRITE_BATCH_H
+
+/**
+ * @file
+ * bn::isprite_batch and bn::sprite_batch implementation header file.
+ *
+ * @ingroup sprite
+ */
+
+#include "bn_span.h"
+#include "bn_vector.h"
+#include "bn_optional.h"
+#include "bn_camera_ptr.h"
+#include "bn_sprite_ptr.h"
+#include "bn_fixed_point.h"
+#include "bn_sprite_item.h"
+#include "bn_sprite_tiles_ptr.h"
+#include "bn_sprite_shape_size.h"
+#include "bn_sprite_palette_ptr.h"
+
+namespace bn
+{
+
+/**
+ * @brief Base class of sprite_batch.
+ *
+ * It displays a group of sprites which share the same shape, size, tiles, palette, background priority, z order,
+ * flips and camera, updating all of their positions at once.
+ *
+ * Sprites are created the first time they are needed, and they are hidden and kept for later use
+ * when they are not displayed anymore, up to max_hidden_size() hidden sprites (call clear to release all of them).
+ *
+ * @ingroup sprite
+ */
+class isprite_batch
+{
+
+public:
+    isprite_batch(const isprite_batch& other) = delete;
+
+    isprite_batch& operator=(const isprite_batch& other) = delete;
+
+    /**
+     * @brief Returns the number of displayed sprites.
+     */
+    [[nodiscard]] int size() const
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Returns the maximum number of displayed sprites.
+     */
+    [[nodiscard]] int max_size() const
+    {
+        return _sprites_ref.max_size();
+    }
+
+    /**
+     * @brief Indicates if no sprites are displayed.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     * @brief Returns the number of allocated sprites, including the hidden ones.
+     */
+    [[nodiscard]] int allocated_size() const
+    {
+        return _sprites_ref.size();
+    }
+
+    /**
+     * @brief Returns the maximum number of hidden sprites kept for later use.
+     */
+    [[nodiscard]] int max_hidden_size() const
+    {
+        return _max_hidden_size;
+    }
+
+    /**
+     * @brief Sets the maximum number of hidden sprites kept for later use.
+     *
+     * Hidden sprites over this limit are released, so they don't take sprite items required by other sprites.
+     *
+     * @param max_hidden_size Maximum number of hidden sprites in the range [0..max_size()].
+     */
+    void set_max_hidden_size(int max_hidden_size);
+
+    /**
+     * @brief Returns the shape and size of the sprites.
+     */
+    [[nodiscard]] const sprite_shape_size& shape_size() const
+    {
+        return _shape_size;
+    }
+
+    /**
+     * @brief Returns the tiles used by the sprites.
+     */
+    [[nodiscard]] const sprite_tiles_ptr& tiles() const
+    {
+        return _tiles;
+    }
+
+    /**
+     * @brief Replaces the tiles used by the sprites.
+     * @param tiles New tiles to use.
+     */
+    void set_tiles(const sprite_tiles_ptr& tiles);
+
+    /**
+     * @brief Returns the color palette used by the sprites.
+     */
+    [[nodiscard]] const sprite_palette_ptr& palette() const
+    {
+        return _palette;
+    }
+
+    /**
+     * @brief Replaces the color palette used by the sprites.
+     * @param palette New color palette to use.
+     */
+    void set_palette(const sprite_palette_ptr& palette);
+
+    /**
+     * @brief Returns the priority of the sprites relative to backgrounds.
+     */
+    [[nodiscard]] int bg_priority() const
+    {
+        return _bg_priority;
+    }
+
+    /**
+     * @brief Sets the priority of the sprites relative to backgrounds.
+     *
+     * Sprites with higher priorities are drawn first
+     * (and therefore can be covered by later sprites and backgrounds).
+     *
+     * @param bg_priority Priority relative to backgrounds in the range [0..3].
+     */
+    void set_bg_priority(int bg_priority);
+
+    /**
+     * @brief Returns the priority of the sprites relative to other ones.
+     */
+    [[nodiscard]] int z_order() const
+    {
+        return _z_order;
+    }
+
+    /**
+     * @brief Sets the priority of the sprites relative to other ones.
+     *
+     * Sprites with higher z orders are drawn first
+     * (and therefore can be covered by later sprites).
+     *
+     * @param z_order Priority relative to other sprites in the range [-32767..32767].
+     */
+    void set_z_order(int z_order);
+
+    /**
+     * @brief Indicates if the sprites are flipped in the horizontal axis or not.
+     */
+    [[nodiscard]] bool horizontal_flip() const
+    {
+        return _horizontal_flip;
+    }
+
+    /**
+     * @brief Sets if the sprites must be flipped in the horizontal axis or not.
+     */
+    void set_horizontal_flip(bool horizontal_flip);
+
+    /**
+     * @brief Indicates if the sprites are flipped in the vertical axis or not.
+     */
+    [[nodiscard]] bool vertical_flip() const
+    {
+        return _vertical_flip;
+    }
+
+    /**
+     * @brief Sets if the sprites must be flipped in the vertical axis or not.
+     */
+    void set_vertical_flip(bool vertical_flip);
+
+    /**
+     * @brief Returns the camera_ptr attached to the sprites (if any).
+     */
+    [[nodiscard]] const optional<camera_ptr>& camera() const
+    {
+        return _camera;
+    }
+
+    /**
+     * @brief Sets the camera_ptr attached to the sprites.
+     * @param camera camera_ptr to copy to the sprites.
+     */
+    void set_camera(const camera_ptr& camera);
+
+    /**
+     * @brief Removes the camera_ptr attached to the sprites (if any).
+     */
+    void remove_camera();
+
+    /**
+     * @brief Displays one sprite for each one of the given positions and hides the remaining ones.
+     *
+     * Hidden sprites over max_hidden_size() are released.
+     *
+     * Sprites are updated in a single loop, which is much faster than updating them one by one.
+     *
+     * @param positions Positions of the sprites to display.
+     * Its size must be less or equal than max_size().
+     */
+    void set_positions(const span<const fixed_point>& positions);
+
+    /**
+     * @brief Releases all sprites, including the hidden ones.
+     */
+    void clear();
+
+protected:
+    /// @cond DO_NOT_DOCUMENT
+
+    isprite_batch(ivector<sprite_ptr>& sprites_ref, int16_t* item_indexes_ptr, const sprite_shape_size& shape_size,
+                  sprite_tiles_ptr&& tiles, sprite_palette_ptr&& palette);
+
+    /// @endcond
+
+private:
+    ivector<sprite_ptr>& _sprites_ref;
+    int16_t* _item_indexes_ptr;
+    sprite_shape_size _shape_size;
+    sprite_tiles_ptr _tiles;
+    sprite_palette_ptr _palette;
+    optional<camera_ptr> _camera;
+    int _size = 0;
+    int _max_hidden_size;
+    int16_t _z_order = 0;
+    int8_t _bg_priority = 3;
+    bool _horizontal_flip = false;
+    bool _vertical_flip = false;
+
+    void _release_hidden_sprites();
+};
+
+
+/**
+ * @brief Displays a group of up to MaxSize sprites which share the same shape, size, tiles, palette,
+ * background priority, z order, flips and camera.
+ *
+ * Useful for bullets and particles, since all sprite positions are updated with one call.
+ *
+ * @tparam MaxSize Maximum number of displayed sprites.
+ *
+ * @ingroup sprite
+ */
+template<int MaxSize>
+class sprite_batch : public isprite_batch
+{
+    static_assert(MaxSize > 0);
+
+public:
+    /**
+     * @brief Constructor.
+     * @param shape_size Shape and size of the sprites.
+     * @param tiles Tiles used by the sprites.
+     * @param palette Color palette used by the sprites.
+     */
+    sprite_batch(const sprite_shape_size& shape_size, sprite_tiles_ptr tiles, sprite_palette_ptr palette) :
+        isprite_batch(_sprites, _item_indexes, shape_size, move(tiles), move(palette))
+    {
+    }
+
+    /**
+     * @brief Constructor.
+     * @param item sprite_item used to create the tiles and the color palette of the sprites.
+     * @param graphics_index Index of the tile set to reference in item.tiles_item().
+     */
+    explicit sprite_batch(const sprite_item& item, int graphics_index = 0) :
+        sprite_batch(item.shape_size(), item.tiles_item().create_tiles(graphics_index),
+                     item.palette_item().create_palette())
+    {
+    }
+
+private:
+    vector<sprite_ptr, MaxSize> _sprites;
+    int16_t _item_indexes[MaxSize];
+};
+
+}
+
+#endif
@@ -24,6 +24,7 @@ namespace bn
 {
 
 class color;
+class palette_cycle;
 class sprite_palette_item;
 enum class bpp_mode : uint8_t;
 
@@ -213,6 +214,23 @@ public:
      */
     void set_rotate_count(int count);
 
+    /**
+     * @brief Indicates if the colors of this palette are cycled by a bn::palette_cycle or not.
+     */
+    [[nodiscard]] bool has_cycle() const;
+
+    /**
+     * @brief Cycles the colors of this palette as described by the given bn::palette_cycle.
+     *
+     * Ranges are copied, so the given bn::palette_cycle doesn't need to outlive this palette.
+     */
+    void set_cycle(const palette_cycle& cycle);
+
+    /**
+     * @brief Stops cycling the colors of this palette.
+     */
+    void remove_cycle();
+
     /**
      * @brief Exchanges the contents of this sprite_palette_ptr with those of the other one.
      * @param other sprite_palette_ptr to exchange the contents with.
@@ -35,6 +35,13 @@ namespace bn::sprite_tiles
      */
     [[nodiscard]] int available_tiles_count();
 
+    /**
+     * @brief Returns the size in tiles of the largest block of contiguous available sprite tiles.
+     *
+     * A sprite_tiles_ptr with more tiles than this can't be created until defragment is called.
+     */
+    [[nodiscard]] int largest_available_tiles_count();
+
     /**
      * @brief Returns the number of used sprite tile sets created with sprite_tiles_ptr static constructors.
      */
@@ -46,6 +53,19 @@ namespace bn::sprite_tiles
      */
     [[nodiscard]] int available_items_count();
 
+    /**
+     * @brief Moves all used sprite tiles to the beginning of VRAM,
+     * so all available sprite tiles are merged in one block.
+     *
+     * Tiles are moved in the next core::update call, and sprites are updated to reference them in the same frame.
+     *
+     * Tiles can't be allocated until the next core::update call,
+     * and calling this function again before it does nothing. Moreover, the memory returned by sprite_tiles_ptr::vram before calling this function must not be used anymore.
+     *
+     * H-Blank effects which reference sprite tiles must be reloaded after calling this function.
+     */
+    void defragment();
+
     #if BN_CFG_LOG_ENABLED || BN_DOXYGEN
         /**
          * @brief Logs the current status of the sprite tiles manager.
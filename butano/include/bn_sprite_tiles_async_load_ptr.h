@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_SPRITE_TILES_ASYNC_LOAD_PTR_H
+#define BN_SPRITE_TILES_ASYNC_LOAD_PTR_H
+
+/**
+ * @file
+ * bn::sprite_tiles_async_load_ptr header file.
+ *
+ * @ingroup sprite
+ * @ingroup tile
+ */
+
+#include "bn_utility.h"
+#include "bn_optional_fwd.h"
+
+namespace bn
+{
+
+class sprite_tiles_ptr;
+class sprite_tiles_item;
+
+/**
+ * @brief std::shared_ptr like smart pointer that retains shared ownership of an asynchronous load
+ * of sprite tiles.
+ *
+ * Compressed tiles are uncompressed into an EWRAM staging buffer a few bytes per frame,
+ * spending at most bn::async_loads::max_ticks_per_frame timer ticks in each frame,
+ * and then they are copied to VRAM in V-Blank.
+ *
+ * The tiles are not copied but referenced, so they should outlive the sprite_tiles_async_load_ptr
+ * to avoid dangling references.
+ *
+ * @ingroup sprite
+ * @ingroup tile
+ */
+class sprite_tiles_async_load_ptr
+{
+
+public:
+    /**
+     * @brief Allocates sprite tiles in VRAM and starts loading the given tiles into them.
+     * @param tiles_item sprite_tiles_item which references the tiles to load.
+     * @return The requested sprite_tiles_async_load_ptr.
+     */
+    [[nodiscard]] static sprite_tiles_async_load_ptr create(const sprite_tiles_item& tiles_item);
+
+    /**
+     * @brief Allocates sprite tiles in VRAM and starts loading the given tiles into them.
+     * @param tiles_item sprite_tiles_item which references the tiles to load.
+     * @return The requested sprite_tiles_async_load_ptr if it could be allocated; bn::nullopt otherwise.
+     */
+    [[nodiscard]] static optional<sprite_tiles_async_load_ptr> create_optional(const sprite_tiles_item& tiles_item);
+
+    /**
+     * @brief Copy constructor.
+     * @param other sprite_tiles_async_load_ptr to copy.
+     */
+    sprite_tiles_async_load_ptr(const sprite_tiles_async_load_ptr& other);
+
+    /**
+     * @brief Copy assignment operator.
+     * @param other sprite_tiles_async_load_ptr to copy.
+     * @return Reference to this.
+     */
+    sprite_tiles_async_load_ptr& operator=(const sprite_tiles_async_load_ptr& other);
+
+    /**
+     * @brief Move constructor.
+     * @param other sprite_tiles_async_load_ptr to move.
+     */
+    sprite_tiles_async_load_ptr(sprite_tiles_async_load_ptr&& other) noexcept :
+        sprite_tiles_async_load_ptr(other._id)
+    {
+        other._id = -1;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other sprite_tiles_async_load_ptr to move.
+     * @return Reference to this.
+     */
+    sprite_tiles_async_load_ptr& operator=(sprite_tiles_async_load_ptr&& other) noexcept
+    {
+        bn::swap(_id, other._id);
+        return *this;
+    }
+
+    /**
+     * @brief Releases the referenced asynchronous load
+     * if no more sprite_tiles_async_load_ptr objects reference to it.
+     *
+     * If the load has not been finished yet, it is cancelled.
+     */
+    ~sprite_tiles_async_load_ptr()
+    {
+        if(_id >= 0)
+        {
+            _destroy();
+        }
+    }
+
+    /**
+     * @brief Returns the internal id.
+     */
+    [[nodiscard]] int id() const
+    {
+        return _id;
+    }
+
+    /**
+     * @brief Returns the sprite tiles in which the tiles are being loaded.
+     *
+     * Their content is undefined until done() returns <b>true</b>.
+     */
+    [[nodiscard]] const sprite_tiles_ptr& tiles() const;
+
+    /**
+     * @brief Indicates if the tiles have been uncompressed and copied to VRAM or not.
+     */
+    [[nodiscard]] bool done() const;
+
+    /**
+     * @brief Exchanges the contents of this sprite_tiles_async_load_ptr with those of the other one.
+     * @param other sprite_tiles_async_load_ptr to exchange the contents with.
+     */
+    void swap(sprite_tiles_async_load_ptr& other)
+    {
+        bn::swap(_id, other._id);
+    }
+
+    /**
+     * @brief Exchanges the contents of a sprite_tiles_async_load_ptr with those of another one.
+     * @param a First sprite_tiles_async_load_ptr to exchange the contents with.
+     * @param b Second sprite_tiles_async_load_ptr to exchange the contents with.
+     */
+    friend void swap(sprite_tiles_async_load_ptr& a, sprite_tiles_async_load_ptr& b)
+    {
+        bn::swap(a._id, b._id);
+    }
+
+    /**
+     * @brief Default equal operator.
+     */
+    [[nodiscard]] friend bool operator==(const sprite_tiles_async_load_ptr& a,
+                                         const sprite_tiles_async_load_ptr& b) = default;
+
+private:
+    int8_t _id;
+
+    explicit sprite_tiles_async_load_ptr(int id) :
+        _id(int8_t(id))
+    {
+    }
+
+    void _destroy();
+};
+
+}
+
+#endif
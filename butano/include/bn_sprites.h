@@ -13,6 +13,7 @@
  * @ingroup sprite
  */
 
+#include "bn_optional_fwd.h"
 #include "../hw/include/bn_hw_sprites_constants.h"
 
 /**
@@ -70,6 +71,30 @@ namespace bn::sprites
         return 32767;
     }
 
+    /**
+     * @brief Indicates if more than 128 sprites were on screen in the last update,
+     * so OAM entries are being reused by sprites further down the screen.
+     *
+     * Sprites multiplexing is enabled with @ref BN_CFG_SPRITES_MULTIPLEXING_ENABLED.
+     */
+    [[nodiscard]] bool multiplexing_active();
+
+    /**
+     * @brief Returns the number of on screen sprites that couldn't be displayed in the last update
+     * because no OAM entry could be reused for them.
+     *
+     * Sprites multiplexing is enabled with @ref BN_CFG_SPRITES_MULTIPLEXING_ENABLED.
+     */
+    [[nodiscard]] int multiplexing_dropped_items_count();
+
+    /**
+     * @brief Returns the first scanline which exceeded the sprite rendering cycles of the GBA in the last update
+     * (some sprites of this scanline are not displayed), or `nullopt` if there was none.
+     *
+     * It is only calculated while sprites multiplexing is active.
+     */
+    [[nodiscard]] optional<int> multiplexing_overloaded_scanline();
+
     /**
      * @brief Reloads the internal attributes of all sprites.
      *
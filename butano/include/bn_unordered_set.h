@@ -688,13 +688,22 @@ public:
         size_type current_index = index;
         size_type next_index = _index(index + 1);
 
-        while(allocated[next_index] && _index(hasher_functor(storage[next_index])) != next_index)
+        while(allocated[next_index])
         {
-            ::new(storage + current_index) value_type(move(storage[next_index]));
-            storage[next_index].~value_type();
-            allocated[current_index] = true;
-            allocated[next_index] = false;
-            current_index = next_index;
+            // Elements are moved back unless their home index is between the free index and their current index:
+            size_type next_home_index = _index(hasher_functor(storage[next_index]));
+            size_type home_distance = _index(next_index - next_home_index);
+            size_type free_distance = _index(next_index - current_index);
+
+            if(home_distance >= free_distance)
+            {
+                ::new(storage + current_index) value_type(move(storage[next_index]));
+                storage[next_index].~value_type();
+                allocated[current_index] = true;
+                allocated[next_index] = false;
+                current_index = next_index;
+            }
+
             next_index = _index(next_index + 1);
         }
 
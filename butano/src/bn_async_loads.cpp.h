@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_async_loads.h"
+
+#include "bn_async_loads_manager.h"
+
+namespace bn::async_loads
+{
+
+int used_count()
+{
+    return async_loads_manager::used_count();
+}
+
+int available_count()
+{
+    return async_loads_manager::available_count();
+}
+
+int max_ticks_per_frame()
+{
+    return async_loads_manager::max_ticks_per_frame();
+}
+
+void set_max_ticks_per_frame(int max_ticks_per_frame)
+{
+    async_loads_manager::set_max_ticks_per_frame(max_ticks_per_frame);
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_async_loads_manager.h"
+
+namespace bn::async_loads_manager
+{
+
+void _uncompress_impl(uncompress_state& state, int max_bytes)
+{
+    const uint8_t* source = state.source;
+    uint8_t* destination = state.destination;
+    uint8_t* destination_end = state.destination_end;
+    uint8_t* destination_limit = destination + max_bytes;
+
+    if(destination_limit > destination_end)
+    {
+        destination_limit = destination_end;
+    }
+
+    if(state.lz77)
+    {
+        unsigned flags = state.lz77_flags;
+        int flags_count = state.lz77_flags_count;
+
+        while(destination < destination_limit)
+        {
+            if(! flags_count)
+            {
+                flags = *source++;
+                flags_count = 8;
+            }
+
+            if(flags & 0x80)
+            {
+                unsigned first_byte = source[0];
+                unsigned second_byte = source[1];
+                source += 2;
+
+                const uint8_t* copy_source = destination - (((first_byte & 0xF) << 8) | second_byte) - 1;
+                int copy_bytes = int(first_byte >> 4) + 3;
+                int available_bytes = destination_end - destination;
+
+                if(copy_bytes > available_bytes)
+                {
+                    copy_bytes = available_bytes;
+                }
+
+                for(int index = 0; index < copy_bytes; ++index)
+                {
+                    destination[index] = copy_source[index];
+                }
+
+                destination += copy_bytes;
+            }
+            else
+            {
+                *destination++ = *source++;
+            }
+
+            flags <<= 1;
+            --flags_count;
+        }
+
+        state.lz77_flags = flags;
+        state.lz77_flags_count = flags_count;
+    }
+    else
+    {
+        while(destination < destination_limit)
+        {
+            unsigned flag = *source++;
+            int available_bytes = destination_end - destination;
+
+            if(flag & 0x80)
+            {
+                int run_bytes = int(flag & 0x7F) + 3;
+                uint8_t value = *source++;
+
+                if(run_bytes > available_bytes)
+                {
+                    run_bytes = available_bytes;
+                }
+
+                for(int index = 0; index < run_bytes; ++index)
+                {
+                    destination[index] = value;
+                }
+
+                destination += run_bytes;
+            }
+            else
+            {
+                int literal_bytes = int(flag & 0x7F) + 1;
+                int copy_bytes = literal_bytes;
+
+                if(copy_bytes > available_bytes)
+                {
+                    copy_bytes = available_bytes;
+                }
+
+                for(int index = 0; index < copy_bytes; ++index)
+                {
+                    destination[index] = source[index];
+                }
+
+                source += literal_bytes;
+                destination += copy_bytes;
+            }
+        }
+    }
+
+    state.source = source;
+    state.destination = destination;
+}
+
+}
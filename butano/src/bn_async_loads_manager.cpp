@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_async_loads_manager.h"
+
+#include "bn_span.h"
+#include "bn_algorithm.h"
+#include "bn_timer.h"
+#include "bn_memory.h"
+#include "bn_vector.h"
+#include "bn_optional.h"
+#include "bn_compression_type.h"
+#include "bn_sprite_tiles_ptr.h"
+#include "bn_regular_bg_tiles_ptr.h"
+#include "bn_config_async_loads.h"
+#include "../hw/include/bn_hw_memory.h"
+
+#include "bn_async_loads.cpp.h"
+#include "bn_sprite_tiles_async_load_ptr.cpp.h"
+#include "bn_regular_bg_tiles_async_load_ptr.cpp.h"
+
+namespace bn::async_loads_manager
+{
+
+namespace
+{
+    static_assert(BN_CFG_ASYNC_LOADS_MAX_ITEMS > 0 && BN_CFG_ASYNC_LOADS_MAX_ITEMS <= 127);
+    static_assert(BN_CFG_ASYNC_LOADS_MAX_TICKS_PER_FRAME >= 0);
+
+
+    constexpr const int max_items = BN_CFG_ASYNC_LOADS_MAX_ITEMS;
+    constexpr const int bytes_per_step = 256;
+    constexpr const int commit_words_per_step = 256;
+
+
+    class item_type
+    {
+
+    public:
+        uncompress_state state;
+        optional<sprite_tiles_ptr> sprite_tiles;
+        optional<regular_bg_tiles_ptr> regular_bg_tiles;
+        const void* commit_source = nullptr;
+        void* vram = nullptr;
+        uint8_t* staging = nullptr;
+        int bytes = 0;
+        int committed_words = 0;
+        unsigned usages = 0;
+        bool uncompressed = false;
+        bool committed = false;
+    };
+
+
+    class static_data
+    {
+
+    public:
+        item_type items[max_items];
+        vector<int8_t, max_items> free_item_indexes;
+        vector<int8_t, max_items> pending_item_indexes;
+        int max_ticks_per_frame = BN_CFG_ASYNC_LOADS_MAX_TICKS_PER_FRAME;
+        bool check_commit = false;
+    };
+
+    BN_DATA_EWRAM static_data data;
+
+
+    [[nodiscard]] int _uncompressed_bytes(const void* source_ptr)
+    {
+        auto source_bytes = static_cast<const uint8_t*>(source_ptr);
+        return int(source_bytes[1]) | (int(source_bytes[2]) << 8) | (int(source_bytes[3]) << 16);
+    }
+
+    [[nodiscard]] int _create_impl(const void* source_ptr, compression_type compression, int bytes,
+                                   void* vram, bool optional)
+    {
+        if(data.free_item_indexes.empty())
+        {
+            BN_ASSERT(optional, "No more async loads available");
+
+            return -1;
+        }
+
+        int id = data.free_item_indexes.back();
+        item_type& item = data.items[id];
+        item.vram = vram;
+        item.usages = 1;
+
+        if(compression == compression_type::NONE)
+        {
+            item.commit_source = source_ptr;
+            item.bytes = bytes;
+            item.uncompressed = true;
+            data.check_commit = true;
+        }
+        else
+        {
+            int uncompressed_bytes = _uncompressed_bytes(source_ptr);
+            BN_ASSERT(uncompressed_bytes <= bytes, "Invalid uncompressed bytes: ", uncompressed_bytes, " - ", bytes);
+
+            auto staging = static_cast<uint8_t*>(memory::ewram_alloc(uncompressed_bytes));
+
+            if(! staging)
+            {
+                BN_ASSERT(optional, "Staging buffer allocation failed: ", uncompressed_bytes);
+
+                return -1;
+            }
+
+            uncompress_state& state = item.state;
+            state.source = static_cast<const uint8_t*>(source_ptr) + 4;
+            state.destination = staging;
+            state.destination_end = staging + uncompressed_bytes;
+            state.lz77_flags = 0;
+            state.lz77_flags_count = 0;
+            state.lz77 = compression == compression_type::LZ77;
+            item.commit_source = staging;
+            item.staging = staging;
+            item.bytes = uncompressed_bytes;
+            item.uncompressed = false;
+            data.pending_item_indexes.push_back(int8_t(id));
+        }
+
+        data.free_item_indexes.pop_back();
+        return id;
+    }
+
+    [[nodiscard]] void* _vram(item_type& item)
+    {
+        // Sprite tiles can be moved by sprite_tiles::defragment:
+        if(optional<sprite_tiles_ptr>& sprite_tiles = item.sprite_tiles)
+        {
+            return sprite_tiles->vram()->data();
+        }
+
+        // Regular BG tiles can be moved by bg_tiles::defragment:
+        if(optional<regular_bg_tiles_ptr>& regular_bg_tiles = item.regular_bg_tiles)
+        {
+            return regular_bg_tiles->vram()->data();
+        }
+
+        return item.vram;
+    }
+
+    void _release_staging(item_type& item)
+    {
+        if(item.staging)
+        {
+            memory::ewram_free(item.staging);
+            item.staging = nullptr;
+        }
+    }
+}
+
+void init()
+{
+    for(int index = max_items - 1; index >= 0; --index)
+    {
+        data.free_item_indexes.push_back(int8_t(index));
+    }
+}
+
+int used_count()
+{
+    return data.free_item_indexes.available();
+}
+
+int available_count()
+{
+    return data.free_item_indexes.size();
+}
+
+int max_ticks_per_frame()
+{
+    return data.max_ticks_per_frame;
+}
+
+void set_max_ticks_per_frame(int max_ticks_per_frame)
+{
+    BN_ASSERT(max_ticks_per_frame >= 0, "Invalid max ticks per frame: ", max_ticks_per_frame);
+
+    data.max_ticks_per_frame = max_ticks_per_frame;
+}
+
+int create(const void* source_ptr, compression_type compression, int bytes, sprite_tiles_ptr&& tiles,
+           bool optional)
+{
+    auto vram = tiles.vram();
+    BN_ASSERT(vram, "Sprite tiles must be allocated");
+    BN_ASSERT(vram->size_bytes() >= bytes, "Not enough allocated sprite tiles: ", vram->size_bytes(), " - ", bytes);
+
+    int result = _create_impl(source_ptr, compression, bytes, vram->data(), optional);
+
+    if(result >= 0)
+    {
+        data.items[result].sprite_tiles = move(tiles);
+    }
+
+    return result;
+}
+
+int create(const void* source_ptr, compression_type compression, int bytes, regular_bg_tiles_ptr&& tiles,
+           bool optional)
+{
+    auto vram = tiles.vram();
+    BN_ASSERT(vram, "Regular BG tiles must be allocated");
+    BN_ASSERT(vram->size_bytes() >= bytes, "Not enough allocated regular BG tiles: ", vram->size_bytes(), " - ", bytes);
+
+    int result = _create_impl(source_ptr, compression, bytes, vram->data(), optional);
+
+    if(result >= 0)
+    {
+        data.items[result].regular_bg_tiles = move(tiles);
+    }
+
+    return result;
+}
+
+void increase_usages(int id)
+{
+    item_type& item = data.items[id];
+    ++item.usages;
+}
+
+void decrease_usages(int id)
+{
+    item_type& item = data.items[id];
+    --item.usages;
+
+    if(! item.usages)
+    {
+        if(! item.uncompressed)
+        {
+            auto pending_item_indexes_it = find(data.pending_item_indexes.begin(), data.pending_item_indexes.end(),
+                                                int8_t(id));
+            data.pending_item_indexes.erase(pending_item_indexes_it);
+        }
+
+        _release_staging(item);
+        item.sprite_tiles.reset();
+        item.regular_bg_tiles.reset();
+        item.commit_source = nullptr;
+        item.vram = nullptr;
+        item.committed_words = 0;
+        item.uncompressed = false;
+        item.committed = false;
+        data.free_item_indexes.push_back(int8_t(id));
+    }
+}
+
+const sprite_tiles_ptr& sprite_tiles(int id)
+{
+    return *data.items[id].sprite_tiles;
+}
+
+const regular_bg_tiles_ptr& regular_bg_tiles(int id)
+{
+    return *data.items[id].regular_bg_tiles;
+}
+
+bool done(int id)
+{
+    return data.items[id].committed;
+}
+
+void update()
+{
+    if(! data.pending_item_indexes.empty())
+    {
+        timer update_timer;
+        int max_ticks = data.max_ticks_per_frame;
+
+        // At least one step is done in each frame so all items are uncompressed eventually:
+        do
+        {
+            item_type& item = data.items[data.pending_item_indexes.front()];
+            uncompress_state& state = item.state;
+            _uncompress_impl(state, bytes_per_step);
+
+            if(state.destination == state.destination_end)
+            {
+                item.uncompressed = true;
+                data.check_commit = true;
+                data.pending_item_indexes.erase(data.pending_item_indexes.begin());
+
+                if(data.pending_item_indexes.empty())
+                {
+                    break;
+                }
+            }
+        }
+        while(update_timer.elapsed_ticks() < max_ticks);
+    }
+}
+
+int commit(int max_ticks)
+{
+    int deferred_bytes = 0;
+
+    if(data.check_commit)
+    {
+        timer commit_timer;
+        bool chunk_committed = false;
+        data.check_commit = false;
+
+        for(item_type& item : data.items)
+        {
+            if(item.usages && item.uncompressed && ! item.committed)
+            {
+                int words = (item.bytes + 3) / 4;
+                int committed_words = item.committed_words;
+
+                // Items are copied in chunks so big ones don't overrun V-Blank,
+                // and at least one chunk is copied in each frame so all of them are committed eventually:
+                while(committed_words < words && (! chunk_committed || commit_timer.elapsed_ticks() < max_ticks))
+                {
+                    int chunk_words = min(words - committed_words, commit_words_per_step);
+                    auto source = static_cast<const uint32_t*>(item.commit_source) + committed_words;
+                    auto destination = static_cast<uint32_t*>(_vram(item)) + committed_words;
+                    hw::memory::copy_words(source, chunk_words, destination);
+                    committed_words += chunk_words;
+                    chunk_committed = true;
+                }
+
+                if(committed_words == words)
+                {
+                    _release_staging(item);
+                    item.commit_source = nullptr;
+                    item.committed_words = 0;
+                    item.committed = true;
+                }
+                else
+                {
+                    item.committed_words = committed_words;
+                    deferred_bytes += (words - committed_words) * 4;
+                    data.check_commit = true;
+                }
+            }
+        }
+    }
+
+    return deferred_bytes;
+}
+
+}
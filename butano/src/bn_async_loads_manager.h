@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_ASYNC_LOADS_MANAGER_H
+#define BN_ASYNC_LOADS_MANAGER_H
+
+#include "bn_common.h"
+
+namespace bn
+{
+    class sprite_tiles_ptr;
+    class regular_bg_tiles_ptr;
+    enum class compression_type : uint8_t;
+}
+
+namespace bn::async_loads_manager
+{
+    class uncompress_state
+    {
+
+    public:
+        const uint8_t* source = nullptr;
+        uint8_t* destination = nullptr;
+        uint8_t* destination_end = nullptr;
+        unsigned lz77_flags = 0;
+        int lz77_flags_count = 0;
+        bool lz77 = false;
+    };
+
+    void init();
+
+    [[nodiscard]] int used_count();
+
+    [[nodiscard]] int available_count();
+
+    [[nodiscard]] int max_ticks_per_frame();
+
+    void set_max_ticks_per_frame(int max_ticks_per_frame);
+
+    [[nodiscard]] int create(const void* source_ptr, compression_type compression, int bytes,
+                             sprite_tiles_ptr&& tiles, bool optional);
+
+    [[nodiscard]] int create(const void* source_ptr, compression_type compression, int bytes,
+                             regular_bg_tiles_ptr&& tiles, bool optional);
+
+    void increase_usages(int id);
+
+    void decrease_usages(int id);
+
+    [[nodiscard]] const sprite_tiles_ptr& sprite_tiles(int id);
+
+    [[nodiscard]] const regular_bg_tiles_ptr& regular_bg_tiles(int id);
+
+    [[nodiscard]] bool done(int id);
+
+    void update();
+
+    [[nodiscard]] int commit(int max_ticks);
+
+    BN_CODE_IWRAM void _uncompress_impl(uncompress_state& state, int max_bytes);
+}
+
+#endif
@@ -312,6 +312,11 @@ void disable_vblank_handler()
     hw::audio::disable_vblank_handler();
 }
 
+void mix()
+{
+    hw::audio::mix();
+}
+
 void commit()
 {
     hw::audio::commit();
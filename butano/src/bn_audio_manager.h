@@ -52,6 +52,8 @@ namespace bn::audio_manager
 
     void disable_vblank_handler();
 
+    void mix();
+
     void commit();
 
     void stop();
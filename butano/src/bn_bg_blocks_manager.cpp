@@ -5,6 +5,7 @@
 
 #include "bn_bg_blocks_manager.h"
 
+#include "bn_timer.h"
 #include "bn_vector.h"
 #include "bn_bgs_manager.h"
 #include "bn_unordered_map.h"
@@ -103,6 +104,48 @@ namespace
     }
 
 
+    [[nodiscard]] constexpr int _regular_tiles_offset(int tiles_start_block, bpp_mode bpp)
+    {
+        int offset_blocks_count = tiles_start_block % hw::bg_blocks::tiles_alignment_blocks_count();
+        int result = _blocks_to_tiles(offset_blocks_count);
+
+        if(bpp == bpp_mode::BPP_8)
+        {
+            result /= 2;
+        }
+
+        return result;
+    }
+
+    [[nodiscard]] constexpr int _affine_tiles_offset(int tiles_start_block)
+    {
+        int offset_blocks_count = tiles_start_block % hw::bg_blocks::tiles_alignment_blocks_count();
+        return _blocks_to_tiles(offset_blocks_count) / 2;
+    }
+
+
+    [[nodiscard]] constexpr int _metatile_shift(int metatile_size)
+    {
+        return metatile_size == 4 ? 2 : 1;
+    }
+
+    [[nodiscard]] const uint16_t* _regular_map_data_ptr(const regular_bg_map_item& map_item)
+    {
+        // Metatile cells can be shared by multiple maps, so metatile indexes are used to identify them:
+        if(const uint8_t* metatile_byte_indexes_ptr = map_item.metatile_byte_indexes_ptr())
+        {
+            return reinterpret_cast<const uint16_t*>(metatile_byte_indexes_ptr);
+        }
+
+        if(const uint16_t* metatile_half_word_indexes_ptr = map_item.metatile_half_word_indexes_ptr())
+        {
+            return metatile_half_word_indexes_ptr;
+        }
+
+        return &map_item.cells_ref();
+    }
+
+
     constexpr const int max_items = BN_CFG_BG_BLOCKS_MAX_ITEMS;
     constexpr const int max_list_items = max_items + 1;
 
@@ -127,7 +170,8 @@ namespace
     {
 
     public:
-        const uint16_t* data = nullptr;
+        const uint16_t* data = nullptr; // If metatile_cells != nullptr, it stores the metatile indexes.
+        const uint16_t* metatile_cells = nullptr;
         unsigned usages = 0;
         optional<regular_bg_tiles_ptr> regular_tiles;
         optional<affine_bg_tiles_ptr> affine_tiles;
@@ -137,6 +181,7 @@ namespace
         uint8_t start_block = 0;
         uint8_t blocks_count = 0;
         uint8_t next_index = max_list_items;
+        uint8_t metatile_shift = 0;
 
     private:
         unsigned _status: 2 = unsigned(status_type::FREE);
@@ -146,6 +191,7 @@ namespace
         bool is_tiles: 1 = false;
         bool is_affine: 1 = false;
         bool commit: 1 = false;
+        bool byte_metatile_indexes: 1 = false;
 
         [[nodiscard]] status_type status() const
         {
@@ -174,23 +220,12 @@ namespace
 
         [[nodiscard]] int regular_tiles_offset() const
         {
-            int tiles_start_block = regular_tiles->id();
-            int offset_blocks_count = tiles_start_block % hw::bg_blocks::tiles_alignment_blocks_count();
-            int result = _blocks_to_tiles(offset_blocks_count);
-
-            if(palette->bpp() == bpp_mode::BPP_8)
-            {
-                result /= 2;
-            }
-
-            return result;
+            return _regular_tiles_offset(regular_tiles->id(), palette->bpp());
         }
 
         [[nodiscard]] int affine_tiles_offset() const
         {
-            int tiles_start_block = affine_tiles->id();
-            int offset_blocks_count = tiles_start_block % hw::bg_blocks::tiles_alignment_blocks_count();
-            return _blocks_to_tiles(offset_blocks_count) / 2;
+            return _affine_tiles_offset(affine_tiles->id());
         }
 
         [[nodiscard]] int palette_offset() const
@@ -352,6 +387,9 @@ namespace
         bpp_mode bpp;
         compression_type compression;
         bool is_affine;
+        const uint16_t* metatile_cells_ptr = nullptr;
+        int metatile_shift = 0;
+        bool byte_metatile_indexes = false;
 
         static create_data from_regular_tiles(const uint16_t* data_ptr, int half_words, bpp_mode bpp,
                                               compression_type compression)
@@ -381,6 +419,22 @@ namespace
                         bpp, compression, false };
         }
 
+        static create_data from_regular_map_item(
+                const regular_bg_map_item& map_item, regular_bg_tiles_ptr&& tiles, bg_palette_ptr&& palette)
+        {
+            create_data result = from_regular_map(_regular_map_data_ptr(map_item), map_item.dimensions(),
+                                                  map_item.compression(), move(tiles), move(palette));
+
+            if(map_item.metatiles())
+            {
+                result.metatile_cells_ptr = &map_item.cells_ref();
+                result.metatile_shift = _metatile_shift(map_item.metatile_size());
+                result.byte_metatile_indexes = map_item.metatile_byte_indexes_ptr();
+            }
+
+            return result;
+        }
+
         static create_data from_affine_map(
                 const uint16_t* data_ptr, const size& dimensions, compression_type compression,
                 affine_bg_tiles_ptr&& tiles, bg_palette_ptr&& palette)
@@ -396,16 +450,28 @@ namespace
     };
 
 
+    class relocation_type
+    {
+
+    public:
+        uint8_t id;
+        uint8_t old_start_block;
+        int16_t tiles_offset_increment;
+    };
+
+
     class static_data
     {
 
     public:
         items_list items;
         unordered_map<const void*, int, max_items * 2> items_map;
+        vector<relocation_type, max_items> relocations;
         int free_blocks_count = 0;
         int to_remove_blocks_count = 0;
         bool check_commit = false;
         bool delay_commit = false;
+        bool defragment = false;
     };
 
     BN_DATA_EWRAM static_data data;
@@ -549,7 +615,7 @@ namespace
     [[nodiscard]] int _find_regular_map_impl(const regular_bg_map_item& map_item, const regular_bg_tiles_ptr& tiles,
                                              const bg_palette_ptr& palette)
     {
-        const regular_bg_map_cell* data_ptr = &map_item.cells_ref();
+        const uint16_t* data_ptr = _regular_map_data_ptr(map_item);
         auto items_map_iterator = data.items_map.find(data_ptr);
 
         if(items_map_iterator != data.items_map.end())
@@ -564,6 +630,9 @@ namespace
                       "Map compression does not match item map compression: ",
                       int(map_item.compression()), " - ", int(item.compression()));
             BN_ASSERT(! item.is_affine, "Item is an affine map");
+            BN_ASSERT(! map_item.metatiles() || &map_item.cells_ref() == item.metatile_cells,
+                      "Metatile cells do not match item metatile cells: ",
+                      &map_item.cells_ref(), " - ", item.metatile_cells);
             BN_ASSERT(! item.regular_tiles || tiles == *item.regular_tiles,
                       "Tiles does not match item tiles: ", tiles.id(), " - ", item.regular_tiles->id());
             BN_ASSERT(! item.palette || palette == *item.palette,
@@ -667,6 +736,107 @@ namespace
         return -1;
     }
 
+    [[nodiscard]] unsigned _metatile_index(const item_type& item, int metatile_index_offset)
+    {
+        if(item.byte_metatile_indexes)
+        {
+            return reinterpret_cast<const uint8_t*>(item.data)[metatile_index_offset];
+        }
+
+        return item.data[metatile_index_offset];
+    }
+
+    void _copy_regular_metatile_map_col(const item_type& item, int x, int y, int rows, uint16_t* vram_data)
+    {
+        int metatile_shift = item.metatile_shift;
+        int metatile_mask = (1 << metatile_shift) - 1;
+        int metatiles_width = item.width >> metatile_shift;
+        const uint16_t* metatile_cells = item.metatile_cells + (x & metatile_mask);
+        auto tiles_offset = unsigned(item.regular_tiles_offset());
+        auto palette_offset = unsigned(item.palette_offset());
+        vram_data += x & 31;
+
+        for(int row = y, row_limit = y + rows; row < row_limit; ++row)
+        {
+            unsigned metatile_index = _metatile_index(item, ((row >> metatile_shift) * metatiles_width) +
+                                                      (x >> metatile_shift));
+            int metatile_cell_offset = int(metatile_index << (metatile_shift * 2)) +
+                    ((row & metatile_mask) << metatile_shift);
+            hw::bg_blocks::copy_regular_bg_map_cell_offset(metatile_cells[metatile_cell_offset], tiles_offset,
+                                                           palette_offset, vram_data[(row & 31) * 32]);
+        }
+    }
+
+    void _copy_regular_metatile_map_row(const item_type& item, int x, int y, int columns, uint16_t* vram_data)
+    {
+        int metatile_shift = item.metatile_shift;
+        int metatile_mask = (1 << metatile_shift) - 1;
+        int metatile_indexes_offset = (y >> metatile_shift) * (item.width >> metatile_shift);
+        const uint16_t* metatile_cells = item.metatile_cells + ((y & metatile_mask) << metatile_shift);
+        auto tiles_offset = unsigned(item.regular_tiles_offset());
+        auto palette_offset = unsigned(item.palette_offset());
+        vram_data += (y & 31) * 32;
+
+        for(int column = x, column_limit = x + columns; column < column_limit; ++column)
+        {
+            unsigned metatile_index = _metatile_index(item, metatile_indexes_offset + (column >> metatile_shift));
+            int metatile_cell_offset = int(metatile_index << (metatile_shift * 2)) + (column & metatile_mask);
+            hw::bg_blocks::copy_regular_bg_map_cell_offset(metatile_cells[metatile_cell_offset], tiles_offset,
+                                                           palette_offset, vram_data[column & 31]);
+        }
+    }
+
+    void _commit_regular_metatile_map(const item_type& item)
+    {
+        uint16_t* vram_data = hw::bg_blocks::vram(item.start_block);
+
+        // Not big maps are stored in screenblock order:
+        for(int block_y = 0, height = item.height; block_y < height; block_y += 32)
+        {
+            for(int block_x = 0, width = item.width; block_x < width; block_x += 32)
+            {
+                for(int row = block_y, row_limit = block_y + 32; row < row_limit; ++row)
+                {
+                    _copy_regular_metatile_map_row(item, block_x, row, 32, vram_data);
+                }
+
+                vram_data += 32 * 32;
+            }
+        }
+    }
+
+    [[nodiscard]] int _commit_item_bytes(const item_type& item)
+    {
+        if(! item.data)
+        {
+            return 0;
+        }
+
+        if(item.is_tiles)
+        {
+            return int(item.width) * 2;
+        }
+
+        if(item.is_affine)
+        {
+            // Big maps are committed from bgs_manager:
+            if(_big_affine_map(item.width, item.height))
+            {
+                return 0;
+            }
+
+            return item.width * item.height;
+        }
+
+        // Big maps are committed from bgs_manager:
+        if(_big_regular_map(item.width, item.height))
+        {
+            return 0;
+        }
+
+        return item.width * item.height * 2;
+    }
+
     void _commit_item(const item_type& item)
     {
         const uint16_t* source_data_ptr = item.data;
@@ -724,6 +894,12 @@ namespace
                 return;
             }
 
+            if(item.metatile_cells)
+            {
+                _commit_regular_metatile_map(item);
+                return;
+            }
+
             compression_type compression = item.compression();
             uint16_t* destination_vram_ptr = hw::bg_blocks::vram(item.start_block);
             auto tiles_offset = unsigned(item.regular_tiles_offset());
@@ -878,6 +1054,9 @@ namespace
         item->is_tiles = is_tiles;
         item->is_affine = create_data.is_affine;
         item->commit = false;
+        item->metatile_cells = create_data.metatile_cells_ptr;
+        item->metatile_shift = uint8_t(create_data.metatile_shift);
+        item->byte_metatile_indexes = create_data.byte_metatile_indexes;
 
         if(data_ptr)
         {
@@ -919,6 +1098,97 @@ namespace
         return result;
     }
 
+    [[nodiscard]] bool _remove_adjacent_item(int adjacent_id, item_type& current_item)
+    {
+        const item_type& adjacent_item = data.items.item(adjacent_id);
+        status_type adjacent_item_status = adjacent_item.status();
+        bool remove = adjacent_item_status != status_type::USED;
+
+        if(remove)
+        {
+            current_item.blocks_count += adjacent_item.blocks_count;
+
+            if(adjacent_item_status == status_type::TO_REMOVE)
+            {
+                if(adjacent_item.data)
+                {
+                    data.items_map.erase(adjacent_item.data);
+                }
+
+                data.free_blocks_count += adjacent_item.blocks_count;
+            }
+        }
+
+        return remove;
+    }
+
+    void _update_to_remove_items()
+    {
+        if(data.to_remove_blocks_count)
+        {
+            BN_BG_BLOCKS_LOG("bg_blocks_manager - UPDATE");
+
+            auto end = data.items.end();
+            auto before_previous_iterator = end;
+            auto previous_iterator = data.items.before_begin();
+            auto iterator = previous_iterator;
+            ++iterator;
+            data.to_remove_blocks_count = 0;
+
+            while(iterator != end)
+            {
+                item_type& item = *iterator;
+
+                if(item.status() == status_type::TO_REMOVE)
+                {
+                    if(item.data)
+                    {
+                        data.items_map.erase(item.data);
+                    }
+
+                    item.data = nullptr;
+                    item.metatile_cells = nullptr;
+                    item.width = 0;
+                    item.height = 0;
+                    item.set_status(status_type::FREE);
+                    item.commit = false;
+                    data.free_blocks_count += item.blocks_count;
+
+                    auto next_iterator = iterator;
+                    ++next_iterator;
+
+                    while(next_iterator != end)
+                    {
+                        if(_remove_adjacent_item(next_iterator.id(), item))
+                        {
+                            next_iterator = data.items.erase_after(iterator.id());
+                        }
+                        else
+                        {
+                            break;
+                        }
+                    }
+
+                    if(before_previous_iterator != end)
+                    {
+                        if(_remove_adjacent_item(previous_iterator.id(), item))
+                        {
+                            item.start_block = previous_iterator->start_block;
+                            data.items.erase_after(before_previous_iterator.id());
+                            previous_iterator = before_previous_iterator;
+                        }
+                    }
+                }
+
+                before_previous_iterator = previous_iterator;
+                previous_iterator = iterator;
+                ++iterator;
+            }
+
+            BN_BG_BLOCKS_LOG_STATUS();
+        }
+    }
+
     template<create_type create_type>
     [[nodiscard]] int _create_impl(create_data&& create_data)
     {
@@ -987,7 +1257,7 @@ namespace
 
         if(to_remove_blocks_count)
         {
-            update();
+            _update_to_remove_items();
             data.delay_commit = true;
             return _create_impl<create_type>(move(create_data));
         }
@@ -1047,28 +1317,256 @@ namespace
         return -1;
     }
 
-    [[nodiscard]] bool _remove_adjacent_item(int adjacent_id, item_type& current_item)
+    [[nodiscard]] bool _big_map(const item_type& item)
     {
-        const item_type& adjacent_item = data.items.item(adjacent_id);
-        status_type adjacent_item_status = adjacent_item.status();
-        bool remove = adjacent_item_status != status_type::USED;
+        if(item.is_affine)
+        {
+            return _big_affine_map(item.width, item.height);
+        }
 
-        if(remove)
+        return _big_regular_map(item.width, item.height);
+    }
+
+    relocation_type& _relocation(int id, int old_start_block)
+    {
+        for(relocation_type& relocation : data.relocations)
         {
-            current_item.blocks_count += adjacent_item.blocks_count;
+            if(relocation.id == id)
+            {
+                return relocation;
+            }
+        }
 
-            if(adjacent_item_status == status_type::TO_REMOVE)
+        data.relocations.push_back(relocation_type{ uint8_t(id), uint8_t(old_start_block), 0 });
+        return data.relocations.back();
+    }
+
+    void _update_moved_tiles_maps(int tiles_id, int old_tiles_start_block)
+    {
+        const item_type& tiles_item = data.items.item(tiles_id);
+        int alignment_blocks_count = hw::bg_blocks::tiles_alignment_blocks_count();
+        int old_tiles_cbb = old_tiles_start_block / alignment_blocks_count;
+        int new_tiles_cbb = tiles_item.start_block / alignment_blocks_count;
+
+        for(auto iterator = data.items.begin(), end = data.items.end(); iterator != end; ++iterator)
+        {
+            item_type& item = *iterator;
+
+            if(item.status() != status_type::USED || item.is_tiles)
             {
-                if(adjacent_item.data)
+                continue;
+            }
+
+            int old_tiles_offset;
+            int new_tiles_offset;
+
+            if(item.is_affine)
+            {
+                if(! item.affine_tiles || item.affine_tiles->handle() != tiles_id)
                 {
-                    data.items_map.erase(adjacent_item.data);
+                    continue;
                 }
 
-                data.free_blocks_count += adjacent_item.blocks_count;
+                if(old_tiles_cbb != new_tiles_cbb)
+                {
+                    bgs_manager::update_affine_map_tiles_cbb(item.start_block, new_tiles_cbb);
+                }
+
+                old_tiles_offset = _affine_tiles_offset(old_tiles_start_block);
+                new_tiles_offset = item.affine_tiles_offset();
+            }
+            else
+            {
+                if(! item.regular_tiles || item.regular_tiles->handle() != tiles_id)
+                {
+                    continue;
+                }
+
+                if(old_tiles_cbb != new_tiles_cbb)
+                {
+                    bgs_manager::update_regular_map_tiles_cbb(item.start_block, new_tiles_cbb);
+                }
+
+                old_tiles_offset = _regular_tiles_offset(old_tiles_start_block, item.palette->bpp());
+                new_tiles_offset = item.regular_tiles_offset();
+            }
+
+            if(int tiles_offset_increment = new_tiles_offset - old_tiles_offset)
+            {
+                if(_big_map(item))
+                {
+                    // Big maps are committed from bgs_manager:
+                    item.commit = true;
+                    data.check_commit = true;
+                }
+                else
+                {
+                    relocation_type& relocation = _relocation(iterator.id(), item.start_block);
+                    relocation.tiles_offset_increment = int16_t(
+                                relocation.tiles_offset_increment + tiles_offset_increment);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] bool _move_item(int previous_id, int free_id, int id)
+    {
+        item_type& free_item = data.items.item(free_id);
+        item_type& item = data.items.item(id);
+        int free_start_block = free_item.start_block;
+        int old_start_block = item.start_block;
+        int padding_blocks_count = 0;
+
+        if(item.is_tiles)
+        {
+            // Regular tiles bpp is unknown, so the BPP_4 alignment (the most restrictive one) is used:
+            if(item.is_affine)
+            {
+                padding_blocks_count = _padding_blocks_count<create_type::AFFINE_TILES>(
+                            free_start_block, item.blocks_count, bpp_mode::BPP_8);
+            }
+            else
+            {
+                padding_blocks_count = _padding_blocks_count<create_type::REGULAR_TILES>(
+                            free_start_block, item.blocks_count, bpp_mode::BPP_4);
+            }
+        }
+
+        int new_start_block = free_start_block + padding_blocks_count;
+
+        if(new_start_block >= old_start_block)
+        {
+            return false;
+        }
+
+        int next_id = item.next_index;
+        bool next_free = next_id != max_list_items && data.items.item(next_id).status() == status_type::FREE;
+
+        if(padding_blocks_count && ! next_free && data.items.full())
+        {
+            return false;
+        }
+
+        int moved_blocks_count = old_start_block - new_start_block;
+
+        if(padding_blocks_count)
+        {
+            free_item.blocks_count = uint8_t(padding_blocks_count);
+        }
+        else
+        {
+            data.items.erase_after(previous_id);
+        }
+
+        item.start_block = uint8_t(new_start_block);
+
+        if(next_free)
+        {
+            item_type& next_item = data.items.item(next_id);
+            next_item.start_block -= uint8_t(moved_blocks_count);
+            next_item.blocks_count += uint8_t(moved_blocks_count);
+        }
+        else
+        {
+            item_type new_free_item;
+            new_free_item.start_block = uint8_t(new_start_block + item.blocks_count);
+            new_free_item.blocks_count = uint8_t(moved_blocks_count);
+            data.items.insert_after(id, new_free_item);
+        }
+
+        if(item.is_tiles)
+        {
+            _update_moved_tiles_maps(id, old_start_block);
+        }
+        else
+        {
+            if(item.is_affine)
+            {
+                bgs_manager::update_affine_map_sbb(new_start_block);
+            }
+            else
+            {
+                bgs_manager::update_regular_map_sbb(new_start_block);
+            }
+
+            if(_big_map(item))
+            {
+                // Big maps are committed from bgs_manager:
+                item.commit = true;
+                data.check_commit = true;
+            }
+        }
+
+        if(item.is_tiles || ! _big_map(item))
+        {
+            // Moved items must be copied in the same order they have been moved:
+            relocation_type relocation{ uint8_t(id), uint8_t(old_start_block), 0 };
+
+            for(auto iterator = data.relocations.begin(), end = data.relocations.end(); iterator != end; ++iterator)
+            {
+                if(iterator->id == id)
+                {
+                    relocation.tiles_offset_increment = iterator->tiles_offset_increment;
+                    data.relocations.erase(iterator);
+                    break;
+                }
+            }
+
+            data.relocations.push_back(relocation);
+        }
+
+        return true;
+    }
+
+    void _defragment_step()
+    {
+        BN_BG_BLOCKS_LOG("bg_blocks_manager - DEFRAGMENT STEP");
+
+        int max_moved_blocks_count = BN_CFG_BG_BLOCKS_DEFRAGMENT_MAX_BLOCKS;
+        int moved_blocks_count = 0;
+        auto end = data.items.end();
+        auto previous_iterator = data.items.before_begin();
+        auto iterator = data.items.begin();
+
+        while(iterator != end)
+        {
+            auto next_iterator = iterator;
+            ++next_iterator;
+
+            if(next_iterator == end)
+            {
+                break;
+            }
+
+            if(iterator->status() == status_type::FREE && next_iterator->status() == status_type::USED)
+            {
+                int next_blocks_count = next_iterator->blocks_count;
+
+                if(_move_item(previous_iterator.id(), iterator.id(), next_iterator.id()))
+                {
+                    moved_blocks_count += next_blocks_count;
+
+                    // The item after the moved one is always free:
+                    previous_iterator = next_iterator;
+                    iterator = next_iterator;
+                    ++iterator;
+
+                    if(moved_blocks_count >= max_moved_blocks_count)
+                    {
+                        BN_BG_BLOCKS_LOG_STATUS();
+                        return;
+                    }
+
+                    continue;
+                }
             }
+
+            previous_iterator = iterator;
+            iterator = next_iterator;
         }
 
-        return remove;
+        data.defragment = false;
+        BN_BG_BLOCKS_LOG_STATUS();
     }
 }
 
@@ -1145,6 +1643,43 @@ int available_map_blocks_count()
     return data.free_blocks_count;
 }
 
+int largest_available_tiles_count()
+{
+    return _blocks_to_tiles(largest_available_blocks_count());
+}
+
+int largest_available_map_cells_count()
+{
+    return _blocks_to_half_words(largest_available_blocks_count());
+}
+
+int largest_available_blocks_count()
+{
+    int result = 0;
+
+    for(const item_type& item : data.items)
+    {
+        if(item.status() == status_type::FREE)
+        {
+            result = max(result, int(item.blocks_count));
+        }
+    }
+
+    return result;
+}
+
+void defragment()
+{
+    BN_BG_BLOCKS_LOG("bg_blocks_manager - DEFRAGMENT");
+
+    data.defragment = true;
+}
+
+bool defragmenting()
+{
+    return data.defragment;
+}
+
 #if BN_CFG_LOG_ENABLED
     void log_status()
     {
@@ -1228,7 +1763,7 @@ int find_affine_tiles(const affine_bg_tiles_item& tiles_item)
 int find_regular_map(const regular_bg_map_item& map_item, const regular_bg_tiles_ptr& tiles,
                      const bg_palette_ptr& palette)
 {
-    BN_BG_BLOCKS_LOG("bg_blocks_manager - FIND REGULAR MAP: ", &map_item.cells_ref(), " - ",
+    BN_BG_BLOCKS_LOG("bg_blocks_manager - FIND REGULAR MAP: ", _regular_map_data_ptr(map_item), " - ",
                      map_item.dimensions().width(), " - ", map_item.dimensions().height(), " - ",
                      palette.id(), " - ", int(map_item.compression()));
 
@@ -1355,11 +1890,11 @@ int create_affine_tiles(const affine_bg_tiles_item& tiles_item, bool optional)
 int create_regular_map(const regular_bg_map_item& map_item, regular_bg_tiles_ptr&& tiles, bg_palette_ptr&& palette,
                        bool optional)
 {
-    const uint16_t* data_ptr = &map_item.cells_ref();
     const size& dimensions = map_item.dimensions();
     compression_type compression = map_item.compression();
 
-    BN_BG_BLOCKS_LOG("bg_blocks_manager - CREATE REGULAR MAP", (optional ? " OPTIONAL: " : ": "), data_ptr, " - ",
+    BN_BG_BLOCKS_LOG("bg_blocks_manager - CREATE REGULAR MAP", (optional ? " OPTIONAL: " : ": "),
+                     _regular_map_data_ptr(map_item), " - ",
                      dimensions.width(), " - ", dimensions.height(), " - ", tiles.id(), " - ", palette.id(), " - ",
                      int(compression));
 
@@ -1376,7 +1911,7 @@ int create_regular_map(const regular_bg_map_item& map_item, regular_bg_tiles_ptr
               "Compressed big regular maps are not supported");
 
     result = _create_impl<create_type::MAP>(
-                create_data::from_regular_map(data_ptr, dimensions, compression, move(tiles), move(palette)));
+                create_data::from_regular_map_item(map_item, move(tiles), move(palette)));
 
     if(result != -1)
     {
@@ -1393,7 +1928,7 @@ int create_regular_map(const regular_bg_map_item& map_item, regular_bg_tiles_ptr
                 log_status();
 
                 BN_ERROR("Regular BG map create failed:",
-                         "\n\tMap data: ", data_ptr,
+                         "\n\tMap data: ", _regular_map_data_ptr(map_item),
                          "\n\tMap width: ", dimensions.width(),
                          "\n\tMap height: ", dimensions.height(),
                          "\n\tBlocks count: ", _regular_map_blocks_count(dimensions.width(), dimensions.height()),
@@ -1571,7 +2106,7 @@ int create_new_affine_tiles(const affine_bg_tiles_item& tiles_item, bool optiona
 int create_new_regular_map(const regular_bg_map_item& map_item, regular_bg_tiles_ptr&& tiles,
                            bg_palette_ptr&& palette, bool optional)
 {
-    const uint16_t* data_ptr = &map_item.cells_ref();
+    const uint16_t* data_ptr = _regular_map_data_ptr(map_item);
     const size& dimensions = map_item.dimensions();
     compression_type compression = map_item.compression();
 
@@ -1587,7 +2122,7 @@ int create_new_regular_map(const regular_bg_map_item& map_item, regular_bg_tiles
               "Multiple copies of the same data not supported");
 
     int result = _create_impl<create_type::MAP>(
-                create_data::from_regular_map(data_ptr, dimensions, compression, move(tiles), move(palette)));
+                create_data::from_regular_map_item(map_item, move(tiles), move(palette)));
 
     if(result != -1)
     {
@@ -1959,7 +2494,10 @@ optional<span<const regular_bg_map_cell>> regular_map_cells_ref(int id)
 
     if(const uint16_t* item_data = item.data)
     {
-        result.emplace(item_data, item.width * item.height);
+        if(! item.metatile_cells)
+        {
+            result.emplace(item_data, item.width * item.height);
+        }
     }
 
     return result;
@@ -2052,8 +2590,11 @@ void set_affine_tiles_ref(int id, const affine_bg_tiles_item& tiles_item)
 
 void set_regular_map_cells_ref(int id, const regular_bg_map_item& map_item)
 {
-    const uint16_t* data_ptr = &map_item.cells_ref();
+    const uint16_t* data_ptr = _regular_map_data_ptr(map_item);
     compression_type compression = map_item.compression();
+    const uint16_t* metatile_cells_ptr = map_item.metatiles() ? &map_item.cells_ref() : nullptr;
+    int metatile_shift = map_item.metatiles() ? _metatile_shift(map_item.metatile_size()) : 0;
+    bool byte_metatile_indexes = map_item.metatile_byte_indexes_ptr();
 
     BN_BG_BLOCKS_LOG("bg_blocks_manager - SET REGULAR MAP CELLS REF: ", id, " - ",
                      data.items.item(id).start_block, " - ", data_ptr, " - ",
@@ -2076,13 +2617,20 @@ void set_regular_map_cells_ref(int id, const regular_bg_map_item& map_item)
         data.items_map.erase(item.data);
         data.items_map.insert(data_ptr, id);
         item.set_compression(compression);
+        item.metatile_cells = metatile_cells_ptr;
+        item.metatile_shift = uint8_t(metatile_shift);
+        item.byte_metatile_indexes = byte_metatile_indexes;
         _check_commit_item(id, data_ptr, true);
 
         BN_BG_BLOCKS_LOG_STATUS();
     }
-    else if(compression != item.compression())
+    else if(compression != item.compression() || metatile_cells_ptr != item.metatile_cells ||
+            metatile_shift != item.metatile_shift || byte_metatile_indexes != item.byte_metatile_indexes)
     {
         item.set_compression(compression);
+        item.metatile_cells = metatile_cells_ptr;
+        item.metatile_shift = uint8_t(metatile_shift);
+        item.byte_metatile_indexes = byte_metatile_indexes;
         _check_commit_item(id, data_ptr, true);
 
         BN_BG_BLOCKS_LOG_STATUS();
@@ -2419,90 +2967,18 @@ void update_regular_map_col(int id, int x, int y)
         return;
     }
 
-    int map_width = item.width;
-    source_data += ((y * map_width) + x);
-
-    int y_separator = y & 31;
-    uint16_t* dest_data = hw::bg_blocks::vram(item.start_block) + ((y_separator * 32) + (x & 31));
-
-    if(auto tiles_offset = unsigned(item.regular_tiles_offset()))
+    if(item.metatile_cells)
     {
-        if(auto palette_offset = unsigned(item.palette_offset()))
-        {
-            for(int iy = y_separator; iy < 32; ++iy)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_offset(*source_data, tiles_offset, palette_offset, *dest_data);
-                dest_data += 32;
-                source_data += map_width;
-            }
-
-            dest_data -= 1024;
-
-            for(int iy = 0; iy < y_separator; ++iy)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_offset(*source_data, tiles_offset, palette_offset, *dest_data);
-                dest_data += 32;
-                source_data += map_width;
-            }
-        }
-        else
-        {
-            for(int iy = y_separator; iy < 32; ++iy)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_tiles_offset(*source_data, tiles_offset, *dest_data);
-                dest_data += 32;
-                source_data += map_width;
-            }
-
-            dest_data -= 1024;
-
-            for(int iy = 0; iy < y_separator; ++iy)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_tiles_offset(*source_data, tiles_offset, *dest_data);
-                dest_data += 32;
-                source_data += map_width;
-            }
-        }
+        int rows = min(32, item.height - y);
+        _copy_regular_metatile_map_col(item, x, y, rows, hw::bg_blocks::vram(item.start_block));
+        return;
     }
-    else
-    {
-        if(auto palette_offset = unsigned(item.palette_offset()))
-        {
-            for(int iy = y_separator; iy < 32; ++iy)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_palette_offset(*source_data, palette_offset, *dest_data);
-                dest_data += 32;
-                source_data += map_width;
-            }
-
-            dest_data -= 1024;
-
-            for(int iy = 0; iy < y_separator; ++iy)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_palette_offset(*source_data, palette_offset, *dest_data);
-                dest_data += 32;
-                source_data += map_width;
-            }
-        }
-        else
-        {
-            for(int iy = y_separator; iy < 32; ++iy)
-            {
-                *dest_data = *source_data;
-                dest_data += 32;
-                source_data += map_width;
-            }
 
-            dest_data -= 1024;
-
-            for(int iy = 0; iy < y_separator; ++iy)
-            {
-                *dest_data = *source_data;
-                dest_data += 32;
-                source_data += map_width;
-            }
-        }
-    }
+    int map_width = item.width;
+    source_data += ((y * map_width) + x);
+    hw::bg_blocks::copy_regular_bg_map_col(source_data, map_width, y & 31, unsigned(item.regular_tiles_offset()),
+                                           unsigned(item.palette_offset()),
+                                           hw::bg_blocks::vram(item.start_block) + (x & 31));
 }
 
 void update_affine_map_col(int id, int x, int y)
@@ -2517,105 +2993,8 @@ void update_affine_map_col(int id, int x, int y)
 
     int map_width = item.width;
     source_data += ((y * map_width) + x);
-
-    int y_separator = y & 31;
-    auto dest_data = reinterpret_cast<uint8_t*>(hw::bg_blocks::vram(item.start_block));
-    dest_data += ((y_separator * 32) + (x & 31));
-
-    if(auto tiles_offset = unsigned(item.affine_tiles_offset()))
-    {
-        if(x % 2)
-        {
-            for(int iy = y_separator; iy < 32; ++iy)
-            {
-                auto u16_dest_data = reinterpret_cast<uint16_t*>(dest_data - 1);
-                auto joined_value = uint16_t(((*source_data + tiles_offset) << 8) | (*u16_dest_data & 0xFF));
-                *u16_dest_data = joined_value;
-                dest_data += 32;
-                source_data += map_width;
-            }
-
-            dest_data -= 1024;
-
-            for(int iy = 0; iy < y_separator; ++iy)
-            {
-                auto u16_dest_data = reinterpret_cast<uint16_t*>(dest_data - 1);
-                auto joined_value = uint16_t(((*source_data + tiles_offset) << 8) | (*u16_dest_data & 0xFF));
-                *u16_dest_data = joined_value;
-                dest_data += 32;
-                source_data += map_width;
-            }
-        }
-        else
-        {
-            for(int iy = y_separator; iy < 32; ++iy)
-            {
-                auto u16_dest_data = reinterpret_cast<uint16_t*>(dest_data);
-                auto joined_value = uint16_t((*u16_dest_data & 0xFF00) | (*source_data + tiles_offset));
-                *u16_dest_data = joined_value;
-                dest_data += 32;
-                source_data += map_width;
-            }
-
-            dest_data -= 1024;
-
-            for(int iy = 0; iy < y_separator; ++iy)
-            {
-                auto u16_dest_data = reinterpret_cast<uint16_t*>(dest_data);
-                auto joined_value = uint16_t((*u16_dest_data & 0xFF00) | (*source_data + tiles_offset));
-                *u16_dest_data = joined_value;
-                dest_data += 32;
-                source_data += map_width;
-            }
-        }
-    }
-    else
-    {
-        if(x % 2)
-        {
-            for(int iy = y_separator; iy < 32; ++iy)
-            {
-                auto u16_dest_data = reinterpret_cast<uint16_t*>(dest_data - 1);
-                auto joined_value = uint16_t((unsigned(*source_data) << 8) | (*u16_dest_data & 0xFF));
-                *u16_dest_data = joined_value;
-                dest_data += 32;
-                source_data += map_width;
-            }
-
-            dest_data -= 1024;
-
-            for(int iy = 0; iy < y_separator; ++iy)
-            {
-                auto u16_dest_data = reinterpret_cast<uint16_t*>(dest_data - 1);
-                uint16_t joined_value = uint16_t((unsigned(*source_data) << 8) | (*u16_dest_data & 0xFF));
-                *u16_dest_data = joined_value;
-                dest_data += 32;
-                source_data += map_width;
-            }
-        }
-        else
-        {
-            for(int iy = y_separator; iy < 32; ++iy)
-            {
-                auto u16_dest_data = reinterpret_cast<uint16_t*>(dest_data);
-                uint16_t joined_value = uint16_t((*u16_dest_data & 0xFF00) | *source_data);
-                *u16_dest_data = joined_value;
-                dest_data += 32;
-                source_data += map_width;
-            }
-
-            dest_data -= 1024;
-
-            for(int iy = 0; iy < y_separator; ++iy)
-            {
-                auto u16_dest_data = reinterpret_cast<uint16_t*>(dest_data);
-                uint16_t joined_value = uint16_t((*u16_dest_data & 0xFF00) | *source_data);
-                *u16_dest_data = joined_value;
-                dest_data += 32;
-                source_data += map_width;
-            }
-        }
-    }
+    hw::bg_blocks::copy_affine_bg_map_col(source_data, map_width, x, y & 31, unsigned(item.affine_tiles_offset()),
+                                          hw::bg_blocks::vram(item.start_block));
 }
 
 void update_regular_map_row(int id, int x, int y)
@@ -2628,79 +3007,17 @@ void update_regular_map_row(int id, int x, int y)
         return;
     }
 
-    source_data += ((y * item.width) + x);
-
-    int x_separator = x & 31;
-    uint16_t* dest_data = hw::bg_blocks::vram(item.start_block) + (((y & 31) * 32) + x_separator);
-
-    if(auto tiles_offset = unsigned(item.regular_tiles_offset()))
+    if(item.metatile_cells)
     {
-        if(auto palette_offset = unsigned(item.palette_offset()))
-        {
-            for(int ix = x_separator; ix < 32; ++ix)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_offset(*source_data, tiles_offset, palette_offset, *dest_data);
-                ++source_data;
-                ++dest_data;
-            }
-
-            dest_data -= 32;
-
-            for(int ix = 0; ix < x_separator; ++ix)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_offset(*source_data, tiles_offset, palette_offset, *dest_data);
-                ++source_data;
-                ++dest_data;
-            }
-        }
-        else
-        {
-            for(int ix = x_separator; ix < 32; ++ix)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_tiles_offset(*source_data, tiles_offset, *dest_data);
-                ++source_data;
-                ++dest_data;
-            }
-
-            dest_data -= 32;
-
-            for(int ix = 0; ix < x_separator; ++ix)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_tiles_offset(*source_data, tiles_offset, *dest_data);
-                ++source_data;
-                ++dest_data;
-            }
-        }
+        int columns = min(32, item.width - x);
+        _copy_regular_metatile_map_row(item, x, y, columns, hw::bg_blocks::vram(item.start_block));
+        return;
     }
-    else
-    {
-        if(auto palette_offset = unsigned(item.palette_offset()))
-        {
-            for(int ix = x_separator; ix < 32; ++ix)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_palette_offset(*source_data, palette_offset, *dest_data);
-                ++source_data;
-                ++dest_data;
-            }
-
-            dest_data -= 32;
 
-            for(int ix = 0; ix < x_separator; ++ix)
-            {
-                hw::bg_blocks::copy_regular_bg_map_cell_palette_offset(*source_data, palette_offset, *dest_data);
-                ++source_data;
-                ++dest_data;
-            }
-        }
-        else
-        {
-            int elements = 32 - x_separator;
-            hw::memory::copy_half_words(source_data, elements, dest_data);
-            source_data += elements;
-            dest_data -= x_separator;
-            hw::memory::copy_half_words(source_data, x_separator, dest_data);
-        }
-    }
+    source_data += ((y * item.width) + x);
+    hw::bg_blocks::copy_regular_bg_map_row(source_data, x & 31, unsigned(item.regular_tiles_offset()),
+                                           unsigned(item.palette_offset()),
+                                           hw::bg_blocks::vram(item.start_block) + ((y & 31) * 32));
 }
 
 void update_affine_map_row(int id, int x, int y)
@@ -2762,100 +3079,44 @@ void set_regular_map_position(int id, int x, int y)
     }
 
     uint16_t* vram_data = hw::bg_blocks::vram(item.start_block);
-    int map_width = item.width;
-    int x_separator = x & 31;
 
-    if(auto tiles_offset = unsigned(item.regular_tiles_offset()))
+    if(item.metatile_cells)
     {
-        if(auto palette_offset = unsigned(item.palette_offset()))
-        {
-            for(int row = y, row_limit = y + 22; row < row_limit; ++row)
-            {
-                const uint16_t* source_data = item_data + ((row * map_width) + x);
-                uint16_t* dest_data = vram_data + (((row & 31) * 32) + x_separator);
-
-                for(int ix = x_separator; ix < 32; ++ix)
-                {
-                    hw::bg_blocks::copy_regular_bg_map_cell_offset(*source_data, tiles_offset, palette_offset,
-                                                                   *dest_data);
-                    ++source_data;
-                    ++dest_data;
-                }
+        int columns = min(32, item.width - x);
 
-                dest_data -= 32;
-
-                for(int ix = 0; ix < x_separator; ++ix)
-                {
-                    hw::bg_blocks::copy_regular_bg_map_cell_offset(*source_data, tiles_offset, palette_offset,
-                                                                   *dest_data);
-                    ++source_data;
-                    ++dest_data;
-                }
-            }
-        }
-        else
+        for(int row = y, row_limit = y + 22; row < row_limit; ++row)
         {
-            for(int row = y, row_limit = y + 22; row < row_limit; ++row)
-            {
-                const uint16_t* source_data = item_data + ((row * map_width) + x);
-                uint16_t* dest_data = vram_data + (((row & 31) * 32) + x_separator);
+            _copy_regular_metatile_map_row(item, x, row, columns, vram_data);
+        }
 
-                for(int ix = x_separator; ix < 32; ++ix)
-                {
-                    hw::bg_blocks::copy_regular_bg_map_cell_tiles_offset(*source_data, tiles_offset, *dest_data);
-                    ++source_data;
-                    ++dest_data;
-                }
+        return;
+    }
 
-                dest_data -= 32;
+    int map_width = item.width;
+    int x_separator = x & 31;
+    auto tiles_offset = unsigned(item.regular_tiles_offset());
+    auto palette_offset = unsigned(item.palette_offset());
 
-                for(int ix = 0; ix < x_separator; ++ix)
-                {
-                    hw::bg_blocks::copy_regular_bg_map_cell_tiles_offset(*source_data, tiles_offset, *dest_data);
-                    ++source_data;
-                    ++dest_data;
-                }
-            }
+    if(tiles_offset || palette_offset)
+    {
+        for(int row = y, row_limit = y + 22; row < row_limit; ++row)
+        {
+            const uint16_t* source_data = item_data + ((row * map_width) + x);
+            hw::bg_blocks::copy_regular_bg_map_row(source_data, x_separator, tiles_offset, palette_offset,
+                                                   vram_data + ((row & 31) * 32));
         }
     }
     else
     {
-        if(auto palette_offset = unsigned(item.palette_offset()))
-        {
-            for(int row = y, row_limit = y + 22; row < row_limit; ++row)
-            {
-                const uint16_t* source_data = item_data + ((row * map_width) + x);
-                uint16_t* dest_data = vram_data + (((row & 31) * 32) + x_separator);
-
-                for(int ix = x_separator; ix < 32; ++ix)
-                {
-                    hw::bg_blocks::copy_regular_bg_map_cell_palette_offset(*source_data, palette_offset, *dest_data);
-                    ++source_data;
-                    ++dest_data;
-                }
-
-                dest_data -= 32;
-
-                for(int ix = 0; ix < x_separator; ++ix)
-                {
-                    hw::bg_blocks::copy_regular_bg_map_cell_palette_offset(*source_data, palette_offset, *dest_data);
-                    ++source_data;
-                    ++dest_data;
-                }
-            }
-        }
-        else
+        for(int row = y, row_limit = y + 22; row < row_limit; ++row)
         {
-            for(int row = y, row_limit = y + 22; row < row_limit; ++row)
-            {
-                const uint16_t* source_data = item_data + ((row * map_width) + x);
-                uint16_t* dest_data = vram_data + (((row & 31) * 32) + x_separator);
-                int elements = 32 - x_separator;
-                hw::memory::copy_half_words(source_data, elements, dest_data);
-                source_data += elements;
-                dest_data -= x_separator;
-                hw::memory::copy_half_words(source_data, x_separator, dest_data);
-            }
+            const uint16_t* source_data = item_data + ((row * map_width) + x);
+            uint16_t* dest_data = vram_data + (((row & 31) * 32) + x_separator);
+            int elements = 32 - x_separator;
+            hw::memory::copy_half_words(source_data, elements, dest_data);
+            source_data += elements;
+            dest_data -= x_separator;
+            hw::memory::copy_half_words(source_data, x_separator, dest_data);
         }
     }
 }
@@ -2918,89 +3179,115 @@ void set_affine_map_position(int id, int x, int y)
 
 void update()
 {
-    if(data.to_remove_blocks_count)
+    _update_to_remove_items();
+
+    // Items are moved only here, so relocations are always committed in the same frame:
+    if(data.defragment && data.relocations.empty())
     {
-        BN_BG_BLOCKS_LOG("bg_blocks_manager - UPDATE");
+        _defragment_step();
+    }
+}
 
-        auto end = data.items.end();
-        auto before_previous_iterator = end;
-        auto previous_iterator = data.items.before_begin();
-        auto iterator = previous_iterator;
-        ++iterator;
-        data.to_remove_blocks_count = 0;
+void commit_relocations()
+{
+    if(! data.relocations.empty())
+    {
+        BN_BG_BLOCKS_LOG("bg_blocks_manager - COMMIT RELOCATIONS");
 
-        while(iterator != end)
+        // Destination blocks of a moved item can overlap source blocks of the previously moved items,
+        // so they are copied in the same order they have been moved:
+        for(const relocation_type& relocation : data.relocations)
         {
-            item_type& item = *iterator;
+            const item_type& item = data.items.item(relocation.id);
+            int old_start_block = relocation.old_start_block;
+
+            if(item.start_block != old_start_block)
+            {
+                hw::bg_blocks::move_blocks(old_start_block, item.blocks_count, item.start_block);
+            }
+        }
 
-            if(item.status() == status_type::TO_REMOVE)
+        for(const relocation_type& relocation : data.relocations)
+        {
+            if(int tiles_offset_increment = relocation.tiles_offset_increment)
             {
+                item_type& item = data.items.item(relocation.id);
+
                 if(item.data)
                 {
-                    data.items_map.erase(item.data);
+                    item.commit = false;
+                    _commit_item(item);
                 }
-
-                item.data = nullptr;
-                item.width = 0;
-                item.height = 0;
-                item.set_status(status_type::FREE);
-                item.commit = false;
-                data.free_blocks_count += item.blocks_count;
-
-                auto next_iterator = iterator;
-                ++next_iterator;
-
-                while(next_iterator != end)
+                else
                 {
-                    if(_remove_adjacent_item(next_iterator.id(), item))
+                    uint16_t* vram_ptr = hw::bg_blocks::vram(item.start_block);
+                    auto tiles_offset = unsigned(tiles_offset_increment);
+
+                    if(item.is_affine)
                     {
-                        next_iterator = data.items.erase_after(iterator.id());
+                        int half_words = (item.width * item.height) / 2;
+                        unsigned half_word_tiles_offset = (tiles_offset << 8) + tiles_offset;
+
+                        for(int index = 0; index < half_words; ++index)
+                        {
+                            vram_ptr[index] = uint16_t(vram_ptr[index] + half_word_tiles_offset);
+                        }
                     }
                     else
                     {
-                        break;
-                    }
-                }
-
-                if(before_previous_iterator != end)
-                {
-                    if(_remove_adjacent_item(previous_iterator.id(), item))
-                    {
-                        item.start_block = previous_iterator->start_block;
-                        data.items.erase_after(before_previous_iterator.id());
-                        previous_iterator = before_previous_iterator;
+                        for(int index = 0, limit = item.width * item.height; index < limit; ++index)
+                        {
+                            hw::bg_blocks::copy_regular_bg_map_cell_tiles_offset(
+                                        vram_ptr[index], tiles_offset, vram_ptr[index]);
+                        }
                     }
                 }
             }
-
-            before_previous_iterator = previous_iterator;
-            previous_iterator = iterator;
-            ++iterator;
         }
 
+        data.relocations.clear();
+
         BN_BG_BLOCKS_LOG_STATUS();
     }
 }
 
-void commit()
+int commit(int max_ticks)
 {
+    int deferred_bytes = 0;
     bool do_commit = data.check_commit;
 
     if(do_commit)
     {
         BN_BG_BLOCKS_LOG("bg_blocks_manager - COMMIT");
 
+        timer commit_timer;
+        bool item_committed = false;
         data.check_commit = false;
 
         for(item_type& item : data.items)
         {
             if(item.commit)
             {
-                item.commit = false;
-
                 if(item.status() == status_type::USED)
                 {
-                    _commit_item(item);
+                    int item_bytes = _commit_item_bytes(item);
+
+                    // At least one item is committed in each frame, so deferred items are committed eventually:
+                    if(! item_bytes || ! item_committed || commit_timer.elapsed_ticks() < max_ticks)
+                    {
+                        item.commit = false;
+                        item_committed |= item_bytes > 0;
+                        _commit_item(item);
+                    }
+                    else
+                    {
+                        deferred_bytes += item_bytes;
+                        data.check_commit = true;
+                    }
+                }
+                else
+                {
+                    item.commit = false;
                 }
             }
         }
@@ -3012,6 +3299,8 @@ void commit()
     {
         BN_BG_BLOCKS_LOG_STATUS();
     }
+
+    return deferred_bytes;
 }
 
 }
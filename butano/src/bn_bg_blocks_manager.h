@@ -47,6 +47,16 @@ namespace bn::bg_blocks_manager
 
     [[nodiscard]] int available_map_blocks_count();
 
+    [[nodiscard]] int largest_available_tiles_count();
+
+    [[nodiscard]] int largest_available_map_cells_count();
+
+    [[nodiscard]] int largest_available_blocks_count();
+
+    void defragment();
+
+    [[nodiscard]] bool defragmenting();
+
     #if BN_CFG_LOG_ENABLED
         void log_status();
     #endif
@@ -175,7 +185,9 @@ namespace bn::bg_blocks_manager
 
     void update();
 
-    void commit();
+    void commit_relocations();
+
+    [[nodiscard]] int commit(int max_ticks);
 }
 
 #endif
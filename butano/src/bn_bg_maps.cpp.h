@@ -30,6 +30,26 @@ int available_blocks_count()
     return bg_blocks_manager::available_map_blocks_count();
 }
 
+int largest_available_cells_count()
+{
+    return bg_blocks_manager::largest_available_map_cells_count();
+}
+
+int largest_available_blocks_count()
+{
+    return bg_blocks_manager::largest_available_blocks_count();
+}
+
+void defragment()
+{
+    bg_blocks_manager::defragment();
+}
+
+bool defragmenting()
+{
+    return bg_blocks_manager::defragmenting();
+}
+
 #if BN_CFG_LOG_ENABLED
     void log_status()
     {
@@ -34,10 +34,7 @@ public:
                 palettes_manager::bg_palettes_bank().retrieve_commit_data())
         {
             palette_target_id palette_target_id(target_id);
-            int target_color = palette_target_id.params.final_color_index;
-            int first_color = commit_data->offset;
-            int last_color = first_color + commit_data->count - 1;
-            return target_color >= first_color && target_color <= last_color;
+            return commit_data->color_updated(palette_target_id.params.final_color_index);
         }
 
         return false;
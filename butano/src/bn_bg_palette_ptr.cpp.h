@@ -284,6 +284,21 @@ void bg_palette_ptr::set_rotate_count(int count)
     palettes_manager::bg_palettes_bank().set_rotate_count(_id, count);
 }
 
+bool bg_palette_ptr::has_cycle() const
+{
+    return palettes_manager::bg_palettes_bank().has_cycle(_id);
+}
+
+void bg_palette_ptr::set_cycle(const palette_cycle& cycle)
+{
+    palettes_manager::bg_palettes_bank().set_cycle(_id, cycle);
+}
+
+void bg_palette_ptr::remove_cycle()
+{
+    palettes_manager::bg_palettes_bank().remove_cycle(_id);
+}
+
 void bg_palette_ptr::_destroy()
 {
     palettes_manager::bg_palettes_bank().decrease_usages(_id);
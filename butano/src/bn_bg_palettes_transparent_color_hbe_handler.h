@@ -32,7 +32,7 @@ public:
         if(optional<palettes_bank::commit_data> commit_data =
                 palettes_manager::bg_palettes_bank().retrieve_commit_data())
         {
-            return commit_data->offset == 0;
+            return commit_data->color_updated(0);
         }
 
         return false;
@@ -7,6 +7,7 @@
 
 #include "bn_math.h"
 #include "bn_pool.h"
+#include "bn_timer.h"
 #include "bn_vector.h"
 #include "bn_display.h"
 #include "bn_sort_key.h"
@@ -1317,7 +1318,7 @@ void update_regular_map_tiles_cbb(int map_id, int tiles_cbb)
 {
     for(item_type* item : data.items_vector)
     {
-        if(item->regular_map->id() == map_id)
+        if(item->regular_map && item->regular_map->id() == map_id)
         {
             hw::bgs::set_tiles_cbb(tiles_cbb, item->handle);
             _update_item(*item);
@@ -1329,7 +1330,7 @@ void update_affine_map_tiles_cbb(int map_id, int tiles_cbb)
 {
     for(item_type* item : data.items_vector)
     {
-        if(item->affine_map->id() == map_id)
+        if(item->affine_map && item->affine_map->id() == map_id)
         {
             hw::bgs::set_tiles_cbb(tiles_cbb, item->handle);
             _update_item(*item);
@@ -1341,7 +1342,7 @@ void update_regular_map_palette_bpp(int map_id, bpp_mode bpp)
 {
     for(item_type* item : data.items_vector)
     {
-        if(item->regular_map->id() == map_id)
+        if(item->regular_map && item->regular_map->id() == map_id)
         {
             hw::bgs::set_bpp(bpp, item->handle);
             _update_item(*item);
@@ -1349,6 +1350,30 @@ void update_regular_map_palette_bpp(int map_id, bpp_mode bpp)
     }
 }
 
+void update_regular_map_sbb(int map_id)
+{
+    for(item_type* item : data.items_vector)
+    {
+        if(item->regular_map && item->regular_map->id() == map_id)
+        {
+            hw::bgs::set_map_sbb(map_id, item->handle);
+            _update_item(*item);
+        }
+    }
+}
+
+void update_affine_map_sbb(int map_id)
+{
+    for(item_type* item : data.items_vector)
+    {
+        if(item->affine_map && item->affine_map->id() == map_id)
+        {
+            hw::bgs::set_map_sbb(map_id, item->handle);
+            _update_item(*item);
+        }
+    }
+}
+
 void reload()
 {
     data.commit = true;
@@ -1519,8 +1544,12 @@ void commit()
     }
 }
 
-void commit_big_maps()
+int commit_big_maps(int max_ticks)
 {
+    int deferred_bytes = 0;
+    timer commit_timer;
+    bool big_map_committed = false;
+
     for(item_type* item : data.items_vector)
     {
         if(item->big_map)
@@ -1560,8 +1589,29 @@ void commit_big_maps()
                 commit_big_map = old_map_x != new_map_x || old_map_y != new_map_y;
             }
 
+            // At least one big map is committed in each frame, so deferred big maps are committed eventually:
+            if(commit_big_map && big_map_committed && commit_timer.elapsed_ticks() >= max_ticks)
+            {
+                int cell_bytes = is_regular ? int(sizeof(regular_bg_map_cell)) : int(sizeof(affine_bg_map_cell));
+                int abs_x_diff = bn::abs(new_map_x - old_map_x);
+                int abs_y_diff = bn::abs(new_map_y - old_map_y);
+                item->commit_big_map = true;
+                item->full_commit_big_map = full_commit_big_map;
+                commit_big_map = false;
+
+                if(full_commit_big_map || abs_x_diff > 8 || abs_y_diff > 8)
+                {
+                    deferred_bytes += 32 * 22 * cell_bytes;
+                }
+                else
+                {
+                    deferred_bytes += ((abs_x_diff * 22) + (abs_y_diff * 32)) * cell_bytes;
+                }
+            }
+
             if(commit_big_map)
             {
+                big_map_committed = true;
                 item->old_big_map_x = uint16_t(new_map_x);
                 item->old_big_map_y = uint16_t(new_map_y);
                 item->commit_big_map = false;
@@ -1636,6 +1686,8 @@ void commit_big_maps()
             }
         }
     }
+
+    return deferred_bytes;
 }
 
 void stop()
@@ -183,6 +183,10 @@ namespace bgs_manager
 
     void update_regular_map_palette_bpp(int map_id, bpp_mode bpp);
 
+    void update_regular_map_sbb(int map_id);
+
+    void update_affine_map_sbb(int map_id);
+
     void reload();
 
     void fill_hblank_effect_regular_positions(int base_position, const fixed* positions_ptr, uint16_t* dest_ptr);
@@ -201,7 +205,7 @@ namespace bgs_manager
 
     void commit();
 
-    void commit_big_maps();
+    [[nodiscard]] int commit_big_maps(int max_ticks);
 
     void stop();
 }
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_bitmap_bg.h"
+
+#include "bn_bg_maps.h"
+#include "bn_bg_tiles.h"
+#include "bn_bg_palette_item.h"
+#include "bn_bitmap_bg_manager.h"
+#include "../hw/include/bn_hw_bitmap_bg.h"
+
+namespace bn
+{
+
+namespace
+{
+    constexpr int reserved_sprite_tiles_chunk = 128;
+
+    void _reserve_sprite_tiles(ivector<sprite_tiles_ptr>& reserved_sprite_tiles)
+    {
+        BN_ASSERT(! bg_tiles::used_tiles_count(), "BG tiles are used: ", bg_tiles::used_tiles_count());
+        BN_ASSERT(! bg_maps::used_cells_count(), "BG maps are used: ", bg_maps::used_cells_count());
+
+        // Sprite tiles allocations are limited in size, so the reserved tiles are allocated in chunks:
+        for(int tile_id = 0, limit = hw::bitmap_bg::reserved_sprite_tiles(); tile_id < limit;
+            tile_id += reserved_sprite_tiles_chunk)
+        {
+            reserved_sprite_tiles.push_back(sprite_tiles_ptr::allocate(reserved_sprite_tiles_chunk, bpp_mode::BPP_8));
+
+            const sprite_tiles_ptr& tiles = reserved_sprite_tiles.back();
+            BN_ASSERT(tiles.id() == tile_id, "Reserved sprite tiles are used: ", tiles.id(), " - ", tile_id);
+        }
+    }
+
+    [[nodiscard]] bg_palette_ptr _create_palette(const bg_palette_item& palette_item)
+    {
+        BN_ASSERT(palette_item.bpp() == bpp_mode::BPP_8, "Mode 4 palette must be 8BPP");
+
+        bg_palette_ptr result = palette_item.create_palette();
+        BN_ASSERT(! result.id(), "Invalid palette id: ", result.id());
+
+        return result;
+    }
+}
+
+bitmap_bg::bitmap_bg(bitmap_bg_mode mode, bool ewram_back_buffer) :
+    _mode(mode),
+    _ewram_back_buffer(ewram_back_buffer)
+{
+    BN_ASSERT(mode == bitmap_bg_mode::MODE_3 || mode == bitmap_bg_mode::MODE_5,
+              "Mode 4 requires a color palette: ", int(mode));
+
+    _reserve_sprite_tiles(_reserved_sprite_tiles);
+    bitmap_bg_manager::create(int(mode), ewram_back_buffer);
+}
+
+bitmap_bg::bitmap_bg(const bg_palette_item& palette_item, bool ewram_back_buffer) :
+    _palette(_create_palette(palette_item)),
+    _mode(bitmap_bg_mode::MODE_4),
+    _ewram_back_buffer(ewram_back_buffer)
+{
+    _reserve_sprite_tiles(_reserved_sprite_tiles);
+    bitmap_bg_manager::create(int(bitmap_bg_mode::MODE_4), ewram_back_buffer);
+}
+
+bitmap_bg::~bitmap_bg()
+{
+    bitmap_bg_manager::destroy();
+}
+
+uint16_t* bitmap_bg::back_buffer()
+{
+    return bitmap_bg_manager::back_buffer();
+}
+
+void bitmap_bg::clear(color color)
+{
+    size dims = dimensions();
+    fill_rect(0, 0, dims.width(), dims.height(), color);
+}
+
+void bitmap_bg::clear(int color_index)
+{
+    size dims = dimensions();
+    fill_rect(0, 0, dims.width(), dims.height(), color_index);
+}
+
+void bitmap_bg::plot(int x, int y, color color)
+{
+    BN_ASSERT(_direct_colors(), "Mode 4 requires palette indexes");
+    _check_rect(x, y, 1, 1);
+
+    back_buffer()[(y * dimensions().width()) + x] = uint16_t(color.data());
+}
+
+void bitmap_bg::plot(int x, int y, int color_index)
+{
+    BN_ASSERT(! _direct_colors(), "Direct color modes require colors");
+    BN_ASSERT(color_index >= 0 && color_index < 256, "Invalid color index: ", color_index);
+    _check_rect(x, y, 1, 1);
+
+    int pixel_index = (y * dimensions().width()) + x;
+    uint16_t& pair = back_buffer()[pixel_index / 2];
+
+    if(pixel_index % 2)
+    {
+        pair = uint16_t((pair & 0x00FF) | (color_index << 8));
+    }
+    else
+    {
+        pair = uint16_t((pair & 0xFF00) | color_index);
+    }
+}
+
+void bitmap_bg::draw_hline(int x, int y, int width, color color)
+{
+    fill_rect(x, y, width, 1, color);
+}
+
+void bitmap_bg::draw_hline(int x, int y, int width, int color_index)
+{
+    fill_rect(x, y, width, 1, color_index);
+}
+
+void bitmap_bg::fill_rect(int x, int y, int width, int height, color color)
+{
+    BN_ASSERT(_direct_colors(), "Mode 4 requires palette indexes");
+    _check_rect(x, y, width, height);
+
+    hw::bitmap_bg::fill_rect_16bpp(unsigned(color.data()), x, y, width, height, dimensions().width(),
+                                   back_buffer());
+}
+
+void bitmap_bg::fill_rect(int x, int y, int width, int height, int color_index)
+{
+    BN_ASSERT(! _direct_colors(), "Direct color modes require colors");
+    BN_ASSERT(color_index >= 0 && color_index < 256, "Invalid color index: ", color_index);
+    _check_rect(x, y, width, height);
+
+    hw::bitmap_bg::fill_rect_8bpp(unsigned(color_index), x, y, width, height, dimensions().width(),
+                                  back_buffer());
+}
+
+void bitmap_bg::blit(int x, int y, const span<const color>& pixels, const size& pixels_dimensions)
+{
+    BN_ASSERT(_direct_colors(), "Mode 4 requires palette indexes");
+    BN_ASSERT(pixels.size() == pixels_dimensions.width() * pixels_dimensions.height(),
+              "Invalid pixels count: ", pixels.size(), " - ", pixels_dimensions.width() * pixels_dimensions.height());
+    _check_rect(x, y, pixels_dimensions.width(), pixels_dimensions.height());
+
+    hw::bitmap_bg::blit_16bpp(reinterpret_cast<const uint16_t*>(pixels.data()), pixels_dimensions.width(), x, y,
+                              pixels_dimensions.width(), pixels_dimensions.height(), dimensions().width(),
+                              back_buffer());
+}
+
+void bitmap_bg::blit(int x, int y, const span<const uint8_t>& pixels, const size& pixels_dimensions)
+{
+    BN_ASSERT(! _direct_colors(), "Direct color modes require colors");
+    BN_ASSERT(pixels.size() == pixels_dimensions.width() * pixels_dimensions.height(),
+              "Invalid pixels count: ", pixels.size(), " - ", pixels_dimensions.width() * pixels_dimensions.height());
+    _check_rect(x, y, pixels_dimensions.width(), pixels_dimensions.height());
+
+    hw::bitmap_bg::blit_8bpp(pixels.data(), pixels_dimensions.width(), x, y, pixels_dimensions.width(),
+                             pixels_dimensions.height(), dimensions().width(), back_buffer());
+}
+
+void bitmap_bg::scaled_blit(int x, int y, const size& dimensions, const span<const color>& pixels,
+                            const size& pixels_dimensions)
+{
+    BN_ASSERT(_direct_colors(), "Mode 4 requires palette indexes");
+    BN_ASSERT(pixels_dimensions.width() > 0 && pixels_dimensions.height() > 0,
+              "Invalid pixels dimensions: ", pixels_dimensions.width(), " - ", pixels_dimensions.height());
+    BN_ASSERT(pixels.size() == pixels_dimensions.width() * pixels_dimensions.height(),
+              "Invalid pixels count: ", pixels.size(), " - ", pixels_dimensions.width() * pixels_dimensions.height());
+    _check_rect(x, y, dimensions.width(), dimensions.height());
+
+    hw::bitmap_bg::scaled_blit_16bpp(reinterpret_cast<const uint16_t*>(pixels.data()), pixels_dimensions.width(),
+                                     pixels_dimensions.height(), x, y, dimensions.width(), dimensions.height(),
+                                     this->dimensions().width(), back_buffer());
+}
+
+void bitmap_bg::scaled_blit(int x, int y, const size& dimensions, const span<const uint8_t>& pixels,
+                            const size& pixels_dimensions)
+{
+    BN_ASSERT(! _direct_colors(), "Direct color modes require colors");
+    BN_ASSERT(pixels_dimensions.width() > 0 && pixels_dimensions.height() > 0,
+              "Invalid pixels dimensions: ", pixels_dimensions.width(), " - ", pixels_dimensions.height());
+    BN_ASSERT(pixels.size() == pixels_dimensions.width() * pixels_dimensions.height(),
+              "Invalid pixels count: ", pixels.size(), " - ", pixels_dimensions.width() * pixels_dimensions.height());
+    _check_rect(x, y, dimensions.width(), dimensions.height());
+
+    hw::bitmap_bg::scaled_blit_8bpp(pixels.data(), pixels_dimensions.width(), pixels_dimensions.height(), x, y,
+                                    dimensions.width(), dimensions.height(), this->dimensions().width(),
+                                    back_buffer());
+}
+
+void bitmap_bg::present()
+{
+    bitmap_bg_manager::present();
+}
+
+void bitmap_bg::_check_rect(int x, int y, int width, int height) const
+{
+    size dims = dimensions();
+    BN_ASSERT(width >= 0 && height >= 0, "Invalid size: ", width, " - ", height);
+    BN_ASSERT(x >= 0 && x + width <= dims.width(), "Invalid x: ", x, " - ", width);
+    BN_ASSERT(y >= 0 && y + height <= dims.height(), "Invalid y: ", y, " - ", height);
+}
+
+}
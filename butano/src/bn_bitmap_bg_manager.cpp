@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_bitmap_bg_manager.h"
+
+#include "bn_memory.h"
+#include "bn_display_manager.h"
+#include "../hw/include/bn_hw_memory.h"
+#include "../hw/include/bn_hw_bitmap_bg.h"
+
+namespace bn::bitmap_bg_manager
+{
+
+namespace
+{
+    class static_data
+    {
+
+    public:
+        uint16_t* ewram_buffer = nullptr;
+        int mode = 0;
+        int displayed_page = 0;
+        int buffer_bytes = 0;
+        bool commit_page = false;
+        bool commit_ewram_buffer = false;
+    };
+
+    BN_DATA_EWRAM static_data data;
+
+    [[nodiscard]] int _buffer_bytes(int mode)
+    {
+        switch(mode)
+        {
+
+        case 3:
+            return M3_SIZE;
+
+        case 4:
+            return M4_SIZE;
+
+        default:
+            return M5_SIZE;
+        }
+    }
+
+    [[nodiscard]] uint16_t* _hidden_page()
+    {
+        return hw::bitmap_bg::page(1 - data.displayed_page);
+    }
+}
+
+void create(int mode, bool ewram_back_buffer)
+{
+    BN_ASSERT(! data.mode, "There's already a bitmap BG");
+
+    int buffer_bytes = _buffer_bytes(mode);
+    data.mode = mode;
+    data.displayed_page = 0;
+    data.buffer_bytes = buffer_bytes;
+    data.commit_page = false;
+    data.commit_ewram_buffer = false;
+
+    if(ewram_back_buffer)
+    {
+        data.ewram_buffer = static_cast<uint16_t*>(memory::ewram_alloc(buffer_bytes));
+        BN_ASSERT(data.ewram_buffer, "EWRAM allocation failed: ", buffer_bytes);
+
+        memory::set_half_words(0, buffer_bytes / 2, data.ewram_buffer);
+    }
+
+    hw::memory::set_words(0, (mode == 3 ? buffer_bytes : hw::bitmap_bg::pages_count() * VRAM_PAGE_SIZE) / 4,
+                          hw::bitmap_bg::page(0));
+    display_manager::set_bitmap_mode(mode);
+}
+
+void destroy()
+{
+    if(uint16_t* ewram_buffer = data.ewram_buffer)
+    {
+        memory::ewram_free(ewram_buffer);
+        data.ewram_buffer = nullptr;
+    }
+
+    data.mode = 0;
+    display_manager::set_bitmap_mode(0);
+}
+
+uint16_t* back_buffer()
+{
+    if(uint16_t* ewram_buffer = data.ewram_buffer)
+    {
+        return ewram_buffer;
+    }
+
+    if(data.mode == 3)
+    {
+        return hw::bitmap_bg::page(0);
+    }
+
+    return _hidden_page();
+}
+
+void present()
+{
+    if(data.mode == 3)
+    {
+        // The EWRAM buffer is copied at the end of the V-Blank commit, racing ahead of the beam:
+        data.commit_ewram_buffer = data.ewram_buffer != nullptr;
+    }
+    else
+    {
+        if(uint16_t* ewram_buffer = data.ewram_buffer)
+        {
+            hw::memory::copy_words(ewram_buffer, data.buffer_bytes / 4, _hidden_page());
+        }
+
+        display_manager::set_bitmap_page(1 - data.displayed_page);
+        data.commit_page = true;
+    }
+}
+
+void commit()
+{
+    if(data.mode)
+    {
+        hw::bitmap_bg::commit_bg();
+
+        if(data.commit_page)
+        {
+            data.displayed_page = 1 - data.displayed_page;
+            data.commit_page = false;
+        }
+
+        if(data.commit_ewram_buffer)
+        {
+            hw::memory::copy_words(data.ewram_buffer, data.buffer_bytes / 4, hw::bitmap_bg::page(0));
+            data.commit_ewram_buffer = false;
+        }
+    }
+}
+
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_BITMAP_BG_MANAGER_H
+#define BN_BITMAP_BG_MANAGER_H
+
+#include "bn_common.h"
+
+namespace bn::bitmap_bg_manager
+{
+    void create(int mode, bool ewram_back_buffer);
+
+    void destroy();
+
+    [[nodiscard]] uint16_t* back_buffer();
+
+    void present();
+
+    void commit();
+}
+
+#endif
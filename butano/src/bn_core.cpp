@@ -6,18 +6,23 @@
 #include "bn_core.h"
 
 #include "bn_span.h"
+#include "bn_deque.h"
 #include "bn_fixed.h"
 #include "bn_timer.h"
+#include "bn_limits.h"
 #include "bn_string.h"
 #include "bn_keypad.h"
 #include "bn_timers.h"
+#include "bn_optional.h"
 #include "bn_profiler.h"
 #include "bn_string_view.h"
+#include "bn_config_core.h"
 #include "bn_bgs_manager.h"
 #include "bn_hdma_manager.h"
 #include "bn_link_manager.h"
 #include "bn_gpio_manager.h"
 #include "bn_audio_manager.h"
+#include "bn_frame_breakdown.h"
 #include "bn_keypad_manager.h"
 #include "bn_memory_manager.h"
 #include "bn_display_manager.h"
@@ -25,6 +30,8 @@
 #include "bn_cameras_manager.h"
 #include "bn_palettes_manager.h"
 #include "bn_bg_blocks_manager.h"
+#include "bn_bitmap_bg_manager.h"
+#include "bn_async_loads_manager.h"
 #include "bn_sprite_tiles_manager.h"
 #include "bn_hblank_effects_manager.h"
 #include "../hw/include/bn_hw_irq.h"
@@ -65,6 +72,8 @@ namespace bn::core
 
 namespace
 {
+    static_assert(BN_CFG_CORE_MAX_FRAME_BREAKDOWNS > 0);
+
     class ticks
     {
 
@@ -73,12 +82,42 @@ namespace
         int vblank_usage_ticks = 0;
     };
 
+    class frame_breakdown_timer
+    {
+
+    public:
+        explicit frame_breakdown_timer(frame_breakdown& breakdown) :
+            _breakdown(breakdown),
+            _last_ticks(hw::timer::ticks())
+        {
+        }
+
+        void restart()
+        {
+            _last_ticks = hw::timer::ticks();
+        }
+
+        void stop(frame_stage stage)
+        {
+            unsigned ticks = hw::timer::ticks();
+            _breakdown.set_ticks(stage, int(ticks - _last_ticks));
+            _last_ticks = ticks;
+        }
+
+    private:
+        frame_breakdown& _breakdown;
+        unsigned _last_ticks;
+    };
+
     class static_data
     {
 
     public:
         timer cpu_usage_timer;
         ticks last_ticks;
+        deque<frame_breakdown, BN_CFG_CORE_MAX_FRAME_BREAKDOWNS> frame_breakdowns;
+        optional<int> vblank_commit_budget;
+        int last_deferred_commit_bytes = 0;
         int skip_frames = 0;
         int last_update_frames = 1;
         bool restart_cpu_usage_timer = false;
@@ -95,6 +134,9 @@ namespace
         }
 
         hdma_manager::commit();
+
+        // If the next frame is not committed in time, the last one must be displayed again:
+        sprites_manager::restore_multiplexed_items();
     }
 
     void enable()
@@ -123,6 +165,7 @@ namespace
         audio_manager::stop();
         audio_manager::disable_vblank_handler();
         hw::core::wait_for_vblank();
+        audio_manager::mix();
         audio_manager::commit();
 
         hdma_manager::force_stop();
@@ -136,45 +179,78 @@ namespace
         disable(disable_audio);
     }
 
+    [[nodiscard]] int deferrable_commit_max_ticks(const timer& commit_timer)
+    {
+        if(data.vblank_commit_budget)
+        {
+            return *data.vblank_commit_budget - commit_timer.elapsed_ticks();
+        }
+
+        return numeric_limits<int>::max();
+    }
+
     [[nodiscard]] ticks update_impl()
     {
         ticks result;
 
+        if(data.frame_breakdowns.full())
+        {
+            data.frame_breakdowns.pop_front();
+        }
+
+        data.frame_breakdowns.push_back(frame_breakdown());
+
+        frame_breakdown_timer breakdown_timer(data.frame_breakdowns.back());
+
         BN_PROFILER_ENGINE_START("eng_cameras_update");
         cameras_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::CAMERAS_UPDATE);
 
         BN_PROFILER_ENGINE_START("eng_sprites_update");
         sprites_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::SPRITES_UPDATE);
 
         BN_PROFILER_ENGINE_START("eng_spr_tiles_update");
         sprite_tiles_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::SPRITE_TILES_UPDATE);
 
         BN_PROFILER_ENGINE_START("eng_bgs_update");
         bgs_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::BGS_UPDATE);
 
         BN_PROFILER_ENGINE_START("eng_bg_blocks_update");
         bg_blocks_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::BG_BLOCKS_UPDATE);
 
         BN_PROFILER_ENGINE_START("eng_palettes_update");
         palettes_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::PALETTES_UPDATE);
 
         BN_PROFILER_ENGINE_START("eng_display_update");
         display_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::DISPLAY_UPDATE);
 
         BN_PROFILER_ENGINE_START("eng_hblank_fx_update");
         hblank_effects_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::HBLANK_EFFECTS_UPDATE);
 
         BN_PROFILER_ENGINE_START("eng_hdma_update");
         hdma_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::HDMA_UPDATE);
+
+        BN_PROFILER_ENGINE_START("eng_async_update");
+        async_loads_manager::update();
+        BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::ASYNC_LOADS_UPDATE);
 
         audio_manager::disable_vblank_handler();
 
@@ -182,54 +258,94 @@ namespace
         data.restart_cpu_usage_timer = true;
 
         hw::core::wait_for_vblank();
+        breakdown_timer.restart();
+
+        timer commit_timer;
+        int deferred_commit_bytes = 0;
 
         BN_PROFILER_ENGINE_START("eng_hblank_fx_commit");
         hblank_effects_manager::commit();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::HBLANK_EFFECTS_COMMIT);
 
         BN_PROFILER_ENGINE_START("eng_display_commit");
         display_manager::commit();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::DISPLAY_COMMIT);
 
         BN_PROFILER_ENGINE_START("eng_sprites_commit");
         sprites_manager::commit();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::SPRITES_COMMIT);
 
         BN_PROFILER_ENGINE_START("eng_bgs_commit");
         bgs_manager::commit();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::BGS_COMMIT);
 
         BN_PROFILER_ENGINE_START("eng_palettes_commit");
         palettes_manager::commit();
         BN_PROFILER_ENGINE_STOP();
 
+        // Display, BGs and palettes commits can overwrite HDMA registers of the first screen line:
+        BN_PROFILER_ENGINE_START("eng_hdma_commit");
+        hdma_manager::commit_first_lines();
+        BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::PALETTES_COMMIT);
+
         BN_PROFILER_ENGINE_START("eng_spr_tiles_commit");
-        sprite_tiles_manager::commit();
+        deferred_commit_bytes += sprite_tiles_manager::commit(deferrable_commit_max_ticks(commit_timer));
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::SPRITE_TILES_COMMIT);
 
         BN_PROFILER_ENGINE_START("eng_big_maps_commit");
-        bgs_manager::commit_big_maps();
+        // Moved BG blocks must be copied before big maps are committed to their new location:
+        bg_blocks_manager::commit_relocations();
+        deferred_commit_bytes += bgs_manager::commit_big_maps(deferrable_commit_max_ticks(commit_timer));
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::BIG_MAPS_COMMIT);
 
         BN_PROFILER_ENGINE_START("eng_bg_blocks_commit");
-        bg_blocks_manager::commit();
+        deferred_commit_bytes += bg_blocks_manager::commit(deferrable_commit_max_ticks(commit_timer));
+        BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::BG_BLOCKS_COMMIT);
+
+        BN_PROFILER_ENGINE_START("eng_async_commit");
+        deferred_commit_bytes += async_loads_manager::commit(deferrable_commit_max_ticks(commit_timer));
+        BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::ASYNC_LOADS_COMMIT);
+
+        // Bitmap BG EWRAM buffers are copied after the other commits to stay ahead of the beam:
+        BN_PROFILER_ENGINE_START("eng_bitmap_bg_commit");
+        bitmap_bg_manager::commit();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::BITMAP_BG_COMMIT);
+
+        data.last_deferred_commit_bytes = deferred_commit_bytes;
 
         BN_PROFILER_ENGINE_START("eng_cpu_usage");
         result.vblank_usage_ticks = data.cpu_usage_timer.elapsed_ticks();
         BN_PROFILER_ENGINE_STOP();
 
+        BN_PROFILER_ENGINE_START("eng_audio_mix");
+        audio_manager::mix();
+        BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::AUDIO_MIX);
+
         BN_PROFILER_ENGINE_START("eng_audio_commit");
         audio_manager::commit();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::AUDIO_COMMIT);
 
         BN_PROFILER_ENGINE_START("eng_gpio_commit");
         gpio_manager::commit();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::GPIO_COMMIT);
 
         BN_PROFILER_ENGINE_START("eng_keypad");
         keypad_manager::update();
         BN_PROFILER_ENGINE_STOP();
+        breakdown_timer.stop(frame_stage::KEYPAD_UPDATE);
 
         return result;
     }
@@ -271,6 +387,7 @@ void init(const string_view& keypad_commands)
     sprite_tiles_manager::init();
     sprites_manager::init();
     bg_blocks_manager::init();
+    async_loads_manager::init();
     keypad_manager::init(keypad_commands);
 
     // WTF hack (if it isn't present and flto is enabled, sometimes everything crash):
@@ -425,6 +542,38 @@ fixed last_vblank_usage()
     return fixed(data.last_ticks.vblank_usage_ticks) / (timers::ticks_per_vblank() * data.last_update_frames);
 }
 
+optional<int> vblank_commit_budget()
+{
+    return data.vblank_commit_budget;
+}
+
+void set_vblank_commit_budget(int ticks)
+{
+    BN_ASSERT(ticks >= 0, "Invalid ticks: ", ticks);
+
+    data.vblank_commit_budget = ticks;
+}
+
+void remove_vblank_commit_budget()
+{
+    data.vblank_commit_budget.reset();
+}
+
+int last_deferred_commit_bytes()
+{
+    return data.last_deferred_commit_bytes;
+}
+
+const frame_breakdown& last_frame_breakdown()
+{
+    return data.frame_breakdowns.back();
+}
+
+const ideque<frame_breakdown>& frame_breakdowns()
+{
+    return data.frame_breakdowns;
+}
+
 }
 
 #if BN_CFG_ASSERT_ENABLED
@@ -31,6 +31,8 @@ namespace
 
     public:
         int mode = 0;
+        int bitmap_mode = 0;
+        int bitmap_page = 0;
         bool enabled_bgs[hw::bgs::count()] = {};
         fixed sprites_mosaic_horizontal_stretch;
         fixed sprites_mosaic_vertical_stretch;
@@ -120,6 +122,27 @@ void set_mode(int mode)
     }
 }
 
+void set_bitmap_mode(int mode)
+{
+    if(data.bitmap_mode != mode)
+    {
+        data.bitmap_mode = mode;
+        data.bitmap_page = 0;
+        data.commit_display = true;
+        data.commit = true;
+    }
+}
+
+void set_bitmap_page(int page)
+{
+    if(data.bitmap_page != page)
+    {
+        data.bitmap_page = page;
+        data.commit_display = true;
+        data.commit = true;
+    }
+}
+
 bool bg_enabled(int bg)
 {
     return data.enabled_bgs[bg];
@@ -802,7 +825,18 @@ void commit()
 
         if(data.commit_display)
         {
-            hw::display::setup(data.mode, data.enabled_bgs, data.inside_windows_enabled);
+            if(int bitmap_mode = data.bitmap_mode)
+            {
+                // Bitmap modes display only BG 2:
+                constexpr bool bitmap_enabled_bgs[hw::bgs::count()] = { false, false, true, false };
+                hw::display::setup(bitmap_mode, data.bitmap_page == 1, bitmap_enabled_bgs,
+                                   data.inside_windows_enabled);
+            }
+            else
+            {
+                hw::display::setup(data.mode, false, data.enabled_bgs, data.inside_windows_enabled);
+            }
+
             data.commit_display = false;
         }
 
@@ -27,6 +27,10 @@ namespace bn::display_manager
 
     void set_mode(int mode);
 
+    void set_bitmap_mode(int mode);
+
+    void set_bitmap_page(int page);
+
     [[nodiscard]] bool bg_enabled(int bg);
 
     void set_bg_enabled(int bg, bool enabled);
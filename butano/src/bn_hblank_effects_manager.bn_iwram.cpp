@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_hblank_effects_manager.h"
+
+#include "bn_display.h"
+#include "bn_sin_lut.h"
+#include "bn_algorithm.h"
+#include "bn_hbe_parallax_band.h"
+
+namespace bn::hblank_effects_manager
+{
+
+void _fill_wave_impl(int base_value, int amplitude, unsigned angle, unsigned angle_step, uint16_t* output_values_ptr)
+{
+    // Angles have 24 bits per turn and sin_lut has 2048 entries per turn:
+    const int16_t* sin_lut_data = sin_lut.data();
+
+    for(int index = 0, limit = display::height(); index < limit; ++index)
+    {
+        int sin_value = sin_lut_data[(angle >> 13) & 2047];
+        int delta = int((int64_t(amplitude) * sin_value) >> (fixed::precision() * 2));
+        output_values_ptr[index] = uint16_t(base_value + delta);
+        angle += angle_step;
+    }
+}
+
+void _fill_parallax_bands_impl(int base_value, int hw_offset, const hbe_parallax_band* bands_ptr, int bands_count,
+                               uint16_t* output_values_ptr)
+{
+    uint16_t* output_values_end = output_values_ptr + display::height();
+
+    // The target position is multiplied instead of its hardware position (hw_offset - position),
+    // so bands are aligned with the target when its position is zero:
+    int position = hw_offset - base_value;
+
+    for(int index = 0; index < bands_count; ++index)
+    {
+        const hbe_parallax_band& band = bands_ptr[index];
+        auto value = uint16_t(hw_offset - ((position * band.position_factor().data()) >> fixed::precision()));
+        uint16_t* band_end = min(output_values_ptr + band.lines(), output_values_end);
+
+        while(output_values_ptr < band_end)
+        {
+            *output_values_ptr = value;
+            ++output_values_ptr;
+        }
+    }
+
+    // Lines after the last band keep the position of the target:
+    auto value = uint16_t(base_value);
+
+    while(output_values_ptr < output_values_end)
+    {
+        *output_values_ptr = value;
+        ++output_values_ptr;
+    }
+}
+
+}
@@ -5,7 +5,13 @@
 
 #include "bn_hblank_effects_manager.h"
 
+#include "bn_size.h"
 #include "bn_vector.h"
+#include "bn_display.h"
+#include "bn_hbe_wave.h"
+#include "bn_hdma_manager.h"
+#include "bn_hbe_parallax_band.h"
+#include "bn_rule_of_three_approximation.h"
 #include "../hw/include/bn_hw_hblank_effects.h"
 
 #include "bn_bg_palette_color_hbe_handler.h"
@@ -221,6 +227,38 @@ namespace
         }
     }
 
+    enum class generator_type : uint8_t
+    {
+        NONE,
+        WAVE,
+        PARALLAX_BANDS
+    };
+
+    [[nodiscard]] bool _generator_supported(handler_type handler)
+    {
+        return handler == handler_type::REGULAR_BG_HORIZONTAL_POSITION ||
+                handler == handler_type::REGULAR_BG_VERTICAL_POSITION;
+    }
+
+    [[nodiscard]] unsigned _wave_angle(fixed degrees_angle)
+    {
+        // Wave angles have 24 bits per turn to avoid accumulating rounding errors between screen lines:
+        constexpr rule_of_three_approximation rule_of_three(fixed(360).data(), 1 << 24);
+        return unsigned(rule_of_three.calculate(degrees_angle.data()));
+    }
+
+    [[nodiscard]] int _parallax_bands_lines(const hbe_parallax_band* bands_ptr, int bands_count)
+    {
+        int result = 0;
+
+        for(int index = 0; index < bands_count; ++index)
+        {
+            result += bands_ptr[index].lines();
+        }
+
+        return result;
+    }
+
     class uint16_output_values_type
     {
 
@@ -250,7 +288,10 @@ namespace
         uint16_t* output_register = nullptr;
         uint16_output_values_type* uint16_output_values = nullptr;
         uint32_output_values_type* uint32_output_values = nullptr;
+        hbe_wave wave = hbe_wave(0, 0, 0);
+        uint8_t parallax_bands_count = 0;
         handler_type handler;
+        generator_type generator = generator_type::NONE;
         bool visible: 1 = false;
         bool update: 1 = false;
         bool on_screen: 1 = false;
@@ -565,9 +606,27 @@ namespace
             }
         }
 
-        void setup_entry(hw_entries& entries) const
+        void setup_entry(hw_entries& entries, int dma_channel) const
         {
-            if(_is_uint32(handler))
+            if(dma_channel >= 0)
+            {
+                hw::hblank_effects::dma_entry& dma_entry = entries.dma_entries[entries.dma_entries_count];
+
+                if(uint16_output_values)
+                {
+                    dma_entry.src = uint16_output_values->a_active ? uint16_output_values->a : uint16_output_values->b;
+                }
+                else
+                {
+                    dma_entry.src = uint32_output_values->a_active ? uint32_output_values->a : uint32_output_values->b;
+                }
+
+                dma_entry.dest = output_register;
+                dma_entry.channel = dma_channel;
+                dma_entry.uint32 = _is_uint32(handler);
+                ++entries.dma_entries_count;
+            }
+            else if(_is_uint32(handler))
             {
                 BN_ASSERT(entries.uint32_entries_count < max_uint32_output_values, "Too much 32 bits entries");
 
@@ -946,6 +1005,51 @@ namespace
         }
 
     private:
+        [[nodiscard]] bool _update_wave_phase()
+        {
+            fixed phase_speed = wave.phase_speed();
+
+            if(generator != generator_type::WAVE || phase_speed == 0)
+            {
+                return false;
+            }
+
+            fixed phase = wave.phase() + phase_speed;
+
+            if(phase >= 360)
+            {
+                phase -= 360;
+            }
+            else if(phase < 0)
+            {
+                phase += 360;
+            }
+
+            wave.set_phase(phase);
+            return true;
+        }
+
+        void _write_generated_output_values(uint16_t* output_values_ptr) const
+        {
+            int base_value = target_last_value.value<int>();
+
+            if(generator == generator_type::WAVE)
+            {
+                _fill_wave_impl(base_value, wave.amplitude().data(), _wave_angle(wave.phase()),
+                                _wave_angle(wave.frequency()), output_values_ptr);
+            }
+            else
+            {
+                // Hardware positions are calculated by bgs_manager from the target position and its half dimensions:
+                auto handle = reinterpret_cast<void*>(target_id);
+                size dimensions = bgs_manager::dimensions(handle);
+                int hw_offset = handler == handler_type::REGULAR_BG_HORIZONTAL_POSITION ?
+                            (dimensions.width() - display::width()) / 2 : (dimensions.height() - display::height()) / 2;
+                _fill_parallax_bands_impl(base_value, hw_offset, static_cast<const hbe_parallax_band*>(values_ptr),
+                                          parallax_bands_count, output_values_ptr);
+            }
+        }
+
         template<class Handler>
         [[nodiscard]] bool _check_update_impl()
         {
@@ -956,8 +1060,12 @@ namespace
             bool new_on_screen = Handler::target_visible(target_id);
             on_screen = new_on_screen;
 
+            // Waves keep moving even if their target is not on screen:
+            bool wave_phase_updated = _update_wave_phase();
+
             if(new_on_screen)
             {
+                updated |= wave_phase_updated;
                 updated |= Handler::target_updated(target_id, target_last_value);
 
                 if(! output_values_written)
@@ -997,7 +1105,14 @@ namespace
                         }
                     }
 
-                    Handler::write_output_values(target_id, target_last_value, values_ptr, output_values_ptr);
+                    if(generator == generator_type::NONE)
+                    {
+                        Handler::write_output_values(target_id, target_last_value, values_ptr, output_values_ptr);
+                    }
+                    else
+                    {
+                        _write_generated_output_values(output_values_ptr);
+                    }
                 }
 
                 uint16_t* old_output_register = output_register;
@@ -1020,8 +1135,12 @@ namespace
         vector<int8_t, max_items> free_item_indexes;
         vector<int8_t, max_uint16_output_values> free_uint16_output_values_indexes;
         vector<int8_t, max_uint32_output_values> free_uint32_output_values_indexes;
+        uint8_t lines_a[display::height()];
+        uint8_t lines_b[display::height()];
         int8_t first_visible_item_index = max_items - 1;
         int8_t last_visible_item_index = 0;
+        uint8_t dma_channels_mask = 0;
+        uint8_t committed_dma_channels_mask = 0;
         bool visible_entries = false;
         bool entries_a_active = false;
         bool update = false;
@@ -1040,6 +1159,41 @@ namespace
     BN_DATA_EWRAM static_external_data external_data;
     static_internal_data internal_data;
 
+    [[nodiscard]] unsigned _dma_channels_mask()
+    {
+        if constexpr(BN_CFG_HBES_DMA_ENABLED)
+        {
+            // HDMA channels can't be used if they are allocated or running:
+            return hdma_manager::free_channels_mask();
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    [[nodiscard]] int _pop_dma_channel(unsigned& dma_channels_mask)
+    {
+        for(int channel = 0; dma_channels_mask; ++channel)
+        {
+            unsigned channel_mask = 1U << channel;
+
+            if(dma_channels_mask & channel_mask)
+            {
+                dma_channels_mask &= ~channel_mask;
+                return channel;
+            }
+        }
+
+        return -1;
+    }
+
+    void _stop_dmas(unsigned used_dma_channels_mask)
+    {
+        unsigned unused_dma_channels_mask = external_data.committed_dma_channels_mask & ~used_dma_channels_mask;
+        hw::hblank_effects::stop_dmas(unused_dma_channels_mask & _dma_channels_mask());
+    }
+
     void _update_visible_item_index(int item_index)
     {
         static_external_data& data = external_data;
@@ -1123,6 +1277,7 @@ namespace
         new_item.uint16_output_values = uint16_output_values;
         new_item.uint32_output_values = uint32_output_values;
         new_item.handler = handler;
+        new_item.generator = generator_type::NONE;
         new_item.visible = true;
         new_item.update = true;
         new_item.on_screen = false;
@@ -1180,6 +1335,8 @@ void disable()
     {
         hw::hblank_effects::disable();
     }
+
+    _stop_dmas(0);
 }
 
 int create(const void* values_ptr, [[maybe_unused]] int values_count, intptr_t target_id, handler_type handler)
@@ -1197,6 +1354,54 @@ int create_optional(const void* values_ptr, [[maybe_unused]] int values_count, i
     return _create(values_ptr, target_id, handler, true);
 }
 
+int create_wave(const hbe_wave& wave, intptr_t target_id, handler_type handler)
+{
+    BN_ASSERT(_generator_supported(handler), "Handler doesn't support waves: ", int(handler));
+
+    int result = _create(nullptr, target_id, handler, false);
+    set_wave(result, wave);
+    return result;
+}
+
+int create_wave_optional(const hbe_wave& wave, intptr_t target_id, handler_type handler)
+{
+    BN_ASSERT(_generator_supported(handler), "Handler doesn't support waves: ", int(handler));
+
+    int result = _create(nullptr, target_id, handler, true);
+
+    if(result >= 0)
+    {
+        set_wave(result, wave);
+    }
+
+    return result;
+}
+
+int create_parallax_bands(const hbe_parallax_band* bands_ptr, int bands_count, intptr_t target_id,
+                          handler_type handler)
+{
+    BN_ASSERT(_generator_supported(handler), "Handler doesn't support parallax bands: ", int(handler));
+
+    int result = _create(nullptr, target_id, handler, false);
+    set_parallax_bands_ref(result, bands_ptr, bands_count);
+    return result;
+}
+
+int create_parallax_bands_optional(const hbe_parallax_band* bands_ptr, int bands_count, intptr_t target_id,
+                                   handler_type handler)
+{
+    BN_ASSERT(_generator_supported(handler), "Handler doesn't support parallax bands: ", int(handler));
+
+    int result = _create(nullptr, target_id, handler, true);
+
+    if(result >= 0)
+    {
+        set_parallax_bands_ref(result, bands_ptr, bands_count);
+    }
+
+    return result;
+}
+
 void increase_usages(int id)
 {
     item_type& item = external_data.items[id];
@@ -1238,7 +1443,7 @@ void decrease_usages(int id)
 const void* values_ref(int id)
 {
     const item_type& item = external_data.items[id];
-    return item.values_ptr;
+    return item.generator == generator_type::NONE ? item.values_ptr : nullptr;
 }
 
 void set_values_ref(int id, const void* values_ptr, [[maybe_unused]] int values_count)
@@ -1248,6 +1453,7 @@ void set_values_ref(int id, const void* values_ptr, [[maybe_unused]] int values_
 
     item_type& item = external_data.items[id];
     item.values_ptr = values_ptr;
+    item.generator = generator_type::NONE;
     item.update = true;
 
     if(item.visible)
@@ -1267,6 +1473,65 @@ void reload_values_ref(int id)
     }
 }
 
+const hbe_wave* wave(int id)
+{
+    const item_type& item = external_data.items[id];
+    return item.generator == generator_type::WAVE ? &item.wave : nullptr;
+}
+
+void set_wave(int id, const hbe_wave& wave)
+{
+    item_type& item = external_data.items[id];
+    BN_ASSERT(_generator_supported(item.handler), "Handler doesn't support waves: ", int(item.handler));
+
+    item.wave = wave;
+    item.values_ptr = nullptr;
+    item.generator = generator_type::WAVE;
+    item.update = true;
+
+    if(item.visible)
+    {
+        external_data.update = true;
+    }
+}
+
+const hbe_parallax_band* parallax_bands_ref(int id)
+{
+    const item_type& item = external_data.items[id];
+
+    if(item.generator != generator_type::PARALLAX_BANDS)
+    {
+        return nullptr;
+    }
+
+    return static_cast<const hbe_parallax_band*>(item.values_ptr);
+}
+
+int parallax_bands_count(int id)
+{
+    const item_type& item = external_data.items[id];
+    return item.generator == generator_type::PARALLAX_BANDS ? item.parallax_bands_count : 0;
+}
+
+void set_parallax_bands_ref(int id, const hbe_parallax_band* bands_ptr, int bands_count)
+{
+    item_type& item = external_data.items[id];
+    BN_ASSERT(_generator_supported(item.handler), "Handler doesn't support parallax bands: ", int(item.handler));
+    BN_ASSERT(bands_count > 0 && bands_count <= display::height(), "Invalid bands count: ", bands_count);
+    BN_ASSERT(_parallax_bands_lines(bands_ptr, bands_count) <= display::height(),
+              "Too many parallax bands lines: ", _parallax_bands_lines(bands_ptr, bands_count));
+
+    item.values_ptr = bands_ptr;
+    item.parallax_bands_count = uint8_t(bands_count);
+    item.generator = generator_type::PARALLAX_BANDS;
+    item.update = true;
+
+    if(item.visible)
+    {
+        external_data.update = true;
+    }
+}
+
 [[nodiscard]] bool visible(int id)
 {
     const item_type& item = external_data.items[id];
@@ -1298,6 +1563,15 @@ void update()
     bool update = external_data.update;
     external_data.update = false;
 
+    // Entries must be assigned again to DMA channels if HDMA channels are allocated, released, started or stopped:
+    unsigned dma_channels_mask = _dma_channels_mask();
+
+    if(dma_channels_mask != external_data.dma_channels_mask)
+    {
+        external_data.dma_channels_mask = uint8_t(dma_channels_mask);
+        update = true;
+    }
+
     int first_visible_item_index = external_data.first_visible_item_index;
     int last_visible_item_index = external_data.last_visible_item_index;
 
@@ -1342,33 +1616,46 @@ void update()
     if(update)
     {
         hw_entries* entries;
+        uint8_t* lines;
         bool visible_entries = false;
 
         if(external_data.entries_a_active)
         {
             entries = &internal_data.entries_b;
+            lines = external_data.lines_b;
             external_data.entries_a_active = false;
         }
         else
         {
             entries = &internal_data.entries_a;
+            lines = external_data.lines_a;
             external_data.entries_a_active = true;
         }
 
         entries->uint16_entries_count = 0;
         entries->uint32_entries_count = 0;
+        entries->dma_entries_count = 0;
 
+        // The first visible entries are committed with DMA, and the remaining ones with the H-Blank interrupt:
         for(int item_index = first_visible_item_index; item_index <= last_visible_item_index; ++item_index)
         {
             const item_type& item = external_data.items[item_index];
 
             if(item.visible && item.on_screen)
             {
-                item.setup_entry(*entries);
+                item.setup_entry(*entries, _pop_dma_channel(dma_channels_mask));
                 visible_entries = true;
             }
         }
 
+        if(visible_entries)
+        {
+            // Only the lines in which at least one value changes raise the H-Blank interrupt
+            // (DMA entries need the interrupt of the first line only):
+            entries->lines = lines;
+            entries->lines_count = hw::hblank_effects::build_lines(*entries, lines);
+        }
+
         external_data.visible_entries = visible_entries;
         external_data.commit = true;
     }
@@ -1380,11 +1667,18 @@ void commit()
     {
         external_data.commit = false;
 
+        unsigned dma_channels_mask = 0;
+
         if(external_data.visible_entries)
         {
             hw_entries* entries = external_data.entries_a_active ? &internal_data.entries_a : &internal_data.entries_b;
             hw::hblank_effects::commit_entries(*entries);
 
+            for(int index = 0, limit = entries->dma_entries_count; index < limit; ++index)
+            {
+                dma_channels_mask |= 1U << entries->dma_entries[index].channel;
+            }
+
             if(! external_data.enabled)
             {
                 external_data.enabled = true;
@@ -1399,6 +1693,9 @@ void commit()
                 hw::hblank_effects::disable();
             }
         }
+
+        _stop_dmas(dma_channels_mask);
+        external_data.committed_dma_channels_mask = uint8_t(dma_channels_mask);
     }
 }
 
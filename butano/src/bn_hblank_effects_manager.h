@@ -8,6 +8,12 @@
 
 #include "bn_common.h"
 
+namespace bn
+{
+    class hbe_wave;
+    class hbe_parallax_band;
+}
+
 namespace bn::hblank_effects_manager
 {
     enum class handler_type : uint8_t
@@ -70,6 +76,16 @@ namespace bn::hblank_effects_manager
     [[nodiscard]] int create_optional(const void* values_ptr, int values_count, intptr_t target_id,
                                       handler_type handler);
 
+    [[nodiscard]] int create_wave(const hbe_wave& wave, intptr_t target_id, handler_type handler);
+
+    [[nodiscard]] int create_wave_optional(const hbe_wave& wave, intptr_t target_id, handler_type handler);
+
+    [[nodiscard]] int create_parallax_bands(const hbe_parallax_band* bands_ptr, int bands_count, intptr_t target_id,
+                                            handler_type handler);
+
+    [[nodiscard]] int create_parallax_bands_optional(const hbe_parallax_band* bands_ptr, int bands_count,
+                                                     intptr_t target_id, handler_type handler);
+
     void increase_usages(int id);
 
     void decrease_usages(int id);
@@ -80,6 +96,16 @@ namespace bn::hblank_effects_manager
 
     void reload_values_ref(int id);
 
+    [[nodiscard]] const hbe_wave* wave(int id);
+
+    void set_wave(int id, const hbe_wave& wave);
+
+    [[nodiscard]] const hbe_parallax_band* parallax_bands_ref(int id);
+
+    [[nodiscard]] int parallax_bands_count(int id);
+
+    void set_parallax_bands_ref(int id, const hbe_parallax_band* bands_ptr, int bands_count);
+
     [[nodiscard]] bool visible(int id);
 
     void set_visible(int id, bool visible);
@@ -87,6 +113,12 @@ namespace bn::hblank_effects_manager
     void update();
 
     void commit();
+
+    BN_CODE_IWRAM void _fill_wave_impl(int base_value, int amplitude, unsigned angle, unsigned angle_step,
+                                       uint16_t* output_values_ptr);
+
+    BN_CODE_IWRAM void _fill_parallax_bands_impl(int base_value, int hw_offset, const hbe_parallax_band* bands_ptr,
+                                                 int bands_count, uint16_t* output_values_ptr);
 }
 
 #endif
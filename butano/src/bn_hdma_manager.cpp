@@ -10,25 +10,33 @@
 #include "../hw/include/bn_hw_memory.h"
 
 #include "bn_hdma.cpp.h"
+#include "bn_hdma_ptr.cpp.h"
 
 namespace bn::hdma_manager
 {
 
 namespace
 {
+    constexpr const int first_allocatable_channel = hw::hdma::first_allocatable_channel();
+    constexpr const int last_allocatable_channel = hw::hdma::last_allocatable_channel();
+    constexpr const int allocatable_channels = last_allocatable_channel - first_allocatable_channel + 1;
+
     class state
     {
 
     public:
-        const uint16_t* source_ptr = nullptr;
-        uint16_t* destination_ptr = nullptr;
+        const void* source_ptr = nullptr;
+        void* destination_ptr = nullptr;
         int elements = 0;
+        bool uint32 = false;
     };
 
     class entry
     {
 
     public:
+        entry() = default;
+
         explicit entry(int channel) :
             _channel(channel)
         {
@@ -39,17 +47,23 @@ namespace
             return _next_state().elements;
         }
 
+        [[nodiscard]] bool start_pending() const
+        {
+            return _updated && _next_state().elements;
+        }
+
         void disable()
         {
             hw::hdma::stop(_channel);
         }
 
-        void start(const uint16_t& source_ref, int elements, uint16_t& destination_ref)
+        void start(const void* source_ptr, int elements, void* destination_ptr, bool uint32)
         {
             state& next_state = _next_state();
-            next_state.source_ptr = &source_ref;
-            next_state.destination_ptr = &destination_ref;
+            next_state.source_ptr = source_ptr;
+            next_state.destination_ptr = destination_ptr;
             next_state.elements = elements;
+            next_state.uint32 = uint32;
             _updated = true;
         }
 
@@ -65,6 +79,7 @@ namespace
             _states[0].elements = 0;
             _states[1].elements = 0;
             _updated = false;
+            _committed = false;
             disable();
         }
 
@@ -93,15 +108,48 @@ namespace
 
             if(int elements = current_state.elements)
             {
-                const uint16_t* source_ptr = current_state.source_ptr;
-                uint16_t* destination_ptr = current_state.destination_ptr;
-                hw::memory::copy_half_words(source_ptr + ((display::height() - 1) * elements),
-                                            elements, destination_ptr);
-                hw::hdma::start(_channel, source_ptr, elements, destination_ptr);
+                commit_first_line();
+
+                if(current_state.uint32)
+                {
+                    hw::hdma::start(_channel, static_cast<const uint32_t*>(current_state.source_ptr), elements,
+                                    static_cast<uint32_t*>(current_state.destination_ptr));
+                }
+                else
+                {
+                    hw::hdma::start(_channel, static_cast<const uint16_t*>(current_state.source_ptr), elements,
+                                    static_cast<uint16_t*>(current_state.destination_ptr));
+                }
+
+                _committed = true;
             }
-            else
+            else if(_committed)
             {
+                // Stopped channels are not stopped again, since they can be used by H-Blank effects:
                 hw::hdma::stop(_channel);
+                _committed = false;
+            }
+        }
+
+        void commit_first_line() const
+        {
+            const state& current_state = _current_state();
+
+            if(int elements = current_state.elements)
+            {
+                // The values of the first screen line are the last ones of the source:
+                if(current_state.uint32)
+                {
+                    auto source_ptr = static_cast<const uint32_t*>(current_state.source_ptr);
+                    hw::memory::copy_words(source_ptr + ((display::height() - 1) * elements), elements,
+                                           static_cast<uint32_t*>(current_state.destination_ptr));
+                }
+                else
+                {
+                    auto source_ptr = static_cast<const uint16_t*>(current_state.source_ptr);
+                    hw::memory::copy_half_words(source_ptr + ((display::height() - 1) * elements), elements,
+                                                static_cast<uint16_t*>(current_state.destination_ptr));
+                }
             }
         }
 
@@ -110,6 +158,7 @@ namespace
         int8_t _channel = 0;
         int8_t _current_state_index = 0;
         bool _updated = false;
+        bool _committed = false;
 
         [[nodiscard]] const state& _current_state() const
         {
@@ -136,11 +185,65 @@ namespace
     {
 
     public:
-        entry low_priority_entry = entry(hw::hdma::low_priority_channel());
         entry high_priority_entry = entry(hw::hdma::high_priority_channel());
+        entry allocatable_entries[allocatable_channels];
+        uint8_t allocatable_usages[allocatable_channels] = {};
+
+        static_data()
+        {
+            for(int index = 0; index < allocatable_channels; ++index)
+            {
+                allocatable_entries[index] = entry(first_allocatable_channel + index);
+            }
+        }
     };
 
+    static_assert(allocatable_channels > 0);
+
     BN_DATA_EWRAM static_data data;
+
+    [[nodiscard]] entry& _allocatable_entry(int channel)
+    {
+        return data.allocatable_entries[channel - first_allocatable_channel];
+    }
+
+    [[nodiscard]] uint8_t& _allocatable_usages(int channel)
+    {
+        return data.allocatable_usages[channel - first_allocatable_channel];
+    }
+
+    [[nodiscard]] entry& _low_priority_entry()
+    {
+        BN_ASSERT(! _allocatable_usages(hw::hdma::low_priority_channel()),
+                  "Low priority HDMA channel is used by a bn::hdma_ptr");
+
+        return _allocatable_entry(hw::hdma::low_priority_channel());
+    }
+
+    [[nodiscard]] int _create(bool optional)
+    {
+        // Channel 2 is allocated first (if it's available), so the low priority channel can be used by bn::hdma:
+        for(int channel = first_allocatable_channel; channel <= last_allocatable_channel; ++channel)
+        {
+            uint8_t& usages = _allocatable_usages(channel);
+
+            if(! usages && ! _allocatable_entry(channel).running())
+            {
+                usages = 1;
+                return channel;
+            }
+        }
+
+        BN_ASSERT(optional, "No more available HDMA channels");
+        return -1;
+    }
+
+    void _check_allocated(int channel)
+    {
+        BN_ASSERT(channel >= first_allocatable_channel && channel <= last_allocatable_channel,
+                  "Invalid channel: ", channel);
+        BN_ASSERT(_allocatable_usages(channel), "Channel is not allocated: ", channel);
+    }
 }
 
 void enable()
@@ -150,29 +253,47 @@ void enable()
 
 void disable()
 {
-    data.low_priority_entry.disable();
     data.high_priority_entry.disable();
+
+    for(entry& allocatable_entry : data.allocatable_entries)
+    {
+        allocatable_entry.disable();
+    }
 }
 
 void force_stop()
 {
-    data.low_priority_entry.force_stop();
     data.high_priority_entry.force_stop();
+
+    for(entry& allocatable_entry : data.allocatable_entries)
+    {
+        allocatable_entry.force_stop();
+    }
 }
 
 bool low_priority_running()
 {
-    return data.low_priority_entry.running();
+    return _allocatable_entry(hw::hdma::low_priority_channel()).running();
 }
 
 void low_priority_start(const uint16_t& source_ref, int elements, uint16_t& destination_ref)
 {
-    data.low_priority_entry.start(source_ref, elements, destination_ref);
+    _low_priority_entry().start(&source_ref, elements, &destination_ref, false);
+}
+
+void low_priority_start(const uint32_t& source_ref, int elements, uint32_t& destination_ref)
+{
+    _low_priority_entry().start(&source_ref, elements, &destination_ref, true);
 }
 
 void low_priority_stop()
 {
-    data.low_priority_entry.stop();
+    int channel = hw::hdma::low_priority_channel();
+
+    if(! _allocatable_usages(channel))
+    {
+        _allocatable_entry(channel).stop();
+    }
 }
 
 bool high_priority_running()
@@ -182,7 +303,12 @@ bool high_priority_running()
 
 void high_priority_start(const uint16_t& source_ref, int elements, uint16_t& destination_ref)
 {
-    data.high_priority_entry.start(source_ref, elements, destination_ref);
+    data.high_priority_entry.start(&source_ref, elements, &destination_ref, false);
+}
+
+void high_priority_start(const uint32_t& source_ref, int elements, uint32_t& destination_ref)
+{
+    data.high_priority_entry.start(&source_ref, elements, &destination_ref, true);
 }
 
 void high_priority_stop()
@@ -190,16 +316,110 @@ void high_priority_stop()
     data.high_priority_entry.stop();
 }
 
+int create()
+{
+    return _create(false);
+}
+
+int create_optional()
+{
+    return _create(true);
+}
+
+void increase_usages(int channel)
+{
+    ++_allocatable_usages(channel);
+}
+
+void decrease_usages(int channel)
+{
+    uint8_t& usages = _allocatable_usages(channel);
+    --usages;
+
+    if(! usages)
+    {
+        _allocatable_entry(channel).stop();
+    }
+}
+
+bool running(int channel)
+{
+    _check_allocated(channel);
+
+    return _allocatable_entry(channel).running();
+}
+
+bool start_pending(int channel)
+{
+    _check_allocated(channel);
+
+    return _allocatable_entry(channel).start_pending();
+}
+
+void start(int channel, const uint16_t& source_ref, int elements, uint16_t& destination_ref)
+{
+    _check_allocated(channel);
+
+    _allocatable_entry(channel).start(&source_ref, elements, &destination_ref, false);
+}
+
+void start(int channel, const uint32_t& source_ref, int elements, uint32_t& destination_ref)
+{
+    _check_allocated(channel);
+
+    _allocatable_entry(channel).start(&source_ref, elements, &destination_ref, true);
+}
+
+void stop(int channel)
+{
+    _check_allocated(channel);
+
+    _allocatable_entry(channel).stop();
+}
+
+unsigned free_channels_mask()
+{
+    unsigned result = 0;
+
+    for(int channel = first_allocatable_channel; channel <= last_allocatable_channel; ++channel)
+    {
+        if(! _allocatable_usages(channel) && ! _allocatable_entry(channel).running())
+        {
+            result |= 1U << channel;
+        }
+    }
+
+    return result;
+}
+
 void update()
 {
-    data.low_priority_entry.update();
     data.high_priority_entry.update();
+
+    for(entry& allocatable_entry : data.allocatable_entries)
+    {
+        allocatable_entry.update();
+    }
 }
 
 void commit()
 {
-    data.low_priority_entry.commit();
     data.high_priority_entry.commit();
+
+    for(entry& allocatable_entry : data.allocatable_entries)
+    {
+        allocatable_entry.commit();
+    }
+}
+
+void commit_first_lines()
+{
+    data.high_priority_entry.commit_first_line();
+
+    for(const entry& allocatable_entry : data.allocatable_entries)
+    {
+        allocatable_entry.commit_first_line();
+    }
 }
 
 }
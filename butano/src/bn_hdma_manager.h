@@ -20,17 +20,46 @@ namespace bn::hdma_manager
 
     void low_priority_start(const uint16_t& source_ref, int elements, uint16_t& destination_ref);
 
+    void low_priority_start(const uint32_t& source_ref, int elements, uint32_t& destination_ref);
+
     void low_priority_stop();
 
     [[nodiscard]] bool high_priority_running();
 
     void high_priority_start(const uint16_t& source_ref, int elements, uint16_t& destination_ref);
 
+    void high_priority_start(const uint32_t& source_ref, int elements, uint32_t& destination_ref);
+
     void high_priority_stop();
 
+    [[nodiscard]] int create();
+
+    [[nodiscard]] int create_optional();
+
+    void increase_usages(int channel);
+
+    void decrease_usages(int channel);
+
+    [[nodiscard]] bool running(int channel);
+
+    // Indicates if start has been called after the last update, so the new transfer is not running yet:
+    [[nodiscard]] bool start_pending(int channel);
+
+    void start(int channel, const uint16_t& source_ref, int elements, uint16_t& destination_ref);
+
+    void start(int channel, const uint32_t& source_ref, int elements, uint32_t& destination_ref);
+
+    void stop(int channel);
+
+    // Allocatable channels which are not allocated nor running, so they can be used by H-Blank effects:
+    [[nodiscard]] unsigned free_channels_mask();
+
     void update();
 
     void commit();
+
+    // Registers of the first screen line can be overwritten by other commits after the VBlank one:
+    void commit_first_lines();
 }
 
 #endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_hdma_ptr.h"
+
+#include "bn_assert.h"
+#include "bn_optional.h"
+#include "bn_hdma_manager.h"
+
+namespace bn
+{
+
+hdma_ptr hdma_ptr::create()
+{
+    return hdma_ptr(hdma_manager::create());
+}
+
+optional<hdma_ptr> hdma_ptr::create_optional()
+{
+    int channel = hdma_manager::create_optional();
+    optional<hdma_ptr> result;
+
+    if(channel >= 0)
+    {
+        result = hdma_ptr(channel);
+    }
+
+    return result;
+}
+
+hdma_ptr::hdma_ptr(const hdma_ptr& other) :
+    _channel(other._channel)
+{
+    hdma_manager::increase_usages(_channel);
+}
+
+hdma_ptr& hdma_ptr::operator=(const hdma_ptr& other)
+{
+    if(_channel != other._channel)
+    {
+        if(_channel >= 0)
+        {
+            hdma_manager::decrease_usages(_channel);
+        }
+
+        _channel = other._channel;
+        hdma_manager::increase_usages(_channel);
+    }
+
+    return *this;
+}
+
+bool hdma_ptr::running() const
+{
+    return hdma_manager::running(_channel);
+}
+
+void hdma_ptr::start(const uint16_t& source_ref, int elements, uint16_t& destination_ref)
+{
+    BN_ASSERT(elements > 0, "Invalid elements: ", elements);
+
+    hdma_manager::start(_channel, source_ref, elements, destination_ref);
+}
+
+void hdma_ptr::start(const uint32_t& source_ref, int elements, uint32_t& destination_ref)
+{
+    BN_ASSERT(elements > 0, "Invalid elements: ", elements);
+
+    hdma_manager::start(_channel, source_ref, elements, destination_ref);
+}
+
+void hdma_ptr::stop()
+{
+    hdma_manager::stop(_channel);
+}
+
+void hdma_ptr::_destroy()
+{
+    hdma_manager::decrease_usages(_channel);
+}
+
+}
@@ -8,7 +8,7 @@
 #include "bn_memory_manager.h"
 #include "../hw/include/bn_hw_memory.h"
 
-void* operator new(unsigned bytes)
+void* operator new(std::size_t bytes)
 {
     void* ptr = bn::memory_manager::ewram_alloc(bytes);
     BN_ASSERT(ptr, "Allocation failed. Size in bytes: ", bytes);
@@ -21,12 +21,12 @@ void operator delete(void* ptr) noexcept
     bn::memory_manager::ewram_free(ptr);
 }
 
-void operator delete(void* ptr, [[maybe_unused]] unsigned bytes) noexcept
+void operator delete(void* ptr, [[maybe_unused]] std::size_t bytes) noexcept
 {
     bn::memory_manager::ewram_free(ptr);
 }
 
-void* operator new[](unsigned bytes)
+void* operator new[](std::size_t bytes)
 {
     void* ptr = bn::memory_manager::ewram_alloc(bytes);
     BN_ASSERT(ptr, "Allocation failed. Size in bytes: ", bytes);
@@ -39,7 +39,7 @@ void operator delete[](void* ptr) noexcept
     bn::memory_manager::ewram_free(ptr);
 }
 
-void operator delete[](void* ptr, [[maybe_unused]] unsigned bytes) noexcept
+void operator delete[](void* ptr, [[maybe_unused]] std::size_t bytes) noexcept
 {
     bn::memory_manager::ewram_free(ptr);
 }
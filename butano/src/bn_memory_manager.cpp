@@ -38,8 +38,8 @@ namespace
     using items_list = list<item_type, max_items>;
     using items_iterator = items_list::iterator;
 
-    static_assert(sizeof(items_iterator) == sizeof(int));
-    static_assert(alignof(items_iterator) == alignof(int));
+    static_assert(sizeof(items_iterator) == sizeof(intptr_t));
+    static_assert(alignof(items_iterator) == alignof(intptr_t));
 
 
     class static_data
@@ -109,7 +109,7 @@ void* ewram_alloc(int bytes)
 {
     BN_ASSERT(bytes >= 0, "Invalid bytes: ", bytes);
 
-    int alignment_bytes = sizeof(int);
+    int alignment_bytes = sizeof(intptr_t);
 
     if(int extra_bytes = bytes % alignment_bytes)
     {
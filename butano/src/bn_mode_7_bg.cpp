@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_mode_7_bg.h"
+
+#include "bn_display.h"
+#include "bn_optional.h"
+#include "bn_bgs_manager.h"
+#include "bn_hdma_manager.h"
+#include "bn_mode_7_bg_values.h"
+
+#include "../hw/include/bn_hw_bgs.h"
+
+namespace bn
+{
+
+namespace
+{
+    constexpr int buffer_words = display::height() * mode_7_bg_values::words_per_line();
+
+    [[nodiscard]] uint32_t* _alloc_values()
+    {
+        int bytes = buffer_words * 2 * int(sizeof(uint32_t));
+        auto result = static_cast<uint32_t*>(memory::ewram_alloc(bytes));
+        BN_ASSERT(result, "EWRAM allocation failed: ", bytes);
+
+        return result;
+    }
+}
+
+mode_7_bg::mode_7_bg(affine_bg_ptr bg, const mode_7_camera& camera) :
+    _values(_alloc_values()),
+    _bg(move(bg)),
+    _hdma(hdma_ptr::create()),
+    _camera(camera)
+{
+    update();
+}
+
+void mode_7_bg::update()
+{
+    optional<int> hw_id = bgs_manager::hw_id(const_cast<void*>(_bg.handle()));
+
+    if(! hw_id)
+    {
+        if(_hw_id >= 0)
+        {
+            _hdma.stop();
+            _hw_id = -1;
+        }
+
+        return;
+    }
+
+    if(_updated || *hw_id != _hw_id)
+    {
+        mode_7_bg_values::camera_data camera_data;
+        camera_data.x = _camera.x().data();
+        camera_data.y = _camera.y().data();
+        camera_data.z = _camera.z().data();
+        camera_data.yaw_sin = _camera.yaw_sin().data();
+        camera_data.yaw_cos = _camera.yaw_cos().data();
+        camera_data.pitch_sin = _camera.pitch_sin().data();
+        camera_data.pitch_cos = _camera.pitch_cos().data();
+        camera_data.focal_length = _camera.focal_length().data();
+        camera_data.horizon = _camera.horizon();
+
+        // The buffer referenced by the running HDMA transfer is not modified,
+        // and the pending one is filled again if this method is called more than once per frame:
+        if(! hdma_manager::start_pending(_hdma.channel()))
+        {
+            _values_index = ! _values_index;
+        }
+
+        uint32_t* values_ptr = _values.get() + (int(_values_index) * buffer_words);
+        mode_7_bg_values::fill(camera_data, values_ptr);
+
+        auto destination_ptr = reinterpret_cast<uint32_t*>(hw::bgs::affine_mat_register(*hw_id));
+        _hdma.start(*values_ptr, mode_7_bg_values::words_per_line(), *destination_ptr);
+        _hw_id = int8_t(*hw_id);
+        _updated = false;
+    }
+}
+
+void mode_7_bg::ewram_deleter::operator()(void* ptr) const
+{
+    memory::ewram_free(ptr);
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_mode_7_bg_values.h"
+
+#include "bn_fixed.h"
+#include "bn_display.h"
+#include "bn_reciprocal_lut.h"
+
+namespace bn::mode_7_bg_values
+{
+
+namespace
+{
+    constexpr int precision = fixed::precision();
+    constexpr int reciprocal_precision = 20;
+    constexpr int lambda_precision = precision + 4;
+
+    // Lines above the horizon reference a position outside the map:
+    constexpr uint32_t out_of_map_position = uint32_t(-(1 << 24));
+
+    // Affine registers have 8 bits of precision:
+    [[nodiscard]] int64_t _to_register(int64_t value)
+    {
+        constexpr int shift = precision - 8;
+        return (value + (1 << (shift - 1))) >> shift;
+    }
+
+    [[nodiscard]] uint32_t _clamp_to_register(int64_t value)
+    {
+        return uint16_t(value < -32768 ? -32768 : value > 32767 ? 32767 : int(value));
+    }
+
+    void _fill_line(const camera_data& camera, int line, uint32_t* line_values_ptr)
+    {
+        int screen_y = line - camera.horizon;
+        int focal_length_sin = int((int64_t(camera.focal_length) * camera.pitch_sin) >> precision);
+        int focal_length_cos = int((int64_t(camera.focal_length) * camera.pitch_cos) >> precision);
+        int depth = (screen_y * camera.pitch_cos) + focal_length_sin;
+
+        if(depth < (1 << precision))
+        {
+            line_values_ptr[0] = 0;
+            line_values_ptr[1] = 0;
+            line_values_ptr[2] = out_of_map_position;
+            line_values_ptr[3] = out_of_map_position;
+            return;
+        }
+
+        // Reciprocal of the depth, linearly interpolated from reciprocal_lut.
+        // The depth is normalized to the range [64, 128) to keep the interpolation error low:
+        int normalized_depth = depth;
+        int depth_exponent = 0;
+
+        while(normalized_depth >= (128 << precision))
+        {
+            normalized_depth >>= 1;
+            ++depth_exponent;
+        }
+
+        while(normalized_depth < (64 << precision))
+        {
+            normalized_depth <<= 1;
+            --depth_exponent;
+        }
+
+        const fixed_t<reciprocal_precision>* reciprocal_lut_data = reciprocal_lut.data();
+        int depth_index = normalized_depth >> precision;
+        int depth_fraction = normalized_depth & ((1 << precision) - 1);
+        int reciprocal_a = reciprocal_lut_data[depth_index].data();
+        int reciprocal_b = reciprocal_lut_data[depth_index + 1].data();
+        int reciprocal = reciprocal_a + (((reciprocal_b - reciprocal_a) * depth_fraction) >> precision);
+
+        // Map pixels per screen pixel:
+        int lambda_shift = reciprocal_precision + depth_exponent - (lambda_precision - precision);
+        int64_t lambda = (int64_t(camera.y) * reciprocal) >> lambda_shift;
+        int64_t lambda_sin = (lambda * camera.yaw_sin) >> lambda_precision;
+        int64_t lambda_cos = (lambda * camera.yaw_cos) >> lambda_precision;
+        int64_t forward = (lambda * (focal_length_cos - (screen_y * camera.pitch_sin))) >> lambda_precision;
+        int64_t half_width = display::width() / 2;
+
+        int64_t dx = camera.x - (half_width * lambda_cos) + ((forward * camera.yaw_sin) >> precision);
+        int64_t dy = camera.z - (half_width * lambda_sin) - ((forward * camera.yaw_cos) >> precision);
+        line_values_ptr[0] = _clamp_to_register(_to_register(lambda_cos));
+        line_values_ptr[1] = _clamp_to_register(_to_register(lambda_sin));
+        line_values_ptr[2] = uint32_t(int(_to_register(dx)));
+        line_values_ptr[3] = uint32_t(int(_to_register(dy)));
+    }
+}
+
+void fill(const camera_data& camera, uint32_t* values_ptr)
+{
+    // HDMA writes the values of each line in the H-Blank period of the previous one,
+    // so the values of the first screen line are the last ones:
+    _fill_line(camera, 0, values_ptr + ((display::height() - 1) * words_per_line()));
+
+    for(int line = 1, limit = display::height(); line < limit; ++line)
+    {
+        _fill_line(camera, line, values_ptr);
+        values_ptr += words_per_line();
+    }
+}
+
+}
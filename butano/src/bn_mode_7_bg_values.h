@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_MODE_7_BG_VALUES_H
+#define BN_MODE_7_BG_VALUES_H
+
+#include "bn_common.h"
+
+namespace bn::mode_7_bg_values
+{
+    // Camera values in fixed point format, precomputed once per frame:
+    class camera_data
+    {
+
+    public:
+        int x;
+        int y;
+        int z;
+        int yaw_sin;
+        int yaw_cos;
+        int pitch_sin;
+        int pitch_cos;
+        int focal_length;
+        int horizon;
+    };
+
+    [[nodiscard]] constexpr int words_per_line()
+    {
+        // PA, PB, PC, PD, X and Y affine background registers:
+        return 4;
+    }
+
+    BN_CODE_IWRAM void fill(const camera_data& camera, uint32_t* values_ptr);
+}
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_palette_cycle.h"
+
+#include "bn_color.h"
+#include "bn_display.h"
+#include "bn_algorithm.h"
+
+namespace bn
+{
+
+void palette_cycle::fill_hblank_effect_colors(const span<const color>& colors, int color_index, int frames,
+                                              int lines_per_step, span<color> hblank_effect_colors) const
+{
+    const palette_cycle_range* range = find_range(color_index);
+    BN_ASSERT(range, "Color index is outside the ranges: ", color_index);
+    BN_ASSERT(range->first_color_index() + range->colors_count() <= colors.size(),
+              "Invalid colors count: ", colors.size());
+    BN_ASSERT(frames >= 0, "Invalid frames: ", frames);
+    BN_ASSERT(lines_per_step > 0, "Invalid lines per step: ", lines_per_step);
+    BN_ASSERT(hblank_effect_colors.size() == display::height(),
+              "Invalid H-Blank effect colors count: ", hblank_effect_colors.size());
+
+    int steps = frames / range->update_frames();
+    int line = 0;
+
+    while(line < display::height())
+    {
+        color step_color = colors[range->cycled_color_index(color_index, steps)];
+
+        for(int limit = min(line + lines_per_step, display::height()); line < limit; ++line)
+        {
+            hblank_effect_colors[line] = step_color;
+        }
+
+        ++steps;
+    }
+}
+
+}
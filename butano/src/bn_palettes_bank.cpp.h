@@ -7,10 +7,10 @@
 
 #include "bn_math.h"
 #include "bn_span.h"
-#include "bn_limits.h"
 #include "bn_display.h"
 #include "bn_bpp_mode.h"
 #include "bn_algorithm.h"
+#include "bn_palette_cycle.h"
 #include "bn_compression_type.h"
 #include "../hw/include/bn_hw_memory.h"
 #include "../hw/include/bn_hw_uncompress.h"
@@ -281,6 +281,11 @@ void palettes_bank::decrease_usages(int id)
             _bpp_4_indexes_map.erase(pal.hash);
         }
 
+        erase_if(_cycle_ranges, [id](const cycle_range& range)
+        {
+            return range.palette_id == id;
+        });
+
         pal = palette();
     }
 }
@@ -407,25 +412,78 @@ void palettes_bank::set_rotate_count(int id, int count)
     }
 }
 
-void palettes_bank::reload(int id)
+bool palettes_bank::has_cycle(int id) const
 {
-    if(_first_index_to_commit != numeric_limits<int>::max())
+    for(const cycle_range& range : _cycle_ranges)
     {
-        _first_index_to_commit = min(_first_index_to_commit, id);
-        _last_index_to_commit = max(_last_index_to_commit, id);
+        if(range.palette_id == id)
+        {
+            return true;
+        }
     }
-    else
+
+    return false;
+}
+
+void palettes_bank::set_cycle(int id, const palette_cycle& cycle)
+{
+    remove_cycle(id);
+
+    int pal_colors_count = colors_count(id);
+
+    for(const palette_cycle_range& range : cycle.ranges())
     {
-        _first_index_to_commit = id;
-        _last_index_to_commit = id;
+        BN_ASSERT(range.first_color_index() + range.colors_count() <= pal_colors_count,
+                  "Invalid range: ", range.first_color_index(), " - ", range.colors_count(), " - ", pal_colors_count);
+        BN_ASSERT(! _cycle_ranges.full(), "No more cycle ranges available");
+
+        auto update_frames = uint16_t(range.update_frames());
+        _cycle_ranges.push_back(cycle_range{ int16_t(id), int16_t(range.first_color_index()),
+                                             int16_t(range.colors_count()), 0, update_frames, update_frames,
+                                             range.reverse() });
     }
 }
 
+void palettes_bank::remove_cycle(int id)
+{
+    bool update = false;
+
+    for(const cycle_range& range : _cycle_ranges)
+    {
+        if(range.palette_id == id && range.offset)
+        {
+            update = true;
+        }
+    }
+
+    erase_if(_cycle_ranges, [id](const cycle_range& range)
+    {
+        return range.palette_id == id;
+    });
+
+    if(update)
+    {
+        _palettes[id].update = true;
+        _update = true;
+    }
+}
+
+void palettes_bank::reload(int id)
+{
+    _banks_to_commit |= _palette_banks(id);
+}
+
 void palettes_bank::set_transparent_color(const optional<color>& transparent_color)
 {
     bool update = _transparent_color != transparent_color;
     _transparent_color = transparent_color;
-    _update |= update;
+
+    if(update)
+    {
+        // The first palette must be updated to restore its first color if the transparent color is removed:
+        _palettes[0].update = true;
+        _update = true;
+    }
 }
 
 void palettes_bank::set_brightness(fixed brightness)
@@ -449,6 +507,8 @@ void palettes_bank::set_brightness(fixed brightness)
         {
             _check_global_effects_enabled();
         }
+
+        _update_global_effects_lut();
     }
 }
 
@@ -473,6 +533,8 @@ void palettes_bank::set_contrast(fixed contrast)
         {
             _check_global_effects_enabled();
         }
+
+        _update_global_effects_lut();
     }
 }
 
@@ -497,6 +559,8 @@ void palettes_bank::set_intensity(fixed intensity)
         {
             _check_global_effects_enabled();
         }
+
+        _update_global_effects_lut();
     }
 }
 
@@ -518,6 +582,8 @@ void palettes_bank::set_inverted(bool inverted)
         {
             _check_global_effects_enabled();
         }
+
+        _update_global_effects_lut();
     }
 }
 
@@ -542,6 +608,8 @@ void palettes_bank::set_grayscale_intensity(fixed intensity)
         {
             _check_global_effects_enabled();
         }
+
+        _update_global_effects_lut();
     }
 }
 
@@ -554,6 +622,7 @@ void palettes_bank::set_fade_color(color color)
     {
         _update = true;
         _update_global_effects = true;
+        _update_global_effects_lut();
     }
 }
 
@@ -578,6 +647,8 @@ void palettes_bank::set_fade_intensity(fixed intensity)
         {
             _check_global_effects_enabled();
         }
+
+        _update_global_effects_lut();
     }
 }
 
@@ -603,80 +674,70 @@ void palettes_bank::set_fade(color color, fixed intensity)
         {
             _check_global_effects_enabled();
         }
+
+        _update_global_effects_lut();
     }
 }
 
 void palettes_bank::update()
 {
-    int first_index = numeric_limits<int>::max();
-    int last_index = 0;
+    if(! _cycle_ranges.empty())
+    {
+        _update_cycle_ranges();
+    }
 
     if(_update)
     {
-        bool update_global_effects = _update_global_effects || _global_effects_enabled;
+        bool update_all = _update_global_effects;
+        unsigned banks = 0;
         _update = false;
         _update_global_effects = false;
 
-        if(update_global_effects)
+        // If global effects have not been changed, only the updated palettes are recomputed and committed:
+        for(int index = 0, limit = hw::palettes::count(); index < limit; ++index)
         {
-            for(int index = 0, limit = hw::palettes::count(); index < limit; ++index)
-            {
-                palette& pal = _palettes[index];
+            palette& pal = _palettes[index];
 
-                if(pal.usages)
-                {
-                    _update_palette(index);
-                    first_index = min(first_index, index);
-                    last_index = index;
-                }
-            }
-        }
-        else
-        {
-            for(int index = 0, limit = hw::palettes::count(); index < limit; ++index)
+            if(pal.usages && (update_all || pal.update))
             {
-                palette& pal = _palettes[index];
-
-                if(pal.update)
-                {
-                    _update_palette(index);
-                    first_index = min(first_index, index);
-                    last_index = index;
-                }
+                _update_palette(index);
+                banks |= _palette_banks(index);
             }
+
+            pal.update = false;
         }
 
-        if(_transparent_color)
+        if(_global_effects_enabled)
         {
-            _final_colors[0] = *_transparent_color;
-            first_index = 0;
+            for_each_banks_range(banks, [this](int colors_offset, int colors_count)
+            {
+                _apply_global_effects(colors_count, _final_colors + colors_offset);
+            });
         }
 
-        if(_global_effects_enabled && first_index != numeric_limits<int>::max())
+        if(const optional<color>& transparent_color = _transparent_color)
         {
-            color* all_colors_ptr = _final_colors + (first_index * hw::palettes::colors_per_palette());
-            int all_colors_count = (last_index - first_index + max(int(_palettes[last_index].slots_count), 1)) *
-                    hw::palettes::colors_per_palette();
-            _apply_global_effects(all_colors_count, all_colors_ptr);
+            _final_colors[0] = *transparent_color;
+
+            if(_global_effects_enabled)
+            {
+                _apply_global_effects(1, _final_colors);
+            }
+
+            banks |= 1;
         }
-    }
 
-    _first_index_to_commit = first_index;
-    _last_index_to_commit = last_index;
+        _banks_to_commit |= banks;
+    }
 }
 
 optional<palettes_bank::commit_data> palettes_bank::retrieve_commit_data() const
 {
     optional<commit_data> result;
 
-    if(_first_index_to_commit != numeric_limits<int>::max())
+    if(_banks_to_commit)
     {
-        int first_index = _first_index_to_commit;
-        int last_index = _last_index_to_commit;
-        int colors_offset = first_index * hw::palettes::colors_per_palette();
-        int colors_count = (last_index - first_index + max(int(_palettes[last_index].slots_count), 1)) *
-                hw::palettes::colors_per_palette();
-        result = commit_data{ _final_colors, colors_offset, colors_count };
+        result = commit_data{ _final_colors, _banks_to_commit };
     }
 
     return result;
@@ -684,8 +745,7 @@ optional<palettes_bank::commit_data> palettes_bank::retrieve_commit_data() const
 
 void palettes_bank::reset_commit_data()
 {
-    _first_index_to_commit = numeric_limits<int>::max();
-    _last_index_to_commit = 0;
+    _banks_to_commit = 0;
 }
 
 void palettes_bank::fill_hblank_effect_colors(int id, const color* source_colors_ptr, uint16_t* dest_ptr) const
@@ -738,6 +798,12 @@ void palettes_bank::fill_hblank_effect_colors(const color* source_colors_ptr, ui
     return true;
 }
 
+unsigned palettes_bank::_palette_banks(int id) const
+{
+    unsigned slots_count = unsigned(max(int(_palettes[id].slots_count), 1));
+    return ((1U << slots_count) - 1) << id;
+}
+
 int palettes_bank::_bpp_8_slots_count() const
 {
     const palette& first_pal = _palettes[0];
@@ -780,6 +846,34 @@ void palettes_bank::_set_colors_bpp_impl(int id, const span<const color>& colors
     _update = true;
 }
 
+void palettes_bank::_update_cycle_ranges()
+{
+    for(cycle_range& range : _cycle_ranges)
+    {
+        --range.counter;
+
+        if(! range.counter)
+        {
+            int offset = range.offset;
+            int last_offset = range.colors_count - 1;
+
+            if(range.reverse)
+            {
+                offset = offset ? offset - 1 : last_offset;
+            }
+            else
+            {
+                offset = offset == last_offset ? 0 : offset + 1;
+            }
+
+            range.offset = int16_t(offset);
+            range.counter = range.update_frames;
+            _palettes[range.palette_id].update = true;
+            _update = true;
+        }
+    }
+}
+
 void palettes_bank::_update_palette(int id)
 {
     palette& pal = _palettes[id];
@@ -787,6 +881,32 @@ void palettes_bank::_update_palette(int id)
     color* final_pal_colors_ptr = _final_colors + (id * hw::palettes::colors_per_palette());
     int pal_colors_count = pal.slots_count * hw::palettes::colors_per_palette();
     copy_colors(initial_pal_colors_ptr, pal_colors_count, final_pal_colors_ptr);
+
+    for(const cycle_range& range : _cycle_ranges)
+    {
+        if(range.palette_id == id)
+        {
+            if(int offset = range.offset)
+            {
+                // Colors are moved offset positions to the right:
+                const color* initial_range_colors_ptr = initial_pal_colors_ptr + range.first_color_index;
+                color* final_range_colors_ptr = final_pal_colors_ptr + range.first_color_index;
+                int range_colors_count = range.colors_count;
+                int moved_colors_count = range_colors_count - offset;
+
+                for(int index = 0; index < moved_colors_count; ++index)
+                {
+                    final_range_colors_ptr[offset + index] = initial_range_colors_ptr[index];
+                }
+
+                for(int index = 0; index < offset; ++index)
+                {
+                    final_range_colors_ptr[index] = initial_range_colors_ptr[moved_colors_count + index];
+                }
+            }
+        }
+    }
+
     pal.apply_effects(pal_colors_count, final_pal_colors_ptr);
 
     if(pal.rotate_count)
@@ -795,39 +915,80 @@ void palettes_bank::_update_palette(int id)
     }
 }
 
-void palettes_bank::_apply_global_effects(int dest_colors_count, color* dest_colors_ptr) const
+void palettes_bank::_update_global_effects_lut()
 {
+    if(! _global_effects_enabled)
+    {
+        return;
+    }
+
+    // Effects are computed once for each channel value, so they can be applied later with table lookups:
+    constexpr int channel_values = 32;
+    alignas(int) color channel_colors[channel_values];
+
+    for(int value = 0; value < channel_values; ++value)
+    {
+        channel_colors[value] = color(value, value, value);
+    }
+
     if(int brightness = fixed_t<8>(_brightness).data())
     {
-        hw::palettes::brightness(brightness, dest_colors_count, dest_colors_ptr);
+        hw::palettes::brightness(brightness, channel_values, channel_colors);
     }
 
     if(int contrast = fixed_t<8>(_contrast).data())
     {
-        hw::palettes::contrast(contrast, dest_colors_count, dest_colors_ptr);
+        hw::palettes::contrast(contrast, channel_values, channel_colors);
     }
 
     if(int intensity = fixed_t<8>(_intensity).data())
     {
-        hw::palettes::intensity(intensity, dest_colors_count, dest_colors_ptr);
+        hw::palettes::intensity(intensity, channel_values, channel_colors);
     }
 
     if(_inverted)
     {
-        hw::palettes::invert(dest_colors_count, dest_colors_ptr);
+        hw::palettes::invert(channel_values, channel_colors);
     }
 
-    if(int grayscale_intensity = fixed_t<5>(_grayscale_intensity).data())
+    hw::palettes::effects_lut& lut = _global_effects_lut;
+    int grayscale_intensity = fixed_t<5>(_grayscale_intensity).data();
+    lut.grayscale_intensity = grayscale_intensity;
+
+    if(grayscale_intensity)
     {
-        hw::palettes::grayscale(grayscale_intensity, dest_colors_count, dest_colors_ptr);
+        // Fade is applied after grayscale, so it goes to its own tables:
+        for(int value = 0; value < channel_values; ++value)
+        {
+            auto channel_value = uint8_t(channel_colors[value].red());
+            lut.channels[0][value] = channel_value;
+            lut.channels[1][value] = channel_value;
+            lut.channels[2][value] = channel_value;
+            channel_colors[value] = color(value, value, value);
+        }
     }
 
     if(int fade_intensity = fixed_t<5>(_fade_intensity).data())
     {
-        hw::palettes::fade(_fade_color, fade_intensity, dest_colors_count, dest_colors_ptr);
+        hw::palettes::fade(_fade_color, fade_intensity, channel_values, channel_colors);
+    }
+
+    uint8_t (&channels)[3][channel_values] = grayscale_intensity ? lut.fade_channels : lut.channels;
+
+    for(int value = 0; value < channel_values; ++value)
+    {
+        color channel_color = channel_colors[value];
+        channels[0][value] = uint8_t(channel_color.red());
+        channels[1][value] = uint8_t(channel_color.green());
+        channels[2][value] = uint8_t(channel_color.blue());
     }
 }
 
+void palettes_bank::_apply_global_effects(int dest_colors_count, color* dest_colors_ptr) const
+{
+    hw::palettes::apply_effects_lut(_global_effects_lut, dest_colors_count, dest_colors_ptr);
+}
+
 void palettes_bank::palette::apply_effects(int dest_colors_count, color* dest_colors_ptr) const
 {
      if(inverted)
@@ -9,9 +9,11 @@
 #include "bn_span.h"
 #include "bn_fixed.h"
 #include "bn_color.h"
+#include "bn_vector.h"
 #include "bn_optional.h"
 #include "bn_config_log.h"
 #include "bn_unordered_map.h"
+#include "bn_config_palettes.h"
 #include "../hw/include/bn_hw_palettes.h"
 
 namespace bn
@@ -19,6 +21,7 @@ namespace bn
 
 enum class bpp_mode : uint8_t;
 enum class compression_type : uint8_t;
+class palette_cycle;
 
 class palettes_bank
 {
@@ -29,10 +32,41 @@ public:
 
     public:
         const color* colors_ptr;
-        int offset;
-        int count;
+        unsigned banks;
+
+        [[nodiscard]] bool color_updated(int color_index) const
+        {
+            return banks & (1U << (color_index / hw::palettes::colors_per_palette()));
+        }
     };
 
+    template<typename Function>
+    static void for_each_banks_range(unsigned banks, const Function& function)
+    {
+        int colors_per_palette = hw::palettes::colors_per_palette();
+        int first_bank = 0;
+
+        while(banks)
+        {
+            while(! (banks & 1))
+            {
+                banks >>= 1;
+                ++first_bank;
+            }
+
+            int banks_count = 0;
+
+            while(banks & 1)
+            {
+                banks >>= 1;
+                ++banks_count;
+            }
+
+            function(first_bank * colors_per_palette, banks_count * colors_per_palette);
+            first_bank += banks_count;
+        }
+    }
+
     [[nodiscard]] static uint16_t colors_hash(const span<const color>& colors);
 
     [[nodiscard]] int used_colors_count() const;
@@ -106,6 +140,12 @@ public:
 
     void set_rotate_count(int id, int count);
 
+    [[nodiscard]] bool has_cycle(int id) const;
+
+    void set_cycle(int id, const palette_cycle& cycle);
+
+    void remove_cycle(int id);
+
     void reload(int id);
 
     [[nodiscard]] const optional<color>& transparent_color() const
@@ -166,6 +206,17 @@ public:
 
     void set_fade(color color, fixed intensity);
 
+    [[nodiscard]] bool global_effects_enabled() const
+    {
+        return _global_effects_enabled;
+    }
+
+    // Global effects lookup tables, only updated when global effects parameters change:
+    [[nodiscard]] const hw::palettes::effects_lut& global_effects_lut() const
+    {
+        return _global_effects_lut;
+    }
+
     void update();
 
     [[nodiscard]] optional<commit_data> retrieve_commit_data() const;
@@ -201,6 +252,19 @@ private:
         void apply_effects(int dest_colors_count, color* dest_colors_ptr) const;
     };
 
+    class cycle_range
+    {
+
+    public:
+        int16_t palette_id;
+        int16_t first_color_index;
+        int16_t colors_count;
+        int16_t offset;
+        uint16_t update_frames;
+        uint16_t counter;
+        bool reverse;
+    };
+
     class identity_hasher
     {
 
@@ -214,6 +278,7 @@ private:
     palette _palettes[hw::palettes::count()] = {};
     alignas(int) color _initial_colors[hw::palettes::colors()] = {};
     alignas(int) color _final_colors[hw::palettes::colors()] = {};
+    hw::palettes::effects_lut _global_effects_lut = {};
     optional<color> _transparent_color;
     fixed _brightness;
     fixed _contrast;
@@ -221,8 +286,8 @@ private:
     fixed _grayscale_intensity;
     fixed _fade_intensity;
     unordered_map<uint16_t, int16_t, hw::palettes::count() * 2, identity_hasher> _bpp_4_indexes_map;
-    int _first_index_to_commit = numeric_limits<int>::max();
-    int _last_index_to_commit = 0;
+    vector<cycle_range, BN_CFG_PALETTES_MAX_CYCLE_RANGES> _cycle_ranges;
+    unsigned _banks_to_commit = 0;
     color _fade_color;
     bool _inverted = false;
     bool _update = false;
@@ -231,6 +296,8 @@ private:
 
     [[nodiscard]] bool _same_colors(const span<const color>& colors, int id) const;
 
+    [[nodiscard]] unsigned _palette_banks(int id) const;
+
     [[nodiscard]] int _bpp_8_slots_count() const;
 
     [[nodiscard]] int _first_bpp_4_palette_index() const;
@@ -239,8 +306,12 @@ private:
 
     void _set_colors_bpp_impl(int id, const span<const color>& colors);
 
+    void _update_cycle_ranges();
+
     void _update_palette(int id);
 
+    void _update_global_effects_lut();
+
     void _apply_global_effects(int dest_colors_count, color* dest_colors_ptr) const;
 };
 
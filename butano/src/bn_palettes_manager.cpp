@@ -49,13 +49,25 @@ void commit()
 {
     if(optional<palettes_bank::commit_data> commit_data = data.sprite_palettes_bank.retrieve_commit_data())
     {
-        hw::palettes::commit_sprites(commit_data->colors_ptr, commit_data->offset, commit_data->count);
+        const color* colors_ptr = commit_data->colors_ptr;
+
+        palettes_bank::for_each_banks_range(commit_data->banks, [colors_ptr](int colors_offset, int colors_count)
+        {
+            hw::palettes::commit_sprites(colors_ptr, colors_offset, colors_count);
+        });
+
         data.sprite_palettes_bank.reset_commit_data();
     }
 
     if(optional<palettes_bank::commit_data> commit_data = data.bg_palettes_bank.retrieve_commit_data())
     {
-        hw::palettes::commit_bgs(commit_data->colors_ptr, commit_data->offset, commit_data->count);
+        const color* colors_ptr = commit_data->colors_ptr;
+
+        palettes_bank::for_each_banks_range(commit_data->banks, [colors_ptr](int colors_offset, int colors_count)
+        {
+            hw::palettes::commit_bgs(colors_ptr, colors_offset, colors_count);
+        });
+
         data.bg_palettes_bank.reset_commit_data();
     }
 }
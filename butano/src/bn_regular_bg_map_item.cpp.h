@@ -27,6 +27,51 @@ regular_bg_map_item regular_bg_map_item::uncompress(regular_bg_map_cell& uncompr
 
     regular_bg_map_item result = *this;
 
+    if(int metatile_size = _metatile_size; metatile_size > 1)
+    {
+        const regular_bg_map_cell* metatile_cells_ptr = _cells_ptr;
+        const uint8_t* metatile_byte_indexes_ptr = _metatile_byte_indexes_ptr;
+        const uint16_t* metatile_half_word_indexes_ptr = _metatile_half_word_indexes_ptr;
+        regular_bg_map_cell* uncompressed_cells_ptr = &uncompressed_cells_ref;
+        int width = _dimensions.width();
+        int height = _dimensions.height();
+        int metatiles_width = width / metatile_size;
+
+        // Cells of not big maps are stored in screenblock order:
+        int block_width = big() ? width : 32;
+        int block_height = big() ? height : 32;
+
+        for(int block_y = 0; block_y < height; block_y += block_height)
+        {
+            for(int block_x = 0; block_x < width; block_x += block_width)
+            {
+                for(int y = block_y, y_limit = block_y + block_height; y < y_limit; ++y)
+                {
+                    int metatile_y = y / metatile_size;
+                    int metatile_cell_y = y % metatile_size;
+
+                    for(int x = block_x, x_limit = block_x + block_width; x < x_limit; ++x)
+                    {
+                        int metatile_index_offset = (metatile_y * metatiles_width) + (x / metatile_size);
+                        int metatile_index = metatile_byte_indexes_ptr ?
+                                    metatile_byte_indexes_ptr[metatile_index_offset] :
+                                    metatile_half_word_indexes_ptr[metatile_index_offset];
+                        int metatile_cell_offset = (metatile_cell_y * metatile_size) + (x % metatile_size);
+                        *uncompressed_cells_ptr = metatile_cells_ptr[
+                                    (metatile_index * metatile_size * metatile_size) + metatile_cell_offset];
+                        ++uncompressed_cells_ptr;
+                    }
+                }
+            }
+        }
+
+        result._cells_ptr = &uncompressed_cells_ref;
+        result._metatile_byte_indexes_ptr = nullptr;
+        result._metatile_half_word_indexes_ptr = nullptr;
+        result._metatile_size = 1;
+        return result;
+    }
+
     switch(_compression)
     {
 
@@ -60,10 +60,81 @@ optional<regular_bg_position_hbe_ptr> regular_bg_position_hbe_ptr::create_vertic
     return result;
 }
 
+regular_bg_position_hbe_ptr regular_bg_position_hbe_ptr::create_horizontal_wave(
+        regular_bg_ptr bg, const hbe_wave& wave)
+{
+    int id = hblank_effects_manager::create_wave(
+                wave, intptr_t(bg.handle()), hblank_effects_manager::handler_type::REGULAR_BG_HORIZONTAL_POSITION);
+    return regular_bg_position_hbe_ptr(id, move(bg));
+}
+
+regular_bg_position_hbe_ptr regular_bg_position_hbe_ptr::create_vertical_wave(
+        regular_bg_ptr bg, const hbe_wave& wave)
+{
+    int id = hblank_effects_manager::create_wave(
+                wave, intptr_t(bg.handle()), hblank_effects_manager::handler_type::REGULAR_BG_VERTICAL_POSITION);
+    return regular_bg_position_hbe_ptr(id, move(bg));
+}
+
+optional<regular_bg_position_hbe_ptr> regular_bg_position_hbe_ptr::create_horizontal_wave_optional(
+        regular_bg_ptr bg, const hbe_wave& wave)
+{
+    int id = hblank_effects_manager::create_wave_optional(
+                wave, intptr_t(bg.handle()), hblank_effects_manager::handler_type::REGULAR_BG_HORIZONTAL_POSITION);
+    optional<regular_bg_position_hbe_ptr> result;
+
+    if(id >= 0)
+    {
+        result = regular_bg_position_hbe_ptr(id, move(bg));
+    }
+
+    return result;
+}
+
+optional<regular_bg_position_hbe_ptr> regular_bg_position_hbe_ptr::create_vertical_wave_optional(
+        regular_bg_ptr bg, const hbe_wave& wave)
+{
+    int id = hblank_effects_manager::create_wave_optional(
+                wave, intptr_t(bg.handle()), hblank_effects_manager::handler_type::REGULAR_BG_VERTICAL_POSITION);
+    optional<regular_bg_position_hbe_ptr> result;
+
+    if(id >= 0)
+    {
+        result = regular_bg_position_hbe_ptr(id, move(bg));
+    }
+
+    return result;
+}
+
+regular_bg_position_hbe_ptr regular_bg_position_hbe_ptr::create_horizontal_parallax_bands(
+        regular_bg_ptr bg, const span<const hbe_parallax_band>& bands_ref)
+{
+    int id = hblank_effects_manager::create_parallax_bands(
+                bands_ref.data(), bands_ref.size(), intptr_t(bg.handle()),
+                hblank_effects_manager::handler_type::REGULAR_BG_HORIZONTAL_POSITION);
+    return regular_bg_position_hbe_ptr(id, move(bg));
+}
+
+optional<regular_bg_position_hbe_ptr> regular_bg_position_hbe_ptr::create_horizontal_parallax_bands_optional(
+        regular_bg_ptr bg, const span<const hbe_parallax_band>& bands_ref)
+{
+    int id = hblank_effects_manager::create_parallax_bands_optional(
+                bands_ref.data(), bands_ref.size(), intptr_t(bg.handle()),
+                hblank_effects_manager::handler_type::REGULAR_BG_HORIZONTAL_POSITION);
+    optional<regular_bg_position_hbe_ptr> result;
+
+    if(id >= 0)
+    {
+        result = regular_bg_position_hbe_ptr(id, move(bg));
+    }
+
+    return result;
+}
+
 span<const fixed> regular_bg_position_hbe_ptr::deltas_ref() const
 {
     auto values_ptr = reinterpret_cast<const fixed*>(hblank_effects_manager::values_ref(id()));
-    return span<const fixed>(values_ptr, display::height());
+    return span<const fixed>(values_ptr, values_ptr ? display::height() : 0);
 }
 
 void regular_bg_position_hbe_ptr::set_deltas_ref(const span<const fixed>& deltas_ref)
@@ -76,6 +147,39 @@ void regular_bg_position_hbe_ptr::reload_deltas_ref()
     hblank_effects_manager::reload_values_ref(id());
 }
 
+optional<hbe_wave> regular_bg_position_hbe_ptr::wave() const
+{
+    optional<hbe_wave> result;
+
+    if(const hbe_wave* wave_ptr = hblank_effects_manager::wave(id()))
+    {
+        result = *wave_ptr;
+    }
+
+    return result;
+}
+
+void regular_bg_position_hbe_ptr::set_wave(const hbe_wave& wave)
+{
+    hblank_effects_manager::set_wave(id(), wave);
+}
+
+span<const hbe_parallax_band> regular_bg_position_hbe_ptr::parallax_bands_ref() const
+{
+    return span<const hbe_parallax_band>(hblank_effects_manager::parallax_bands_ref(id()),
+                                         hblank_effects_manager::parallax_bands_count(id()));
+}
+
+void regular_bg_position_hbe_ptr::set_parallax_bands_ref(const span<const hbe_parallax_band>& bands_ref)
+{
+    hblank_effects_manager::set_parallax_bands_ref(id(), bands_ref.data(), bands_ref.size());
+}
+
+void regular_bg_position_hbe_ptr::reload_parallax_bands_ref()
+{
+    hblank_effects_manager::reload_values_ref(id());
+}
+
 void regular_bg_position_hbe_ptr::swap(regular_bg_position_hbe_ptr& other)
 {
     hbe_ptr::swap(other);
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_regular_bg_tiles_async_load_ptr.h"
+
+#include "bn_regular_bg_tiles_item.h"
+#include "bn_async_loads_manager.h"
+
+namespace bn
+{
+
+regular_bg_tiles_async_load_ptr regular_bg_tiles_async_load_ptr::create(const regular_bg_tiles_item& tiles_item)
+{
+    span<const tile> tiles_ref = tiles_item.tiles_ref();
+    regular_bg_tiles_ptr tiles = regular_bg_tiles_ptr::allocate(tiles_ref.size(), tiles_item.bpp());
+    int id = async_loads_manager::create(tiles_ref.data(), tiles_item.compression(), tiles_ref.size_bytes(),
+                                         move(tiles), false);
+    return regular_bg_tiles_async_load_ptr(id);
+}
+
+optional<regular_bg_tiles_async_load_ptr> regular_bg_tiles_async_load_ptr::create_optional(const regular_bg_tiles_item& tiles_item)
+{
+    span<const tile> tiles_ref = tiles_item.tiles_ref();
+    optional<regular_bg_tiles_async_load_ptr> result;
+
+    if(optional<regular_bg_tiles_ptr> tiles = regular_bg_tiles_ptr::allocate_optional(tiles_ref.size(), tiles_item.bpp()))
+    {
+        int id = async_loads_manager::create(tiles_ref.data(), tiles_item.compression(), tiles_ref.size_bytes(),
+                                             move(*tiles), true);
+
+        if(id >= 0)
+        {
+            result = regular_bg_tiles_async_load_ptr(id);
+        }
+    }
+
+    return result;
+}
+
+regular_bg_tiles_async_load_ptr::regular_bg_tiles_async_load_ptr(const regular_bg_tiles_async_load_ptr& other) :
+    regular_bg_tiles_async_load_ptr(other._id)
+{
+    async_loads_manager::increase_usages(_id);
+}
+
+regular_bg_tiles_async_load_ptr& regular_bg_tiles_async_load_ptr::operator=(const regular_bg_tiles_async_load_ptr& other)
+{
+    if(_id != other._id)
+    {
+        if(_id >= 0)
+        {
+            async_loads_manager::decrease_usages(_id);
+        }
+
+        _id = other._id;
+        async_loads_manager::increase_usages(_id);
+    }
+
+    return *this;
+}
+
+const regular_bg_tiles_ptr& regular_bg_tiles_async_load_ptr::tiles() const
+{
+    return async_loads_manager::regular_bg_tiles(_id);
+}
+
+bool regular_bg_tiles_async_load_ptr::done() const
+{
+    return async_loads_manager::done(_id);
+}
+
+void regular_bg_tiles_async_load_ptr::_destroy()
+{
+    async_loads_manager::decrease_usages(_id);
+}
+
+}
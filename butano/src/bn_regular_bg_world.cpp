@@ -0,0 +1,643 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_regular_bg_world.h"
+
+#include "bn_math.h"
+#include "bn_display.h"
+#include "bn_bg_palette_ptr.h"
+#include "bn_regular_bg_item.h"
+#include "bn_regular_bg_builder.h"
+#include "bn_regular_bg_map_ptr.h"
+#include "bn_regular_bg_tiles_ptr.h"
+
+#include "../hw/include/bn_hw_bg_blocks.h"
+
+namespace bn
+{
+
+namespace
+{
+    constexpr int chunk_size = regular_bg_world_item::chunk_size();
+    constexpr int chunk_cells = chunk_size * chunk_size;
+    constexpr int visible_rows = (display::height() / 8) + 2;
+    constexpr int prefetch_pixels = 64;
+    constexpr int no_dynamic_tile = 0xFFFF;
+
+    [[nodiscard]] regular_bg_map_cell* _alloc_cells(int max_cached_chunks)
+    {
+        BN_ASSERT(max_cached_chunks >= 4, "Invalid max cached chunks: ", max_cached_chunks);
+
+        // The first chunk stores the cells displayed by the background:
+        int cells_count = (max_cached_chunks + 1) * chunk_cells;
+        int bytes = (cells_count * int(sizeof(regular_bg_map_cell))) + (max_cached_chunks * int(sizeof(int) * 2));
+        auto result = static_cast<regular_bg_map_cell*>(memory::ewram_alloc(bytes));
+        BN_ASSERT(result, "EWRAM allocation failed: ", bytes);
+
+        memory::clear(chunk_cells, *result);
+        return result;
+    }
+
+    [[nodiscard]] int _tile_units(const regular_bg_world_item& item)
+    {
+        return item.palette_item().bpp() == bpp_mode::BPP_8 ? 2 : 1;
+    }
+
+    [[nodiscard]] int _world_tiles_count(const regular_bg_world_item& item)
+    {
+        int result = 0;
+
+        for(const regular_bg_tiles_item& tiles_item : item.tiles_items())
+        {
+            result += tiles_item.tiles_ref().size();
+        }
+
+        return result / _tile_units(item);
+    }
+
+    [[nodiscard]] uint16_t* _alloc_dynamic_tiles_data(const regular_bg_world_item& item, int dynamic_tiles_count)
+    {
+        if(! dynamic_tiles_count)
+        {
+            BN_ASSERT(item.tiles_items().size() == 1, "Dynamic tiles are required by worlds with several tiles items");
+
+            return nullptr;
+        }
+
+        BN_ASSERT(dynamic_tiles_count > 0 && dynamic_tiles_count <= 1024,
+                  "Invalid dynamic tiles count: ", dynamic_tiles_count);
+
+        int world_tiles_count = _world_tiles_count(item);
+        BN_ASSERT(world_tiles_count < no_dynamic_tile, "Too many tiles: ", world_tiles_count);
+
+        // Tile of each map cell, followed by the dynamic tile of each world tile and the dynamic tiles:
+        int half_words = chunk_cells + world_tiles_count + (world_tiles_count % 2);
+        int bytes = (half_words * int(sizeof(uint16_t))) + (dynamic_tiles_count * int(sizeof(int16_t) * 4));
+        auto result = static_cast<uint16_t*>(memory::ewram_alloc(bytes));
+        BN_ASSERT(result, "EWRAM allocation failed: ", bytes);
+
+        memory::set_half_words(uint16_t(no_dynamic_tile), chunk_cells + world_tiles_count, result);
+        return result;
+    }
+
+    [[nodiscard]] regular_bg_ptr _create_bg(const regular_bg_world_item& item, regular_bg_map_cell& cells_ref,
+                                            int dynamic_tiles_count)
+    {
+        regular_bg_map_item map_item(cells_ref, size(chunk_size, chunk_size));
+
+        if(! dynamic_tiles_count)
+        {
+            regular_bg_item bg_item(item.tiles_item(), item.palette_item(), map_item);
+            return bg_item.create_bg(0, 0);
+        }
+
+        const bg_palette_item& palette_item = item.palette_item();
+        regular_bg_tiles_ptr tiles = regular_bg_tiles_ptr::allocate(
+                    dynamic_tiles_count * _tile_units(item), palette_item.bpp());
+        regular_bg_map_ptr map = regular_bg_map_ptr::create(map_item, move(tiles), palette_item.create_palette());
+        regular_bg_builder builder(move(map));
+        return builder.release_build();
+    }
+}
+
+regular_bg_world::regular_bg_world(const regular_bg_world_item& item, const point& position, int max_cached_chunks,
+                                   int dynamic_tiles_count) :
+    _item(item),
+    _cells(_alloc_cells(max_cached_chunks)),
+    _dynamic_tiles_data(_alloc_dynamic_tiles_data(item, dynamic_tiles_count)),
+    _cached_chunks(reinterpret_cast<cached_chunk*>(_cells.get() + ((max_cached_chunks + 1) * chunk_cells))),
+    _bg(_create_bg(item, *_cells, dynamic_tiles_count)),
+    _max_cached_chunks(max_cached_chunks),
+    _dynamic_tiles_count(dynamic_tiles_count),
+    _last_free_dynamic_tile(dynamic_tiles_count - 1)
+{
+    static_assert(sizeof(cached_chunk) == sizeof(int) * 2);
+    static_assert(sizeof(dynamic_tile) == sizeof(int16_t) * 4);
+
+    for(int index = 0; index < max_cached_chunks; ++index)
+    {
+        _cached_chunks[index] = cached_chunk{ -1, -1 };
+    }
+
+    if(dynamic_tiles_count)
+    {
+        int world_tiles_count = _world_tiles_count(item);
+        int half_words = chunk_cells + world_tiles_count + (world_tiles_count % 2);
+        _dynamic_tiles = reinterpret_cast<dynamic_tile*>(_dynamic_tiles_data.get() + half_words);
+
+        // All dynamic tiles are free at the beginning:
+        for(int index = 0; index < dynamic_tiles_count; ++index)
+        {
+            _dynamic_tiles[index] = dynamic_tile{ uint16_t(no_dynamic_tile), 0, int16_t(index - 1),
+                                                  int16_t(index + 1 < dynamic_tiles_count ? index + 1 : -1) };
+        }
+    }
+
+    set_position(position);
+}
+
+void regular_bg_world::set_position(const point& position)
+{
+    size pixels_dimensions = _item.pixels_dimensions();
+    int x = position.x();
+    int y = position.y();
+    BN_ASSERT(x >= 0 && x <= pixels_dimensions.width() - display::width(), "Invalid x: ", x);
+    BN_ASSERT(y >= 0 && y <= pixels_dimensions.height() - display::height(), "Invalid y: ", y);
+
+    point old_position = _position;
+    int old_map_x = _map_position.x();
+    int old_map_y = _map_position.y();
+    int new_map_x = x / 8;
+    int new_map_y = y / 8;
+    bool first_update = _ticks == 0;
+    bool reload = first_update;
+    ++_ticks;
+
+    if(_dynamic_tiles)
+    {
+        // VRAM location of the tiles can change when BG blocks are defragmented:
+        regular_bg_tiles_ptr tiles = _bg.tiles();
+        _dynamic_tiles_vram = tiles.vram()->data();
+
+        // Slots released from now on are displayed until the next V-Blank, so they can't be reused yet:
+        _last_reusable_dynamic_tile = _last_free_dynamic_tile;
+    }
+
+    if(first_update || abs(new_map_x - old_map_x) > 8 || abs(new_map_y - old_map_y) > 8)
+    {
+        if(_dynamic_tiles && ! first_update)
+        {
+            for(int row = 0; row < chunk_size; ++row)
+            {
+                _release_dynamic_row(row);
+            }
+        }
+
+        for(int row = new_map_y, row_limit = new_map_y + visible_rows; row < row_limit; ++row)
+        {
+            _load_row(new_map_x, row);
+        }
+
+        reload = true;
+    }
+    else
+    {
+        while(new_map_x < old_map_x)
+        {
+            --old_map_x;
+            _load_col(old_map_x, new_map_y);
+            reload = true;
+        }
+
+        while(new_map_x > old_map_x)
+        {
+            ++old_map_x;
+            _load_col(old_map_x + chunk_size - 1, new_map_y);
+            reload = true;
+        }
+
+        // Rows which leave the screen release their dynamic tiles:
+        while(new_map_y < old_map_y)
+        {
+            _release_dynamic_row(old_map_y + visible_rows - 1);
+            --old_map_y;
+            _load_row(new_map_x, old_map_y);
+            reload = true;
+        }
+
+        while(new_map_y > old_map_y)
+        {
+            _release_dynamic_row(old_map_y);
+            ++old_map_y;
+            _load_row(new_map_x, old_map_y + visible_rows - 1);
+            reload = true;
+        }
+    }
+
+    if(reload)
+    {
+        regular_bg_map_ptr map = _bg.map();
+        map.reload_cells_ref();
+    }
+
+    // The 32x32 map wraps every 256 pixels:
+    int wrap_mask = (chunk_size * 8) - 1;
+    int half_map_size = chunk_size * 4;
+    _bg.set_position(half_map_size - (display::width() / 2) - (x & wrap_mask),
+                     half_map_size - (display::height() / 2) - (y & wrap_mask));
+    _position = position;
+    _map_position = point(new_map_x, new_map_y);
+
+    if(! first_update)
+    {
+        _prefetch(old_position);
+    }
+}
+
+int regular_bg_world::cached_chunks_count() const
+{
+    int result = 0;
+
+    for(int index = 0; index < _max_cached_chunks; ++index)
+    {
+        if(_cached_chunks[index].chunk_index >= 0)
+        {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+int regular_bg_world::used_dynamic_tiles_count() const
+{
+    int result = 0;
+
+    for(int index = 0; index < _dynamic_tiles_count; ++index)
+    {
+        if(_dynamic_tiles[index].usages)
+        {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+void regular_bg_world::ewram_deleter::operator()(void* ptr) const
+{
+    memory::ewram_free(ptr);
+}
+
+const regular_bg_tiles_item& regular_bg_world::_chunk_tiles_item(int chunk_x, int chunk_y, int& tiles_base) const
+{
+    span<const regular_bg_tiles_item> tiles_items = _item.tiles_items();
+    int tiles_index = _item.chunk_tiles_index(_item.chunk_index(chunk_x, chunk_y));
+    int tile_units = _tile_units(_item);
+    tiles_base = 0;
+
+    for(int index = 0; index < tiles_index; ++index)
+    {
+        tiles_base += tiles_items[index].tiles_ref().size() / tile_units;
+    }
+
+    return tiles_items[tiles_index];
+}
+
+void regular_bg_world::_set_dynamic_cell(int ring_index, regular_bg_map_cell cell,
+                                         const regular_bg_tiles_item& tiles_item, int tiles_base)
+{
+    uint16_t* ring_tiles = _dynamic_tiles_data.get();
+    uint16_t* tile_slots = ring_tiles + chunk_cells;
+    int tile_index = hw::bg_blocks::regular_bg_map_cell_tile_index(cell);
+    int world_tile = tiles_base + tile_index;
+    int old_world_tile = ring_tiles[ring_index];
+    int slot = tile_slots[world_tile];
+
+    if(world_tile != old_world_tile)
+    {
+        if(slot != no_dynamic_tile)
+        {
+            dynamic_tile& slot_tile = _dynamic_tiles[slot];
+
+            if(! slot_tile.usages)
+            {
+                _unlink_free_dynamic_tile(slot);
+            }
+
+            ++slot_tile.usages;
+        }
+        else
+        {
+            // The least recently released tile is replaced:
+            slot = _first_free_dynamic_tile;
+            BN_ASSERT(_last_reusable_dynamic_tile >= 0, "There's no more available dynamic tiles");
+
+            _unlink_free_dynamic_tile(slot);
+
+            dynamic_tile& slot_tile = _dynamic_tiles[slot];
+
+            if(slot_tile.tile != no_dynamic_tile)
+            {
+                tile_slots[slot_tile.tile] = no_dynamic_tile;
+            }
+
+            slot_tile.tile = uint16_t(world_tile);
+            slot_tile.usages = 1;
+            tile_slots[world_tile] = uint16_t(slot);
+
+            int tile_units = _tile_units(_item);
+            const tile& source_tile_ref = tiles_item.tiles_ref()[tile_index * tile_units];
+            memory::copy(source_tile_ref, tile_units, _dynamic_tiles_vram[slot * tile_units]);
+        }
+
+        if(old_world_tile != no_dynamic_tile)
+        {
+            _release_dynamic_tile(tile_slots[old_world_tile]);
+        }
+
+        ring_tiles[ring_index] = uint16_t(world_tile);
+    }
+
+    _cells.get()[ring_index] = hw::bg_blocks::set_regular_bg_map_cell_tile_index(cell, unsigned(slot));
+}
+
+void regular_bg_world::_release_dynamic_row(int y)
+{
+    if(! _dynamic_tiles)
+    {
+        return;
+    }
+
+    uint16_t* ring_tiles = _dynamic_tiles_data.get() + ((y % chunk_size) * chunk_size);
+    uint16_t* tile_slots = _dynamic_tiles_data.get() + chunk_cells;
+
+    for(int column = 0; column < chunk_size; ++column)
+    {
+        if(int world_tile = ring_tiles[column]; world_tile != no_dynamic_tile)
+        {
+            _release_dynamic_tile(tile_slots[world_tile]);
+            ring_tiles[column] = uint16_t(no_dynamic_tile);
+        }
+    }
+}
+
+void regular_bg_world::_release_dynamic_tile(int slot)
+{
+    dynamic_tile& slot_tile = _dynamic_tiles[slot];
+    --slot_tile.usages;
+
+    if(! slot_tile.usages)
+    {
+        // Released tiles are kept in VRAM until their slot is reused:
+        slot_tile.prev = int16_t(_last_free_dynamic_tile);
+        slot_tile.next = -1;
+
+        if(_last_free_dynamic_tile >= 0)
+        {
+            _dynamic_tiles[_last_free_dynamic_tile].next = int16_t(slot);
+        }
+        else
+        {
+            _first_free_dynamic_tile = slot;
+        }
+
+        _last_free_dynamic_tile = slot;
+    }
+}
+
+void regular_bg_world::_unlink_free_dynamic_tile(int slot)
+{
+    dynamic_tile& slot_tile = _dynamic_tiles[slot];
+    int prev = slot_tile.prev;
+    int next = slot_tile.next;
+
+    if(slot == _last_reusable_dynamic_tile)
+    {
+        _last_reusable_dynamic_tile = prev;
+    }
+
+    if(prev >= 0)
+    {
+        _dynamic_tiles[prev].next = int16_t(next);
+    }
+    else
+    {
+        _first_free_dynamic_tile = next;
+    }
+
+    if(next >= 0)
+    {
+        _dynamic_tiles[next].prev = int16_t(prev);
+    }
+    else
+    {
+        _last_free_dynamic_tile = prev;
+    }
+}
+
+const regular_bg_map_cell* regular_bg_world::_chunk_cells(int chunk_x, int chunk_y, bool prefetch)
+{
+    const regular_bg_map_item& chunk_item = _item.chunk_item(chunk_x, chunk_y);
+
+    if(chunk_item.compression() == compression_type::NONE && ! chunk_item.metatiles())
+    {
+        return prefetch ? nullptr : &chunk_item.cells_ref();
+    }
+
+    int chunk_index = _item.chunk_index(chunk_x, chunk_y);
+    int ticks = _ticks;
+    regular_bg_map_cell* cache_cells_ptr = _cells.get() + chunk_cells;
+    cached_chunk* lru_chunk_ptr = _cached_chunks;
+    int lru_chunk_offset = 0;
+
+    for(int index = 0; index < _max_cached_chunks; ++index)
+    {
+        cached_chunk& chunk = _cached_chunks[index];
+
+        if(chunk.chunk_index == chunk_index)
+        {
+            chunk.last_use = ticks;
+            return prefetch ? nullptr : cache_cells_ptr + (index * chunk_cells);
+        }
+
+        if(chunk.last_use < lru_chunk_ptr->last_use)
+        {
+            lru_chunk_ptr = &chunk;
+            lru_chunk_offset = index * chunk_cells;
+        }
+    }
+
+    // Chunks used in this update are never evicted by a prefetch:
+    if(prefetch && lru_chunk_ptr->last_use == ticks)
+    {
+        return nullptr;
+    }
+
+    regular_bg_map_cell* result = cache_cells_ptr + lru_chunk_offset;
+    lru_chunk_ptr->chunk_index = chunk_index;
+    lru_chunk_ptr->last_use = ticks;
+    [[maybe_unused]] regular_bg_map_item uncompressed_item = chunk_item.uncompress(
+                *result, size(chunk_size, chunk_size));
+    return result;
+}
+
+void regular_bg_world::_load_col(int x, int y)
+{
+    int world_width = _item.dimensions().width() * chunk_size;
+
+    if(x >= world_width)
+    {
+        return;
+    }
+
+    int world_height = _item.dimensions().height() * chunk_size;
+    int chunk_x = x / chunk_size;
+    int cell_x = x % chunk_size;
+    regular_bg_map_cell* cells_ptr = _cells.get() + cell_x;
+    const regular_bg_map_cell* chunk_cells_ptr = nullptr;
+    int last_chunk_y = -1;
+
+    const regular_bg_tiles_item* tiles_item_ptr = nullptr;
+    int tiles_base = 0;
+
+    for(int row = y, row_limit = min(y + visible_rows, world_height); row < row_limit; ++row)
+    {
+        int chunk_y = row / chunk_size;
+
+        if(chunk_y != last_chunk_y)
+        {
+            chunk_cells_ptr = _chunk_cells(chunk_x, chunk_y, false);
+            last_chunk_y = chunk_y;
+
+            if(_dynamic_tiles)
+            {
+                tiles_item_ptr = &_chunk_tiles_item(chunk_x, chunk_y, tiles_base);
+            }
+        }
+
+        int cell_y = row % chunk_size;
+        regular_bg_map_cell cell = chunk_cells_ptr[(cell_y * chunk_size) + cell_x];
+
+        if(tiles_item_ptr)
+        {
+            _set_dynamic_cell((cell_y * chunk_size) + cell_x, cell, *tiles_item_ptr, tiles_base);
+        }
+        else
+        {
+            cells_ptr[cell_y * chunk_size] = cell;
+        }
+    }
+}
+
+void regular_bg_world::_load_row(int x, int y)
+{
+    int world_height = _item.dimensions().height() * chunk_size;
+
+    if(y >= world_height)
+    {
+        return;
+    }
+
+    // Chunk boundaries are the same as the map boundaries, so each run can be copied at once:
+    int world_width = _item.dimensions().width() * chunk_size;
+    int chunk_y = y / chunk_size;
+    int cell_y = y % chunk_size;
+    regular_bg_map_cell* cells_ptr = _cells.get() + (cell_y * chunk_size);
+    int column = x;
+    int column_limit = min(x + chunk_size, world_width);
+
+    while(column < column_limit)
+    {
+        int cell_x = column % chunk_size;
+        int run = min(chunk_size - cell_x, column_limit - column);
+        int chunk_x = column / chunk_size;
+        const regular_bg_map_cell* chunk_cells_ptr = _chunk_cells(chunk_x, chunk_y, false) + (cell_y * chunk_size);
+
+        if(_dynamic_tiles)
+        {
+            int tiles_base;
+            const regular_bg_tiles_item& tiles_item = _chunk_tiles_item(chunk_x, chunk_y, tiles_base);
+
+            for(int index = cell_x, limit = cell_x + run; index < limit; ++index)
+            {
+                _set_dynamic_cell((cell_y * chunk_size) + index, chunk_cells_ptr[index], tiles_item, tiles_base);
+            }
+        }
+        else
+        {
+            memory::copy(chunk_cells_ptr[cell_x], run, cells_ptr[cell_x]);
+        }
+
+        column += run;
+    }
+}
+
+void regular_bg_world::_prefetch(const point& old_position)
+{
+    int x = _position.x();
+    int y = _position.y();
+    int chunk_pixels = chunk_size * 8;
+    int first_chunk_x = x / chunk_pixels;
+    int last_chunk_x = (x + display::width() - 1) / chunk_pixels;
+    int first_chunk_y = y / chunk_pixels;
+    int last_chunk_y = (y + display::height() - 1) / chunk_pixels;
+
+    // Visible chunks are touched so they are not evicted by the prefetched ones:
+    for(int chunk_y = first_chunk_y; chunk_y <= last_chunk_y; ++chunk_y)
+    {
+        for(int chunk_x = first_chunk_x; chunk_x <= last_chunk_x; ++chunk_x)
+        {
+            int chunk_index = _item.chunk_index(chunk_x, chunk_y);
+
+            for(int index = 0; index < _max_cached_chunks; ++index)
+            {
+                cached_chunk& chunk = _cached_chunks[index];
+
+                if(chunk.chunk_index == chunk_index)
+                {
+                    chunk.last_use = _ticks;
+                }
+            }
+        }
+    }
+
+    const size& dimensions = _item.dimensions();
+    int next_chunk_x = -1;
+    int next_chunk_y = -1;
+
+    if(x > old_position.x())
+    {
+        next_chunk_x = (x + display::width() - 1 + prefetch_pixels) / chunk_pixels;
+    }
+    else if(x < old_position.x() && x >= prefetch_pixels)
+    {
+        next_chunk_x = (x - prefetch_pixels) / chunk_pixels;
+    }
+
+    if(y > old_position.y())
+    {
+        next_chunk_y = (y + display::height() - 1 + prefetch_pixels) / chunk_pixels;
+    }
+    else if(y < old_position.y() && y >= prefetch_pixels)
+    {
+        next_chunk_y = (y - prefetch_pixels) / chunk_pixels;
+    }
+
+    if(next_chunk_x >= dimensions.width() || (next_chunk_x >= first_chunk_x && next_chunk_x <= last_chunk_x))
+    {
+        next_chunk_x = -1;
+    }
+
+    if(next_chunk_y >= dimensions.height() || (next_chunk_y >= first_chunk_y && next_chunk_y <= last_chunk_y))
+    {
+        next_chunk_y = -1;
+    }
+
+    // Only one chunk is uncompressed per update at most:
+    if(next_chunk_x >= 0)
+    {
+        for(int chunk_y = first_chunk_y; chunk_y <= last_chunk_y; ++chunk_y)
+        {
+            if(_chunk_cells(next_chunk_x, chunk_y, true))
+            {
+                return;
+            }
+        }
+    }
+
+    if(next_chunk_y >= 0)
+    {
+        for(int chunk_x = first_chunk_x; chunk_x <= last_chunk_x; ++chunk_x)
+        {
+            if(_chunk_cells(chunk_x, next_chunk_y, true))
+            {
+                return;
+            }
+        }
+    }
+}
+
+}
@@ -7,6 +7,7 @@
 #define BN_SORT_KEY_H
 
 #include "bn_limits.h"
+#include "bn_functional.h"
 
 namespace bn
 {
@@ -57,6 +58,11 @@ public:
         _fields.z_order = uint16_t(z_order + numeric_limits<int16_t>::max());
     }
 
+    [[nodiscard]] constexpr unsigned data() const
+    {
+        return _data;
+    }
+
     [[nodiscard]] constexpr friend bool operator==(sort_key a, sort_key b)
     {
         return a._data == b._data;
@@ -99,6 +105,16 @@ private:
     };
 };
 
+
+template<>
+struct hash<sort_key>
+{
+    [[nodiscard]] constexpr unsigned operator()(sort_key value) const
+    {
+        return make_hash(value.data());
+    }
+};
+
 }
 
 #endif
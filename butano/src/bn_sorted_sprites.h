@@ -7,6 +7,7 @@
 #define BN_SORTED_SPRITES_H
 
 #include "bn_pool.h"
+#include "bn_unordered_map.h"
 #include "bn_config_sprites.h"
 #include "bn_sprites_manager_item.h"
 
@@ -45,6 +46,20 @@ namespace bn::sorted_sprites
     using layers_type = intrusive_list<layer>;
 
 
+    [[nodiscard]] constexpr int layers_map_size()
+    {
+        // Map size is at least twice the number of layers to keep probe sequences short:
+        int result = 1;
+
+        while(result < BN_CFG_SPRITES_MAX_SORT_LAYERS * 2)
+        {
+            result *= 2;
+        }
+
+        return result;
+    }
+
+
     class sorter
     {
 
@@ -56,32 +71,21 @@ namespace bn::sorted_sprites
 
         void insert(sprites_manager_item& item)
         {
-            layers_type& layers = _layer_ptrs;
             sort_key item_sort_key = item.sprite_sort_key;
-            layers_type::iterator layers_end = layers.end();
-            layers_type::iterator layers_it = lower_bound(layers.begin(), layers_end, item_sort_key,
-                    [](const layer& layer, sort_key sort_key) {
-                        return layer.layer_sort_key() < sort_key;
-                    });
+            layers_map_type::iterator layers_map_it = _layers_map.find(item_sort_key);
+            layer* layer_ptr;
 
-            if(layers_it == layers_end)
+            if(layers_map_it != _layers_map.end())
             {
-                BN_ASSERT(! _layer_pool.full(), "No more sprite sort layers available");
-
-                layer& pool_layer = _layer_pool.create(item_sort_key);
-                layers_it = layers.insert(layers_end, pool_layer);
+                layer_ptr = layers_map_it->second;
             }
-            else if(item_sort_key != layers_it->layer_sort_key())
+            else
             {
-                BN_ASSERT(! _layer_pool.full(), "No more sprite sort layers available");
-
-                layer& pool_layer = _layer_pool.create(item_sort_key);
-                layers_it = layers.insert(layers_it, pool_layer);
+                layer_ptr = &_create_layer(item_sort_key);
             }
 
-            layer& layer = *layers_it;
-            layer.items().push_front(item);
-            item.sort_layer_ptr = &layer;
+            layer_ptr->items().push_front(item);
+            item.sort_layer_ptr = layer_ptr;
         }
 
         void erase(sprites_manager_item& item)
@@ -92,6 +96,7 @@ namespace bn::sorted_sprites
 
             if(layer_items.empty())
             {
+                _layers_map.erase(layer->layer_sort_key());
                 _layer_ptrs.erase(*layer);
                 _layer_pool.destroy(*layer);
             }
@@ -128,8 +133,29 @@ namespace bn::sorted_sprites
         }
 
     private:
+        using layers_map_type = unordered_map<sort_key, layer*, layers_map_size()>;
+
         pool<layer, BN_CFG_SPRITES_MAX_SORT_LAYERS> _layer_pool;
+        layers_map_type _layers_map;
         layers_type _layer_ptrs;
+
+        [[nodiscard]] layer& _create_layer(sort_key layer_sort_key)
+        {
+            BN_ASSERT(! _layer_pool.full(), "No more sprite sort layers available");
+
+            // Layers with the same sort key are found with the map,
+            // so the sorted list is only traversed when a new sort key is used:
+            layers_type& layers = _layer_ptrs;
+            layers_type::iterator layers_it = lower_bound(layers.begin(), layers.end(), layer_sort_key,
+                    [](const layer& layer, sort_key sort_key) {
+                        return layer.layer_sort_key() < sort_key;
+                    });
+
+            layer& pool_layer = _layer_pool.create(layer_sort_key);
+            layers.insert(layers_it, pool_layer);
+            _layers_map.insert(layer_sort_key, &pool_layer);
+            return pool_layer;
+        }
     };
 }
 
@@ -21,6 +21,7 @@ namespace
     constexpr const int max_items = hw::sprite_affine_mats::count();
 
     static_assert(max_items <= numeric_limits<int8_t>::max());
+    static_assert(max_items <= 32);
 
     class item_type
     {
@@ -79,8 +80,7 @@ namespace
         item_type items[max_items];
         vector<int8_t, max_items> free_item_indexes;
         hw::sprite_affine_mats::handle* handles_ptr = nullptr;
-        int first_index_to_commit = max_items;
-        int last_index_to_commit = 0;
+        unsigned indexes_to_commit = 0;
         int first_index_to_remove_if_not_needed = max_items;
         int last_index_to_remove_if_not_needed = 0;
     };
@@ -90,8 +90,7 @@ namespace
 
     void _update_indexes_to_commit(int index)
     {
-        data.first_index_to_commit = min(data.first_index_to_commit, index);
-        data.last_index_to_commit = max(data.last_index_to_commit, index);
+        data.indexes_to_commit |= 1U << index;
     }
 
     void _update(int index)
@@ -572,19 +571,10 @@ void update()
     }
 }
 
-optional<commit_data> retrieve_commit_data()
+unsigned retrieve_indexes_to_commit()
 {
-    optional<commit_data> result;
-
-    if(data.first_index_to_commit < max_items)
-    {
-        int offset = data.first_index_to_commit;
-        int count = data.last_index_to_commit - data.first_index_to_commit + 1;
-        result = commit_data{ offset, count };
-        data.first_index_to_commit = max_items;
-        data.last_index_to_commit = 0;
-    }
-
+    unsigned result = data.indexes_to_commit;
+    data.indexes_to_commit = 0;
     return result;
 }
 
@@ -7,7 +7,6 @@
 #define BN_SPRITES_AFFINE_MATS_MANAGER_H
 
 #include "bn_fixed_fwd.h"
-#include "bn_optional_fwd.h"
 #include "bn_intrusive_list.h"
 
 namespace bn
@@ -19,15 +18,6 @@ namespace bn
 
 namespace bn::sprite_affine_mats_manager
 {
-    class commit_data
-    {
-
-    public:
-        int offset;
-        int count;
-    };
-
-
     void init(void* handles);
 
     [[nodiscard]] int used_count();
@@ -100,7 +90,7 @@ namespace bn::sprite_affine_mats_manager
 
     void update();
 
-    [[nodiscard]] optional<commit_data> retrieve_commit_data();
+    [[nodiscard]] unsigned retrieve_indexes_to_commit();
 }
 
 #endif
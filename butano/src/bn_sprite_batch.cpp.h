@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_sprite_batch.h"
+
+#include "bn_sprites.h"
+#include "bn_sprite_builder.h"
+#include "bn_sprites_manager.h"
+
+namespace bn
+{
+
+isprite_batch::isprite_batch(ivector<sprite_ptr>& sprites_ref, int16_t* item_indexes_ptr,
+                             const sprite_shape_size& shape_size, sprite_tiles_ptr&& tiles,
+                             sprite_palette_ptr&& palette) :
+    _sprites_ref(sprites_ref),
+    _item_indexes_ptr(item_indexes_ptr),
+    _shape_size(shape_size),
+    _tiles(move(tiles)),
+    _palette(move(palette)),
+    _max_hidden_size(sprites_ref.max_size())
+{
+    BN_ASSERT(_tiles.tiles_count() == shape_size.tiles_count(_palette.bpp()),
+              "Invalid tiles count: ", _tiles.tiles_count(), " - ", shape_size.tiles_count(_palette.bpp()));
+}
+
+void isprite_batch::set_max_hidden_size(int max_hidden_size)
+{
+    BN_ASSERT(max_hidden_size >= 0 && max_hidden_size <= _sprites_ref.max_size(),
+              "Invalid max hidden size: ", max_hidden_size, " - ", _sprites_ref.max_size());
+
+    _max_hidden_size = max_hidden_size;
+    _release_hidden_sprites();
+}
+
+void isprite_batch::set_tiles(const sprite_tiles_ptr& tiles)
+{
+    for(sprite_ptr& sprite : _sprites_ref)
+    {
+        sprite.set_tiles(tiles);
+    }
+
+    _tiles = tiles;
+}
+
+void isprite_batch::set_palette(const sprite_palette_ptr& palette)
+{
+    for(sprite_ptr& sprite : _sprites_ref)
+    {
+        sprite.set_palette(palette);
+    }
+
+    _palette = palette;
+}
+
+void isprite_batch::set_bg_priority(int bg_priority)
+{
+    BN_ASSERT(bg_priority >= 0 && bg_priority <= sprites::max_bg_priority(), "Invalid BG priority: ", bg_priority);
+
+    for(sprite_ptr& sprite : _sprites_ref)
+    {
+        sprite.set_bg_priority(bg_priority);
+    }
+
+    _bg_priority = int8_t(bg_priority);
+}
+
+void isprite_batch::set_z_order(int z_order)
+{
+    BN_ASSERT(z_order >= sprites::min_z_order() && z_order <= sprites::max_z_order(), "Invalid z order: ", z_order);
+
+    for(sprite_ptr& sprite : _sprites_ref)
+    {
+        sprite.set_z_order(z_order);
+    }
+
+    _z_order = int16_t(z_order);
+}
+
+void isprite_batch::set_horizontal_flip(bool horizontal_flip)
+{
+    for(sprite_ptr& sprite : _sprites_ref)
+    {
+        sprite.set_horizontal_flip(horizontal_flip);
+    }
+
+    _horizontal_flip = horizontal_flip;
+}
+
+void isprite_batch::set_vertical_flip(bool vertical_flip)
+{
+    for(sprite_ptr& sprite : _sprites_ref)
+    {
+        sprite.set_vertical_flip(vertical_flip);
+    }
+
+    _vertical_flip = vertical_flip;
+}
+
+void isprite_batch::set_camera(const camera_ptr& camera)
+{
+    for(sprite_ptr& sprite : _sprites_ref)
+    {
+        sprite.set_camera(camera);
+    }
+
+    _camera = camera;
+}
+
+void isprite_batch::remove_camera()
+{
+    for(sprite_ptr& sprite : _sprites_ref)
+    {
+        sprite.remove_camera();
+    }
+
+    _camera.reset();
+}
+
+void isprite_batch::set_positions(const span<const fixed_point>& positions)
+{
+    ivector<sprite_ptr>& sprites_ref = _sprites_ref;
+    int positions_count = positions.size();
+    BN_ASSERT(positions_count <= sprites_ref.max_size(),
+              "Too many positions: ", positions_count, " - ", sprites_ref.max_size());
+
+    for(int index = sprites_ref.size(); index < positions_count; ++index)
+    {
+        sprite_builder builder(_shape_size, _tiles, _palette);
+        builder.set_position(positions[index]);
+        builder.set_bg_priority(_bg_priority);
+        builder.set_z_order(_z_order);
+        builder.set_horizontal_flip(_horizontal_flip);
+        builder.set_vertical_flip(_vertical_flip);
+        builder.set_camera(_camera);
+        builder.set_visible(false);
+
+        sprite_ptr sprite = builder.release_build();
+        _item_indexes_ptr[index] = int16_t(sprites_manager::item_index(const_cast<void*>(sprite.handle())));
+        sprites_ref.push_back(move(sprite));
+    }
+
+    sprites_manager::set_batch_positions(_item_indexes_ptr, positions.data(), positions_count, _size);
+    _size = positions_count;
+    _release_hidden_sprites();
+}
+
+void isprite_batch::clear()
+{
+    _sprites_ref.clear();
+    _size = 0;
+}
+
+void isprite_batch::_release_hidden_sprites()
+{
+    // Hidden sprites are the last ones, so they can be released without updating item indexes:
+    int max_allocated_size = _size + _max_hidden_size;
+
+    if(_sprites_ref.size() > max_allocated_size)
+    {
+        _sprites_ref.shrink(max_allocated_size);
+    }
+}
+
+}
@@ -5,6 +5,7 @@
 
 #include "bn_sprite_tiles.h"
 
+#include "bn_sprites_manager.h"
 #include "bn_sprite_tiles_manager.h"
 
 namespace bn::sprite_tiles
@@ -20,6 +21,11 @@ int available_tiles_count()
     return sprite_tiles_manager::available_tiles_count();
 }
 
+int largest_available_tiles_count()
+{
+    return sprite_tiles_manager::largest_available_tiles_count();
+}
+
 int used_items_count()
 {
     return sprite_tiles_manager::used_items_count();
@@ -30,6 +36,12 @@ int available_items_count()
     return sprite_tiles_manager::available_items_count();
 }
 
+void defragment()
+{
+    sprite_tiles_manager::defragment();
+    sprites_manager::reload_tiles();
+}
+
 #if BN_CFG_LOG_ENABLED
     void log_status()
     {
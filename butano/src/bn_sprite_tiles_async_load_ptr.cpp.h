@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_sprite_tiles_async_load_ptr.h"
+
+#include "bn_sprite_tiles_item.h"
+#include "bn_async_loads_manager.h"
+
+namespace bn
+{
+
+sprite_tiles_async_load_ptr sprite_tiles_async_load_ptr::create(const sprite_tiles_item& tiles_item)
+{
+    span<const tile> tiles_ref = tiles_item.graphics_tiles_ref();
+    sprite_tiles_ptr tiles = sprite_tiles_ptr::allocate(tiles_ref.size(), tiles_item.bpp());
+    int id = async_loads_manager::create(tiles_ref.data(), tiles_item.compression(), tiles_ref.size_bytes(),
+                                         move(tiles), false);
+    return sprite_tiles_async_load_ptr(id);
+}
+
+optional<sprite_tiles_async_load_ptr> sprite_tiles_async_load_ptr::create_optional(const sprite_tiles_item& tiles_item)
+{
+    span<const tile> tiles_ref = tiles_item.graphics_tiles_ref();
+    optional<sprite_tiles_async_load_ptr> result;
+
+    if(optional<sprite_tiles_ptr> tiles = sprite_tiles_ptr::allocate_optional(tiles_ref.size(), tiles_item.bpp()))
+    {
+        int id = async_loads_manager::create(tiles_ref.data(), tiles_item.compression(), tiles_ref.size_bytes(),
+                                             move(*tiles), true);
+
+        if(id >= 0)
+        {
+            result = sprite_tiles_async_load_ptr(id);
+        }
+    }
+
+    return result;
+}
+
+sprite_tiles_async_load_ptr::sprite_tiles_async_load_ptr(const sprite_tiles_async_load_ptr& other) :
+    sprite_tiles_async_load_ptr(other._id)
+{
+    async_loads_manager::increase_usages(_id);
+}
+
+sprite_tiles_async_load_ptr& sprite_tiles_async_load_ptr::operator=(const sprite_tiles_async_load_ptr& other)
+{
+    if(_id != other._id)
+    {
+        if(_id >= 0)
+        {
+            async_loads_manager::decrease_usages(_id);
+        }
+
+        _id = other._id;
+        async_loads_manager::increase_usages(_id);
+    }
+
+    return *this;
+}
+
+const sprite_tiles_ptr& sprite_tiles_async_load_ptr::tiles() const
+{
+    return async_loads_manager::sprite_tiles(_id);
+}
+
+bool sprite_tiles_async_load_ptr::done() const
+{
+    return async_loads_manager::done(_id);
+}
+
+void sprite_tiles_async_load_ptr::_destroy()
+{
+    async_loads_manager::decrease_usages(_id);
+}
+
+}
@@ -5,6 +5,7 @@
 
 #include "bn_sprite_tiles_manager.h"
 
+#include "bn_timer.h"
 #include "bn_vector.h"
 #include "bn_unordered_map.h"
 #include "bn_config_sprite_tiles.h"
@@ -38,6 +39,22 @@ namespace
     constexpr const int max_list_items = max_items + 2;
 
 
+    [[nodiscard]] constexpr int _bin_index(unsigned tiles_count)
+    {
+        int result = 0;
+
+        while(tiles_count > 1)
+        {
+            tiles_count >>= 1;
+            ++result;
+        }
+
+        return result;
+    }
+
+    constexpr const int bins_count = _bin_index(hw::sprite_tiles::tiles_count()) + 1;
+
+
     enum class status_type
     {
         FREE,
@@ -61,6 +78,8 @@ namespace
     public:
         const tile* data = nullptr;
         unsigned usages = 0;
+        uint16_t bin_prev_index = 0;
+        uint16_t bin_next_index = 0;
         unsigned start_tile: 12 = 0;
         unsigned tiles_count: 12 = 0;
 
@@ -259,14 +278,35 @@ namespace
     };
 
 
+    // Segregated lists of items: bin N contains the items with [2^N..2^(N+1)) tiles.
+    // Index 0 is the head node of items_list, so it is used as null index:
+    class items_bins
+    {
+
+    public:
+        uint16_t first_indexes[bins_count] = {};
+        unsigned non_empty_bins = 0;
+    };
+
+
+    class relocation_type
+    {
+
+    public:
+        uint16_t id;
+        uint16_t old_start_tile;
+    };
+
+
     class static_data
     {
 
     public:
         items_list items;
         unordered_map<const tile*, int, max_items * 2> items_map;
-        vector<uint16_t, max_items> free_items;
-        vector<uint16_t, max_items> to_remove_items;
+        items_bins free_bins;
+        items_bins to_remove_bins;
+        vector<relocation_type, max_items> relocations;
         int free_tiles_count = 0;
         int to_remove_tiles_count = 0;
         bool check_commit = false;
@@ -277,6 +317,29 @@ namespace
 
 
     #if BN_CFG_SPRITE_TILES_LOG_ENABLED
+        void _log_bins(const items_bins& bins)
+        {
+            BN_LOG('[');
+
+            for(int bin_index = 0; bin_index < bins_count; ++bin_index)
+            {
+                int item_index = bins.first_indexes[bin_index];
+
+                while(item_index)
+                {
+                    const item_type& item = data.items.item(item_index);
+                    BN_LOG("    ",
+                            "index: ", item_index,
+                            " - data: ", item.data,
+                            " - start_tile: ", item.start_tile,
+                            " - tiles_count: ", item.tiles_count);
+                    item_index = item.bin_next_index;
+                }
+            }
+
+            BN_LOG(']');
+        }
+
         void _log_status()
         {
             BN_LOG("items: ", data.items.size());
@@ -309,36 +372,13 @@ namespace
 
             BN_LOG(']');
 
-            BN_LOG("free_items: ", data.free_items.size());
-            BN_LOG('[');
+            BN_LOG("free_items:");
+            _log_bins(data.free_bins);
 
-            for(int item_index : data.free_items)
-            {
-                const item_type& item = data.items.item(item_index);
-                BN_LOG("    ",
-                        "index: ", item_index,
-                        " - data: ", item.data,
-                        " - start_tile: ", item.start_tile,
-                        " - tiles_count: ", item.tiles_count);
-            }
-
-            BN_LOG(']');
-
-            BN_LOG("to_remove_items: ", data.to_remove_items.size());
-            BN_LOG('[');
-
-            for(int item_index : data.to_remove_items)
-            {
-                const item_type& item = data.items.item(item_index);
-                BN_LOG("    ",
-                        "index: ", item_index,
-                        " - data: ", item.data,
-                        " - start_tile: ", item.start_tile,
-                        " - tiles_count: ", item.tiles_count);
-            }
-
-            BN_LOG(']');
+            BN_LOG("to_remove_items:");
+            _log_bins(data.to_remove_bins);
 
+            BN_LOG("relocations: ", data.relocations.size());
             BN_LOG("free_tiles_count: ", data.free_tiles_count);
             BN_LOG("to_remove_tiles_count: ", data.to_remove_tiles_count);
             BN_LOG("check_commit: ", (data.check_commit ? "true" : "false"));
@@ -362,65 +402,154 @@ namespace
     #endif
 
 
-    constexpr const auto lower_bound_comparator = [](int item_index, unsigned tiles_count)
+    void _insert_bins_item(int id, items_bins& bins)
     {
-        return data.items.item(item_index).tiles_count < tiles_count;
-    };
+        item_type& item = data.items.item(id);
+        int bin_index = _bin_index(item.tiles_count);
+        int next_index = bins.first_indexes[bin_index];
+        item.bin_prev_index = 0;
+        item.bin_next_index = uint16_t(next_index);
 
-    constexpr const auto upper_bound_comparator = [](unsigned tiles_count, int item_index)
-    {
-        return tiles_count < data.items.item(item_index).tiles_count;
-    };
+        if(next_index)
+        {
+            data.items.item(next_index).bin_prev_index = uint16_t(id);
+        }
 
-    void _insert_free_item(int id, ivector<uint16_t>::iterator free_items_last)
-    {
-        const item_type& item = data.items.item(id);
-        auto free_items_it = upper_bound(data.free_items.begin(), free_items_last, item.tiles_count,
-                                         upper_bound_comparator);
-        data.free_items.insert(free_items_it, id);
+        bins.first_indexes[bin_index] = uint16_t(id);
+        bins.non_empty_bins |= 1U << bin_index;
     }
 
-    void _insert_free_item(int id)
+    void _erase_bins_item(int id, items_bins& bins)
     {
-        _insert_free_item(id, data.free_items.end());
+        const item_type& item = data.items.item(id);
+        int prev_index = item.bin_prev_index;
+        int next_index = item.bin_next_index;
+
+        if(next_index)
+        {
+            data.items.item(next_index).bin_prev_index = uint16_t(prev_index);
+        }
+
+        if(prev_index)
+        {
+            data.items.item(prev_index).bin_next_index = uint16_t(next_index);
+        }
+        else
+        {
+            int bin_index = _bin_index(item.tiles_count);
+            bins.first_indexes[bin_index] = uint16_t(next_index);
+
+            if(! next_index)
+            {
+                bins.non_empty_bins &= ~(1U << bin_index);
+            }
+        }
     }
 
-    void _erase_free_item(int id)
+    // Returns the smallest item with at least tiles_count tiles, or 0 if there's none:
+    [[nodiscard]] int _find_best_bins_item(unsigned tiles_count, const items_bins& bins)
     {
-        const item_type& item = data.items.item(id);
-        auto free_items_end = data.free_items.end();
-        auto free_items_it = lower_bound(data.free_items.begin(), free_items_end, item.tiles_count,
-                                         lower_bound_comparator);
+        int bin_index = _bin_index(tiles_count);
+        unsigned non_empty_bins = bins.non_empty_bins >> bin_index;
 
-        while(*free_items_it != id)
+        while(non_empty_bins)
         {
-            ++free_items_it;
+            if(non_empty_bins & 1)
+            {
+                int best_index = 0;
+                unsigned best_tiles_count = hw::sprite_tiles::tiles_count() + 1;
+                int item_index = bins.first_indexes[bin_index];
+
+                while(item_index)
+                {
+                    const item_type& item = data.items.item(item_index);
+                    unsigned item_tiles_count = item.tiles_count;
+
+                    if(item_tiles_count >= tiles_count && item_tiles_count < best_tiles_count)
+                    {
+                        best_index = item_index;
+                        best_tiles_count = item_tiles_count;
+
+                        if(item_tiles_count == tiles_count)
+                        {
+                            break;
+                        }
+                    }
+
+                    item_index = item.bin_next_index;
+                }
+
+                // Bins are sorted by size, so the best item of the first bin with a valid one is the best one:
+                if(best_index)
+                {
+                    return best_index;
+                }
+            }
+
+            non_empty_bins >>= 1;
+            ++bin_index;
         }
 
-        data.free_items.erase(free_items_it);
+        return 0;
     }
 
-    void _insert_to_remove_item(int id)
+    // Returns an item of the first non empty bin, or 0 if there's none:
+    [[nodiscard]] int _first_bins_item(const items_bins& bins)
     {
-        const item_type& item = data.items.item(id);
-        auto to_remove_items_it = upper_bound(data.to_remove_items.begin(), data.to_remove_items.end(),
-                                              item.tiles_count, upper_bound_comparator);
-        data.to_remove_items.insert(to_remove_items_it, id);
+        if(unsigned non_empty_bins = bins.non_empty_bins)
+        {
+            int bin_index = 0;
+
+            while(! (non_empty_bins & 1))
+            {
+                non_empty_bins >>= 1;
+                ++bin_index;
+            }
+
+            return bins.first_indexes[bin_index];
+        }
+
+        return 0;
     }
 
-    void _erase_to_remove_item(int id)
+    // Returns the item with tiles_count tiles, or 0 if there's none:
+    [[nodiscard]] int _find_exact_bins_item(unsigned tiles_count, const items_bins& bins)
     {
-        const item_type& item = data.items.item(id);
-        auto to_remove_items_end = data.to_remove_items.end();
-        auto to_remove_items_it = lower_bound(data.to_remove_items.begin(), to_remove_items_end, item.tiles_count,
-                                              lower_bound_comparator);
+        int item_index = bins.first_indexes[_bin_index(tiles_count)];
 
-        while(*to_remove_items_it != id)
+        while(item_index)
         {
-            ++to_remove_items_it;
+            const item_type& item = data.items.item(item_index);
+
+            if(item.tiles_count == tiles_count)
+            {
+                return item_index;
+            }
+
+            item_index = item.bin_next_index;
         }
 
-        data.to_remove_items.erase(to_remove_items_it);
+        return 0;
+    }
+
+    void _insert_free_item(int id)
+    {
+        _insert_bins_item(id, data.free_bins);
+    }
+
+    void _erase_free_item(int id)
+    {
+        _erase_bins_item(id, data.free_bins);
+    }
+
+    void _insert_to_remove_item(int id)
+    {
+        _insert_bins_item(id, data.to_remove_bins);
+    }
+
+    void _erase_to_remove_item(int id)
+    {
+        _erase_bins_item(id, data.to_remove_bins);
     }
 
     [[nodiscard]] int _find_impl(const tile* tiles_data, [[maybe_unused]] compression_type compression,
@@ -551,48 +680,31 @@ namespace
 
         if(tiles_count <= to_remove_tiles_count)
         {
-            auto to_remove_items_end = data.to_remove_items.end();
-            auto to_remove_items_it = lower_bound(
-                        data.to_remove_items.begin(), to_remove_items_end, tiles_count, lower_bound_comparator);
-
-            if(to_remove_items_it != to_remove_items_end)
+            if(int id = _find_exact_bins_item(unsigned(tiles_count), data.to_remove_bins))
             {
-                int id = *to_remove_items_it;
-                const item_type& item = data.items.item(id);
+                _erase_to_remove_item(id);
 
-                if(int(item.tiles_count) == tiles_count)
+                if(optional<int> new_free_item_id = _create_item(id, tiles_data, compression, tiles_count, true))
                 {
-                    data.to_remove_items.erase(to_remove_items_it);
-
-                    if(optional<int> new_free_item_id = _create_item(
-                                id, tiles_data, compression, tiles_count, true))
-                    {
-                        _insert_free_item(*new_free_item_id);
-                    }
-
-                    return id;
+                    _insert_free_item(*new_free_item_id);
                 }
+
+                return id;
             }
         }
 
         if(tiles_count <= data.free_tiles_count)
         {
-            auto free_items_end = data.free_items.end();
-            auto free_items_it = lower_bound(data.free_items.begin(), free_items_end, tiles_count,
-                                             lower_bound_comparator);
-
-            if(free_items_it != free_items_end)
+            if(int id = _find_best_bins_item(unsigned(tiles_count), data.free_bins))
             {
-                int id = *free_items_it;
+                _erase_free_item(id);
 
                 if(optional<int> new_free_item_id = _create_item(
                             id, tiles_data, compression, tiles_count, data.delay_commit))
                 {
-                    _insert_free_item(*new_free_item_id, free_items_it);
-                    ++free_items_it;
+                    _insert_free_item(*new_free_item_id);
                 }
 
-                data.free_items.erase(free_items_it);
                 return id;
             }
         }
@@ -616,28 +728,47 @@ namespace
 
         if(tiles_count <= data.free_tiles_count)
         {
-            auto free_items_end = data.free_items.end();
-            auto free_items_it = lower_bound(data.free_items.begin(), free_items_end, tiles_count,
-                                             lower_bound_comparator);
-
-            if(free_items_it != free_items_end)
+            if(int id = _find_best_bins_item(unsigned(tiles_count), data.free_bins))
             {
-                int id = *free_items_it;
+                _erase_free_item(id);
 
                 if(optional<int> new_free_item_id = _create_item(
                             id, nullptr, compression_type::NONE, tiles_count, false))
                 {
-                    _insert_free_item(*new_free_item_id, free_items_it);
-                    ++free_items_it;
+                    _insert_free_item(*new_free_item_id);
                 }
 
-                data.free_items.erase(free_items_it);
                 return id;
             }
         }
 
         return -1;
     }
+
+    void _commit_relocations()
+    {
+        for(const relocation_type& relocation : data.relocations)
+        {
+            item_type& item = data.items.item(relocation.id);
+
+            if(item.status() == status_type::USED)
+            {
+                if(item.data)
+                {
+                    item.commit = false;
+                    hw::sprite_tiles::commit(item.data, item.compression(), int(item.start_tile),
+                                             int(item.tiles_count));
+                }
+                else
+                {
+                    hw::sprite_tiles::move_tiles(int(relocation.old_start_tile), int(item.tiles_count),
+                                                 int(item.start_tile));
+                }
+            }
+        }
+
+        data.relocations.clear();
+    }
 }
 
 void init()
@@ -648,7 +779,7 @@ void init()
     new_item.tiles_count = hw::sprite_tiles::tiles_count();
     data.items.init();
     data.items.push_front(new_item);
-    data.free_items.push_back(data.items.begin().id());
+    _insert_free_item(data.items.begin().id());
     data.free_tiles_count = int(new_item.tiles_count);
 
     BN_SPRITE_TILES_LOG_STATUS();
@@ -664,6 +795,30 @@ int available_tiles_count()
     return data.free_tiles_count;
 }
 
+int largest_available_tiles_count()
+{
+    int result = 0;
+
+    for(int bin_index = bins_count - 1; bin_index >= 0; --bin_index)
+    {
+        if(data.free_bins.non_empty_bins & (1U << bin_index))
+        {
+            int item_index = data.free_bins.first_indexes[bin_index];
+
+            while(item_index)
+            {
+                const item_type& item = data.items.item(item_index);
+                result = max(result, int(item.tiles_count));
+                item_index = item.bin_next_index;
+            }
+
+            break;
+        }
+    }
+
+    return result;
+}
+
 int used_items_count()
 {
     return data.items.size();
@@ -1032,8 +1187,10 @@ void update()
         auto begin = data.items.begin();
         auto end = data.items.end();
 
-        for(int to_remove_item_index : data.to_remove_items)
+        while(int to_remove_item_index = _first_bins_item(data.to_remove_bins))
         {
+            _erase_to_remove_item(to_remove_item_index);
+
             auto iterator = data.items.it(to_remove_item_index);
             item_type& item = *iterator;
 
@@ -1083,30 +1240,108 @@ void update()
             _insert_free_item(to_remove_item_index);
         }
 
-        data.to_remove_items.clear();
         data.to_remove_tiles_count = 0;
 
         BN_SPRITE_TILES_LOG_STATUS();
     }
 }
 
-void commit()
+void defragment()
+{
+    BN_SPRITE_TILES_LOG("sprite_tiles_manager - DEFRAGMENT");
+
+    if(! data.relocations.empty())
+    {
+        BN_SPRITE_TILES_LOG("PENDING RELOCATIONS");
+        return;
+    }
+
+    update();
+
+    auto iterator = data.items.begin();
+    auto end = data.items.end();
+    int next_start_tile = 0;
+
+    while(iterator != end)
+    {
+        item_type& item = *iterator;
+        int id = iterator.id();
+
+        if(item.status() == status_type::FREE)
+        {
+            _erase_free_item(id);
+            iterator = data.items.erase(id);
+        }
+        else
+        {
+            if(int(item.start_tile) != next_start_tile)
+            {
+                data.relocations.push_back({ uint16_t(id), uint16_t(item.start_tile) });
+                item.start_tile = unsigned(next_start_tile);
+            }
+
+            next_start_tile += int(item.tiles_count);
+            ++iterator;
+        }
+    }
+
+    if(int free_tiles_count = data.free_tiles_count)
+    {
+        item_type new_item;
+        new_item.start_tile = unsigned(next_start_tile);
+        new_item.tiles_count = unsigned(free_tiles_count);
+        _insert_free_item(data.items.insert(end.id(), new_item).id());
+    }
+
+    if(! data.relocations.empty())
+    {
+        // Relocated tiles are copied in the next commit, so new tiles can't be uploaded before it:
+        data.check_commit = true;
+        data.delay_commit = true;
+    }
+
+    BN_SPRITE_TILES_LOG_STATUS();
+}
+
+int commit(int max_ticks)
 {
+    int deferred_bytes = 0;
+
+    if(! data.relocations.empty())
+    {
+        _commit_relocations();
+    }
+
     if(data.check_commit)
     {
         BN_SPRITE_TILES_LOG("sprite_tiles_manager - COMMIT");
 
+        timer commit_timer;
+        bool item_committed = false;
         data.check_commit = false;
 
         for(item_type& item : data.items)
         {
             if(item.commit)
             {
-                item.commit = false;
-
                 if(item.status() == status_type::USED)
                 {
-                    hw::sprite_tiles::commit(item.data, item.compression(), int(item.start_tile), int(item.tiles_count));
+                    // At least one item is committed in each frame, so deferred items are committed eventually:
+                    if(! item_committed || commit_timer.elapsed_ticks() < max_ticks)
+                    {
+                        item.commit = false;
+                        item_committed = true;
+                        hw::sprite_tiles::commit(item.data, item.compression(), int(item.start_tile), int(item.tiles_count));
+                    }
+                    else
+                    {
+                        deferred_bytes += int(item.tiles_count) * int(sizeof(tile));
+                        data.check_commit = true;
+                    }
+                }
+                else
+                {
+                    item.commit = false;
                 }
             }
         }
@@ -1115,6 +1350,7 @@ void commit()
     }
 
     data.delay_commit = false;
+    return deferred_bytes;
 }
 
 }
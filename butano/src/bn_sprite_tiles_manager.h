@@ -25,6 +25,8 @@ namespace bn::sprite_tiles_manager
 
     [[nodiscard]] int available_tiles_count();
 
+    [[nodiscard]] int largest_available_tiles_count();
+
     [[nodiscard]] int used_items_count();
 
     [[nodiscard]] int available_items_count();
@@ -67,7 +69,9 @@ namespace bn::sprite_tiles_manager
 
     void update();
 
-    void commit();
+    void defragment();
+
+    [[nodiscard]] int commit(int max_ticks);
 }
 
 #endif
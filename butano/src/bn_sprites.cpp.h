@@ -5,6 +5,7 @@
 
 #include "bn_sprites.h"
 
+#include "bn_optional.h"
 #include "bn_sprites_manager.h"
 
 namespace bn::sprites
@@ -20,6 +21,21 @@ int available_items_count()
     return sprites_manager::available_items_count();
 }
 
+bool multiplexing_active()
+{
+    return sprites_manager::multiplexing_active();
+}
+
+int multiplexing_dropped_items_count()
+{
+    return sprites_manager::multiplexing_dropped_items_count();
+}
+
+optional<int> multiplexing_overloaded_scanline()
+{
+    return sprites_manager::multiplexing_overloaded_scanline();
+}
+
 void reload()
 {
     sprites_manager::reload_all();
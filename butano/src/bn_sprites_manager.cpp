@@ -6,14 +6,18 @@
 #include "bn_sprites_manager.h"
 
 #include "bn_vector.h"
+#include "bn_config_cameras.h"
+#include "bn_cameras_manager.h"
 #include "bn_sprite_first_attributes.h"
 #include "bn_sprite_regular_second_attributes.h"
 #include "bn_sorted_sprites.h"
+#include "bn_sprites_multiplexer.h"
 #include "../hw/include/bn_hw_sprite_affine_mats_constants.h"
 
 #include "bn_sprites.cpp.h"
 #include "bn_sprite_ptr.cpp.h"
 #include "bn_sprite_item.cpp.h"
+#include "bn_sprite_batch.cpp.h"
 #include "bn_sprite_builder.cpp.h"
 #include "bn_sprite_third_attributes.cpp.h"
 #include "bn_sprite_affine_second_attributes.cpp.h"
@@ -23,7 +27,15 @@ namespace bn::sprites_manager
 
 namespace
 {
-    static_assert(BN_CFG_SPRITES_MAX_ITEMS > 0);
+    static_assert(BN_CFG_SPRITES_MAX_ITEMS > 0 && BN_CFG_SPRITES_MAX_ITEMS <= numeric_limits<int16_t>::max());
+
+    constexpr const int commit_blocks_count = hw::sprites::count() / commit_block_size();
+    constexpr const unsigned all_blocks_to_commit = (1U << commit_blocks_count) - 1;
+    constexpr const int affine_mats_per_commit_block =
+            commit_block_size() / (hw::sprites::count() / hw::sprite_affine_mats::count());
+
+    static_assert(commit_blocks_count <= 32);
+    static_assert(affine_mats_per_commit_block > 0);
 
     using item_type = sprites_manager_item;
     using sorted_items_type = vector<item_type*, BN_CFG_SPRITES_MAX_ITEMS>;
@@ -33,10 +45,16 @@ namespace
 
     public:
         pool<item_type, BN_CFG_SPRITES_MAX_ITEMS> items_pool;
+        vector<int16_t, BN_CFG_SPRITES_MAX_ITEMS> free_item_indexes;
         hw::sprites::handle_type handles[hw::sprites::count()];
         sorted_sprites::sorter sorter;
-        int first_index_to_commit = 0;
-        int last_index_to_commit = hw::sprites::count() - 1;
+
+        #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+            sprites_multiplexer::context multiplexer;
+        #endif
+
+        unsigned blocks_to_commit = all_blocks_to_commit;
+        int hot_items_count = 0;
         int last_visible_items_count = 0;
         bool check_items_on_screen = false;
         bool rebuild_handles = false;
@@ -44,37 +62,73 @@ namespace
 
     BN_DATA_EWRAM static_data data;
 
-    void _update_indexes_to_commit(const item_type& item)
+    // Hot items data is placed in IWRAM:
+    sprites_manager_hot_items hot_items;
+
+    [[nodiscard]] hw::sprites::handle_type& _handle(const item_type& item)
     {
-        int handles_index = item.handles_index;
+        return hot_items.handles[item.index];
+    }
 
-        if(handles_index != -1)
-        {
-            hw::sprites::copy_handle(item.handle, data.handles[handles_index]);
+    [[nodiscard]] int _create_item_index()
+    {
+        int item_index = data.free_item_indexes.back();
+        data.free_item_indexes.pop_back();
+        data.hot_items_count = max(data.hot_items_count, item_index + 1);
+        return item_index;
+    }
 
-            if(handles_index < data.first_index_to_commit)
-            {
-                data.first_index_to_commit = handles_index;
-            }
+    void _destroy_item_index(int item_index)
+    {
+        hot_items.camera_ids[item_index] = -1;
+        hot_items.visible[item_index] = false;
+        hot_items.on_screen[item_index] = false;
+        hot_items.check_on_screen[item_index] = false;
+        data.free_item_indexes.push_back(int16_t(item_index));
+    }
 
-            if(handles_index > data.last_index_to_commit)
-            {
-                data.last_index_to_commit = handles_index;
-            }
+    void _check_item_on_screen(const item_type& item)
+    {
+        int item_index = item.index;
+
+        if(hot_items.visible[item_index])
+        {
+            hot_items.check_on_screen[item_index] = true;
+            data.check_items_on_screen = true;
         }
     }
 
-    void _update_item_dimensions(item_type& item)
+    void _update_indexes_to_commit(int item_index)
     {
-        item.update_half_dimensions();
+        int handles_index = hot_items.handles_indexes[item_index];
 
-        if(item.visible)
+        if(handles_index != -1)
         {
-            item.check_on_screen = true;
-            data.check_items_on_screen = true;
+            hw::sprites::copy_handle(hot_items.handles[item_index], data.handles[handles_index]);
+            data.blocks_to_commit |= 1U << (handles_index / commit_block_size());
         }
     }
 
+    void _update_indexes_to_commit(const item_type& item)
+    {
+        _update_indexes_to_commit(item.index);
+    }
+
+    void _hide_item(int item_index)
+    {
+        hot_items.visible[item_index] = false;
+        hot_items.on_screen[item_index] = false;
+        hot_items.check_on_screen[item_index] = false;
+        hw::sprites::hide(hot_items.handles[item_index]);
+        _update_indexes_to_commit(item_index);
+    }
+
+    void _update_item_dimensions(item_type& item)
+    {
+        item.update_half_dimensions(hot_items);
+        _check_item_on_screen(item);
+    }
+
     void _assign_affine_mat(item_type& item, sprite_affine_mat_ptr&& affine_mat)
     {
         if(item.affine_mat)
@@ -86,13 +140,16 @@ namespace
         item.affine_mat = move(affine_mat);
         sprite_affine_mats_manager::attach_sprite(affine_mat_id, item.affine_mat_attach_node);
 
-        bool new_double_size = item.new_double_size();
-        hw::sprites::set_affine_mat(affine_mat_id, item.handle);
-        hw::sprites::show_affine(new_double_size, item.handle);
+        int item_index = item.index;
+        hw::sprites::handle_type& handle = hot_items.handles[item_index];
+        bool new_double_size = item.new_double_size(hot_items);
+        hot_items.affine[item_index] = true;
+        hw::sprites::set_affine_mat(affine_mat_id, handle);
+        hw::sprites::show_affine(new_double_size, handle);
 
-        if(item.double_size != new_double_size)
+        if(hot_items.double_size[item_index] != new_double_size)
         {
-            item.double_size = new_double_size;
+            hot_items.double_size[item_index] = new_double_size;
             _update_item_dimensions(item);
         }
         else
@@ -103,16 +160,19 @@ namespace
 
     void _remove_affine_mat(item_type& item)
     {
+        int item_index = item.index;
+        hw::sprites::handle_type& handle = hot_items.handles[item_index];
         sprite_affine_mat_ptr& affine_mat = *item.affine_mat;
-        hw::sprites::set_horizontal_flip(affine_mat.horizontal_flip(), item.handle);
-        hw::sprites::set_vertical_flip(affine_mat.vertical_flip(), item.handle);
-        hw::sprites::show_regular(item.handle);
+        hw::sprites::set_horizontal_flip(affine_mat.horizontal_flip(), handle);
+        hw::sprites::set_vertical_flip(affine_mat.vertical_flip(), handle);
+        hw::sprites::show_regular(handle);
         sprite_affine_mats_manager::dettach_sprite(affine_mat.id(), item.affine_mat_attach_node);
         item.affine_mat.reset();
+        hot_items.affine[item_index] = false;
 
-        if(item.double_size)
+        if(hot_items.double_size[item_index])
         {
-            item.double_size = false;
+            hot_items.double_size[item_index] = false;
             _update_item_dimensions(item);
         }
         else
@@ -127,15 +187,22 @@ namespace
         {
             hw::sprites::handle_type* handles = data.handles;
             int last_visible_items_count = data.last_visible_items_count;
-            int visible_items_count = _rebuild_handles_impl(last_visible_items_count, handles, data.sorter.layers());
+            #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+                int visible_items_count = _rebuild_multiplexed_handles_impl(
+                        last_visible_items_count, handles, hot_items, data.sorter.layers(), data.multiplexer);
+            #else
+                int visible_items_count = _rebuild_handles_impl(
+                        last_visible_items_count, handles, hot_items, data.sorter.layers());
+            #endif
+
             int to_commit_items_count = max(visible_items_count, last_visible_items_count);
             data.rebuild_handles = false;
             data.last_visible_items_count = visible_items_count;
 
             if(to_commit_items_count)
             {
-                data.first_index_to_commit = 0;
-                data.last_index_to_commit = to_commit_items_count - 1;
+                int last_block = (to_commit_items_count - 1) / commit_block_size();
+                data.blocks_to_commit |= (2U << last_block) - 1;
             }
         }
     }
@@ -146,8 +213,8 @@ namespace
         {
             data.check_items_on_screen = false;
 
-            if(_check_items_on_screen_impl(data.handles, data.sorter.layers(), data.rebuild_handles,
-                                           data.first_index_to_commit, data.last_index_to_commit))
+            if(_check_items_on_screen_impl(data.handles, hot_items, data.hot_items_count, data.rebuild_handles,
+                                           data.blocks_to_commit))
             {
                 data.rebuild_handles = true;
             }
@@ -157,12 +224,24 @@ namespace
 
 void init()
 {
+    for(int index = BN_CFG_SPRITES_MAX_ITEMS - 1; index >= 0; --index)
+    {
+        data.free_item_indexes.push_back(int16_t(index));
+    }
+
     for(hw::sprites::handle_type& handle : data.handles)
     {
         hw::sprites::hide_and_destroy(handle);
     }
 
     sprite_affine_mats_manager::init(data.handles);
+
+    #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+        static_assert(BN_CFG_SPRITES_MAX_ITEMS > hw::sprites::count(),
+                      "Sprites multiplexing requires more than 128 sprite items");
+
+        hw::sprites_multiplexer::init();
+    #endif
 }
 
 int used_items_count()
@@ -180,7 +259,8 @@ id_type create(const fixed_point& position, const sprite_shape_size& shape_size,
 {
     BN_ASSERT(! data.items_pool.full(), "No more sprite items available");
 
-    item_type& new_item = data.items_pool.create(position, shape_size, move(tiles), move(palette));
+    item_type& new_item = data.items_pool.create(_create_item_index(), hot_items, position, shape_size,
+                                                     move(tiles), move(palette));
     data.sorter.insert(new_item);
     data.check_items_on_screen = true;
     data.rebuild_handles = true;
@@ -195,7 +275,8 @@ id_type create_optional(const fixed_point& position, const sprite_shape_size& sh
         return nullptr;
     }
 
-    item_type& new_item = data.items_pool.create(position, shape_size, move(tiles), move(palette));
+    item_type& new_item = data.items_pool.create(_create_item_index(), hot_items, position, shape_size,
+                                                     move(tiles), move(palette));
     data.sorter.insert(new_item);
     data.check_items_on_screen = true;
     data.rebuild_handles = true;
@@ -208,10 +289,11 @@ id_type create(sprite_builder&& builder)
 
     sprite_tiles_ptr tiles = builder.release_tiles();
     sprite_palette_ptr palette = builder.release_palette();
-    item_type& new_item = data.items_pool.create(move(builder), move(tiles), move(palette));
+    item_type& new_item = data.items_pool.create(_create_item_index(), hot_items, move(builder), move(tiles),
+                                                     move(palette));
     data.sorter.insert(new_item);
 
-    if(new_item.visible)
+    if(hot_items.visible[new_item.index])
     {
         data.check_items_on_screen = true;
         data.rebuild_handles = true;
@@ -241,10 +323,11 @@ id_type create_optional(sprite_builder&& builder)
         return nullptr;
     }
 
-    item_type& new_item = data.items_pool.create(move(builder), move(*tiles), move(*palette));
+    item_type& new_item = data.items_pool.create(_create_item_index(), hot_items, move(builder), move(*tiles),
+                                                     move(*palette));
     data.sorter.insert(new_item);
 
-    if(new_item.visible)
+    if(hot_items.visible[new_item.index])
     {
         data.check_items_on_screen = true;
         data.rebuild_handles = true;
@@ -273,12 +356,15 @@ void decrease_usages(id_type id)
             sprite_affine_mats_manager::dettach_sprite(item->affine_mat->id(), item->affine_mat_attach_node);
         }
 
-        if(item->visible)
+        int item_index = item->index;
+
+        if(hot_items.visible[item_index])
         {
-            hw::sprites::hide_and_destroy(item->handle);
+            hw::sprites::hide_and_destroy(hot_items.handles[item_index]);
             _update_indexes_to_commit(*item);
         }
 
+        _destroy_item_index(item_index);
         data.items_pool.destroy(*item);
     }
 }
@@ -286,7 +372,7 @@ void decrease_usages(id_type id)
 optional<int> hw_id(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    int handles_index = item->handles_index;
+    int handles_index = hot_items.handles_indexes[item->index];
     optional<int> result;
 
     if(handles_index >= 0)
@@ -300,25 +386,26 @@ optional<int> hw_id(id_type id)
 sprite_shape shape(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return hw::sprites::shape(item->handle);
+    return hw::sprites::shape(_handle(*item));
 }
 
 sprite_size size(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return hw::sprites::size(item->handle);
+    return hw::sprites::size(_handle(*item));
 }
 
 sprite_shape_size shape_size(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return hw::sprites::shape_size(item->handle);
+    return hw::sprites::shape_size(_handle(*item));
 }
 
 bn::size dimensions(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return bn::size(item->half_width * 2, item->half_height * 2);
+    int item_index = item->index;
+    return bn::size(hot_items.half_widths[item_index] * 2, hot_items.half_heights[item_index] * 2);
 }
 
 const sprite_tiles_ptr& tiles(id_type id)
@@ -333,7 +420,7 @@ void set_tiles(id_type id, const sprite_tiles_ptr& tiles)
 
     if(tiles != item->tiles)
     {
-        hw::sprites::handle_type& handle = item->handle;
+        hw::sprites::handle_type& handle = _handle(*item);
         BN_ASSERT(tiles.tiles_count() == hw::sprites::shape_size(handle).tiles_count(item->palette->bpp()),
                   "Invalid tiles count: ", tiles.tiles_count(), " - ",
                   hw::sprites::shape_size(handle).tiles_count(item->palette->bpp()));
@@ -350,7 +437,7 @@ void set_tiles(id_type id, sprite_tiles_ptr&& tiles)
 
     if(tiles != item->tiles)
     {
-        hw::sprites::handle_type& handle = item->handle;
+        hw::sprites::handle_type& handle = _handle(*item);
         BN_ASSERT(tiles.tiles_count() == hw::sprites::shape_size(handle).tiles_count(item->palette->bpp()),
                   "Invalid tiles count: ", tiles.tiles_count(), " - ",
                   hw::sprites::shape_size(handle).tiles_count(item->palette->bpp()));
@@ -371,7 +458,7 @@ void set_tiles(id_type id, const sprite_shape_size& shape_size, const sprite_til
                   "Invalid tiles or shape size: ", tiles.tiles_count(), " - ",
                   shape_size.tiles_count(item->palette->bpp()));
 
-        hw::sprites::handle_type& handle = item->handle;
+        hw::sprites::handle_type& handle = _handle(*item);
         hw::sprites::set_tiles(tiles.id(), handle);
         item->tiles = tiles;
 
@@ -408,7 +495,7 @@ void set_tiles(id_type id, const sprite_shape_size& shape_size, sprite_tiles_ptr
                   "Invalid tiles or shape size: ", tiles.tiles_count(), " - ",
                   shape_size.tiles_count(item->palette->bpp()));
 
-        hw::sprites::handle_type& handle = item->handle;
+        hw::sprites::handle_type& handle = _handle(*item);
         hw::sprites::set_tiles(tiles.id(), handle);
         item->tiles = move(tiles);
 
@@ -443,7 +530,7 @@ void set_palette(id_type id, [[maybe_unused]] bpp_mode old_bpp, const sprite_pal
     {
         BN_ASSERT(old_bpp == palette.bpp(), "Palette BPP mode mismatch: ", int(old_bpp), " - ", int(palette.bpp()));
 
-        hw::sprites::set_palette(palette.id(), item->handle);
+        hw::sprites::set_palette(palette.id(), _handle(*item));
         item->palette = palette;
         _update_indexes_to_commit(*item);
     }
@@ -457,7 +544,7 @@ void set_palette(id_type id, [[maybe_unused]] bpp_mode old_bpp, sprite_palette_p
     {
         BN_ASSERT(old_bpp == palette.bpp(), "Palette BPP mode mismatch: ", int(old_bpp), " - ", int(palette.bpp()));
 
-        hw::sprites::set_palette(palette.id(), item->handle);
+        hw::sprites::set_palette(palette.id(), _handle(*item));
         item->palette = move(palette);
         _update_indexes_to_commit(*item);
     }
@@ -473,7 +560,7 @@ void set_tiles_and_palette(id_type id, const sprite_shape_size& shape_size, spri
                            sprite_palette_ptr&& palette)
 {
     auto item = static_cast<item_type*>(id);
-    hw::sprites::handle_type& handle = item->handle;
+    hw::sprites::handle_type& handle = _handle(*item);
     bool different_shape_size = shape_size != hw::sprites::shape_size(handle);
     bool different_tiles = tiles != item->tiles;
     bool different_palette = palette != item->palette;
@@ -523,7 +610,7 @@ const fixed_point& position(id_type id)
 const point& hw_position(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return item->hw_position;
+    return hot_items.hw_positions[item->index];
 }
 
 void set_x(id_type id, fixed x)
@@ -538,15 +625,13 @@ void set_x(id_type id, fixed x)
 
     if(diff)
     {
-        int hw_x = item->hw_position.x() + diff;
-        item->hw_position.set_x(hw_x);
-        hw::sprites::set_x(hw_x, item->handle);
-
-        if(item->visible)
-        {
-            item->check_on_screen = true;
-            data.check_items_on_screen = true;
-        }
+        int item_index = item->index;
+        point& hw_position = hot_items.hw_positions[item_index];
+        int hw_x = hw_position.x() + diff;
+        hot_items.positions[item_index].set_x(new_integer_x);
+        hw_position.set_x(hw_x);
+        hw::sprites::set_x(hw_x, hot_items.handles[item_index]);
+        _check_item_on_screen(*item);
     }
 }
 
@@ -562,15 +647,13 @@ void set_y(id_type id, fixed y)
 
     if(diff)
     {
-        int hw_y = item->hw_position.y() + diff;
-        item->hw_position.set_y(hw_y);
-        hw::sprites::set_y(hw_y, item->handle);
-
-        if(item->visible)
-        {
-            item->check_on_screen = true;
-            data.check_items_on_screen = true;
-        }
+        int item_index = item->index;
+        point& hw_position = hot_items.hw_positions[item_index];
+        int hw_y = hw_position.y() + diff;
+        hot_items.positions[item_index].set_y(new_integer_y);
+        hw_position.set_y(hw_y);
+        hw::sprites::set_y(hw_y, hot_items.handles[item_index]);
+        _check_item_on_screen(*item);
     }
 }
 
@@ -586,18 +669,15 @@ void set_position(id_type id, const fixed_point& position)
 
     if(diff != point())
     {
-        point hw_position = item->hw_position + diff;
-        item->hw_position = hw_position;
+        int item_index = item->index;
+        point hw_position = hot_items.hw_positions[item_index] + diff;
+        hot_items.positions[item_index] = new_integer_position;
+        hot_items.hw_positions[item_index] = hw_position;
 
-        hw::sprites::handle_type& handle = item->handle;
+        hw::sprites::handle_type& handle = hot_items.handles[item_index];
         hw::sprites::set_x(hw_position.x(), handle);
         hw::sprites::set_y(hw_position.y(), handle);
-
-        if(item->visible)
-        {
-            item->check_on_screen = true;
-            data.check_items_on_screen = true;
-        }
+        _check_item_on_screen(*item);
     }
 }
 
@@ -616,7 +696,7 @@ void set_bg_priority(id_type id, int bg_priority)
         BN_ASSERT(bg_priority >= 0 && bg_priority <= sprites::max_bg_priority(),
                   "Invalid BG priority: ", bg_priority);
 
-        hw::sprites::set_bg_priority(bg_priority, item->handle);
+        hw::sprites::set_bg_priority(bg_priority, _handle(*item));
         data.sorter.erase(*item);
         item->set_bg_priority(bg_priority);
         data.sorter.insert(*item);
@@ -675,7 +755,7 @@ bool horizontal_flip(id_type id)
         return item->affine_mat->horizontal_flip();
     }
 
-    return hw::sprites::horizontal_flip(item->handle);
+    return hw::sprites::horizontal_flip(_handle(*item));
 }
 
 void set_horizontal_flip(id_type id, bool horizontal_flip)
@@ -688,7 +768,7 @@ void set_horizontal_flip(id_type id, bool horizontal_flip)
     }
     else
     {
-        hw::sprites::handle_type& handle = item->handle;
+        hw::sprites::handle_type& handle = _handle(*item);
 
         if(horizontal_flip != hw::sprites::horizontal_flip(handle))
         {
@@ -707,7 +787,7 @@ bool vertical_flip(id_type id)
         return item->affine_mat->vertical_flip();
     }
 
-    return hw::sprites::vertical_flip(item->handle);
+    return hw::sprites::vertical_flip(_handle(*item));
 }
 
 void set_vertical_flip(id_type id, bool vertical_flip)
@@ -720,7 +800,7 @@ void set_vertical_flip(id_type id, bool vertical_flip)
     }
     else
     {
-        hw::sprites::handle_type& handle = item->handle;
+        hw::sprites::handle_type& handle = _handle(*item);
 
         if(vertical_flip != hw::sprites::vertical_flip(handle))
         {
@@ -733,13 +813,13 @@ void set_vertical_flip(id_type id, bool vertical_flip)
 bool mosaic_enabled(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return hw::sprites::mosaic_enabled(item->handle);
+    return hw::sprites::mosaic_enabled(_handle(*item));
 }
 
 void set_mosaic_enabled(id_type id, bool mosaic_enabled)
 {
     auto item = static_cast<item_type*>(id);
-    hw::sprites::handle_type& handle = item->handle;
+    hw::sprites::handle_type& handle = _handle(*item);
 
     if(mosaic_enabled != hw::sprites::mosaic_enabled(handle))
     {
@@ -760,7 +840,7 @@ void set_blending_enabled(id_type id, bool blending_enabled)
 
     if(blending_enabled != item->blending_enabled)
     {
-        hw::sprites::handle_type& handle = item->handle;
+        hw::sprites::handle_type& handle = _handle(*item);
         BN_ASSERT(! blending_enabled || ! hw::sprites::window_enabled(handle),
                   "Blending and window can't be enabled at the same time");
 
@@ -773,13 +853,13 @@ void set_blending_enabled(id_type id, bool blending_enabled)
 bool window_enabled(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return hw::sprites::window_enabled(item->handle);
+    return hw::sprites::window_enabled(_handle(*item));
 }
 
 void set_window_enabled(id_type id, bool window_enabled)
 {
     auto item = static_cast<item_type*>(id);
-    hw::sprites::handle_type& handle = item->handle;
+    hw::sprites::handle_type& handle = _handle(*item);
 
     if(window_enabled != hw::sprites::window_enabled(handle))
     {
@@ -794,13 +874,13 @@ void set_window_enabled(id_type id, bool window_enabled)
 int view_mode(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return hw::sprites::view_mode(item->handle);
+    return hw::sprites::view_mode(_handle(*item));
 }
 
 bool double_size(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return item->double_size;
+    return hot_items.double_size[item->index];
 }
 
 sprite_double_size_mode double_size_mode(id_type id)
@@ -827,28 +907,26 @@ void set_double_size_mode(id_type id, sprite_double_size_mode double_size_mode)
 bool visible(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    return item->visible;
+    return hot_items.visible[item->index];
 }
 
 void set_visible(id_type id, bool visible)
 {
     auto item = static_cast<item_type*>(id);
 
-    if(visible != item->visible)
-    {
-        item->visible = visible;
+    int item_index = item->index;
 
+    if(visible != hot_items.visible[item_index])
+    {
         if(visible)
         {
-            item->check_on_screen = true;
+            hot_items.visible[item_index] = true;
+            hot_items.check_on_screen[item_index] = true;
             data.check_items_on_screen = true;
         }
         else
         {
-            hw::sprites::hide(item->handle);
-            item->on_screen = false;
-            item->check_on_screen = false;
-            _update_indexes_to_commit(*item);
+            _hide_item(item_index);
         }
     }
 }
@@ -866,13 +944,8 @@ void set_camera(id_type id, camera_ptr&& camera)
     if(camera != item->camera)
     {
         item->camera = move(camera);
-        item->update_hw_position();
-
-        if(item->visible)
-        {
-            item->check_on_screen = true;
-            data.check_items_on_screen = true;
-        }
+        item->update_camera(hot_items);
+        _check_item_on_screen(*item);
     }
 }
 
@@ -883,13 +956,8 @@ void remove_camera(id_type id)
     if(item->camera)
     {
         item->camera.reset();
-        item->update_hw_position();
-
-        if(item->visible)
-        {
-            item->check_on_screen = true;
-            data.check_items_on_screen = true;
-        }
+        item->update_camera(hot_items);
+        _check_item_on_screen(*item);
     }
 }
 
@@ -944,9 +1012,9 @@ void set_remove_affine_mat_when_not_needed(id_type id, bool remove_when_not_need
 sprite_first_attributes first_attributes(id_type id)
 {
     auto item = static_cast<const item_type*>(id);
-    const hw::sprites::handle_type& handle = item->handle;
+    const hw::sprites::handle_type& handle = _handle(*item);
     return sprite_first_attributes(item->position.y(), hw::sprites::mosaic_enabled(handle), item->blending_enabled,
-                                   hw::sprites::window_enabled(handle), item->visible);
+                                   hw::sprites::window_enabled(handle), hot_items.visible[item->index]);
 }
 
 void set_first_attributes(id_type id, const sprite_first_attributes& first_attributes)
@@ -963,7 +1031,7 @@ sprite_regular_second_attributes regular_second_attributes(id_type id)
     auto item = static_cast<const item_type*>(id);
     BN_ASSERT(! item->affine_mat, "Item is not regular");
 
-    const hw::sprites::handle_type& handle = item->handle;
+    const hw::sprites::handle_type& handle = _handle(*item);
     return sprite_regular_second_attributes(item->position.x(), hw::sprites::horizontal_flip(handle),
                                             hw::sprites::vertical_flip(handle));
 }
@@ -1024,12 +1092,27 @@ void reload_blending()
     {
         for(item_type& item : layer.items())
         {
-            hw::sprites::set_blending_enabled(item.blending_enabled, fade_enabled, item.handle);
+            hw::sprites::set_blending_enabled(item.blending_enabled, fade_enabled, _handle(item));
             _update_indexes_to_commit(item);
         }
     }
 }
 
+void reload_tiles()
+{
+    for(sorted_sprites::layer& layer : data.sorter.layers())
+    {
+        for(item_type& item : layer.items())
+        {
+            if(const optional<sprite_tiles_ptr>& tiles = item.tiles)
+            {
+                hw::sprites::set_tiles(tiles->id(), _handle(item));
+                _update_indexes_to_commit(item);
+            }
+        }
+    }
+}
+
 void reload_all()
 {
     data.last_visible_items_count = hw::sprites::count();
@@ -1039,7 +1122,7 @@ void reload_all()
 void fill_hblank_effect_horizontal_positions(id_type id, int hw_x, const fixed* positions_ptr, uint16_t* dest_ptr)
 {
     auto item = static_cast<item_type*>(id);
-    uint16_t attr1 = item->handle.attr1;
+    uint16_t attr1 = _handle(*item).attr1;
 
     if(hw_x == 0)
     {
@@ -1064,7 +1147,7 @@ void fill_hblank_effect_horizontal_positions(id_type id, int hw_x, const fixed*
 void fill_hblank_effect_vertical_positions(id_type id, int hw_y, const fixed* positions_ptr, uint16_t* dest_ptr)
 {
     auto item = static_cast<item_type*>(id);
-    uint16_t attr0 = item->handle.attr0;
+    uint16_t attr0 = _handle(*item).attr0;
 
     if(hw_y == 0)
     {
@@ -1199,7 +1282,48 @@ void fill_hblank_effect_third_attributes([[maybe_unused]] sprite_shape_size shap
 
 void update_cameras()
 {
-    data.check_items_on_screen |= _update_cameras_impl(data.sorter.layers());
+    point camera_positions[BN_CFG_CAMERA_MAX_ITEMS];
+
+    for(int index = 0; index < BN_CFG_CAMERA_MAX_ITEMS; ++index)
+    {
+        const fixed_point& camera_position = cameras_manager::position(index);
+        camera_positions[index] = point(camera_position.x().right_shift_integer(),
+                                        camera_position.y().right_shift_integer());
+    }
+
+    data.check_items_on_screen |= _update_cameras_impl(hot_items, data.hot_items_count, camera_positions);
+}
+
+int item_index(id_type id)
+{
+    auto item = static_cast<const item_type*>(id);
+    return item->index;
+}
+
+void set_batch_positions(const int16_t* item_indexes, const fixed_point* positions, int positions_count,
+                         int last_positions_count)
+{
+    // Only per frame data is updated, since batch sprites are not exposed with sprite_ptr getters:
+    if(positions_count)
+    {
+        // Batch sprites share the same camera:
+        point camera_position;
+
+        if(int camera_id = hot_items.camera_ids[item_indexes[0]]; camera_id >= 0)
+        {
+            const fixed_point& camera_fixed_position = cameras_manager::position(camera_id);
+            camera_position = point(camera_fixed_position.x().right_shift_integer(),
+                                    camera_fixed_position.y().right_shift_integer());
+        }
+
+        data.check_items_on_screen |= _set_batch_positions_impl(
+                    hot_items, item_indexes, positions, positions_count, camera_position);
+    }
+
+    for(int index = positions_count; index < last_positions_count; ++index)
+    {
+        _hide_item(item_indexes[index]);
+    }
 }
 
 void remove_identity_affine_mat_if_not_needed(id_type id)
@@ -1215,18 +1339,59 @@ void remove_identity_affine_mat_if_not_needed(id_type id)
 void update_affine_mat_double_size(id_type id)
 {
     auto item = static_cast<item_type*>(id);
-    bool new_double_size = item->new_double_size();
+    int item_index = item->index;
+    bool new_double_size = item->new_double_size(hot_items);
 
-    if(item->double_size != new_double_size)
+    if(hot_items.double_size[item_index] != new_double_size)
     {
-        item->double_size = new_double_size;
-        hw::sprites::show_affine(new_double_size, item->handle);
+        hot_items.double_size[item_index] = new_double_size;
+        hw::sprites::show_affine(new_double_size, hot_items.handles[item_index]);
         _update_item_dimensions(*item);
     }
 }
 
+bool multiplexing_active()
+{
+    #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+        return data.multiplexer.active;
+    #else
+        return false;
+    #endif
+}
+
+int multiplexing_dropped_items_count()
+{
+    #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+        return data.multiplexer.dropped_items_count;
+    #else
+        return 0;
+    #endif
+}
+
+optional<int> multiplexing_overloaded_scanline()
+{
+    optional<int> result;
+
+    #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+        if(int overloaded_scanline = data.multiplexer.overloaded_scanline; overloaded_scanline >= 0)
+        {
+            result = overloaded_scanline;
+        }
+    #endif
+
+    return result;
+}
+
 void update()
 {
+    #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+        if(data.multiplexer.active)
+        {
+            // Multiplexed sprites don't have a fixed OAM entry, so they must be scheduled again each frame:
+            data.rebuild_handles = true;
+        }
+    #endif
+
     sprite_affine_mats_manager::update();
     _check_items_on_screen();
     _rebuild_handles();
@@ -1234,25 +1399,67 @@ void update()
 
 void commit()
 {
-    int first_index_to_commit = data.first_index_to_commit;
-    int last_index_to_commit = data.last_index_to_commit;
+    unsigned blocks_to_commit = data.blocks_to_commit;
+
+    #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+        // OAM entries rewritten in the last frame must be restored:
+        sprites_multiplexer::context& multiplexer = data.multiplexer;
+        blocks_to_commit |= multiplexer.front_multiplexed_blocks();
+    #endif
+    unsigned affine_mats_to_commit = sprite_affine_mats_manager::retrieve_indexes_to_commit();
 
-    if(auto affine_mats_commit_data = sprite_affine_mats_manager::retrieve_commit_data())
+    for(int affine_mat_index = 0; affine_mats_to_commit; ++affine_mat_index)
     {
-        int multiplier = hw::sprites::count() / hw::sprite_affine_mats::count();
-        int first_mat_index_to_commit = affine_mats_commit_data->offset * multiplier;
-        int last_mat_index_to_commit = first_mat_index_to_commit + (affine_mats_commit_data->count * multiplier) - 1;
-        first_index_to_commit = min(first_index_to_commit, first_mat_index_to_commit);
-        last_index_to_commit = max(last_index_to_commit, last_mat_index_to_commit);
+        if(affine_mats_to_commit & 1)
+        {
+            blocks_to_commit |= 1U << (affine_mat_index / affine_mats_per_commit_block);
+        }
+
+        affine_mats_to_commit >>= 1;
     }
 
-    if(first_index_to_commit < hw::sprites::count())
+    if(blocks_to_commit)
     {
-        int commit_items_count = last_index_to_commit - first_index_to_commit + 1;
-        hw::sprites::commit(data.handles[0], first_index_to_commit, commit_items_count);
-        data.first_index_to_commit = hw::sprites::count();
-        data.last_index_to_commit = 0;
+        const hw::sprites::handle_type& handles_ref = data.handles[0];
+        int block_index = 0;
+
+        // Each run of consecutive dirty blocks is copied at once:
+        while(blocks_to_commit)
+        {
+            if(blocks_to_commit & 1)
+            {
+                int first_block_index = block_index;
+
+                while(blocks_to_commit & 1)
+                {
+                    ++block_index;
+                    blocks_to_commit >>= 1;
+                }
+
+                hw::sprites::commit(handles_ref, first_block_index * commit_block_size(),
+                                    (block_index - first_block_index) * commit_block_size());
+            }
+            else
+            {
+                ++block_index;
+                blocks_to_commit >>= 1;
+            }
+        }
+
+        data.blocks_to_commit = 0;
     }
+
+    #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+        hw::sprites_multiplexer::commit(multiplexer.back_schedule());
+        multiplexer.swap();
+    #endif
+}
+
+void restore_multiplexed_items()
+{
+    #if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+        hw::sprites_multiplexer::restore();
+    #endif
 }
 
 }
@@ -26,6 +26,7 @@ class sprite_first_attributes;
 class sprite_third_attributes;
 class sprite_regular_second_attributes;
 class sprite_affine_second_attributes;
+class sprites_manager_hot_items;
 enum class bpp_mode : uint8_t;
 enum class sprite_size : uint8_t;
 enum class sprite_shape : uint8_t;
@@ -36,10 +37,20 @@ namespace sorted_sprites
     class layer;
 }
 
+namespace sprites_multiplexer
+{
+    class context;
+}
+
 namespace sprites_manager
 {
     using id_type = void*;
 
+    [[nodiscard]] constexpr int commit_block_size()
+    {
+        return 8;
+    }
+
     void init();
 
     [[nodiscard]] int used_items_count();
@@ -185,6 +196,8 @@ namespace sprites_manager
 
     void reload_blending();
 
+    void reload_tiles();
+
     void reload_all();
 
     void fill_hblank_effect_horizontal_positions(id_type id, int hw_x, const fixed* positions_ptr, uint16_t* dest_ptr);
@@ -207,22 +220,45 @@ namespace sprites_manager
 
     void update_cameras();
 
+    [[nodiscard]] int item_index(id_type id);
+
+    void set_batch_positions(const int16_t* item_indexes, const fixed_point* positions, int positions_count,
+                             int last_positions_count);
+
     void remove_identity_affine_mat_if_not_needed(id_type id);
 
     void update_affine_mat_double_size(id_type id);
 
+    [[nodiscard]] bool multiplexing_active();
+
+    [[nodiscard]] int multiplexing_dropped_items_count();
+
+    [[nodiscard]] optional<int> multiplexing_overloaded_scanline();
+
     void update();
 
     void commit();
 
+    void restore_multiplexed_items();
+
     [[nodiscard]] BN_CODE_IWRAM bool _check_items_on_screen_impl(
-            void* hw_handles, intrusive_list<sorted_sprites::layer>& layers, bool rebuild_handles,
-            int& first_index_to_commit, int& last_index_to_commit);
+            void* hw_handles, sprites_manager_hot_items& hot_items, int items_count, bool rebuild_handles,
+            unsigned& blocks_to_commit);
 
     [[nodiscard]] BN_CODE_IWRAM int _rebuild_handles_impl(
-            int last_visible_items_count, void* hw_handles, intrusive_list<sorted_sprites::layer>& layers);
+            int last_visible_items_count, void* hw_handles, sprites_manager_hot_items& hot_items,
+            intrusive_list<sorted_sprites::layer>& layers);
+
+    [[nodiscard]] BN_CODE_IWRAM int _rebuild_multiplexed_handles_impl(
+            int last_visible_items_count, void* hw_handles, sprites_manager_hot_items& hot_items,
+            intrusive_list<sorted_sprites::layer>& layers, sprites_multiplexer::context& context);
+
+    [[nodiscard]] BN_CODE_IWRAM bool _update_cameras_impl(
+            sprites_manager_hot_items& hot_items, int items_count, const point* camera_positions);
 
-    [[nodiscard]] BN_CODE_IWRAM bool _update_cameras_impl(intrusive_list<sorted_sprites::layer>& layers);
+    [[nodiscard]] BN_CODE_IWRAM bool _set_batch_positions_impl(
+            sprites_manager_hot_items& hot_items, const int16_t* item_indexes, const fixed_point* positions,
+            int positions_count, const point& camera_position);
 }
 
 }
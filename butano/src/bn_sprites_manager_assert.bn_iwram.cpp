@@ -18,7 +18,7 @@
 namespace bn::sprites_manager
 {
 
-int _rebuild_handles_impl(int last_visible_items_count, void* hw_handles,
+int _rebuild_handles_impl(int last_visible_items_count, void* hw_handles, sprites_manager_hot_items& hot_items,
                           intrusive_list<sorted_sprites::layer>& layers)
 {
     auto handles = reinterpret_cast<hw::sprites::handle_type*>(hw_handles);
@@ -26,19 +26,21 @@ int _rebuild_handles_impl(int last_visible_items_count, void* hw_handles,
 
     for(sorted_sprites::layer& layer : layers)
     {
-        for(sprites_manager_item& item : layer.items())
+        for(const sprites_manager_item& item : layer.items())
         {
-            if(item.on_screen)
+            int index = item.index;
+
+            if(hot_items.on_screen[index])
             {
                 BN_ASSERT(visible_items_count <= hw::sprites::count(), "Too much on screen sprites");
 
-                hw::sprites::copy_handle(item.handle, handles[visible_items_count]);
-                item.handles_index = int8_t(visible_items_count);
+                hw::sprites::copy_handle(hot_items.handles[index], handles[visible_items_count]);
+                hot_items.handles_indexes[index] = int8_t(visible_items_count);
                 ++visible_items_count;
             }
             else
             {
-                item.handles_index = -1;
+                hot_items.handles_indexes[index] = -1;
             }
         }
     }
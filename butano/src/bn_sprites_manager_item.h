@@ -6,12 +6,14 @@
 #ifndef BN_SPRITES_MANAGER_ITEM_H
 #define BN_SPRITES_MANAGER_ITEM_H
 
+#include "bn_point.h"
 #include "bn_display.h"
 #include "bn_sprites.h"
 #include "bn_optional.h"
 #include "bn_sort_key.h"
 #include "bn_camera_ptr.h"
 #include "bn_fixed_point.h"
+#include "bn_config_sprites.h"
 #include "bn_intrusive_list.h"
 #include "bn_display_manager.h"
 #include "bn_sprites_manager.h"
@@ -36,14 +38,37 @@ namespace bn::sorted_sprites
 namespace bn
 {
 
+/*
+ * Per frame sprite data is stored in contiguous arrays indexed by sprite item index,
+ * so camera, on screen and OAM handles updates don't touch cold sprite item data.
+ */
+class sprites_manager_hot_items
+{
+
+public:
+    static constexpr int max_items = BN_CFG_SPRITES_MAX_ITEMS;
+
+    hw::sprites::handle_type handles[max_items];
+    point hw_positions[max_items];
+    point positions[max_items];
+    int8_t camera_ids[max_items];
+    int8_t half_widths[max_items];
+    int8_t half_heights[max_items];
+    int8_t handles_indexes[max_items];
+    bool visible[max_items];
+    bool on_screen[max_items];
+    bool check_on_screen[max_items];
+    bool affine[max_items];
+    bool double_size[max_items];
+};
+
+
 class sprites_manager_item : public intrusive_list_node_type
 {
 
 public:
     sprite_affine_mat_attach_node_type affine_mat_attach_node;
-    hw::sprites::handle_type handle;
     fixed_point position;
-    point hw_position;
     unsigned usages = 1;
     sort_key sprite_sort_key;
     bn::sorted_sprites::layer* sort_layer_ptr;
@@ -51,16 +76,10 @@ public:
     optional<sprite_palette_ptr> palette;
     optional<sprite_affine_mat_ptr> affine_mat;
     optional<camera_ptr> camera;
-    int8_t handles_index = -1;
-    int8_t half_width;
-    int8_t half_height;
+    int16_t index;
     unsigned double_size_mode: 2;
-    bool double_size: 1;
     bool blending_enabled: 1;
-    bool visible: 1;
     bool remove_affine_mat_when_not_needed: 1;
-    bool on_screen: 1;
-    bool check_on_screen: 1;
 
     [[nodiscard]] static sprites_manager_item& affine_mat_attach_node_item(
             sprite_affine_mat_attach_node_type& attach_node)
@@ -72,42 +91,41 @@ public:
         return *item;
     }
 
-    sprites_manager_item(const fixed_point& _position, const sprite_shape_size& shape_size,
-                         sprite_tiles_ptr&& _tiles, sprite_palette_ptr&& _palette) :
+    sprites_manager_item(int _index, sprites_manager_hot_items& hot_items, const fixed_point& _position,
+                         const sprite_shape_size& shape_size, sprite_tiles_ptr&& _tiles,
+                         sprite_palette_ptr&& _palette) :
         position(_position),
         sprite_sort_key(3, 0),
         tiles(move(_tiles)),
         palette(move(_palette)),
+        index(int16_t(_index)),
         double_size_mode(unsigned(sprite_double_size_mode::AUTO)),
-        double_size(false),
         blending_enabled(false),
-        visible(true),
-        remove_affine_mat_when_not_needed(true),
-        on_screen(false),
-        check_on_screen(true)
+        remove_affine_mat_when_not_needed(true)
     {
         const sprite_palette_ptr& palette_ref = *palette;
         hw::sprites::setup_regular(shape_size, tiles->id(), palette_ref.id(), palette_ref.bpp(),
-                                   display_manager::blending_fade_enabled(), handle);
-        update_half_dimensions();
+                                   display_manager::blending_fade_enabled(), hot_items.handles[_index]);
+        hot_items.double_size[_index] = false;
+        _init_hot_item(hot_items, true);
     }
 
-    sprites_manager_item(sprite_builder&& builder, sprite_tiles_ptr&& _tiles, sprite_palette_ptr&& _palette) :
+    sprites_manager_item(int _index, sprites_manager_hot_items& hot_items, sprite_builder&& builder,
+                         sprite_tiles_ptr&& _tiles, sprite_palette_ptr&& _palette) :
         position(builder.position()),
         sprite_sort_key(builder.bg_priority(), builder.z_order()),
         tiles(move(_tiles)),
         palette(move(_palette)),
         affine_mat(builder.release_affine_mat()),
         camera(builder.release_camera()),
+        index(int16_t(_index)),
         double_size_mode(unsigned(builder.double_size_mode())),
-        double_size(false),
         blending_enabled(builder.blending_enabled()),
-        visible(builder.visible()),
-        remove_affine_mat_when_not_needed(builder.remove_affine_mat_when_not_needed()),
-        on_screen(false),
-        check_on_screen(builder.visible())
+        remove_affine_mat_when_not_needed(builder.remove_affine_mat_when_not_needed())
     {
         const sprite_palette_ptr& palette_ref = *palette;
+        hw::sprites::handle_type& handle = hot_items.handles[_index];
+        bool double_size = false;
 
         if(affine_mat)
         {
@@ -123,9 +141,9 @@ public:
             else
             {
                 int affine_mat_id = affine_mat_ref.id();
-                double_size = new_double_size();
                 hw::sprites::setup_affine(builder, tiles->id(), palette_ref.id(), palette_ref.bpp(),
                                           display_manager::blending_fade_enabled(), handle);
+                double_size = new_double_size(hot_items);
                 hw::sprites::set_affine_mat(affine_mat_id, handle);
                 hw::sprites::show_affine(double_size, handle);
                 sprite_affine_mats_manager::attach_sprite(affine_mat_id, affine_mat_attach_node);
@@ -137,17 +155,18 @@ public:
                                        display_manager::blending_fade_enabled(), handle);
         }
 
-        update_half_dimensions();
+        hot_items.double_size[_index] = double_size;
+        _init_hot_item(hot_items, builder.visible());
     }
 
-    [[nodiscard]] bool new_double_size() const
+    [[nodiscard]] bool new_double_size(const sprites_manager_hot_items& hot_items) const
     {
         switch(sprite_double_size_mode(double_size_mode))
         {
 
         case sprite_double_size_mode::AUTO:
             {
-                pair<int, int> base_dimensions = hw::sprites::base_dimensions(handle);
+                pair<int, int> base_dimensions = hw::sprites::base_dimensions(hot_items.handles[index]);
                 return sprite_affine_mats_manager::sprite_double_size(
                             affine_mat->id(), base_dimensions.first, base_dimensions.second);
             }
@@ -184,42 +203,50 @@ public:
         sprite_sort_key.set_z_order(z_order);
     }
 
-    void update_half_dimensions()
+    void update_half_dimensions(sprites_manager_hot_items& hot_items) const
     {
-        pair<int, int> dimensions = hw::sprites::dimensions(handle, double_size);
-        half_width = int8_t(dimensions.first / 2);
-        half_height = int8_t(dimensions.second / 2);
-        update_hw_position();
+        pair<int, int> dimensions = hw::sprites::dimensions(hot_items.handles[index], hot_items.double_size[index]);
+        hot_items.half_widths[index] = int8_t(dimensions.first / 2);
+        hot_items.half_heights[index] = int8_t(dimensions.second / 2);
+        update_hw_position(hot_items);
     }
 
-    void update_hw_position()
+    void update_camera(sprites_manager_hot_items& hot_items) const
     {
-        int real_x = position.x().right_shift_integer();
-        int real_y = position.y().right_shift_integer();
+        hot_items.camera_ids[index] = camera ? int8_t(camera->id()) : int8_t(-1);
+        update_hw_position(hot_items);
+    }
+
+    void update_hw_position(sprites_manager_hot_items& hot_items) const
+    {
+        point real_position = hot_items.positions[index];
 
         if(camera)
         {
             const fixed_point& camera_position = camera->position();
-            real_x -= camera_position.x().right_shift_integer();
-            real_y -= camera_position.y().right_shift_integer();
+            real_position -= point(camera_position.x().right_shift_integer(),
+                                   camera_position.y().right_shift_integer());
         }
 
-        update_hw_x(real_x);
-        update_hw_y(real_y);
-    }
-
-    void update_hw_x(int real_x)
-    {
-        int hw_x = real_x + (display::width() / 2) - int(half_width);
-        hw_position.set_x(hw_x);
+        int hw_x = real_position.x() + (display::width() / 2) - hot_items.half_widths[index];
+        int hw_y = real_position.y() + (display::height() / 2) - hot_items.half_heights[index];
+        hw::sprites::handle_type& handle = hot_items.handles[index];
+        hot_items.hw_positions[index] = point(hw_x, hw_y);
         hw::sprites::set_x(hw_x, handle);
+        hw::sprites::set_y(hw_y, handle);
     }
 
-    void update_hw_y(int real_y)
+private:
+    void _init_hot_item(sprites_manager_hot_items& hot_items, bool visible) const
     {
-        int hw_y = real_y + (display::height() / 2) - int(half_height);
-        hw_position.set_y(hw_y);
-        hw::sprites::set_y(hw_y, handle);
+        hot_items.positions[index] = point(position.x().right_shift_integer(), position.y().right_shift_integer());
+        hot_items.handles_indexes[index] = -1;
+        hot_items.visible[index] = visible;
+        hot_items.on_screen[index] = false;
+        hot_items.check_on_screen[index] = visible;
+        hot_items.affine[index] = affine_mat.has_value();
+        hot_items.camera_ids[index] = camera ? int8_t(camera->id()) : int8_t(-1);
+        update_half_dimensions(hot_items);
     }
 };
 
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_sprites_manager.h"
+
+#include "bn_config_sprites.h"
+
+#if BN_CFG_SPRITES_MULTIPLEXING_ENABLED
+
+#define BN_ASSERT(condition, ...)
+
+#define BN_ERROR(...)
+
+#include "bn_sorted_sprites.h"
+#include "bn_sprites_multiplexer.h"
+
+namespace bn::sprites_manager
+{
+
+namespace
+{
+    constexpr const int oam_entries = hw::sprites::count();
+    constexpr const int screen_lines = display::height();
+    constexpr const int max_line_writes = BN_CFG_SPRITES_MULTIPLEXING_MAX_LINE_WRITES;
+
+    static_assert(max_line_writes > 0 && max_line_writes <= numeric_limits<uint8_t>::max());
+
+
+    [[nodiscard]] int _first_line(const sprites_manager_hot_items& hot_items, int item_index)
+    {
+        return max(hot_items.hw_positions[item_index].y(), 0);
+    }
+
+    [[nodiscard]] int _last_line(const sprites_manager_hot_items& hot_items, int item_index)
+    {
+        int hw_y = hot_items.hw_positions[item_index].y();
+        return min(hw_y + (hot_items.half_heights[item_index] * 2), screen_lines) - 1;
+    }
+
+    [[nodiscard]] int _scanline_cycles(const sprites_manager_hot_items& hot_items, int item_index)
+    {
+        int width = hot_items.half_widths[item_index] * 2;
+        return hot_items.affine[item_index] ? (width * 2) + 10 : width;
+    }
+
+    void _add_scanline_cycles(const sprites_manager_hot_items& hot_items, int item_index, int* scanline_cycles)
+    {
+        int cycles = _scanline_cycles(hot_items, item_index);
+        scanline_cycles[_first_line(hot_items, item_index)] += cycles;
+        scanline_cycles[_last_line(hot_items, item_index) + 1] -= cycles;
+    }
+
+    void _sift_down(sprites_multiplexer::slot* slots, int index)
+    {
+        while(true)
+        {
+            int smallest_index = index;
+            int left_index = (index * 2) + 1;
+            int right_index = left_index + 1;
+
+            if(left_index < oam_entries && slots[left_index].last_line < slots[smallest_index].last_line)
+            {
+                smallest_index = left_index;
+            }
+
+            if(right_index < oam_entries && slots[right_index].last_line < slots[smallest_index].last_line)
+            {
+                smallest_index = right_index;
+            }
+
+            if(smallest_index == index)
+            {
+                return;
+            }
+
+            swap(slots[index], slots[smallest_index]);
+            index = smallest_index;
+        }
+    }
+}
+
+int _rebuild_multiplexed_handles_impl(int last_visible_items_count, void* hw_handles,
+                                      sprites_manager_hot_items& hot_items,
+                                      intrusive_list<sorted_sprites::layer>& layers,
+                                      sprites_multiplexer::context& context)
+{
+    auto handles = reinterpret_cast<hw::sprites::handle_type*>(hw_handles);
+    int8_t* handles_indexes = hot_items.handles_indexes;
+    int16_t* sorted_item_indexes = context.sorted_item_indexes;
+    int items_count = 0;
+
+    for(sorted_sprites::layer& layer : layers)
+    {
+        for(const sprites_manager_item& item : layer.items())
+        {
+            int item_index = item.index;
+            handles_indexes[item_index] = -1;
+
+            if(hot_items.on_screen[item_index])
+            {
+                sorted_item_indexes[items_count] = int16_t(item_index);
+                ++items_count;
+            }
+        }
+    }
+
+    context.dropped_items_count = 0;
+    context.overloaded_scanline = -1;
+    context.active = items_count > oam_entries;
+
+    if(! context.active)
+    {
+        for(int index = 0; index < items_count; ++index)
+        {
+            int item_index = sorted_item_indexes[index];
+            hw::sprites::copy_handle(hot_items.handles[item_index], handles[index]);
+            handles_indexes[item_index] = int8_t(index);
+        }
+
+        for(int index = items_count; index < last_visible_items_count; ++index)
+        {
+            hw::sprites::hide_and_destroy(handles[index]);
+        }
+
+        return items_count;
+    }
+
+    // Stable counting sort by first displayed scanline:
+    int16_t line_offsets[screen_lines + 1] = {};
+
+    for(int index = 0; index < items_count; ++index)
+    {
+        ++line_offsets[_first_line(hot_items, sorted_item_indexes[index]) + 1];
+    }
+
+    for(int line = 1; line <= screen_lines; ++line)
+    {
+        line_offsets[line] += line_offsets[line - 1];
+    }
+
+    int16_t* vertically_sorted_item_indexes = context.vertically_sorted_item_indexes;
+
+    for(int index = 0; index < items_count; ++index)
+    {
+        int16_t item_index = sorted_item_indexes[index];
+        int16_t& line_offset = line_offsets[_first_line(hot_items, item_index)];
+        vertically_sorted_item_indexes[line_offset] = item_index;
+        ++line_offset;
+    }
+
+    // Topmost sprites are committed in V-Blank keeping their sort order:
+    sprites_multiplexer::slot* slots = context.slots;
+    int scanline_cycles[screen_lines + 1] = {};
+
+    for(int index = 0; index < oam_entries; ++index)
+    {
+        handles_indexes[vertically_sorted_item_indexes[index]] = 0;
+    }
+
+    for(int index = 0, oam_index = 0; oam_index < oam_entries; ++index)
+    {
+        int item_index = sorted_item_indexes[index];
+
+        if(handles_indexes[item_index] == 0)
+        {
+            hw::sprites::copy_handle(hot_items.handles[item_index], handles[oam_index]);
+            handles_indexes[item_index] = int8_t(oam_index);
+            slots[oam_index] = sprites_multiplexer::slot{
+                    int16_t(_last_line(hot_items, item_index)), int16_t(oam_index) };
+            _add_scanline_cycles(hot_items, item_index, scanline_cycles);
+            ++oam_index;
+        }
+    }
+
+    for(int index = (oam_entries / 2) - 1; index >= 0; --index)
+    {
+        _sift_down(slots, index);
+    }
+
+    // Remaining sprites reuse the OAM entry of the sprite which stops being displayed first:
+    sprites_multiplexer::pending_entry* pending_entries = context.pending_entries;
+    int pending_entries_count = 0;
+    uint8_t line_writes[screen_lines] = {};
+
+    for(int index = oam_entries; index < items_count; ++index)
+    {
+        int16_t item_index = vertically_sorted_item_indexes[index];
+        sprites_multiplexer::slot& slot = slots[0];
+        int last_line = slot.last_line;
+        int vcount = _first_line(hot_items, item_index) - 2;
+
+        while(vcount >= last_line && line_writes[vcount] == max_line_writes)
+        {
+            --vcount;
+        }
+
+        if(vcount < last_line)
+        {
+            ++context.dropped_items_count;
+            continue;
+        }
+
+        ++line_writes[vcount];
+        pending_entries[pending_entries_count] = sprites_multiplexer::pending_entry{
+                item_index, int16_t(vcount), slot.oam_index };
+        ++pending_entries_count;
+        _add_scanline_cycles(hot_items, item_index, scanline_cycles);
+
+        slot.last_line = int16_t(_last_line(hot_items, item_index));
+        _sift_down(slots, 0);
+    }
+
+    // Pending entries are grouped by scanline:
+    hw::sprites_multiplexer::schedule& schedule = context.back_schedule();
+    hw::sprites_multiplexer::line* schedule_lines = schedule.lines;
+    int schedule_lines_count = 0;
+    int schedule_entries_count = 0;
+
+    for(int line = 0; line < screen_lines; ++line)
+    {
+        if(int writes = line_writes[line])
+        {
+            schedule_lines[schedule_lines_count] = hw::sprites_multiplexer::line{ uint8_t(line), uint8_t(writes) };
+            ++schedule_lines_count;
+            line_offsets[line] = int16_t(schedule_entries_count);
+            schedule_entries_count += writes;
+        }
+    }
+
+    hw::sprites_multiplexer::entry* schedule_entries = schedule.entries;
+    hw::sprites_multiplexer::entry* restore_entries = schedule.restore_entries;
+    int restore_entries_count = 0;
+    bool rewritten_oam_entries[oam_entries] = {};
+    unsigned multiplexed_blocks = 0;
+
+    for(int index = 0; index < pending_entries_count; ++index)
+    {
+        const sprites_multiplexer::pending_entry& pending_entry = pending_entries[index];
+        const hw::sprites::handle_type& handle = hot_items.handles[pending_entry.item_index];
+        int oam_index = pending_entry.oam_index;
+        int16_t& line_offset = line_offsets[pending_entry.vcount];
+        schedule_entries[line_offset] = hw::sprites_multiplexer::entry{
+                handle.attr0, handle.attr1, handle.attr2, uint16_t(oam_index) };
+        ++line_offset;
+        multiplexed_blocks |= 1U << (oam_index / commit_block_size());
+
+        // First band values are kept to restore them in V-Blank if the next frame is not committed in time:
+        if(! rewritten_oam_entries[oam_index])
+        {
+            const hw::sprites::handle_type& first_band_handle = handles[oam_index];
+            restore_entries[restore_entries_count] = hw::sprites_multiplexer::entry{
+                    first_band_handle.attr0, first_band_handle.attr1, first_band_handle.attr2, uint16_t(oam_index) };
+            rewritten_oam_entries[oam_index] = true;
+            ++restore_entries_count;
+        }
+    }
+
+    schedule.lines_count = schedule_lines_count;
+    schedule.restore_entries_count = restore_entries_count;
+    context.back_multiplexed_blocks() = multiplexed_blocks;
+
+    // Sprites rendering cycles of each scanline:
+    int cycles = 0;
+
+    for(int line = 0; line < screen_lines; ++line)
+    {
+        cycles += scanline_cycles[line];
+
+        if(cycles > hw::sprites_multiplexer::max_scanline_cycles())
+        {
+            context.overloaded_scanline = line;
+            break;
+        }
+    }
+
+    return oam_entries;
+}
+
+}
+
+#endif
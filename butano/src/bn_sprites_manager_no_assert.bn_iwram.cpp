@@ -9,114 +9,108 @@
 
 #define BN_ERROR(...)
 
-#include "bn_sorted_sprites.h"
+#include "bn_sprites_manager_item.h"
 
 namespace bn::sprites_manager
 {
 
-bool _check_items_on_screen_impl(void* hw_handles, intrusive_list<sorted_sprites::layer>& layers,
-                                 bool rebuild_handles, int& first_index_to_commit, int& last_index_to_commit)
+bool _check_items_on_screen_impl(void* hw_handles, sprites_manager_hot_items& hot_items, int items_count,
+                                 bool rebuild_handles, unsigned& blocks_to_commit)
 {
     auto handles = reinterpret_cast<hw::sprites::handle_type*>(hw_handles);
-    int first_index = first_index_to_commit;
-    int last_index = last_index_to_commit;
+    bool* check_on_screen_ptr = hot_items.check_on_screen;
+    unsigned blocks = blocks_to_commit;
 
-    for(sorted_sprites::layer& layer : layers)
+    for(int index = 0; index < items_count; ++index)
     {
-        for(sprites_manager_item& item : layer.items())
+        if(check_on_screen_ptr[index])
         {
-            if(item.check_on_screen)
+            const point& hw_position = hot_items.hw_positions[index];
+            int x = hw_position.x();
+            bool on_screen = false;
+            check_on_screen_ptr[index] = false;
+
+            if(x < display::width())
             {
-                int x = item.hw_position.x();
-                bool on_screen = false;
-                item.check_on_screen = false;
+                int y = hw_position.y();
 
-                if(x < display::width())
+                if(y < display::height())
                 {
-                    int y = item.hw_position.y();
-
-                    if(y < display::height())
+                    if(x + (hot_items.half_widths[index] * 2) > 0)
                     {
-                        if(x + (item.half_width * 2) > 0)
+                        if(y + (hot_items.half_heights[index] * 2) > 0)
                         {
-                            if(y + (item.half_height * 2) > 0)
-                            {
-                                on_screen = true;
-                            }
+                            on_screen = true;
                         }
                     }
                 }
+            }
 
-                if(item.on_screen != on_screen)
-                {
-                    item.on_screen = on_screen;
+            hw::sprites::handle_type& handle = hot_items.handles[index];
+
+            if(hot_items.on_screen[index] != on_screen)
+            {
+                hot_items.on_screen[index] = on_screen;
 
-                    if(on_screen)
+                if(on_screen)
+                {
+                    if(hot_items.affine[index])
                     {
-                        if(item.affine_mat)
-                        {
-                            hw::sprites::show_affine(item.double_size, item.handle);
-                        }
-                        else
-                        {
-                            hw::sprites::show_regular(item.handle);
-                        }
+                        hw::sprites::show_affine(hot_items.double_size[index], handle);
                     }
                     else
                     {
-                        hw::sprites::hide(item.handle);
+                        hw::sprites::show_regular(handle);
                     }
                 }
-
-                if(! rebuild_handles)
+                else
                 {
-                    int handles_index = item.handles_index;
-
-                    if(handles_index != -1)
-                    {
-                        hw::sprites::copy_handle(item.handle, handles[handles_index]);
+                    hw::sprites::hide(handle);
+                }
+            }
 
-                        if(handles_index < first_index)
-                        {
-                            first_index = handles_index;
-                        }
+            if(! rebuild_handles)
+            {
+                int handles_index = hot_items.handles_indexes[index];
 
-                        if(handles_index > last_index)
-                        {
-                            last_index = handles_index;
-                        }
-                    }
-                    else
-                    {
-                        rebuild_handles = true;
-                    }
+                if(handles_index != -1)
+                {
+                    hw::sprites::copy_handle(handle, handles[handles_index]);
+                    blocks |= 1U << (handles_index / commit_block_size());
+                }
+                else
+                {
+                    rebuild_handles = true;
                 }
             }
         }
     }
 
-    first_index_to_commit = first_index;
-    last_index_to_commit = last_index;
+    blocks_to_commit = blocks;
     return rebuild_handles;
 }
 
-bool _update_cameras_impl(intrusive_list<sorted_sprites::layer>& layers)
+bool _update_cameras_impl(sprites_manager_hot_items& hot_items, int items_count, const point* camera_positions)
 {
+    const int8_t* camera_ids_ptr = hot_items.camera_ids;
     bool check_items_on_screen = false;
 
-    for(sorted_sprites::layer& layer : layers)
+    for(int index = 0; index < items_count; ++index)
     {
-        for(sprites_manager_item& item : layer.items())
+        if(int camera_id = camera_ids_ptr[index]; camera_id >= 0)
         {
-            if(item.camera)
+            point real_position = hot_items.positions[index] - camera_positions[camera_id];
+            int hw_x = real_position.x() + (display::width() / 2) - hot_items.half_widths[index];
+            int hw_y = real_position.y() + (display::height() / 2) - hot_items.half_heights[index];
+            hw::sprites::handle_type& handle = hot_items.handles[index];
+            hot_items.hw_positions[index] = point(hw_x, hw_y);
+            hw::sprites::set_x(hw_x, handle);
+            hw::sprites::set_y(hw_y, handle);
+
+            if(hot_items.visible[index])
             {
-                item.update_hw_position();
-
-                if(item.visible)
-                {
-                    item.check_on_screen = true;
-                    check_items_on_screen = true;
-                }
+                hot_items.check_on_screen[index] = true;
+                check_items_on_screen = true;
             }
         }
     }
@@ -124,4 +118,37 @@ bool _update_cameras_impl(intrusive_list<sorted_sprites::layer>& layers)
     return check_items_on_screen;
 }
 
+bool _set_batch_positions_impl(sprites_manager_hot_items& hot_items, const int16_t* item_indexes,
+                               const fixed_point* positions, int positions_count, const point& camera_position)
+{
+    int camera_x = camera_position.x();
+    int camera_y = camera_position.y();
+    bool check_items_on_screen = false;
+
+    for(int index = 0; index < positions_count; ++index)
+    {
+        int item_index = item_indexes[index];
+        const fixed_point& position = positions[index];
+        int real_x = position.x().right_shift_integer();
+        int real_y = position.y().right_shift_integer();
+        int hw_x = real_x - camera_x + (display::width() / 2) - hot_items.half_widths[item_index];
+        int hw_y = real_y - camera_y + (display::height() / 2) - hot_items.half_heights[item_index];
+        point& hw_position = hot_items.hw_positions[item_index];
+        hot_items.positions[item_index] = point(real_x, real_y);
+
+        if(hw_position.x() != hw_x || hw_position.y() != hw_y || ! hot_items.visible[item_index])
+        {
+            hw::sprites::handle_type& handle = hot_items.handles[item_index];
+            hw_position = point(hw_x, hw_y);
+            hw::sprites::set_x(hw_x, handle);
+            hw::sprites::set_y(hw_y, handle);
+            hot_items.visible[item_index] = true;
+            hot_items.check_on_screen[item_index] = true;
+            check_items_on_screen = true;
+        }
+    }
+
+    return check_items_on_screen;
+}
+
 }
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef BN_SPRITES_MULTIPLEXER_H
+#define BN_SPRITES_MULTIPLEXER_H
+
+#include "bn_config_sprites.h"
+#include "../hw/include/bn_hw_sprites_multiplexer.h"
+
+namespace bn::sprites_multiplexer
+{
+    class pending_entry
+    {
+
+    public:
+        int16_t item_index;
+        int16_t vcount;
+        int16_t oam_index;
+    };
+
+
+    class slot
+    {
+
+    public:
+        int16_t last_line;
+        int16_t oam_index;
+    };
+
+
+    class context
+    {
+
+    public:
+        hw::sprites_multiplexer::schedule schedules[2];
+        int16_t sorted_item_indexes[BN_CFG_SPRITES_MAX_ITEMS];
+        int16_t vertically_sorted_item_indexes[BN_CFG_SPRITES_MAX_ITEMS];
+        pending_entry pending_entries[hw::sprites_multiplexer::max_entries()];
+        slot slots[hw::sprites::count()];
+        unsigned multiplexed_blocks[2] = {};
+        int back_index = 0;
+        int dropped_items_count = 0;
+        int overloaded_scanline = -1;
+        bool active = false;
+
+        [[nodiscard]] hw::sprites_multiplexer::schedule& back_schedule()
+        {
+            return schedules[back_index];
+        }
+
+        [[nodiscard]] unsigned& back_multiplexed_blocks()
+        {
+            return multiplexed_blocks[back_index];
+        }
+
+        [[nodiscard]] unsigned front_multiplexed_blocks() const
+        {
+            return multiplexed_blocks[! back_index];
+        }
+
+        void swap()
+        {
+            back_index = ! back_index;
+            schedules[back_index].lines_count = 0;
+            multiplexed_blocks[back_index] = 0;
+        }
+    };
+}
+
+#endif
@@ -10,6 +10,7 @@ import sys
 import traceback
 
 from file_info import FileInfo
+import native_soundbank
 
 
 def list_audio_files(audio_folder_paths):
@@ -59,6 +60,22 @@ def process_audio_files(audio_file_paths, soundbank_bin_path, soundbank_header_p
     return os.path.getsize(soundbank_bin_path)
 
 
+def process_native_audio_files(audio_file_paths, soundbank_bin_path):
+    samples = []
+
+    for audio_file_path in audio_file_paths:
+        if os.path.splitext(audio_file_path)[1] != '.wav':
+            raise ValueError('Only *.wav files are supported by the native audio backend: ' + audio_file_path)
+
+        sample_format, frequency, sample_values = native_soundbank.read_wav(audio_file_path)
+        samples.append(native_soundbank.build_sample(sample_format, frequency, sample_values, audio_file_path))
+
+    with open(soundbank_bin_path, 'wb') as soundbank_file:
+        soundbank_file.write(native_soundbank.build_bank(samples))
+
+    return os.path.getsize(soundbank_bin_path)
+
+
 def write_output_file(items, include_guard, include_file, namespace, item_class, output_file_path):
     if len(items) > 0:
         with open(output_file_path, 'w') as output_file:
@@ -122,9 +139,37 @@ def write_output_files(audio_file_names_no_ext, soundbank_header_path, build_fol
                       build_folder_path + '/bn_sound_items.h')
 
 
-def process(audio_folder_paths, build_folder_path):
+def write_native_output_files(audio_file_names_no_ext, build_folder_path):
+    sound_items_list = []
+
+    for index, audio_file_name_no_ext in enumerate(audio_file_names_no_ext):
+        sound_items_list.append([audio_file_name_no_ext, str(index)])
+
+    write_output_file([], 'BN_MUSIC_ITEMS_H', 'bn_music_item.h', 'bn::music_items', 'music_item',
+                      build_folder_path + '/bn_music_items.h')
+
+    write_output_file(sound_items_list, 'BN_SOUND_ITEMS_H', 'bn_sound_item.h', 'bn::sound_items', 'sound_item',
+                      build_folder_path + '/bn_sound_items.h')
+
+
+def process(audio_folder_paths, backend, build_folder_path):
+    if backend not in ('', 'maxmod', 'native'):
+        raise ValueError('Invalid audio backend: ' + backend)
+
+    native = backend == 'native'
     audio_file_names, audio_file_names_no_ext, audio_file_paths = list_audio_files(audio_folder_paths)
-    file_info_path = build_folder_path + '/_bn_audio_files_info.txt'
+
+    # Each backend has its own file info, so audio files are processed again when the backend is changed:
+    if native:
+        file_info_path = build_folder_path + '/_bn_audio_native_files_info.txt'
+        other_file_info_path = build_folder_path + '/_bn_audio_files_info.txt'
+    else:
+        file_info_path = build_folder_path + '/_bn_audio_files_info.txt'
+        other_file_info_path = build_folder_path + '/_bn_audio_native_files_info.txt'
+
+    if os.path.exists(other_file_info_path):
+        os.remove(other_file_info_path)
+
     old_file_info = FileInfo.read(file_info_path)
     new_file_info = FileInfo.build_from_files(audio_file_paths)
 
@@ -137,22 +182,30 @@ def process(audio_folder_paths, build_folder_path):
     sys.stdout.flush()
 
     soundbank_bin_path = build_folder_path + '/_bn_audio_soundbank.bin'
-    soundbank_header_path = build_folder_path + '/_bn_audio_soundbank.h'
-    total_size = process_audio_files(audio_file_paths, soundbank_bin_path, soundbank_header_path, build_folder_path)
-    write_output_files(audio_file_names_no_ext, soundbank_header_path, build_folder_path)
+
+    if native:
+        total_size = process_native_audio_files(audio_file_paths, soundbank_bin_path)
+        write_native_output_files(audio_file_names_no_ext, build_folder_path)
+    else:
+        soundbank_header_path = build_folder_path + '/_bn_audio_soundbank.h'
+        total_size = process_audio_files(audio_file_paths, soundbank_bin_path, soundbank_header_path,
+                                         build_folder_path)
+        write_output_files(audio_file_names_no_ext, soundbank_header_path, build_folder_path)
+        os.remove(soundbank_header_path)
+
     print('    Processed audio size: ' + str(total_size) + ' bytes')
-    os.remove(soundbank_header_path)
     new_file_info.write(file_info_path)
 
 
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description='Butano audio tool.')
     parser.add_argument('--audio', required=True, help='audio folder paths')
+    parser.add_argument('--backend', default='', help='audio backend (maxmod or native)')
     parser.add_argument('--build', required=True, help='build folder path')
 
     try:
         args = parser.parse_args()
-        process(args.audio, args.build)
+        process(args.audio, args.backend, args.build)
     except Exception as ex:
         sys.stderr.write('Error: ' + str(ex) + '\n')
         traceback.print_exc()
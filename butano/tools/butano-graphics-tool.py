@@ -571,6 +571,23 @@ class RegularBgItem:
             except KeyError:
                 self.__map_compression = 'none'
 
+        try:
+            self.__metatile_size = int(info['metatile_size'])
+        except KeyError:
+            self.__metatile_size = 1
+
+        if self.__metatile_size != 1:
+            if self.__metatile_size != 2 and self.__metatile_size != 4:
+                raise ValueError('Invalid metatile size: ' + str(self.__metatile_size))
+
+            if self.__map_compression == 'auto':
+                self.__map_compression = 'none'
+            elif self.__map_compression != 'none':
+                raise ValueError('Compressed metatile maps not supported: ' + self.__map_compression)
+
+            # Metatiles are built from the flat map:
+            self.__sbb = False
+
     def process(self):
         tiles_compression = self.__tiles_compression
         palette_compression = self.__palette_compression
@@ -663,6 +680,17 @@ class RegularBgItem:
         else:
             bpp_mode_label = 'bpp_mode::BPP_4'
 
+        if self.__metatile_size != 1:
+            grit_data, metatiles_total_size_increment = self.__write_metatiles(grit_data)
+            total_size += metatiles_total_size_increment
+            map_item = 'regular_bg_map_item(' + name + '_bn_graphicsMetatiles[0], ' + \
+                       name + '_bn_graphicsMetatileIndexes[0], ' + str(self.__metatile_size) + ', ' + \
+                       'size(' + str(self.__width) + ', ' + str(self.__height) + ')));'
+        else:
+            map_item = 'regular_bg_map_item(' + name + '_bn_graphicsMap[0], ' + \
+                       'size(' + str(self.__width) + ', ' + str(self.__height) + '), ' + \
+                       compression_label(map_compression) + '));'
+
         with open(header_file_path, 'w') as header_file:
             include_guard = 'BN_REGULAR_BG_ITEMS_' + name.upper() + '_H'
             header_file.write('#ifndef ' + include_guard + '\n')
@@ -680,9 +708,7 @@ class RegularBgItem:
                               'bg_palette_item(span<const color>(' + name + '_bn_graphicsPal, ' +
                               str(self.__colors_count) + '), ' + bpp_mode_label + ', ' +
                               compression_label(palette_compression) + '),' + '\n            ' +
-                              'regular_bg_map_item(' + name + '_bn_graphicsMap[0], ' +
-                              'size(' + str(self.__width) + ', ' + str(self.__height) + '), ' +
-                              compression_label(map_compression) + '));' + '\n')
+                              map_item + '\n')
             header_file.write('}' + '\n')
             header_file.write('\n')
             header_file.write('#endif' + '\n')
@@ -690,6 +716,120 @@ class RegularBgItem:
 
         return total_size, header_file_path
 
+    def __write_metatiles(self, grit_data):
+        name = self.__file_name_no_ext
+        map_label = name + '_bn_graphicsMap'
+        grit_asm_file_path = self.__build_folder_path + '/' + name + '_bn_graphics.s'
+
+        with open(grit_asm_file_path, 'r') as grit_asm_file:
+            grit_asm_blocks = grit_asm_file.read().split('\n\n')
+
+        map_block_index = None
+        map_cells = []
+
+        for grit_asm_block_index, grit_asm_block in enumerate(grit_asm_blocks):
+            if map_label + ':' in grit_asm_block:
+                map_block_index = grit_asm_block_index
+
+                for grit_asm_line in grit_asm_block.splitlines():
+                    grit_asm_words = grit_asm_line.split(None, 1)
+
+                    if len(grit_asm_words) == 2:
+                        if grit_asm_words[0] == '.hword':
+                            for value in grit_asm_words[1].split(','):
+                                map_cells.append(int(value, 0))
+                        elif grit_asm_words[0] == '.word':
+                            for value in grit_asm_words[1].split(','):
+                                value = int(value, 0)
+                                map_cells.append(value & 0xFFFF)
+                                map_cells.append(value >> 16)
+                break
+
+        if map_block_index is None:
+            raise ValueError('Map not found in grit output: ' + grit_asm_file_path)
+
+        width = self.__width
+        height = self.__height
+        metatile_size = self.__metatile_size
+
+        if len(map_cells) != width * height:
+            raise ValueError('Invalid map cells count: ' + str(len(map_cells)) + ' - ' + str(width * height))
+
+        metatiles = {}
+        metatile_cells = []
+        metatile_indexes = []
+
+        for metatile_y in range(0, height, metatile_size):
+            for metatile_x in range(0, width, metatile_size):
+                metatile = []
+
+                for y in range(metatile_y, metatile_y + metatile_size):
+                    for x in range(metatile_x, metatile_x + metatile_size):
+                        metatile.append(map_cells[(y * width) + x])
+
+                metatile = tuple(metatile)
+                metatile_index = metatiles.get(metatile)
+
+                if metatile_index is None:
+                    metatile_index = len(metatiles)
+                    metatiles[metatile] = metatile_index
+                    metatile_cells.extend(metatile)
+
+                metatile_indexes.append(metatile_index)
+
+        if len(metatiles) <= 256:
+            index_type = 'uint8_t'
+            index_asm_type = '.byte'
+            index_bytes = 1
+        elif len(metatiles) <= 65536:
+            index_type = 'uint16_t'
+            index_asm_type = '.hword'
+            index_bytes = 2
+        else:
+            raise ValueError('Maps with more than 65536 metatiles not supported: ' + str(len(metatiles)))
+
+        metatiles_label = name + '_bn_graphicsMetatiles'
+        metatile_indexes_label = name + '_bn_graphicsMetatileIndexes'
+        metatiles_bytes = len(metatile_cells) * 2
+        metatile_indexes_bytes = len(metatile_indexes) * index_bytes
+        grit_asm_blocks[map_block_index] = \
+            RegularBgItem.__asm_block(metatiles_label, metatiles_bytes, '.hword', 4, metatile_cells) + '\n\n' + \
+            RegularBgItem.__asm_block(metatile_indexes_label, metatile_indexes_bytes, index_asm_type,
+                                      index_bytes * 2, metatile_indexes)
+
+        with open(grit_asm_file_path, 'w') as grit_asm_file:
+            grit_asm_file.write('\n\n'.join(grit_asm_blocks))
+
+        grit_lines = []
+
+        for grit_line in grit_data.splitlines():
+            if map_label + 'Len' in grit_line:
+                grit_lines.append('#define ' + metatiles_label + 'Len ' + str(metatiles_bytes))
+                grit_lines.append('#define ' + metatile_indexes_label + 'Len ' + str(metatile_indexes_bytes))
+            elif map_label + '[' in grit_line:
+                grit_lines.append('extern const bn::regular_bg_map_cell ' + metatiles_label + '[' +
+                                  str(len(metatile_cells)) + '];')
+                grit_lines.append('extern const ' + index_type + ' ' + metatile_indexes_label + '[' +
+                                  str(len(metatile_indexes)) + '];')
+            else:
+                grit_lines.append(grit_line)
+
+        grit_data = '\n'.join(grit_lines) + '\n'
+        total_size_increment = metatiles_bytes + metatile_indexes_bytes - (len(map_cells) * 2)
+        return grit_data, total_size_increment
+
+    @staticmethod
+    def __asm_block(label, bytes_count, asm_type, hex_digits, values):
+        lines = ['\t.section .rodata', '\t.align\t2', '\t.global ' + label + '\t\t@ ' + str(bytes_count) +
+                 ' unsigned chars', '\t.hidden ' + label, label + ':']
+        value_format = '0x{:0' + str(hex_digits) + 'X}'
+
+        for values_index in range(0, len(values), 16):
+            values_line = values[values_index:values_index + 16]
+            lines.append('\t' + asm_type + ' ' + ','.join(value_format.format(value) for value in values_line))
+
+        return '\n'.join(lines)
+
     def __execute_command(self, tiles_compression, palette_compression, map_compression):
         command = ['grit', self.__file_path, '-pe' + str(self.__colors_count)]
 
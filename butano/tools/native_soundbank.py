@@ -0,0 +1,194 @@
+"""
+Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+zlib License, see LICENSE file.
+
+Sound bank of the native audio backend (see butano/hw/include/bn_hw_audio_mixer.h).
+"""
+
+import struct
+
+PCM_8_FORMAT = 0
+IMA_ADPCM_FORMAT = 1
+
+MAX_SAMPLE_LENGTH = 1 << 19
+
+_WAVE_FORMAT_PCM = 0x0001
+_WAVE_FORMAT_IMA_ADPCM = 0x0011
+_WAVE_FORMAT_EXTENSIBLE = 0xFFFE
+
+ADPCM_STEPS = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+    4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767
+]
+
+ADPCM_STEP_INDEX_DELTAS = [-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8]
+
+
+class AdpcmState:
+
+    def __init__(self, value=0, step_index=0):
+        self.value = value
+        self.step_index = step_index
+
+    def decode(self, code):
+        step = ADPCM_STEPS[self.step_index]
+        delta = step >> 3
+
+        if code & 1:
+            delta += step >> 2
+
+        if code & 2:
+            delta += step >> 1
+
+        if code & 4:
+            delta += step
+
+        if code & 8:
+            self.value = max(self.value - delta, -32768)
+        else:
+            self.value = min(self.value + delta, 32767)
+
+        self.step_index = min(max(self.step_index + ADPCM_STEP_INDEX_DELTAS[code], 0), len(ADPCM_STEPS) - 1)
+        return self.value
+
+    def encode(self, sample):
+        step = ADPCM_STEPS[self.step_index]
+        difference = sample - self.value
+        code = 0
+
+        if difference < 0:
+            code = 8
+            difference = -difference
+
+        if difference >= step:
+            code |= 4
+            difference -= step
+
+        step >>= 1
+
+        if difference >= step:
+            code |= 2
+            difference -= step
+
+        step >>= 1
+
+        if difference >= step:
+            code |= 1
+
+        self.decode(code)
+        return code
+
+
+def encode_adpcm(samples):
+    """Encodes 16 bits samples in one IMA ADPCM stream (low nibble first)."""
+    state = AdpcmState()
+    codes = [state.encode(sample) for sample in samples]
+
+    if len(codes) % 2:
+        codes.append(0)
+
+    return bytes(codes[index] | (codes[index + 1] << 4) for index in range(0, len(codes), 2))
+
+
+def _decode_adpcm_wav_blocks(data, block_align):
+    samples = []
+
+    for block_start in range(0, len(data), block_align):
+        block = data[block_start:block_start + block_align]
+
+        if len(block) < 4:
+            break
+
+        value, step_index = struct.unpack_from('<hB', block)
+        state = AdpcmState(value, min(step_index, len(ADPCM_STEPS) - 1))
+        samples.append(value)
+
+        for code_byte in block[4:]:
+            samples.append(state.decode(code_byte & 15))
+            samples.append(state.decode(code_byte >> 4))
+
+    return samples
+
+
+def read_wav(file_path):
+    """Returns the format, frequency and 16 bits mono samples of a *.wav file."""
+    with open(file_path, 'rb') as file:
+        content = file.read()
+
+    if len(content) < 12 or content[0:4] != b'RIFF' or content[8:12] != b'WAVE':
+        raise ValueError('Invalid WAV file: ' + file_path)
+
+    wave_format = None
+    data = None
+    offset = 12
+
+    while offset + 8 <= len(content):
+        chunk_id = content[offset:offset + 4]
+        chunk_size = struct.unpack_from('<I', content, offset + 4)[0]
+        chunk = content[offset + 8:offset + 8 + chunk_size]
+
+        if chunk_id == b'fmt ':
+            wave_format = struct.unpack_from('<HHIIHH', chunk)
+        elif chunk_id == b'data':
+            data = chunk
+
+        offset += 8 + chunk_size + (chunk_size & 1)
+
+    if wave_format is None or data is None:
+        raise ValueError('WAV file without format or data chunks: ' + file_path)
+
+    format_tag, channels, frequency, _, block_align, bits_per_sample = wave_format
+
+    if format_tag == _WAVE_FORMAT_EXTENSIBLE:
+        format_tag = struct.unpack_from('<H', content, content.find(b'fmt ') + 8 + 24)[0]
+
+    if format_tag == _WAVE_FORMAT_IMA_ADPCM:
+        if channels != 1:
+            raise ValueError('Only mono IMA ADPCM WAV files are supported: ' + file_path)
+
+        return IMA_ADPCM_FORMAT, frequency, _decode_adpcm_wav_blocks(data, block_align)
+
+    if format_tag != _WAVE_FORMAT_PCM or bits_per_sample not in (8, 16):
+        raise ValueError('Only 8 bits PCM, 16 bits PCM and IMA ADPCM WAV files are supported: ' + file_path)
+
+    if bits_per_sample == 8:
+        values = [value - 128 << 8 for value in data]
+    else:
+        values = list(struct.unpack('<' + str(len(data) // 2) + 'h', data[0:len(data) // 2 * 2]))
+
+    # Stereo samples are converted to mono:
+    samples = [sum(values[index:index + channels]) // channels
+               for index in range(0, len(values) - channels + 1, channels)]
+
+    return PCM_8_FORMAT, frequency, samples
+
+
+def build_sample(sample_format, frequency, samples, file_path):
+    length = len(samples)
+
+    if length == 0 or length > MAX_SAMPLE_LENGTH:
+        raise ValueError('Invalid samples count: ' + str(length) + ' (max: ' + str(MAX_SAMPLE_LENGTH) + '): ' +
+                         file_path)
+
+    if sample_format == IMA_ADPCM_FORMAT:
+        data = encode_adpcm(samples)
+    else:
+        data = bytes((sample >> 8) & 0xFF for sample in samples)
+
+    result = struct.pack('<IIB3x', length, frequency, sample_format) + data
+    return result + bytes(-len(result) % 4)
+
+
+def build_bank(samples):
+    """Builds a sound bank from a list of samples built with build_sample."""
+    offset = 4 + (len(samples) * 4)
+    header = struct.pack('<I', len(samples))
+
+    for sample in samples:
+        header += struct.pack('<I', offset)
+        offset += len(sample)
+
+    return header + b''.join(samples)
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_core.h"
+#include "bn_math.h"
+#include "bn_array.h"
+#include "bn_keypad.h"
+#include "bn_bitmap_bg.h"
+#include "bn_bg_palette_item.h"
+#include "bn_sprite_text_generator.h"
+
+#include "info.h"
+#include "variable_8x16_sprite_font.h"
+
+namespace
+{
+    void bitmap_bg_mode_3_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "PAD: move square",
+            "A: change square color",
+            "",
+            "START: go to next scene",
+        };
+
+        // Bitmap BGs reserve the first half of sprite tiles VRAM, so they must be created before any sprite:
+        bn::bitmap_bg bitmap_bg(bn::bitmap_bg_mode::MODE_3, true);
+        info info("Bitmap BG mode 3", info_text_lines, text_generator);
+
+        constexpr const bn::color background_color(4, 4, 8);
+        constexpr const bn::color square_colors[] = {
+            bn::color(31, 0, 0), bn::color(0, 31, 0), bn::color(0, 0, 31), bn::color(31, 31, 0)
+        };
+
+        constexpr const int square_size = 23;
+        int square_x = 108;
+        int square_y = 68;
+        int square_color_index = 0;
+        bitmap_bg.clear(background_color);
+
+        while(! bn::keypad::start_pressed())
+        {
+            // Only the previous square is erased, since the EWRAM back buffer keeps the last frame:
+            bitmap_bg.fill_rect(square_x, square_y, square_size, square_size, background_color);
+
+            if(bn::keypad::left_held())
+            {
+                square_x = bn::max(square_x - 1, 0);
+            }
+            else if(bn::keypad::right_held())
+            {
+                square_x = bn::min(square_x + 1, bitmap_bg.dimensions().width() - square_size);
+            }
+
+            if(bn::keypad::up_held())
+            {
+                square_y = bn::max(square_y - 1, 0);
+            }
+            else if(bn::keypad::down_held())
+            {
+                square_y = bn::min(square_y + 1, bitmap_bg.dimensions().height() - square_size);
+            }
+
+            if(bn::keypad::a_pressed())
+            {
+                square_color_index = (square_color_index + 1) % 4;
+            }
+
+            bitmap_bg.fill_rect(square_x, square_y, square_size, square_size, square_colors[square_color_index]);
+
+            // The EWRAM back buffer is copied to VRAM in the next V-Blank:
+            bitmap_bg.present();
+            info.update();
+            bn::core::update();
+        }
+    }
+
+    void bitmap_bg_mode_4_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "START: go to next scene",
+        };
+
+        bn::array<bn::color, 256> colors;
+
+        for(int index = 1; index < 32; ++index)
+        {
+            colors[index] = bn::color(index, 31 - index, 16);
+        }
+
+        bn::bitmap_bg bitmap_bg(bn::bg_palette_item(colors, bn::bpp_mode::BPP_8));
+        info info("Bitmap BG mode 4", info_text_lines, text_generator);
+
+        constexpr const int bars_count = 31;
+        constexpr const int bar_width = 5;
+        int max_x = bitmap_bg.dimensions().width() - bar_width;
+        int bar_height = bitmap_bg.dimensions().height();
+        int frame = 0;
+
+        while(! bn::keypad::start_pressed())
+        {
+            // The hidden page contains the frame before the last one, so it is redrawn from scratch:
+            bitmap_bg.clear(0);
+
+            for(int index = 0; index < bars_count; ++index)
+            {
+                int x = (index * 7) + frame;
+                x %= max_x * 2;
+
+                if(x > max_x)
+                {
+                    x = (max_x * 2) - x;
+                }
+
+                bitmap_bg.fill_rect(x, 0, bar_width, bar_height, index + 1);
+            }
+
+            // Pages are flipped in the next V-Blank:
+            bitmap_bg.present();
+            ++frame;
+            info.update();
+            bn::core::update();
+        }
+    }
+
+    void bitmap_bg_mode_5_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "A: zoom in",
+            "B: zoom out",
+            "",
+            "START: go to next scene",
+        };
+
+        bn::bitmap_bg bitmap_bg(bn::bitmap_bg_mode::MODE_5);
+        info info("Bitmap BG mode 5", info_text_lines, text_generator);
+
+        constexpr const int image_size = 16;
+        bn::array<bn::color, image_size * image_size> image;
+
+        for(int y = 0; y < image_size; ++y)
+        {
+            for(int x = 0; x < image_size; ++x)
+            {
+                image[(y * image_size) + x] = (x + y) % 2 ? bn::color(x * 2, y * 2, 31) : bn::color(31, 31, 31);
+            }
+        }
+
+        bn::span<const bn::color> image_pixels(image.data(), image.size());
+        int max_zoom_size = bitmap_bg.dimensions().height();
+        int zoom_size = image_size * 3;
+
+        while(! bn::keypad::start_pressed())
+        {
+            if(bn::keypad::a_held())
+            {
+                zoom_size = bn::min(zoom_size + 1, max_zoom_size);
+            }
+            else if(bn::keypad::b_held())
+            {
+                zoom_size = bn::max(zoom_size - 1, 1);
+            }
+
+            int x = (bitmap_bg.dimensions().width() - zoom_size) / 2;
+            int y = (bitmap_bg.dimensions().height() - zoom_size) / 2;
+            bitmap_bg.clear(bn::color(8, 0, 8));
+            bitmap_bg.scaled_blit(x, y, bn::size(zoom_size, zoom_size), image_pixels,
+                                  bn::size(image_size, image_size));
+            bitmap_bg.present();
+            info.update();
+            bn::core::update();
+        }
+    }
+}
+
+int main()
+{
+    bn::core::init();
+
+    bn::sprite_text_generator text_generator(variable_8x16_sprite_font);
+
+    while(true)
+    {
+        // Released sprite tiles are not available until the next update, so it is called before each scene:
+        bitmap_bg_mode_3_scene(text_generator);
+        bn::core::update();
+
+        bitmap_bg_mode_4_scene(text_generator);
+        bn::core::update();
+
+        bitmap_bg_mode_5_scene(text_generator);
+        bn::core::update();
+    }
+}
@@ -6,14 +6,13 @@
 #include "bn_core.h"
 #include "bn_math.h"
 #include "bn_keypad.h"
+#include "bn_vector.h"
 #include "bn_display.h"
-#include "bn_affine_bg_ptr.h"
+#include "bn_mode_7_bg.h"
+#include "bn_sprite_ptr.h"
 #include "bn_sprite_text_generator.h"
-#include "bn_affine_bg_pa_register_hbe_ptr.h"
-#include "bn_affine_bg_pc_register_hbe_ptr.h"
-#include "bn_affine_bg_dx_register_hbe_ptr.h"
-#include "bn_affine_bg_dy_register_hbe_ptr.h"
 
+#include "bn_sprite_items_dino.h"
 #include "bn_affine_bg_items_land.h"
 
 #include "info.h"
@@ -21,105 +20,106 @@
 
 namespace
 {
-    struct camera
-    {
-        bn::fixed x = 440;
-        bn::fixed y = 128;
-        bn::fixed z = 320;
-        int phi = 10;
-        int cos = 0;
-        int sin = 0;
+    constexpr const int billboards_count = 4;
+
+    constexpr const bn::fixed_point billboard_positions[billboards_count] = {
+        bn::fixed_point(440, 160), bn::fixed_point(360, 40), bn::fixed_point(560, 96), bn::fixed_point(480, -64)
     };
 
-    void update_camera(camera& camera)
+    void update_camera(bn::mode_7_camera& camera)
     {
-        bn::fixed dir_x = 0;
-        bn::fixed dir_z = 0;
+        bn::fixed yaw = camera.yaw();
+        bn::fixed pitch = camera.pitch();
+        bn::fixed y = camera.y();
+        bn::fixed speed = 0;
 
         if(bn::keypad::left_held())
         {
-            dir_x -= bn::fixed::from_data(32);
+            yaw -= 1;
+
+            if(yaw < 0)
+            {
+                yaw += 360;
+            }
         }
         else if(bn::keypad::right_held())
         {
-            dir_x += bn::fixed::from_data(32);
+            yaw += 1;
+
+            if(yaw >= 360)
+            {
+                yaw -= 360;
+            }
         }
 
-        if(bn::keypad::down_held())
+        if(bn::keypad::up_held())
         {
-            dir_z += bn::fixed::from_data(32);
+            speed = 1;
         }
-        else if(bn::keypad::up_held())
+        else if(bn::keypad::down_held())
         {
-            dir_z -= bn::fixed::from_data(32);
+            speed = -1;
         }
 
         if(bn::keypad::b_held())
         {
-            camera.y -= bn::fixed::from_data(2048);
-
-            if(camera.y < 0)
-            {
-                camera.y = 0;
-            }
+            y = bn::max(y - bn::fixed(0.5), bn::fixed(8));
         }
         else if(bn::keypad::a_held())
         {
-            camera.y += bn::fixed::from_data(2048);
+            y = bn::min(y + bn::fixed(0.5), bn::fixed(256));
         }
 
         if(bn::keypad::l_held())
         {
-            camera.phi -= 4;
-
-            if(camera.phi < 0)
-            {
-                camera.phi += 2048;
-            }
+            pitch = bn::max(pitch - bn::fixed(0.5), bn::fixed(-10));
         }
         else if(bn::keypad::r_held())
         {
-            camera.phi += 4;
-
-            if(camera.phi >= 2048)
-            {
-                camera.phi -= 2048;
-            }
+            pitch = bn::min(pitch + bn::fixed(0.5), bn::fixed(30));
         }
 
-        camera.cos = bn::lut_cos(camera.phi).data() >> 4;
-        camera.sin = bn::lut_sin(camera.phi).data() >> 4;
-        camera.x += (dir_x * camera.cos) - (dir_z * camera.sin);
-        camera.z += (dir_x * camera.sin) + (dir_z * camera.cos);
+        camera.set_yaw(yaw);
+        camera.set_pitch(pitch);
+        camera.set_y(y);
+
+        // The camera looks at the top of the map with a yaw angle of 0:
+        camera.set_x(camera.x() + (speed * camera.yaw_sin()));
+        camera.set_z(camera.z() - (speed * camera.yaw_cos()));
     }
 
-    void update_hbe_values(const camera& camera, int16_t* pa_values, int16_t* pc_values, int* dx_values,
-                           int* dy_values)
+    void update_billboards(const bn::mode_7_camera& camera, bn::ivector<bn::sprite_ptr>& billboards)
     {
-        int camera_x = camera.x.data();
-        int camera_y = camera.y.data() >> 4;
-        int camera_z = camera.z.data();
-        int camera_cos = camera.cos;
-        int camera_sin = camera.sin;
-        int y_shift = 160;
-
-        for(int index = 0; index < bn::display::height(); ++index)
-        {
-            int reciprocal = bn::reciprocal_lut[index].data() >> 4;
-            int lam = camera_y * reciprocal >> 12;
-            int lcf = lam * camera_cos >> 8;
-            int lsf = lam * camera_sin >> 8;
+        constexpr int half_width = bn::display::width() / 2;
+        constexpr int half_height = bn::display::height() / 2;
+        constexpr int dino_half_height = 32;
 
-            pa_values[index] = int16_t(lcf >> 4);
-            pc_values[index] = int16_t(lsf >> 4);
+        for(int index = 0; index < billboards_count; ++index)
+        {
+            const bn::fixed_point& billboard_position = billboard_positions[index];
+            bn::optional<bn::mode_7_projection> projection =
+                    camera.project(billboard_position.x(), 0, billboard_position.y());
+            bn::sprite_ptr& billboard = billboards[index];
+            bool visible = false;
 
-            int lxr = (bn::display::width() / 2) * lcf;
-            int lyr = y_shift * lsf;
-            dx_values[index] = (camera_x - lxr + lyr) >> 4;
+            if(projection && projection->scale() >= bn::fixed(0.0625) && projection->scale() <= 2)
+            {
+                bn::fixed scale = projection->scale();
+                bn::fixed_point position = projection->position();
+                position.set_y(position.y() - (dino_half_height * scale));
+
+                if(bn::abs(position.x()) < half_width + (dino_half_height * 2) &&
+                        bn::abs(position.y()) < half_height + (dino_half_height * 2))
+                {
+                    // The feet of the dino are placed on the plane, and nearest dinos are displayed above:
+                    billboard.set_position(position);
+                    billboard.set_scale(scale);
+                    billboard.set_z_order(1024 - (scale * 256).right_shift_integer());
+                    visible = true;
+                }
+            }
 
-            lxr = (bn::display::width() / 2) * lsf;
-            lyr = y_shift * lcf;
-            dy_values[index] = (camera_z - lxr - lyr) >> 4;
+            billboard.set_visible(visible);
         }
     }
 }
@@ -131,38 +131,36 @@ int main()
     bn::sprite_text_generator text_generator(variable_8x16_sprite_font);
 
     constexpr const bn::string_view info_text_lines[] = {
-        "Left/Right: move camera x",
-        "Up/Down: move camera z",
+        "Left/Right: rotate camera",
+        "Up/Down: move camera",
         "B/A: move camera y",
-        "L/R: move camera phi",
+        "L/R: change camera pitch",
     };
 
     info info("Mode 7", info_text_lines, text_generator);
 
-    bn::affine_bg_ptr bg = bn::affine_bg_items::land.create_bg(-376, -336);
-
-    int16_t pa_values[bn::display::height()];
-    bn::affine_bg_pa_register_hbe_ptr pa_hbe = bn::affine_bg_pa_register_hbe_ptr::create(bg, pa_values);
+    // Lines above the horizon display nothing since wrapping is disabled:
+    bn::affine_bg_ptr bg = bn::affine_bg_items::land.create_bg(0, 0);
+    bg.set_wrapping_enabled(false);
 
-    int16_t pc_values[bn::display::height()];
-    bn::affine_bg_pc_register_hbe_ptr pc_hbe = bn::affine_bg_pc_register_hbe_ptr::create(bg, pc_values);
+    bn::mode_7_camera camera(440, 64, 320, 0, 0, 40);
+    bn::mode_7_bg mode_7_bg(bn::move(bg), camera);
 
-    int dx_values[bn::display::height()];
-    bn::affine_bg_dx_register_hbe_ptr dx_hbe = bn::affine_bg_dx_register_hbe_ptr::create(bg, dx_values);
+    bn::vector<bn::sprite_ptr, billboards_count> billboards;
 
-    int dy_values[bn::display::height()];
-    bn::affine_bg_dy_register_hbe_ptr dy_hbe = bn::affine_bg_dy_register_hbe_ptr::create(bg, dy_values);
-
-    camera camera;
+    for(int index = 0; index < billboards_count; ++index)
+    {
+        bn::sprite_ptr billboard = bn::sprite_items::dino.create_sprite(0, 0);
+        billboard.set_visible(false);
+        billboards.push_back(bn::move(billboard));
+    }
 
     while(true)
     {
         update_camera(camera);
-        update_hbe_values(camera, pa_values, pc_values, dx_values, dy_values);
-        pa_hbe.reload_values_ref();
-        pc_hbe.reload_values_ref();
-        dx_hbe.reload_values_ref();
-        dy_hbe.reload_values_ref();
+        mode_7_bg.set_camera(camera);
+        mode_7_bg.update();
+        update_billboards(camera, billboards);
         info.update();
         bn::core::update();
     }
@@ -4,11 +4,15 @@
  */
 
 #include "bn_core.h"
+#include "bn_array.h"
 #include "bn_keypad.h"
 #include "bn_colors.h"
+#include "bn_string.h"
 #include "bn_display.h"
 #include "bn_optional.h"
+#include "bn_palette_cycle.h"
 #include "bn_regular_bg_ptr.h"
+#include "bn_frame_breakdown.h"
 #include "bn_bg_palette_actions.h"
 #include "bn_bg_palettes_actions.h"
 #include "bn_sprite_text_generator.h"
@@ -269,6 +273,70 @@ namespace
         }
     }
 
+    void palette_cycle_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "A: start/stop sprite palette cycle",
+            "",
+            "START: go to next scene",
+        };
+
+        info info("Palette cycle", info_text_lines, text_generator);
+
+        constexpr const bn::palette_cycle_range sprite_ranges[] = {
+            bn::palette_cycle_range(1, 7, 8),
+            bn::palette_cycle_range(8, 8, 4, true),
+        };
+
+        constexpr const bn::palette_cycle_range bg_ranges[] = {
+            bn::palette_cycle_range(1, 15, 4),
+        };
+
+        bn::palette_cycle sprite_cycle(sprite_ranges);
+        bn::palette_cycle bg_cycle(bg_ranges);
+
+        bn::regular_bg_ptr village_bg = bn::regular_bg_items::village.create_bg(0, 0);
+        bn::bg_palette_ptr village_palette = village_bg.palette();
+        bn::array<bn::color, bn::display::height()> colors;
+        bg_cycle.fill_hblank_effect_colors(village_palette.colors(), 1, 0, 8, colors);
+
+        bn::bg_palette_color_hbe_ptr colors_hbe =
+                bn::bg_palette_color_hbe_ptr::create(village_palette, 1, colors);
+
+        bn::sprite_ptr cavegirl_sprite = bn::sprite_items::cavegirl_green.create_sprite(0, 0);
+        bn::sprite_palette_ptr cavegirl_palette = cavegirl_sprite.palette();
+        cavegirl_palette.set_cycle(sprite_cycle);
+
+        int frames = 0;
+
+        while(! bn::keypad::start_pressed())
+        {
+            if(bn::keypad::a_pressed())
+            {
+                if(cavegirl_palette.has_cycle())
+                {
+                    cavegirl_palette.remove_cycle();
+                }
+                else
+                {
+                    cavegirl_palette.set_cycle(sprite_cycle);
+                }
+            }
+
+            ++frames;
+
+            // H-Blank effect colors only change when the cycle is stepped:
+            if(frames % bg_ranges[0].update_frames() == 0)
+            {
+                bg_cycle.fill_hblank_effect_colors(village_palette.colors(), 1, frames, 8, colors);
+                colors_hbe.reload_colors_ref();
+            }
+
+            info.update();
+            bn::core::update();
+        }
+    }
+
     void global_brightness_scene(bn::sprite_text_generator& text_generator)
     {
         constexpr const bn::string_view info_text_lines[] = {
@@ -492,6 +560,87 @@ namespace
             bn::core::update();
         }
     }
+
+    void palettes_commit_benchmark_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "First and last sprite palettes",
+            "are faded every frame",
+            "",
+            "A: toggle global brightness",
+            "START: go to next scene",
+        };
+
+        info info("Palettes commit benchmark", info_text_lines, text_generator);
+
+        // Fill the sprite palettes bank with different palettes:
+        bn::vector<bn::sprite_palette_ptr, 16> palettes;
+
+        while(bn::sprite_palettes::available_colors_count() >= 16)
+        {
+            bn::array<bn::color, 16> colors;
+            int palette_index = palettes.size();
+
+            for(int index = 0; index < 16; ++index)
+            {
+                colors[index] = bn::color(palette_index, index, 31 - palette_index);
+            }
+
+            palettes.push_back(bn::sprite_palette_item(colors, bn::bpp_mode::BPP_4).create_palette());
+        }
+
+        bn::sprite_palette_ptr& first_palette = palettes.front();
+        bn::sprite_palette_ptr& last_palette = palettes.back();
+        first_palette.set_fade_color(bn::colors::red);
+        last_palette.set_fade_color(bn::colors::blue);
+
+        bn::vector<bn::sprite_ptr, 16> text_sprites;
+        bn::fixed fade_intensity;
+        int frames = -1;
+        int ticks = 0;
+
+        while(! bn::keypad::start_pressed())
+        {
+            if(bn::keypad::a_pressed())
+            {
+                bn::sprite_palettes::set_brightness(bn::sprite_palettes::brightness() == 0 ? 0.25 : 0);
+            }
+
+            fade_intensity += 0.01;
+
+            if(fade_intensity > 1)
+            {
+                fade_intensity = 0;
+            }
+
+            first_palette.set_fade_intensity(fade_intensity);
+            last_palette.set_fade_intensity(fade_intensity);
+            info.update();
+            bn::core::update();
+
+            if(frames >= 0)
+            {
+                ticks += bn::core::last_frame_breakdown().ticks(bn::frame_stage::PALETTES_COMMIT);
+            }
+
+            ++frames;
+
+            if(frames == 64)
+            {
+                bn::string<32> text;
+                bn::ostringstream text_stream(text);
+                text_stream.append("Commit ticks: ");
+                text_stream.append(ticks / frames);
+                text_sprites.clear();
+                text_generator.generate(0, 0, text, text_sprites);
+
+                frames = 0;
+                ticks = 0;
+            }
+        }
+
+        bn::sprite_palettes::set_brightness(0);
+    }
 }
 
 int main()
@@ -530,6 +679,9 @@ int main()
         palette_rotate_actions_scene(text_generator);
         bn::core::update();
 
+        palette_cycle_scene(text_generator);
+        bn::core::update();
+
         global_brightness_scene(text_generator);
         bn::core::update();
 
@@ -553,5 +705,8 @@ int main()
 
         palette_color_hbe_scene(text_generator);
         bn::core::update();
+
+        palettes_commit_benchmark_scene(text_generator);
+        bn::core::update();
     }
 }
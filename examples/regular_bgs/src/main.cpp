@@ -10,6 +10,7 @@
 #include "bn_blending.h"
 #include "bn_bgs_mosaic.h"
 #include "bn_bg_palettes.h"
+#include "bn_regular_bg_world.h"
 #include "bn_regular_bg_actions.h"
 #include "bn_regular_bg_builder.h"
 #include "bn_regular_bg_attributes.h"
@@ -175,6 +176,161 @@ namespace
         }
     }
 
+    void regular_bgs_position_wave_hbe_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "LEFT: decrease amplitude",
+            "RIGHT: increase amplitude",
+            "",
+            "START: go to next scene",
+        };
+
+        info info("Regular BGs wave H-Blank effect", info_text_lines, text_generator);
+
+        bn::regular_bg_ptr red_bg = bn::regular_bg_items::red.create_bg(0, 0);
+
+        // The deltas of each screen line are generated by the engine, so they don't need to be updated here:
+        bn::regular_bg_position_hbe_ptr horizontal_wave_hbe =
+                bn::regular_bg_position_hbe_ptr::create_horizontal_wave(red_bg, bn::hbe_wave(8, 8, 4));
+
+        while(! bn::keypad::start_pressed())
+        {
+            bn::hbe_wave wave = *horizontal_wave_hbe.wave();
+            bn::fixed amplitude = wave.amplitude();
+
+            if(bn::keypad::left_held())
+            {
+                wave.set_amplitude(bn::max(amplitude - bn::fixed(0.25), bn::fixed(0)));
+            }
+            else if(bn::keypad::right_held())
+            {
+                wave.set_amplitude(bn::min(amplitude + bn::fixed(0.25), bn::fixed(32)));
+            }
+
+            if(wave.amplitude() != amplitude)
+            {
+                horizontal_wave_hbe.set_wave(wave);
+            }
+
+            info.update();
+            bn::core::update();
+        }
+    }
+
+    void regular_bgs_position_parallax_hbe_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "LEFT: move BG to the left",
+            "RIGHT: move BG to the right",
+            "",
+            "START: go to next scene",
+        };
+
+        info info("Regular BGs parallax H-Blank effect", info_text_lines, text_generator);
+
+        bn::regular_bg_ptr red_bg = bn::regular_bg_items::red.create_bg(0, 0);
+
+        // Upper bands move slower than the BG, and all of them are aligned when the BG position is zero:
+        constexpr const bn::hbe_parallax_band bands[] = {
+            bn::hbe_parallax_band(40, 0.25),
+            bn::hbe_parallax_band(40, 0.5),
+            bn::hbe_parallax_band(40, 0.75),
+            bn::hbe_parallax_band(40, 1),
+        };
+
+        bn::regular_bg_position_hbe_ptr horizontal_parallax_hbe =
+                bn::regular_bg_position_hbe_ptr::create_horizontal_parallax_bands(red_bg, bands);
+
+        while(! bn::keypad::start_pressed())
+        {
+            if(bn::keypad::left_held())
+            {
+                red_bg.set_x(red_bg.x() - 1);
+            }
+            else if(bn::keypad::right_held())
+            {
+                red_bg.set_x(red_bg.x() + 1);
+            }
+
+            info.update();
+            bn::core::update();
+        }
+    }
+
+    void regular_bg_world_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "PAD: move world",
+            "PAD+A: move world faster",
+            "",
+            "START: go to next scene",
+        };
+
+        info info("Regular BG world", info_text_lines, text_generator);
+
+        // Each chunk references its own tiles, so the world must be displayed with dynamic tiles:
+        constexpr const bn::regular_bg_tiles_item tiles_items[] = {
+            bn::regular_bg_items::red.tiles_item(),
+            bn::regular_bg_items::green.tiles_item(),
+            bn::regular_bg_items::blue.tiles_item(),
+            bn::regular_bg_items::yellow.tiles_item(),
+        };
+
+        constexpr const bn::regular_bg_map_item chunk_items[] = {
+            bn::regular_bg_items::red.map_item(),
+            bn::regular_bg_items::green.map_item(),
+            bn::regular_bg_items::blue.map_item(),
+            bn::regular_bg_items::yellow.map_item(),
+        };
+
+        constexpr const uint8_t chunk_tiles_indexes[] = {
+            0, 1, 2, 3,
+        };
+
+        constexpr const uint16_t chunk_indexes[] = {
+            0, 1, 2, 3,
+            1, 3, 0, 2,
+            2, 0, 3, 1,
+            3, 2, 1, 0,
+        };
+
+        bn::regular_bg_world_item world_item(
+                tiles_items, bn::regular_bg_items::red.palette_item(), chunk_items, chunk_tiles_indexes,
+                chunk_indexes, bn::size(4, 4));
+
+        bn::regular_bg_world world(world_item, bn::point(0, 0), 4, 512);
+        int x_limit = world_item.pixels_dimensions().width() - bn::display::width();
+        int y_limit = world_item.pixels_dimensions().height() - bn::display::height();
+
+        while(! bn::keypad::start_pressed())
+        {
+            int speed = bn::keypad::a_held() ? 4 : 1;
+            bn::point position = world.position();
+
+            if(bn::keypad::left_held())
+            {
+                position.set_x(bn::max(position.x() - speed, 0));
+            }
+            else if(bn::keypad::right_held())
+            {
+                position.set_x(bn::min(position.x() + speed, x_limit));
+            }
+
+            if(bn::keypad::up_held())
+            {
+                position.set_y(bn::max(position.y() - speed, 0));
+            }
+            else if(bn::keypad::down_held())
+            {
+                position.set_y(bn::min(position.y() + speed, y_limit));
+            }
+
+            world.set_position(position);
+            info.update();
+            bn::core::update();
+        }
+    }
+
     void regular_bgs_priority_scene(bn::sprite_text_generator& text_generator)
     {
         constexpr const bn::string_view info_text_lines[] = {
@@ -447,6 +603,15 @@ int main()
         regular_bgs_position_hbe_scene(text_generator);
         bn::core::update();
 
+        regular_bgs_position_wave_hbe_scene(text_generator);
+        bn::core::update();
+
+        regular_bgs_position_parallax_hbe_scene(text_generator);
+        bn::core::update();
+
+        regular_bg_world_scene(text_generator);
+        bn::core::update();
+
         regular_bgs_priority_scene(text_generator);
         bn::core::update();
 
@@ -6,11 +6,10 @@
 #ifndef BF_GAME_ENEMY_BULLETS_H
 #define BF_GAME_ENEMY_BULLETS_H
 
-#include "bn_array.h"
 #include "bn_optional.h"
+#include "bn_sprite_batch.h"
 #include "bn_forward_list.h"
 #include "bn_sprite_actions.h"
-#include "bn_sprite_tiles_ptr.h"
 #include "bn_sprite_palette_actions.h"
 #include "bf_constants.h"
 #include "bf_game_enemy_bullet_type.h"
@@ -29,7 +28,7 @@ class enemy_bullets
 {
 
 public:
-    enemy_bullets();
+    explicit enemy_bullets(const bn::camera_ptr& camera);
 
     [[nodiscard]] bool check_hero(const bn::fixed_rect& hero_rect);
 
@@ -43,16 +42,24 @@ public:
 private:
     struct bullet_type
     {
-        bn::sprite_move_by_action sprite_move_action;
+        bn::fixed_point position;
+        bn::fixed_point delta_position;
         bn::optional<bn::sprite_rotate_by_action> sprite_rotate_action;
         enemy_bullet_type type;
     };
 
     bn::sprite_palette_fade_loop_action _palette_fade_action;
-    bn::array<bn::sprite_tiles_ptr, 2> _tiles_list;
+    bn::sprite_batch<constants::max_enemy_bullets> _small_sprite_batch;
+    bn::sprite_batch<constants::max_enemy_bullets> _big_sprite_batch;
     bn::forward_list<bullet_type, constants::max_enemy_bullets / 2> _even_bullets;
     bn::forward_list<bullet_type, constants::max_enemy_bullets / 2> _odd_bullets;
     bool _check_odds = false;
+
+    [[nodiscard]] int _huge_bullets_count() const;
+
+    void _update_sprites();
+
+    void _set_max_hidden_sprites(int displayed_sprites);
 };
 
 }
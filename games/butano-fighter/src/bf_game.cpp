@@ -20,6 +20,7 @@ game::game(status& status, bn::sprite_text_generator& text_generator, butano_bac
     _hero(_camera, status),
     _intro(status.current_stage(), text_generator),
     _enemies(status.current_stage(), bn::sprite_items::flash_palette.palette_item().create_palette()),
+    _enemy_bullets(_camera),
     _objects(bn::sprite_items::flash_palette.palette_item().create_palette()),
     _scoreboard(text_generator),
     _butano_background(butano_background)
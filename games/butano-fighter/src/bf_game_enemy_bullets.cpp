@@ -6,6 +6,7 @@
 #include "bf_game_enemy_bullets.h"
 
 #include "bn_colors.h"
+#include "bn_algorithm.h"
 #include "bn_fixed_rect.h"
 #include "bn_sprite_builder.h"
 #include "bn_sprite_affine_mats.h"
@@ -30,13 +31,23 @@ namespace
         palette.set_fade_color(bn::colors::red);
         return bn::sprite_palette_fade_loop_action(bn::move(palette), 15, 0.5);
     }
+
+    void _init_sprite_batch(const bn::camera_ptr& camera, bn::isprite_batch& sprite_batch)
+    {
+        sprite_batch.set_z_order(constants::enemy_bullets_z_order);
+        sprite_batch.set_camera(camera);
+    }
 }
 
-enemy_bullets::enemy_bullets() :
+enemy_bullets::enemy_bullets(const bn::camera_ptr& camera) :
     _palette_fade_action(_create_palette_fade_action()),
-    _tiles_list({ bn::sprite_items::enemy_bullets.tiles_item().create_tiles(0),
-           bn::sprite_items::enemy_bullets.tiles_item().create_tiles(1) })
+    _small_sprite_batch(bn::sprite_items::enemy_bullets.shape_size(),
+                        bn::sprite_items::enemy_bullets.tiles_item().create_tiles(0), _palette_fade_action.palette()),
+    _big_sprite_batch(bn::sprite_items::enemy_bullets.shape_size(),
+                      bn::sprite_items::enemy_bullets.tiles_item().create_tiles(1), _palette_fade_action.palette())
 {
+    _init_sprite_batch(camera, _small_sprite_batch);
+    _init_sprite_batch(camera, _big_sprite_batch);
 }
 
 bool enemy_bullets::check_hero(const bn::fixed_rect& hero_rect)
@@ -45,8 +56,7 @@ bool enemy_bullets::check_hero(const bn::fixed_rect& hero_rect)
 
     for(const bullet_type& bullet : *bullets)
     {
-        const bn::fixed_point& bullet_position = bullet.sprite_move_action.sprite().position();
-        bn::fixed_rect bullet_rect(bullet_position, dimensions[int(bullet.type)]);
+        bn::fixed_rect bullet_rect(bullet.position, dimensions[int(bullet.type)]);
 
         if(bullet_rect.intersects(hero_rect))
         {
@@ -207,29 +217,11 @@ void enemy_bullets::add_bullet(const bn::fixed_point& hero_position, const bn::f
         break;
     }
 
-    bn::fixed scale = 1;
-    int tile_index;
-
-    if(type == enemy_bullet_type::HUGE)
-    {
-        scale = 2;
-        tile_index = 1;
-    }
-    else
-    {
-        tile_index = int(type);
-    }
-
     bn::iforward_list<bullet_type>* bullets = _odd_bullets.size() < _even_bullets.size() ?
                 &_odd_bullets : &_even_bullets;
     BN_ASSERT(! bullets->full(), "No more space for enemy bullets");
 
-    bn::sprite_builder builder(bn::sprite_items::enemy_bullets.shape_size(), _tiles_list[tile_index],
-                                _palette_fade_action.palette());
-    builder.set_position(enemy_position);
-    builder.set_scale(scale);
-    builder.set_z_order(constants::enemy_bullets_z_order);
-    builder.set_camera(camera);
+    bn::fixed_point delta_position = event.delta_position;
 
     if(event.delta_speed > 0)
     {
@@ -240,20 +232,23 @@ void enemy_bullets::add_bullet(const bn::fixed_point& hero_position, const bn::f
             distance.set_y(1);
         }
 
-        bn::fixed_point delta_position = direction_vector(distance.x(), distance.y(), event.delta_speed);
-        bullets->push_front({ bn::sprite_move_by_action(builder.release_build(), delta_position),
-                             bn::nullopt, type });
-    }
-    else
-    {
-        bullets->push_front({ bn::sprite_move_by_action(builder.release_build(), event.delta_position),
-                             bn::nullopt, type });
+        delta_position = direction_vector(distance.x(), distance.y(), event.delta_speed);
     }
 
+    bullets->push_front({ enemy_position, delta_position, bn::nullopt, type });
+
+    // Huge bullets are rotated, so they can't be displayed with a sprite batch:
     if(type == enemy_bullet_type::HUGE)
     {
-        bullet_type& bullet = bullets->front();
-        bullet.sprite_rotate_action.emplace(bullet.sprite_move_action.sprite(), 4);
+        _set_max_hidden_sprites(_small_sprite_batch.size() + _big_sprite_batch.size() + _huge_bullets_count() + 1);
+
+        bn::sprite_builder builder(bn::sprite_items::enemy_bullets.shape_size(), _big_sprite_batch.tiles(),
+                                    _palette_fade_action.palette());
+        builder.set_position(enemy_position);
+        builder.set_scale(2);
+        builder.set_z_order(constants::enemy_bullets_z_order);
+        builder.set_camera(camera);
+        bullets->front().sprite_rotate_action.emplace(builder.release_build(), 4);
     }
 }
 
@@ -261,6 +256,8 @@ void enemy_bullets::clear()
 {
     _even_bullets.clear();
     _odd_bullets.clear();
+    _small_sprite_batch.clear();
+    _big_sprite_batch.clear();
 }
 
 void enemy_bullets::update()
@@ -289,8 +286,7 @@ void enemy_bullets::update()
     while(it != end)
     {
         bullet_type& bullet = *it;
-        bn::sprite_move_by_action& sprite_move_action = bullet.sprite_move_action;
-        const bn::fixed_point& position = sprite_move_action.sprite().position();
+        bn::fixed_point& position = bullet.position;
 
         if(position.x() < -constants::view_width || position.x() > constants::view_width ||
                 position.y() < -constants::view_height || position.y() > constants::view_height)
@@ -299,13 +295,7 @@ void enemy_bullets::update()
         }
         else
         {
-            sprite_move_action.update();
-
-            if(bullet.sprite_rotate_action)
-            {
-                bullet.sprite_rotate_action->update();
-            }
-
+            position += bullet.delta_position;
             before_it = it;
             ++it;
         }
@@ -313,13 +303,89 @@ void enemy_bullets::update()
 
     for(bullet_type& bullet : *update_bullets)
     {
-        bullet.sprite_move_action.update();
+        bullet.position += bullet.delta_position;
+    }
+
+    _update_sprites();
+}
+
+int enemy_bullets::_huge_bullets_count() const
+{
+    int result = 0;
+
+    for(const bullet_type& bullet : _even_bullets)
+    {
+        result += bool(bullet.sprite_rotate_action);
+    }
+
+    for(const bullet_type& bullet : _odd_bullets)
+    {
+        result += bool(bullet.sprite_rotate_action);
+    }
+
+    return result;
+}
+
+void enemy_bullets::_update_sprites()
+{
+    bn::vector<bn::fixed_point, constants::max_enemy_bullets> small_positions;
+    bn::vector<bn::fixed_point, constants::max_enemy_bullets> big_positions;
+    int huge_bullets_count = 0;
 
-        if(bullet.sprite_rotate_action)
+    bn::iforward_list<bullet_type>* bullets_lists[] = { &_even_bullets, &_odd_bullets };
+
+    for(bn::iforward_list<bullet_type>* bullets : bullets_lists)
+    {
+        for(bullet_type& bullet : *bullets)
         {
-            bullet.sprite_rotate_action->update();
+            if(bn::optional<bn::sprite_rotate_by_action>& sprite_rotate_action = bullet.sprite_rotate_action)
+            {
+                bn::sprite_ptr sprite = sprite_rotate_action->sprite();
+                sprite.set_position(bullet.position);
+                sprite_rotate_action->update();
+                ++huge_bullets_count;
+            }
+            else if(bullet.type == enemy_bullet_type::SMALL)
+            {
+                small_positions.push_back(bullet.position);
+            }
+            else
+            {
+                big_positions.push_back(bullet.position);
+            }
         }
     }
+
+    _set_max_hidden_sprites(small_positions.size() + big_positions.size() + huge_bullets_count);
+
+    // The batch which doesn't display more sprites is updated first, so its hidden sprites are released
+    // before creating the new sprites of the other one:
+    bn::span<const bn::fixed_point> small_positions_span(small_positions.data(), small_positions.size());
+    bn::span<const bn::fixed_point> big_positions_span(big_positions.data(), big_positions.size());
+
+    if(_small_sprite_batch.size() >= small_positions.size())
+    {
+        _small_sprite_batch.set_positions(small_positions_span);
+        _big_sprite_batch.set_positions(big_positions_span);
+    }
+    else
+    {
+        _big_sprite_batch.set_positions(big_positions_span);
+        _small_sprite_batch.set_positions(small_positions_span);
+    }
+
+    BN_ASSERT(_small_sprite_batch.allocated_size() + _big_sprite_batch.allocated_size() + huge_bullets_count <=
+              constants::max_enemy_bullets, "Too many enemy bullets sprites: ", _small_sprite_batch.allocated_size(),
+              " - ", _big_sprite_batch.allocated_size(), " - ", huge_bullets_count);
+}
+
+void enemy_bullets::_set_max_hidden_sprites(int displayed_sprites)
+{
+    // Hidden sprites are kept only while there's room for them in the enemy bullets sprites budget,
+    // so enemy bullets never take more sprite items than max_enemy_bullets:
+    int max_hidden_sprites = bn::max(constants::max_enemy_bullets - displayed_sprites, 0);
+    _small_sprite_batch.set_max_hidden_size(max_hidden_sprites / 2);
+    _big_sprite_batch.set_max_hidden_size(max_hidden_sprites - (max_hidden_sprites / 2));
 }
 
 }
@@ -4,8 +4,11 @@
  */
 
 #include "bn_core.h"
+#include "bn_math.h"
+#include "bn_string.h"
 #include "bn_keypad.h"
 #include "bn_display.h"
+#include "bn_frame_breakdown.h"
 #include "bn_regular_bg_ptr.h"
 #include "bn_sprite_text_generator.h"
 
@@ -15,6 +18,7 @@
 #include "bn_regular_bg_items_big_map_4.h"
 #include "bn_regular_bg_items_big_map_8.h"
 #include "bn_regular_bg_items_border_map.h"
+#include "bn_regular_bg_items_metatile_map.h"
 
 namespace
 {
@@ -60,6 +64,78 @@ namespace
             bn::core::update();
         }
     }
+
+    void streaming_benchmark_scene(bn::sprite_text_generator& text_generator)
+    {
+        constexpr const bn::string_view info_text_lines[] = {
+            "Two big BGs scrolled 8px per frame",
+            "",
+            "START: go to next scene",
+        };
+
+        info info("Big maps streaming benchmark", info_text_lines, text_generator);
+
+        // The second BG uses tiles and palette offsets:
+        bn::regular_bg_ptr first_bg = bn::regular_bg_items::border_map.create_bg(0, 0);
+        bn::regular_bg_ptr second_bg = bn::regular_bg_items::big_map_4.create_bg(0, 0);
+        int first_x_limit = (first_bg.dimensions().width() - bn::display::width()) / 2;
+        int first_y_limit = (first_bg.dimensions().height() - bn::display::height()) / 2;
+        int second_x_limit = (second_bg.dimensions().width() - bn::display::width()) / 2;
+        int second_y_limit = (second_bg.dimensions().height() - bn::display::height()) / 2;
+        int x_limit = bn::min(first_x_limit, second_x_limit) - 8;
+        int y_limit = bn::min(first_y_limit, second_y_limit) - 8;
+        bn::vector<bn::sprite_ptr, 16> text_sprites;
+        int x = 0;
+        int y = 0;
+        int x_inc = 8;
+        int y_inc = 0;
+        int frames = -1;
+        int ticks = 0;
+
+        while(! bn::keypad::start_pressed())
+        {
+            x += x_inc;
+            y += y_inc;
+
+            if(x_inc && bn::abs(x) >= x_limit)
+            {
+                x_inc = -x_inc;
+            }
+
+            if(y_inc && bn::abs(y) >= y_limit)
+            {
+                y_inc = -y_inc;
+            }
+
+            first_bg.set_position(x, y);
+            second_bg.set_position(x, y);
+            info.update();
+            bn::core::update();
+
+            // The first frame commits the full maps, so it is not measured:
+            if(frames >= 0)
+            {
+                ticks += bn::core::last_frame_breakdown().ticks(bn::frame_stage::BIG_MAPS_COMMIT);
+            }
+
+            ++frames;
+
+            if(frames == 64)
+            {
+                // Each frame updates one column or one row of each BG:
+                bn::string<32> text;
+                bn::ostringstream text_stream(text);
+                text_stream.append(x_inc ? "Ticks per column: " : "Ticks per row: ");
+                text_stream.append(ticks / 128);
+                text_sprites.clear();
+                text_generator.generate(0, 0, text, text_sprites);
+
+                bn::swap(x_inc, y_inc);
+                frames = 0;
+                ticks = 0;
+            }
+        }
+    }
 }
 
 int main()
@@ -70,9 +146,15 @@ int main()
 
     while(true)
     {
+        streaming_benchmark_scene(text_generator);
+        bn::core::update();
+
         big_map_scene("1024x512 BPP8 regular BG", bn::regular_bg_items::big_map_8, text_generator);
         bn::core::update();
 
+        big_map_scene("1024x512 BPP4 metatiles regular BG", bn::regular_bg_items::metatile_map, text_generator);
+        bn::core::update();
+
         big_map_scene("1280x768 BPP4 regular BG", bn::regular_bg_items::big_map_4, text_generator);
         bn::core::update();
 
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#ifndef UNORDERED_TESTS_H
+#define UNORDERED_TESTS_H
+
+#include "bn_unordered_set.h"
+#include "bn_unordered_map.h"
+#include "tests.h"
+
+// Identity hash, so the home index of each key is known and collision chains can be built on purpose:
+struct unordered_tests_hash
+{
+    [[nodiscard]] unsigned operator()(int value) const
+    {
+        return unsigned(value);
+    }
+};
+
+class unordered_tests : public tests
+{
+
+public:
+    unordered_tests() :
+        tests("unordered")
+    {
+        _erase_tests<map_type>();
+        _erase_tests<set_type>();
+    }
+
+private:
+    using map_type = bn::unordered_map<int, int, 8, unordered_tests_hash>;
+    using set_type = bn::unordered_set<int, 8, unordered_tests_hash>;
+
+    template<typename Container>
+    static void _erase_tests()
+    {
+        // Key 9 collides with key 1 and it is placed after key 2, which is in its home index:
+        Container container;
+        _insert(container, { 1, 2, 9 });
+        BN_ASSERT(container.erase(1));
+        _check(container, { 2, 9 }, 1);
+
+        // Keys 1, 9 and 17 collide in index 1, and key 2 is placed after them (index 4):
+        container.clear();
+        _insert(container, { 1, 9, 17, 2 });
+        BN_ASSERT(container.erase(9));
+        _check(container, { 1, 17, 2 }, 9);
+
+        BN_ASSERT(container.erase(1));
+        _check(container, { 17, 2 }, 1);
+
+        // Key 15 collides with key 7 and it wraps around after key 0, which is in its home index:
+        container.clear();
+        _insert(container, { 7, 0, 15 });
+        BN_ASSERT(container.erase(7));
+        _check(container, { 0, 15 }, 7);
+
+        // Keys 7, 15 and 23 collide in index 7 and wrap around to indexes 0 and 1,
+        // and key 0 is placed after them (index 2):
+        container.clear();
+        _insert(container, { 7, 15, 23, 0 });
+        BN_ASSERT(container.erase(7));
+        _check(container, { 15, 23, 0 }, 7);
+
+        BN_ASSERT(container.erase(23));
+        _check(container, { 15, 0 }, 23);
+
+        // Last element of a wrapped around chain:
+        container.clear();
+        _insert(container, { 7, 15, 23, 0 });
+        BN_ASSERT(container.erase(0));
+        _check(container, { 7, 15, 23 }, 0);
+
+        // Erased keys can be inserted again:
+        _insert(container, { 0 });
+        BN_ASSERT(container.erase(15));
+        _check(container, { 7, 23, 0 }, 15);
+    }
+
+    template<int Size>
+    static void _insert(map_type& map, const int (&keys)[Size])
+    {
+        for(int key : keys)
+        {
+            map.insert(key, key * 100);
+        }
+    }
+
+    template<int Size>
+    static void _insert(set_type& set, const int (&keys)[Size])
+    {
+        for(int key : keys)
+        {
+            set.insert(key);
+        }
+    }
+
+    template<int Size>
+    static void _check(const map_type& map, const int (&keys)[Size], int erased_key)
+    {
+        BN_ASSERT(map.size() == Size, "Invalid size: ", map.size(), " - ", Size);
+
+        for(int key : keys)
+        {
+            auto it = map.find(key);
+            BN_ASSERT(it != map.end(), "Key not found: ", key);
+            BN_ASSERT(it->second == key * 100, "Invalid value: ", it->second, " - ", key);
+        }
+
+        BN_ASSERT(map.find(erased_key) == map.end(), "Erased key found: ", erased_key);
+    }
+
+    template<int Size>
+    static void _check(const set_type& set, const int (&keys)[Size], int erased_key)
+    {
+        BN_ASSERT(set.size() == Size, "Invalid size: ", set.size(), " - ", Size);
+
+        for(int key : keys)
+        {
+            BN_ASSERT(set.find(key) != set.end(), "Key not found: ", key);
+        }
+
+        BN_ASSERT(set.find(erased_key) == set.end(), "Erased key found: ", erased_key);
+    }
+};
+
+#endif
@@ -18,6 +18,7 @@
 #include "any_tests.h"
 #include "format_tests.h"
 #include "malloc_tests.h"
+#include "unordered_tests.h"
 #include "sram_tests.h"
 #include "variable_8x16_sprite_font.h"
 
@@ -43,6 +44,7 @@ int main()
     any_tests();
     format_tests();
     malloc_tests();
+    unordered_tests();
     sram_tests sram_tests;
 
     if(sram_tests.again())
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include "bn_core.h"
+#include "bn_array.h"
+#include "bn_timer.h"
+#include "bn_colors.h"
+#include "bn_string.h"
+#include "bn_timers.h"
+#include "bn_vector.h"
+#include "bn_display.h"
+#include "bn_sprite_ptr.h"
+#include "bn_bg_palettes.h"
+#include "bn_config_hbes.h"
+#include "bn_bg_palette_ptr.h"
+#include "bn_bg_palette_item.h"
+#include "bn_sprite_text_generator.h"
+#include "bn_bg_palette_color_hbe_ptr.h"
+
+#include "variable_8x16_sprite_font.h"
+
+namespace
+{
+    constexpr const int max_effects = 8;
+    constexpr const int measured_frames = 4;
+
+    bn::array<bn::color, bn::display::height()> effects_colors[max_effects];
+    volatile int busy_loop_output;
+
+    [[nodiscard]] int busy_loop_ticks(int iterations)
+    {
+        // Measure starts just after V-Blank, with the H-Blank effects already committed:
+        bn::core::update();
+        bn::core::update();
+
+        bn::timer timer;
+
+        for(int index = 0; index < iterations; ++index)
+        {
+            busy_loop_output = index;
+        }
+
+        return timer.elapsed_ticks();
+    }
+
+    [[nodiscard]] int calibrate_iterations()
+    {
+        int iterations = 1024 * 16;
+        int ticks = busy_loop_ticks(iterations);
+        return int((int64_t(iterations) * measured_frames * bn::timers::ticks_per_frame()) / ticks);
+    }
+
+    [[nodiscard]] int hblank_effects_cycles(const bn::bg_palette_ptr& palette, int effects_count, int iterations,
+                                            int base_ticks)
+    {
+        bn::vector<bn::bg_palette_color_hbe_ptr, max_effects> effects;
+
+        for(int index = 0; index < effects_count; ++index)
+        {
+            effects.push_back(bn::bg_palette_color_hbe_ptr::create(palette, index + 1, effects_colors[index]));
+        }
+
+        // Interrupts and DMA transfers delay the busy loop, so its extra time is distributed between the frames:
+        int ticks = busy_loop_ticks(iterations);
+        int64_t extra_cycles = int64_t(ticks - base_ticks) * bn::timers::cpu_clocks_per_tick();
+        return int((extra_cycles * bn::timers::ticks_per_frame()) / ticks);
+    }
+}
+
+int main()
+{
+    bn::core::init();
+
+    bn::sprite_text_generator text_generator(variable_8x16_sprite_font);
+    text_generator.set_center_alignment();
+    bn::bg_palettes::set_transparent_color(bn::colors::gray);
+
+    bn::vector<bn::sprite_ptr, 32> text_sprites;
+    text_generator.generate(0, 0, "Running tests...", text_sprites);
+
+    // Each effect changes its color in every screen line, so the H-Blank interrupt is raised in all of them:
+    for(int effect_index = 0; effect_index < max_effects; ++effect_index)
+    {
+        for(int line = 0; line < bn::display::height(); ++line)
+        {
+            effects_colors[effect_index][line] = bn::color((line + effect_index) % 32, line % 32, effect_index * 4);
+        }
+    }
+
+    bn::array<bn::color, 16> palette_colors;
+    bn::bg_palette_ptr palette = bn::bg_palette_item(palette_colors, bn::bpp_mode::BPP_4).create_new_palette();
+
+    int iterations = calibrate_iterations();
+    int base_ticks = busy_loop_ticks(iterations);
+    constexpr const int effects_counts[] = { 1, 4, max_effects };
+    int cycles[3];
+
+    for(int index = 0; index < 3; ++index)
+    {
+        cycles[index] = hblank_effects_cycles(palette, effects_counts[index], iterations, base_ticks);
+    }
+
+    text_sprites.clear();
+    text_generator.generate(0, -48, "H-Blank effects cycles per frame", text_sprites);
+    text_generator.generate(0, -32, BN_CFG_HBES_DMA_ENABLED ? "(DMA enabled)" : "(DMA disabled)", text_sprites);
+
+    for(int index = 0; index < 3; ++index)
+    {
+        bn::string<32> text;
+        bn::ostringstream text_stream(text);
+        text_stream.append(effects_counts[index]);
+        text_stream.append(effects_counts[index] == 1 ? " effect: " : " effects: ");
+        text_stream.append(cycles[index]);
+        text_generator.generate(0, (index * 16) - 8, text, text_sprites);
+    }
+
+    while(true)
+    {
+        bn::core::update();
+    }
+}
@@ -0,0 +1,748 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include "bn_core.h"
+#include "bn_random.h"
+#include "bn_vector.h"
+#include "bn_audio_mixing_rate.h"
+#include "../hw/include/bn_hw_tonc.h"
+#include "../hw/include/bn_hw_audio_mixer.h"
+
+// Mixes several scenarios with the native audio backend mixer and checks its output bit-exactly against the golden
+// WAV files of the golden folder.
+//
+// Golden files are generated by the reference mixer of this test, which is a straightforward implementation of the
+// same mixing rules: run with --update to write them again.
+//
+// It also checks with a cycle level model of timer 0, the sound FIFOs and the sound DMA transfers that restarting
+// them in each V-Blank interrupt plays each output buffer exactly once, without FIFO underruns nor drift.
+
+namespace
+{
+    namespace mixer = bn::hw::audio_mixer;
+
+    // Containers have a fixed capacity, since global new and delete use the (small) butano EWRAM heap:
+    constexpr const int max_sample_words = 2048;
+    constexpr const int max_sounds = 8;
+    constexpr const int max_output_samples = 8192;
+    constexpr const int max_file_bytes = max_output_samples + 64;
+
+    // Upper bounds of the CPU cycles taken by audio_mixer::restart_sound_dma (including the sound DMA transfers
+    // requested during it) and by the first V-Blank interrupt from the end of the restart to the start of timer 0:
+    constexpr const int restart_cycles = 96;
+    constexpr const int timer_start_cycles = 64;
+
+    constexpr const int fifo_model_frames = 600;
+    constexpr const int fifo_bytes = 32;
+    constexpr const int fifo_refill_bytes = 16;
+    constexpr const int max_buffer_size = 528;
+    constexpr const int8_t padding_sample = -128;
+
+    using output_vector = bn::vector<int8_t, max_output_samples>;
+    using file_vector = bn::vector<uint8_t, max_file_bytes>;
+
+    constexpr const int adpcm_steps[] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+        107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+        876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+        4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+        22385, 24623, 27086, 29794, 32767
+    };
+
+    constexpr const int adpcm_step_index_deltas[] = {
+        -1, -1, -1, -1, 2, 4, 6, 8
+    };
+
+
+    class adpcm_state
+    {
+
+    public:
+        int value = 0;
+        int step_index = 0;
+
+        int decode(int code)
+        {
+            int step = adpcm_steps[step_index];
+            int delta = step >> 3;
+
+            if(code & 1)
+            {
+                delta += step >> 2;
+            }
+
+            if(code & 2)
+            {
+                delta += step >> 1;
+            }
+
+            if(code & 4)
+            {
+                delta += step;
+            }
+
+            value = code & 8 ? std::max(value - delta, -32768) : std::min(value + delta, 32767);
+            step_index = std::min(std::max(step_index + adpcm_step_index_deltas[code & 7], 0), 88);
+            return value;
+        }
+
+        int encode(int sample)
+        {
+            int step = adpcm_steps[step_index];
+            int difference = sample - value;
+            int code = 0;
+
+            if(difference < 0)
+            {
+                code = 8;
+                difference = -difference;
+            }
+
+            for(int bit = 4; bit; bit >>= 1)
+            {
+                if(difference >= step)
+                {
+                    code |= bit;
+                    difference -= step;
+                }
+
+                step >>= 1;
+            }
+
+            decode(code);
+            return code;
+        }
+    };
+
+
+    // Sample stored as in a native sound bank:
+    class test_sample
+    {
+
+    public:
+        bn::vector<uint32_t, max_sample_words> words;
+
+        template<typename Generator>
+        test_sample(mixer::sample_format format, int frequency, int length, const Generator& generator)
+        {
+            mixer::sample_header header = {};
+            header.length = uint32_t(length);
+            header.frequency = uint32_t(frequency);
+            header.format = format;
+
+            int data_size = format == mixer::sample_format::PCM_8 ? length : (length + 1) / 2;
+            words.resize(int(sizeof(header) + unsigned(data_size) + 3) / 4);
+            std::memcpy(words.data(), &header, sizeof(header));
+
+            uint8_t* data = reinterpret_cast<uint8_t*>(words.data()) + sizeof(header);
+
+            if(format == mixer::sample_format::PCM_8)
+            {
+                for(int index = 0; index < length; ++index)
+                {
+                    data[index] = uint8_t(generator(index) >> 8);
+                }
+            }
+            else
+            {
+                adpcm_state state;
+
+                for(int index = 0; index < length; index += 2)
+                {
+                    int low_code = state.encode(generator(index));
+                    int high_code = index + 1 < length ? state.encode(generator(index + 1)) : 0;
+                    data[index / 2] = uint8_t(low_code | (high_code << 4));
+                }
+            }
+        }
+
+        [[nodiscard]] const mixer::sample_header& header() const
+        {
+            return *reinterpret_cast<const mixer::sample_header*>(words.data());
+        }
+    };
+
+
+    class test_sound
+    {
+
+    public:
+        const test_sample* sample;
+        int start_frame;
+        int volume;
+        int speed;
+        int panning;
+    };
+
+
+    class scenario
+    {
+
+    public:
+        const char* name;
+        int mixing_rate;
+        int frames;
+        test_sound sounds[max_sounds];
+
+        [[nodiscard]] int sounds_count() const
+        {
+            int result = 0;
+
+            while(result < max_sounds && sounds[result].sample)
+            {
+                ++result;
+            }
+
+            return result;
+        }
+    };
+
+
+    [[nodiscard]] auto saw_generator(int period, int amplitude)
+    {
+        return [=](int index)
+        {
+            return ((index % period) * 2 * amplitude) / period - amplitude;
+        };
+    }
+
+    [[nodiscard]] auto square_generator(int period, int amplitude)
+    {
+        return [=](int index)
+        {
+            return index % period < period / 2 ? amplitude : -amplitude;
+        };
+    }
+
+    [[nodiscard]] auto triangle_generator(int period, int amplitude)
+    {
+        return [=](int index)
+        {
+            int phase = index % period;
+            int half_period = period / 2;
+            int value = phase < half_period ? phase : period - phase;
+            return (value * 2 * amplitude) / half_period - amplitude;
+        };
+    }
+
+
+    // Interleaved stereo output (left first):
+    void reference_mix(const scenario& scenario, output_vector& output)
+    {
+        int buffer_size = mixer::buffer_size(scenario.mixing_rate);
+        int timer_period = mixer::frame_cycles() / buffer_size;
+
+        // Samples are decoded from the beginning one by one, so each value is played as it is stored:
+        class reference_channel
+        {
+
+        public:
+            const mixer::sample_header* header = nullptr;
+            adpcm_state decoder;
+            unsigned decoded_samples = 0;
+            int value = 0;
+            unsigned position = 0;
+            unsigned step = 0;
+            int left_volume = 0;
+            int right_volume = 0;
+            bool active = false;
+
+            [[nodiscard]] int sample_value(unsigned sample_index)
+            {
+                auto data = reinterpret_cast<const uint8_t*>(header + 1);
+
+                if(header->format == mixer::sample_format::PCM_8)
+                {
+                    return int8_t(data[sample_index]);
+                }
+
+                while(decoded_samples <= sample_index)
+                {
+                    int code = (data[decoded_samples / 2] >> ((decoded_samples % 2) * 4)) & 15;
+                    value = decoder.decode(code) >> 8;
+                    ++decoded_samples;
+                }
+
+                return value;
+            }
+        };
+
+        reference_channel channels[max_sounds];
+        output.clear();
+
+        for(int frame = 0; frame < scenario.frames; ++frame)
+        {
+            for(int index = 0, limit = scenario.sounds_count(); index < limit; ++index)
+            {
+                const test_sound& sound = scenario.sounds[index];
+
+                if(sound.start_frame == frame)
+                {
+                    reference_channel& channel = channels[index];
+                    uint64_t step = (uint64_t(sound.sample->header().frequency) * unsigned(sound.speed) *
+                                     unsigned(timer_period)) / (uint64_t(1) << 22);
+                    channel = reference_channel();
+                    channel.header = &sound.sample->header();
+                    channel.step = std::max(unsigned(step), 1U);
+                    channel.left_volume = sound.panning <= 128 ? sound.volume :
+                                                                 sound.volume * (255 - sound.panning) / 128;
+                    channel.right_volume = sound.panning >= 128 ? sound.volume : sound.volume * sound.panning / 128;
+                    channel.active = true;
+                }
+            }
+
+            for(int index = 0; index < buffer_size; ++index)
+            {
+                int left = 0;
+                int right = 0;
+
+                for(reference_channel& channel : channels)
+                {
+                    if(channel.active)
+                    {
+                        int value = channel.sample_value(channel.position / 4096);
+                        left += (value * channel.left_volume) >> 4;
+                        right += (value * channel.right_volume) >> 4;
+                        channel.position += channel.step;
+                        channel.active = channel.position / 4096 < channel.header->length;
+                    }
+                }
+
+                output.push_back(int8_t(std::clamp(left >> 4, -128, 127)));
+                output.push_back(int8_t(std::clamp(right >> 4, -128, 127)));
+            }
+        }
+    }
+
+    void mixer_mix(const scenario& scenario, output_vector& output, long long& mix_nanoseconds)
+    {
+        int buffer_size = mixer::buffer_size(scenario.mixing_rate);
+        mixer::channel channels[max_sounds];
+        alignas(int) int16_t accumulators[max_buffer_size * 2];
+        int8_t left_output[max_buffer_size];
+        int8_t right_output[max_buffer_size];
+        output.clear();
+        mix_nanoseconds = 0;
+
+        for(int frame = 0; frame < scenario.frames; ++frame)
+        {
+            for(int index = 0, limit = scenario.sounds_count(); index < limit; ++index)
+            {
+                const test_sound& sound = scenario.sounds[index];
+
+                if(sound.start_frame == frame)
+                {
+                    channels[index].start(sound.sample->header(), sound.volume, sound.speed, sound.panning,
+                                          scenario.mixing_rate);
+                }
+            }
+
+            timespec start;
+            timespec end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            mixer::mix(channels, scenario.sounds_count(), buffer_size, accumulators, left_output, right_output);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            mix_nanoseconds += (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
+
+            for(int index = 0; index < buffer_size; ++index)
+            {
+                output.push_back(left_output[index]);
+                output.push_back(right_output[index]);
+            }
+        }
+    }
+
+
+    // Variation of the V-Blank interrupt latency allowed by the timer 0 overflows of the given mixing rate,
+    // which are half a period away from the restarts of the sound DMA transfers:
+    [[nodiscard]] int max_latency_jitter(int mixing_rate)
+    {
+        return (mixer::timer_period(mixing_rate) / 2) - restart_cycles - timer_start_cycles - 1;
+    }
+
+    [[nodiscard]] int8_t model_sample(int frame, int index)
+    {
+        return int8_t(((frame * 37) + (index * 5)) & 127);
+    }
+
+    // One Direct Sound output: each timer 0 overflow plays the first sample of the FIFO,
+    // and the sound DMA transfer refills it with 16 bytes when it has 16 bytes or less.
+    // The restart of each V-Blank interrupt begins between 0 and latency_jitter cycles after the start of V-Blank.
+    // If dma_request_on_enable is true, the sound DMA transfer also refills the FIFO as soon as it is enabled.
+    // Returns the description of the first error found, or nullptr if there's none:
+    [[nodiscard]] const char* run_fifo_model(int mixing_rate, int latency_jitter, bool dma_request_on_enable,
+                                             bn::random& random, int& error_frame)
+    {
+        int buffer_size = mixer::buffer_size(mixing_rate);
+        int timer_period = mixer::timer_period(mixing_rate);
+        int padded_buffer_size = buffer_size + mixer::output_buffer_padding();
+        int8_t buffers[2][max_buffer_size + mixer::output_buffer_padding()];
+        bn::vector<int8_t, fifo_bytes> fifo;
+        long long next_overflow = 0;
+        const int8_t* dma_buffer = nullptr;
+        int dma_position = 0;
+        int played_samples = 0;
+
+        auto refill_fifo = [&]()
+        {
+            if(dma_position + fifo_refill_bytes > padded_buffer_size)
+            {
+                return false;
+            }
+
+            for(int index = 0; index < fifo_refill_bytes; ++index)
+            {
+                fifo.push_back(dma_buffer[dma_position + index]);
+            }
+
+            dma_position += fifo_refill_bytes;
+            return true;
+        };
+
+        for(int frame = 0; frame < fifo_model_frames; ++frame)
+        {
+            int latency = int(random.get() % unsigned(latency_jitter + 1));
+            long long restart_start = (frame * mixer::frame_cycles()) + latency;
+            long long restart_end = restart_start + restart_cycles;
+
+            if(frame && next_overflow < restart_end)
+            {
+                error_frame = frame;
+                return "timer 0 overflow during restart";
+            }
+
+            if(frame && played_samples != buffer_size)
+            {
+                error_frame = frame;
+                return "invalid played samples count";
+            }
+
+            // The buffer played in this frame was mixed in the previous one:
+            int8_t* buffer = buffers[frame % 2];
+
+            for(int index = 0; index < buffer_size; ++index)
+            {
+                buffer[index] = model_sample(frame, index);
+            }
+
+            std::fill(buffer + buffer_size, buffer + padded_buffer_size, padding_sample);
+
+            // audio_mixer::restart_sound_dma:
+            fifo.clear();
+
+            for(int index = 0; index < mixer::fifo_prime_words() * 4; ++index)
+            {
+                fifo.push_back(buffer[index]);
+            }
+
+            dma_buffer = buffer;
+            dma_position = mixer::fifo_prime_words() * 4;
+
+            if(dma_request_on_enable && fifo.size() <= fifo_refill_bytes)
+            {
+                (void) refill_fifo();
+            }
+
+            played_samples = 0;
+
+            if(! frame)
+            {
+                next_overflow = restart_end + timer_start_cycles + mixer::first_overflow_delay(mixing_rate);
+            }
+
+            for(long long next_restart = (frame + 1) * mixer::frame_cycles(); next_overflow < next_restart;
+                next_overflow += timer_period)
+            {
+                if(fifo.empty())
+                {
+                    error_frame = frame;
+                    return "FIFO underrun";
+                }
+
+                if(played_samples == buffer_size || fifo.front() != model_sample(frame, played_samples))
+                {
+                    error_frame = frame;
+                    return "invalid played sample";
+                }
+
+                fifo.erase(fifo.begin());
+                ++played_samples;
+
+                if(fifo.size() <= fifo_refill_bytes && ! refill_fifo())
+                {
+                    error_frame = frame;
+                    return "sound DMA transfer out of output buffer";
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    [[nodiscard]] int check_restart_sound_dma()
+    {
+        alignas(int) static int8_t left_output[64];
+        alignas(int) static int8_t right_output[64];
+        unsigned direct_sound_control = SDS_A100 | SDS_AR | SDS_B100 | SDS_BL;
+        unsigned dma_control = DMA_DST_FIXED | DMA_REPEAT | DMA_32 | DMA_AT_FIFO | DMA_ENABLE;
+        mixer::restart_sound_dma(direct_sound_control, left_output, right_output);
+
+        // Direct Sound A is played by DMA channel 1 and Direct Sound B by DMA channel 2:
+        bool valid = REG_SNDDSCNT == (direct_sound_control | SDS_ARESET | SDS_BRESET) &&
+                REG_DMA[1].src == right_output + 16 && REG_DMA[1].dst == &REG_FIFO_A && REG_DMA[1].cnt == dma_control &&
+                REG_DMA[2].src == left_output + 16 && REG_DMA[2].dst == &REG_FIFO_B && REG_DMA[2].cnt == dma_control;
+        REG_DMA[1].cnt = 0;
+        REG_DMA[2].cnt = 0;
+
+        if(! valid)
+        {
+            std::printf("restart_sound_dma: invalid registers\n");
+            return 1;
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int check_fifo_model()
+    {
+        constexpr const int mixing_rates[] = {
+            BN_AUDIO_MIXING_RATE_8_KHZ, BN_AUDIO_MIXING_RATE_10_KHZ, BN_AUDIO_MIXING_RATE_13_KHZ,
+            BN_AUDIO_MIXING_RATE_16_KHZ, BN_AUDIO_MIXING_RATE_18_KHZ, BN_AUDIO_MIXING_RATE_21_KHZ,
+            BN_AUDIO_MIXING_RATE_27_KHZ, BN_AUDIO_MIXING_RATE_31_KHZ
+        };
+
+        bn::random random;
+        int errors = 0;
+
+        for(int mixing_rate : mixing_rates)
+        {
+            int buffer_size = mixer::buffer_size(mixing_rate);
+            int latency_jitter = max_latency_jitter(mixing_rate);
+
+            if(buffer_size * mixer::timer_period(mixing_rate) != mixer::frame_cycles() || buffer_size % 4)
+            {
+                std::printf("Mixing rate %d: buffer size is not frame locked: %d\n", mixing_rate, buffer_size);
+                ++errors;
+            }
+
+            for(bool dma_request_on_enable : { false, true })
+            {
+                int error_frame = 0;
+
+                if(const char* error = run_fifo_model(mixing_rate, latency_jitter, dma_request_on_enable, random,
+                                                      error_frame))
+                {
+                    std::printf("Mixing rate %d, frame %d: %s\n", mixing_rate, error_frame, error);
+                    ++errors;
+                }
+            }
+
+            // Restarts which can't keep up with timer 0 must be detected:
+            int error_frame = 0;
+
+            if(! run_fifo_model(mixing_rate, mixer::timer_period(mixing_rate), false, random, error_frame))
+            {
+                std::printf("Mixing rate %d: invalid restart not detected\n", mixing_rate);
+                ++errors;
+            }
+
+            std::printf("%-20s %6d Hz %3d samples per frame, max latency jitter: %4d cycles\n", "fifo_model",
+                        16777216 / mixer::timer_period(mixing_rate), buffer_size, latency_jitter);
+        }
+
+        return errors;
+    }
+
+
+    void write_le(file_vector& output, uint32_t value, int bytes)
+    {
+        for(int index = 0; index < bytes; ++index)
+        {
+            output.push_back(uint8_t(value >> (index * 8)));
+        }
+    }
+
+    void write_tag(file_vector& output, const char* tag)
+    {
+        for(int index = 0; index < 4; ++index)
+        {
+            output.push_back(uint8_t(tag[index]));
+        }
+    }
+
+    // 8 bits unsigned stereo WAV file:
+    void wav_file(const scenario& scenario, const output_vector& samples, file_vector& output)
+    {
+        auto frequency = uint32_t(16777216 / mixer::timer_period(scenario.mixing_rate));
+        auto data_size = uint32_t(samples.size());
+        output.clear();
+        write_tag(output, "RIFF");
+        write_le(output, 36 + data_size, 4);
+        write_tag(output, "WAVE");
+        write_tag(output, "fmt ");
+        write_le(output, 16, 4);
+        write_le(output, 1, 2);
+        write_le(output, 2, 2);
+        write_le(output, frequency, 4);
+        write_le(output, frequency * 2, 4);
+        write_le(output, 2, 2);
+        write_le(output, 8, 2);
+        write_tag(output, "data");
+        write_le(output, data_size, 4);
+
+        for(int8_t sample : samples)
+        {
+            output.push_back(uint8_t(sample + 128));
+        }
+    }
+
+    [[nodiscard]] bool read_file(const char* path, file_vector& output)
+    {
+        FILE* file = std::fopen(path, "rb");
+        output.clear();
+
+        if(! file)
+        {
+            return false;
+        }
+
+        int character;
+
+        while(! output.full() && (character = std::fgetc(file)) != EOF)
+        {
+            output.push_back(uint8_t(character));
+        }
+
+        std::fclose(file);
+        return true;
+    }
+
+    [[nodiscard]] bool write_file(const char* path, const file_vector& data)
+    {
+        FILE* file = std::fopen(path, "wb");
+
+        if(! file)
+        {
+            return false;
+        }
+
+        bool result = std::fwrite(data.data(), 1, size_t(data.size()), file) == size_t(data.size());
+        std::fclose(file);
+        return result;
+    }
+
+    [[nodiscard]] int mismatches(const file_vector& a, const file_vector& b)
+    {
+        int result = a.size() == b.size() ? 0 : 1;
+
+        for(int index = 0, limit = std::min(a.size(), b.size()); index < limit; ++index)
+        {
+            result += a[index] != b[index];
+        }
+
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bn::core::init();
+
+    bool update = argc > 1 && std::strcmp(argv[1], "--update") == 0;
+
+    static const test_sample pcm_saw(mixer::sample_format::PCM_8, 8000, 3000, saw_generator(40, 30000));
+    static const test_sample pcm_square(mixer::sample_format::PCM_8, 11025, 2000, square_generator(50, 20000));
+    static const test_sample pcm_short(mixer::sample_format::PCM_8, 16000, 700, triangle_generator(64, 32000));
+    static const test_sample adpcm_triangle(mixer::sample_format::IMA_ADPCM, 8000, 2501,
+                                            triangle_generator(90, 28000));
+    static const test_sample adpcm_square(mixer::sample_format::IMA_ADPCM, 22050, 6000,
+                                          square_generator(100, 16000));
+
+    static const scenario scenarios[] = {
+        { "pcm_centered", BN_AUDIO_MIXING_RATE_16_KHZ, 8, {
+            { &pcm_saw, 0, 255, 1024, 128 }
+        } },
+        { "pcm_speed_panning", BN_AUDIO_MIXING_RATE_16_KHZ, 12, {
+            { &pcm_saw, 0, 200, 512, 0 },
+            { &pcm_square, 1, 255, 1792, 255 },
+            { &pcm_short, 3, 128, 1000, 64 },
+            { &pcm_short, 4, 90, 3000, 200 }
+        } },
+        { "adpcm", BN_AUDIO_MIXING_RATE_16_KHZ, 12, {
+            { &adpcm_triangle, 0, 255, 1024, 128 },
+            { &adpcm_square, 2, 180, 1331, 200 },
+            { &adpcm_triangle, 5, 140, 4500, 30 }
+        } },
+        { "saturation", BN_AUDIO_MIXING_RATE_31_KHZ, 6, {
+            { &pcm_saw, 0, 255, 1024, 128 },
+            { &pcm_square, 0, 255, 1024, 128 },
+            { &pcm_short, 0, 255, 700, 0 },
+            { &pcm_short, 1, 255, 1300, 255 },
+            { &adpcm_triangle, 0, 255, 2048, 128 },
+            { &adpcm_square, 1, 255, 512, 128 },
+            { &adpcm_square, 2, 255, 900, 100 },
+            { &pcm_saw, 2, 255, 64, 160 }
+        } },
+        { "low_rate", BN_AUDIO_MIXING_RATE_8_KHZ, 10, {
+            { &pcm_square, 0, 255, 1024, 128 },
+            { &adpcm_triangle, 0, 100, 1024, 50 }
+        } }
+    };
+
+    static output_vector output;
+    static file_vector reference_wav;
+    static file_vector mixer_wav;
+    static file_vector golden_wav;
+    int errors = 0;
+
+    if(! update)
+    {
+        errors += check_restart_sound_dma();
+        errors += check_fifo_model();
+    }
+
+    for(const scenario& scenario : scenarios)
+    {
+        char golden_path[64];
+        std::snprintf(golden_path, sizeof(golden_path), "golden/%s.wav", scenario.name);
+        reference_mix(scenario, output);
+        wav_file(scenario, output, reference_wav);
+
+        if(update)
+        {
+            if(! write_file(golden_path, reference_wav))
+            {
+                std::printf("%-20s golden file write failed: %s\n", scenario.name, golden_path);
+                ++errors;
+            }
+
+            continue;
+        }
+
+        long long mix_nanoseconds;
+        mixer_mix(scenario, output, mix_nanoseconds);
+        wav_file(scenario, output, mixer_wav);
+
+        if(! read_file(golden_path, golden_wav))
+        {
+            std::printf("%-20s golden file not found: %s\n", scenario.name, golden_path);
+            ++errors;
+            continue;
+        }
+
+        int reference_mismatches = mismatches(reference_wav, golden_wav);
+        int mixer_mismatches = mismatches(mixer_wav, golden_wav);
+        errors += reference_mismatches + mixer_mismatches;
+        std::printf("%-20s reference mismatches: %6d mixer mismatches: %6d %10lld ns/frame\n", scenario.name,
+                    reference_mismatches, mixer_mismatches, mix_nanoseconds / scenario.frames);
+    }
+
+    std::printf("Errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
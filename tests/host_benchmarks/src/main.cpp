@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include "bn_core.h"
+#include "bn_math.h"
+#include "bn_vector.h"
+#include "bn_display.h"
+#include "bn_camera_ptr.h"
+#include "bn_sprite_ptr.h"
+#include "bn_bg_palettes.h"
+#include "bn_sprite_item.h"
+#include "bn_sprite_batch.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_sprite_palettes.h"
+#include "bn_regular_bg_item.h"
+#include "bn_frame_breakdown.h"
+#include "bn_regular_bg_position_hbe_ptr.h"
+
+namespace
+{
+    constexpr const int warmup_frames = 60;
+    constexpr const int measured_frames = 600;
+
+    constexpr const bn::tile sprite_tiles[16] = {};
+    constexpr const bn::color sprite_colors[16] = {};
+    constexpr const bn::sprite_item sprite_item(
+            bn::sprite_shape_size(bn::sprite_shape::SQUARE, bn::sprite_size::BIG), sprite_tiles, sprite_colors,
+            bn::bpp_mode::BPP_4, 1);
+
+    constexpr const bn::tile bg_tiles[4] = {};
+    constexpr const bn::color bg_colors[16] = {};
+    constexpr const bn::regular_bg_map_cell bg_cells[32 * 32] = {};
+    constexpr const bn::regular_bg_item bg_item(
+            bn::span<const bn::tile>(bg_tiles), bg_colors, bn::bpp_mode::BPP_4, bg_cells[0], bn::size(32, 32));
+
+
+    // Updates the given number of frames and prints the average host time and timer ticks per frame:
+    template<typename UpdateFunction>
+    void run_benchmark(const char* name, const UpdateFunction& update_function)
+    {
+        using clock = std::chrono::steady_clock;
+
+        for(int index = 0; index < warmup_frames; ++index)
+        {
+            update_function(index);
+            bn::core::update();
+        }
+
+        long long update_ticks = 0;
+        long long commit_ticks = 0;
+        clock::time_point start = clock::now();
+
+        for(int index = 0; index < measured_frames; ++index)
+        {
+            update_function(index);
+            bn::core::update();
+
+            const bn::frame_breakdown& breakdown = bn::core::last_frame_breakdown();
+            update_ticks += breakdown.update_ticks();
+            commit_ticks += breakdown.commit_ticks();
+        }
+
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+        std::printf("%-24s %12lld ns/frame %10.2f update ticks/frame %10.2f commit ticks/frame\n", name,
+                    static_cast<long long>(nanoseconds / measured_frames), double(update_ticks) / measured_frames,
+                    double(commit_ticks) / measured_frames);
+    }
+
+    void sprites_benchmark()
+    {
+        bn::vector<bn::sprite_ptr, 128> sprites;
+
+        for(int index = 0; index < sprites.max_size(); ++index)
+        {
+            bn::sprite_ptr sprite = sprite_item.create_sprite((index % 16) * 16 - 120, (index / 16) * 20 - 80);
+            sprite.set_z_order(index % 4);
+            sprites.push_back(bn::move(sprite));
+        }
+
+        run_benchmark("128 moving sprites", [&sprites](int frame) {
+            for(bn::sprite_ptr& sprite : sprites)
+            {
+                sprite.set_x(sprite.x() + (frame % 2 ? 1 : -1));
+            }
+        });
+    }
+
+    void sprite_batch_benchmark()
+    {
+        bn::sprite_batch<128> batch(sprite_item);
+        bn::fixed_point positions[128];
+
+        for(int index = 0; index < batch.max_size(); ++index)
+        {
+            positions[index] = bn::fixed_point((index % 16) * 16 - 120, (index / 16) * 20 - 80);
+        }
+
+        run_benchmark("128 batch sprites", [&batch, &positions](int frame) {
+            for(bn::fixed_point& position : positions)
+            {
+                position.set_x(position.x() + (frame % 2 ? 1 : -1));
+            }
+
+            batch.set_positions(positions);
+        });
+    }
+
+    void camera_sprites_benchmark()
+    {
+        bn::camera_ptr camera = bn::camera_ptr::create(0, 0);
+        bn::vector<bn::sprite_ptr, 128> sprites;
+
+        for(int index = 0; index < sprites.max_size(); ++index)
+        {
+            bn::sprite_ptr sprite = sprite_item.create_sprite((index % 16) * 16 - 120, (index / 16) * 20 - 80);
+            sprite.set_z_order(index % 4);
+            sprite.set_camera(camera);
+            sprites.push_back(bn::move(sprite));
+        }
+
+        run_benchmark("128 camera sprites", [&camera](int frame) {
+            camera.set_position((frame % 64) - 32, (frame % 32) - 16);
+        });
+    }
+
+    void bgs_benchmark()
+    {
+        bn::vector<bn::regular_bg_ptr, 4> bgs;
+
+        for(int index = 0; index < bgs.max_size(); ++index)
+        {
+            bgs.push_back(bg_item.create_bg(0, 0));
+        }
+
+        run_benchmark("4 scrolling regular BGs", [&bgs](int frame) {
+            for(int index = 0, limit = bgs.size(); index < limit; ++index)
+            {
+                bgs[index].set_position(frame * (index + 1), frame);
+            }
+        });
+    }
+
+    void palettes_benchmark()
+    {
+        bn::vector<bn::sprite_ptr, 16> sprites;
+
+        for(int index = 0; index < sprites.max_size(); ++index)
+        {
+            sprites.push_back(sprite_item.create_sprite(0, 0));
+        }
+
+        bn::regular_bg_ptr bg = bg_item.create_bg(0, 0);
+
+        run_benchmark("Palette fades", [](int frame) {
+            bn::fixed intensity = bn::fixed(frame % 32) / 32;
+            bn::bg_palettes::set_fade(bn::color(31, 0, 0), intensity);
+            bn::sprite_palettes::set_fade(bn::color(0, 0, 31), intensity);
+        });
+
+        bn::bg_palettes::set_fade_intensity(0);
+        bn::sprite_palettes::set_fade_intensity(0);
+    }
+
+    void hbes_benchmark()
+    {
+        bn::regular_bg_ptr bg = bg_item.create_bg(0, 0);
+        bn::fixed deltas[bn::display::height()];
+        bn::regular_bg_position_hbe_ptr hbe = bn::regular_bg_position_hbe_ptr::create_horizontal(bg, deltas);
+
+        run_benchmark("BG position H-Blank", [&deltas, &hbe](int frame) {
+            for(int index = 0; index < bn::display::height(); ++index)
+            {
+                deltas[index] = bn::degrees_lut_sin((index + frame) % 360) * 8;
+            }
+
+            hbe.reload_deltas_ref();
+        });
+    }
+}
+
+int main()
+{
+    bn::core::init();
+
+    sprites_benchmark();
+    bn::core::update();
+
+    sprite_batch_benchmark();
+    bn::core::update();
+
+    camera_sprites_benchmark();
+    bn::core::update();
+
+    bgs_benchmark();
+    bn::core::update();
+
+    palettes_benchmark();
+    bn::core::update();
+
+    hbes_benchmark();
+    bn::core::update();
+
+    return 0;
+}
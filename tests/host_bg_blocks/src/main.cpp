@@ -0,0 +1,573 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include <cstdio>
+#include "bn_core.h"
+#include "bn_random.h"
+#include "bn_vector.h"
+#include "bn_display.h"
+#include "bn_bg_maps.h"
+#include "bn_optional.h"
+#include "bn_algorithm.h"
+#include "bn_bg_tiles.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_bg_palette_ptr.h"
+#include "bn_bg_palette_item.h"
+#include "bn_regular_bg_builder.h"
+#include "bn_regular_bg_map_ptr.h"
+#include "bn_regular_bg_map_item.h"
+#include "bn_regular_bg_tiles_ptr.h"
+#include "bn_regular_bg_tiles_item.h"
+
+// Creates, destroys and defragments random BG tiles, maps and regular BGs for several seeds,
+// checking after each frame that:
+// * The VRAM of each regular_bg_tiles_ptr contains its tiles, even if it has been moved by bg_tiles::defragment.
+// * The VRAM of each regular_bg_map_ptr contains its cells, patched with the current tiles offset.
+// * The visible window of big maps has been committed again after moving their tiles or maps.
+// * BG control registers reference the current character and screen base blocks of each BG.
+//
+// BGs keep removed maps alive, so BN_CFG_BG_BLOCKS_MAX_ITEMS is raised to the VRAM blocks count in the Makefile:
+// items can't run out even if free blocks are fragmented as much as possible.
+
+namespace
+{
+    constexpr const int seeds = 4;
+    constexpr const int frames_per_seed = 1000;
+    constexpr const int operations_per_frame = 3;
+    constexpr const int max_tiles = 6;
+    constexpr const int max_maps = 6;
+    constexpr const int max_bgs = 4;
+    constexpr const int slots = 12;
+
+    // GBA addresses, which are mapped by the host backend:
+    constexpr const uintptr_t vram_address = 0x06000000;
+    constexpr const uintptr_t dispcnt_address = 0x04000000;
+    constexpr const uintptr_t bgcnt_address = 0x04000008;
+
+    constexpr const int block_size = 2048;
+    constexpr const int bgcnt_blocks_mask = (3 << 2) | (31 << 8);
+
+    bn::tile rom_tiles[slots][1024];
+    bn::regular_bg_map_cell rom_cells[slots][128 * 64];
+    constexpr const bn::color colors[16] = {};
+
+
+    class tiles_entry
+    {
+
+    public:
+        bn::regular_bg_tiles_ptr tiles;
+        int slot;
+        int seed;
+        bool allocated;
+        bn::bpp_mode bpp;
+    };
+
+
+    class map_entry
+    {
+
+    public:
+        bn::regular_bg_map_ptr map;
+        int slot;
+        int seed;
+        int width;
+        int height;
+        bool allocated;
+        int tiles_slot;
+    };
+
+
+    class bg_entry
+    {
+
+    public:
+        bn::regular_bg_ptr bg;
+        int map_slot;
+        int tiles_slot;
+    };
+
+
+    // ROM tiles and cells can't be reused while a tiles or map item references them:
+    class rom_slots
+    {
+
+    public:
+        bool tiles[slots] = {};
+        bool maps[slots] = {};
+
+        [[nodiscard]] static int free_slot(const bool (&used)[slots])
+        {
+            for(int slot = 0; slot < slots; ++slot)
+            {
+                if(! used[slot])
+                {
+                    return slot;
+                }
+            }
+
+            return -1;
+        }
+    };
+
+
+    [[nodiscard]] unsigned tile_word(int seed, int tile_index, int word_index)
+    {
+        return unsigned((seed * 7919) + (tile_index * 31) + word_index);
+    }
+
+    [[nodiscard]] int cell_tile(int seed, int cell_index, int tiles_count)
+    {
+        return ((cell_index * 7) + seed) % tiles_count;
+    }
+
+    [[nodiscard]] const uint16_t* block_vram(int block)
+    {
+        return reinterpret_cast<const uint16_t*>(vram_address + uintptr_t(block * block_size));
+    }
+
+    void add_tiles(bn::random& random, rom_slots& used_slots, int& next_seed, bn::ivector<tiles_entry>& tiles,
+                   bool& defragmented)
+    {
+        int slot = rom_slots::free_slot(used_slots.tiles);
+
+        if(slot < 0)
+        {
+            return;
+        }
+
+        constexpr const int tiles_counts[] = { 64, 128, 192, 256, 512, 1024 };
+        int tiles_count = tiles_counts[random.get() % 6];
+        bool allocated = random.get() % 2;
+        bn::bpp_mode bpp = random.get() % 4 ? bn::bpp_mode::BPP_4 : bn::bpp_mode::BPP_8;
+        int seed = next_seed++;
+        bn::optional<bn::regular_bg_tiles_ptr> tiles_ptr;
+
+        if(allocated)
+        {
+            if(bpp == bn::bpp_mode::BPP_8 && random.get() % 2)
+            {
+                tiles_count *= 2;
+            }
+
+            tiles_ptr = bn::regular_bg_tiles_ptr::allocate_optional(tiles_count, bpp);
+
+            if(tiles_ptr)
+            {
+                bn::span<bn::tile> vram = *tiles_ptr->vram();
+
+                for(int tile_index = 0, limit = vram.size(); tile_index < limit; ++tile_index)
+                {
+                    for(int word_index = 0; word_index < 8; ++word_index)
+                    {
+                        vram[tile_index].data[word_index] = tile_word(seed, tile_index, word_index);
+                    }
+                }
+            }
+        }
+        else
+        {
+            for(int tile_index = 0; tile_index < tiles_count; ++tile_index)
+            {
+                for(int word_index = 0; word_index < 8; ++word_index)
+                {
+                    rom_tiles[slot][tile_index].data[word_index] = tile_word(seed, tile_index, word_index);
+                }
+            }
+
+            bn::regular_bg_tiles_item item(bn::span<const bn::tile>(rom_tiles[slot], tiles_count), bpp);
+            tiles_ptr = bn::regular_bg_tiles_ptr::create_new_optional(item);
+        }
+
+        if(tiles_ptr)
+        {
+            used_slots.tiles[slot] = true;
+            tiles.push_back(tiles_entry{ bn::move(*tiles_ptr), slot, seed, allocated, bpp });
+        }
+        else if(! defragmented &&
+                bn::bg_tiles::largest_available_blocks_count() < bn::bg_tiles::available_blocks_count())
+        {
+            bn::bg_tiles::defragment();
+            defragmented = true;
+        }
+    }
+
+    void add_map(bn::random& random, const bn::bg_palette_ptr& palette, rom_slots& used_slots, int& next_seed,
+                 const bn::ivector<tiles_entry>& tiles, bn::ivector<map_entry>& maps)
+    {
+        const tiles_entry& tiles_entry = tiles[int(random.get() % unsigned(tiles.size()))];
+
+        if(tiles_entry.bpp != bn::bpp_mode::BPP_4)
+        {
+            return;
+        }
+
+        int slot = rom_slots::free_slot(used_slots.maps);
+
+        if(slot < 0)
+        {
+            return;
+        }
+
+        // Kind 0 is a big map:
+        int kind = int(random.get() % 5);
+        int width = kind == 0 ? 128 : kind == 1 ? 64 : 32;
+        int height = kind == 0 || kind == 4 ? 64 : 32;
+        bool allocated = kind >= 3;
+        int seed = next_seed++;
+        int tiles_count = tiles_entry.tiles.tiles_count();
+        bn::optional<bn::regular_bg_map_ptr> map_ptr;
+
+        if(allocated)
+        {
+            map_ptr = bn::regular_bg_map_ptr::allocate_optional(bn::size(width, height), tiles_entry.tiles, palette);
+
+            if(map_ptr)
+            {
+                bn::span<bn::regular_bg_map_cell> vram = *map_ptr->vram();
+                int tiles_offset = map_ptr->tiles_offset();
+
+                for(int cell_index = 0, limit = vram.size(); cell_index < limit; ++cell_index)
+                {
+                    vram[cell_index] = bn::regular_bg_map_cell(cell_tile(seed, cell_index, tiles_count) + tiles_offset);
+                }
+            }
+        }
+        else
+        {
+            for(int cell_index = 0; cell_index < width * height; ++cell_index)
+            {
+                rom_cells[slot][cell_index] = bn::regular_bg_map_cell(cell_tile(seed, cell_index, tiles_count));
+            }
+
+            bn::regular_bg_map_item item(rom_cells[slot][0], bn::size(width, height));
+            map_ptr = bn::regular_bg_map_ptr::create_new_optional(item, tiles_entry.tiles, palette);
+        }
+
+        if(map_ptr)
+        {
+            used_slots.maps[slot] = true;
+            maps.push_back(map_entry{ bn::move(*map_ptr), slot, seed, width, height, allocated,
+                                      tiles_entry.allocated ? -1 : tiles_entry.slot });
+        }
+    }
+
+    void add_or_remove_bg(bn::random& random, const bn::ivector<map_entry>& maps, bn::ivector<bg_entry>& bgs)
+    {
+        if(bgs.full() || (! bgs.empty() && random.get() % 2))
+        {
+            bgs.erase(bgs.begin() + int(random.get() % unsigned(bgs.size())));
+            return;
+        }
+
+        const map_entry& map_entry = maps[int(random.get() % unsigned(maps.size()))];
+
+        // Big maps can't be shared by several BGs:
+        if(map_entry.width > 64)
+        {
+            for(const bg_entry& bg_entry : bgs)
+            {
+                if(bg_entry.bg.map() == map_entry.map)
+                {
+                    return;
+                }
+            }
+        }
+
+        bn::regular_bg_builder builder(map_entry.map);
+        builder.set_position(int(random.get() % 64), int(random.get() % 64));
+        bgs.push_back(bg_entry{ builder.release_build(), map_entry.allocated ? -1 : map_entry.slot,
+                                map_entry.tiles_slot });
+    }
+
+    void update_used_slots(const bn::ivector<tiles_entry>& tiles, const bn::ivector<map_entry>& maps,
+                           const bn::ivector<bg_entry>& bgs, rom_slots& used_slots)
+    {
+        used_slots = {};
+
+        for(const tiles_entry& tiles_entry : tiles)
+        {
+            if(! tiles_entry.allocated)
+            {
+                used_slots.tiles[tiles_entry.slot] = true;
+            }
+        }
+
+        for(const map_entry& map_entry : maps)
+        {
+            if(! map_entry.allocated)
+            {
+                used_slots.maps[map_entry.slot] = true;
+            }
+
+            if(map_entry.tiles_slot >= 0)
+            {
+                used_slots.tiles[map_entry.tiles_slot] = true;
+            }
+        }
+
+        for(const bg_entry& bg_entry : bgs)
+        {
+            if(bg_entry.map_slot >= 0)
+            {
+                used_slots.maps[bg_entry.map_slot] = true;
+            }
+
+            if(bg_entry.tiles_slot >= 0)
+            {
+                used_slots.tiles[bg_entry.tiles_slot] = true;
+            }
+        }
+    }
+
+    [[nodiscard]] int check_tiles(int seed, int frame, const bn::ivector<tiles_entry>& tiles)
+    {
+        int errors = 0;
+
+        for(const tiles_entry& tiles_entry : tiles)
+        {
+            auto vram = reinterpret_cast<const unsigned*>(block_vram(tiles_entry.tiles.id()));
+            bool valid = true;
+
+            for(int tile_index = 0, limit = tiles_entry.tiles.tiles_count(); tile_index < limit && valid; ++tile_index)
+            {
+                for(int word_index = 0; word_index < 8 && valid; ++word_index)
+                {
+                    valid = vram[(tile_index * 8) + word_index] == tile_word(tiles_entry.seed, tile_index, word_index);
+                }
+            }
+
+            if(! valid)
+            {
+                std::printf("Seed %d, frame %d: invalid VRAM tiles: %d\n", seed, frame, tiles_entry.tiles.id());
+                ++errors;
+            }
+        }
+
+        return errors;
+    }
+
+    [[nodiscard]] int check_maps(int seed, int frame, const bn::ivector<map_entry>& maps)
+    {
+        int errors = 0;
+
+        for(const map_entry& map_entry : maps)
+        {
+            // Big maps are checked with their BG:
+            if(map_entry.width > 64)
+            {
+                continue;
+            }
+
+            const bn::regular_bg_map_ptr& map = map_entry.map;
+            const uint16_t* vram = block_vram(map.id());
+            int tiles_count = map.tiles().tiles_count();
+            int tiles_offset = map.tiles_offset();
+
+            if(! map_entry.allocated)
+            {
+                tiles_offset += map.palette_banks_offset() << 12;
+            }
+
+            for(int cell_index = 0, limit = map_entry.width * map_entry.height; cell_index < limit; ++cell_index)
+            {
+                if(vram[cell_index] != cell_tile(map_entry.seed, cell_index, tiles_count) + tiles_offset)
+                {
+                    std::printf("Seed %d, frame %d: invalid VRAM map: %d\n", seed, frame, map.id());
+                    ++errors;
+                    break;
+                }
+            }
+        }
+
+        return errors;
+    }
+
+    [[nodiscard]] int check_big_maps(int seed, int frame, const bn::ivector<map_entry>& maps,
+                                     const bn::ivector<bg_entry>& bgs)
+    {
+        int errors = 0;
+
+        for(const bg_entry& bg_entry : bgs)
+        {
+            const bn::regular_bg_map_ptr& map = bg_entry.bg.map();
+            bn::size dimensions = map.dimensions();
+
+            if(dimensions.width() <= 64)
+            {
+                continue;
+            }
+
+            const map_entry* big_map_entry = nullptr;
+
+            for(const map_entry& map_entry : maps)
+            {
+                if(map_entry.map == map)
+                {
+                    big_map_entry = &map_entry;
+                }
+            }
+
+            if(! big_map_entry)
+            {
+                continue;
+            }
+
+            // Same hardware position than the one calculated by bgs_manager for BGs without camera:
+            const bn::fixed_point& position = bg_entry.bg.position();
+            int hw_x = -position.x().right_shift_integer() - (bn::display::width() / 2) + (dimensions.width() * 4);
+            int hw_y = -position.y().right_shift_integer() - (bn::display::height() / 2) + (dimensions.height() * 4);
+            int map_x = bn::min(hw_x >> 3, dimensions.width() - 32);
+            int map_y = bn::min(hw_y >> 3, dimensions.height() - 22);
+            const uint16_t* vram = block_vram(map.id());
+            int tiles_count = map.tiles().tiles_count();
+            int tiles_offset = map.tiles_offset() + (map.palette_banks_offset() << 12);
+            bool valid = true;
+
+            for(int y = map_y; y < map_y + 22 && valid; ++y)
+            {
+                for(int x = map_x; x < map_x + 32 && valid; ++x)
+                {
+                    int expected_cell = cell_tile(big_map_entry->seed, (y * dimensions.width()) + x, tiles_count) +
+                            tiles_offset;
+                    valid = vram[((y & 31) * 32) + (x & 31)] == expected_cell;
+                }
+            }
+
+            if(! valid)
+            {
+                std::printf("Seed %d, frame %d: invalid VRAM big map: %d\n", seed, frame, map.id());
+                ++errors;
+            }
+        }
+
+        return errors;
+    }
+
+    [[nodiscard]] int check_bgcnt(int seed, int frame, const bn::ivector<bg_entry>& bgs)
+    {
+        auto dispcnt = reinterpret_cast<const uint16_t*>(dispcnt_address);
+        auto bgcnt = reinterpret_cast<const uint16_t*>(bgcnt_address);
+        bn::vector<int, max_bgs> expected_bgcnts;
+        bn::vector<int, max_bgs> bgcnts;
+
+        for(const bg_entry& bg_entry : bgs)
+        {
+            const bn::regular_bg_map_ptr& map = bg_entry.bg.map();
+            expected_bgcnts.push_back((map.tiles().cbb() << 2) | (map.id() << 8));
+        }
+
+        for(int index = 0; index < 4; ++index)
+        {
+            // Only enabled BGs are checked:
+            if(*dispcnt & (1 << (8 + index)))
+            {
+                bgcnts.push_back(bgcnt[index] & bgcnt_blocks_mask);
+            }
+        }
+
+        bn::sort(expected_bgcnts.begin(), expected_bgcnts.end());
+        bn::sort(bgcnts.begin(), bgcnts.end());
+
+        if(expected_bgcnts != bgcnts)
+        {
+            std::printf("Seed %d, frame %d: invalid BG control registers\n", seed, frame);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int run_seed(int seed, const bn::bg_palette_ptr& palette)
+    {
+        bn::random random;
+
+        for(int index = 0; index < seed * 1000; ++index)
+        {
+            (void) random.get();
+        }
+
+        bn::vector<tiles_entry, max_tiles> tiles;
+        bn::vector<map_entry, max_maps> maps;
+        bn::vector<bg_entry, max_bgs> bgs;
+        rom_slots used_slots;
+        int next_seed = 1;
+        int errors = 0;
+
+        for(int frame = 0; frame < frames_per_seed; ++frame)
+        {
+            bool defragmented = false;
+
+            for(int operation = 0; operation < operations_per_frame; ++operation)
+            {
+                int operation_type = int(random.get() % 12);
+
+                if(operation_type < 3 && ! tiles.full())
+                {
+                    add_tiles(random, used_slots, next_seed, tiles, defragmented);
+                }
+                else if(operation_type < 6 && ! maps.full() && ! tiles.empty())
+                {
+                    add_map(random, palette, used_slots, next_seed, tiles, maps);
+                }
+                else if(operation_type < 8 && ! tiles.empty())
+                {
+                    tiles.erase(tiles.begin() + int(random.get() % unsigned(tiles.size())));
+                }
+                else if(operation_type < 9 && ! maps.empty())
+                {
+                    maps.erase(maps.begin() + int(random.get() % unsigned(maps.size())));
+                }
+                else if(operation_type < 10 && ! maps.empty())
+                {
+                    add_or_remove_bg(random, maps, bgs);
+                }
+                else if(operation_type < 11 && ! defragmented && random.get() % 8 == 0)
+                {
+                    bn::bg_maps::defragment();
+                    defragmented = true;
+                }
+            }
+
+            bn::core::update();
+
+            // ROM data of removed items can be reused only after the next update:
+            update_used_slots(tiles, maps, bgs, used_slots);
+
+            if(bn::bg_tiles::largest_available_blocks_count() > bn::bg_tiles::available_blocks_count())
+            {
+                std::printf("Seed %d, frame %d: invalid largest available blocks count\n", seed, frame);
+                ++errors;
+            }
+
+            errors += check_tiles(seed, frame, tiles);
+            errors += check_maps(seed, frame, maps);
+            errors += check_big_maps(seed, frame, maps, bgs);
+            errors += check_bgcnt(seed, frame, bgs);
+        }
+
+        bgs.clear();
+        maps.clear();
+        tiles.clear();
+        bn::core::update();
+        return errors;
+    }
+}
+
+int main()
+{
+    bn::core::init();
+
+    bn::bg_palette_ptr palette = bn::bg_palette_item(colors, bn::bpp_mode::BPP_4).create_palette();
+    int errors = 0;
+
+    for(int seed = 0; seed < seeds; ++seed)
+    {
+        errors += run_seed(seed, palette);
+    }
+
+    std::printf("Errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include <cstdio>
+#include "bn_core.h"
+#include "bn_random.h"
+#include "bn_bitmap_bg.h"
+#include "bn_sprite_tiles.h"
+#include "bn_bg_palette_item.h"
+
+// Draws random primitives in bitmap BGs of modes 3, 4 and 5, with and without EWRAM back buffer, checking that:
+// * Fill, blit and scaled blit kernels match a reference framebuffer, including odd positions and widths
+//   (which are written in pixel pairs in mode 4).
+// * Presented frames are displayed after the next update, flipping pages in modes 4 and 5.
+// * The first half of sprite tiles VRAM is reserved while a bitmap BG is alive.
+
+namespace
+{
+    constexpr const int operations_count = 1500;
+    constexpr const int present_operations = 25;
+    constexpr const int max_source_width = 64;
+    constexpr const int max_source_height = 48;
+
+    // GBA addresses, which are mapped by the host backend:
+    constexpr const uintptr_t dispcnt_address = 0x04000000;
+    constexpr const uintptr_t vram_address = 0x06000000;
+
+    constexpr const int page_size = 0xA000;
+    constexpr const int reserved_sprite_tiles = 512;
+
+    bn::color palette_colors[256];
+    bn::color source_colors[max_source_width * max_source_height];
+    uint8_t source_indexes[max_source_width * max_source_height];
+
+    // Expected pixels of each page (only the first one is used in mode 3 and with EWRAM back buffer):
+    uint16_t expected_pixels[2][240 * 160];
+
+
+    [[nodiscard]] int pixel(const uint16_t* pixels_ptr, bool direct_colors, int index)
+    {
+        if(direct_colors)
+        {
+            return pixels_ptr[index];
+        }
+
+        int pair = pixels_ptr[index / 2];
+        return index % 2 ? pair >> 8 : pair & 0xFF;
+    }
+
+    [[nodiscard]] int check_pixels(const char* label, int config, int operation, const uint16_t* pixels_ptr,
+                                   const uint16_t* expected_pixels_ptr, const bn::bitmap_bg& bg)
+    {
+        bool direct_colors = bg.mode() != bn::bitmap_bg_mode::MODE_4;
+        int width = bg.dimensions().width();
+        int pixels_count = width * bg.dimensions().height();
+
+        for(int index = 0; index < pixels_count; ++index)
+        {
+            if(pixel(pixels_ptr, direct_colors, index) != expected_pixels_ptr[index])
+            {
+                std::printf("Config %d, operation %d: invalid %s pixel: %d - %d\n", config, operation, label,
+                            index % width, index / width);
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int random_int(int max, bn::random& random)
+    {
+        return int(random.get() % unsigned(max + 1));
+    }
+
+    void draw(bn::bitmap_bg& bg, bn::random& random, uint16_t* expected_pixels_ptr)
+    {
+        bool direct_colors = bg.mode() != bn::bitmap_bg_mode::MODE_4;
+        int bg_width = bg.dimensions().width();
+        int bg_height = bg.dimensions().height();
+        int value = direct_colors ? int(random.get() & 0x7FFF) : int(random.get() % 256);
+        int operation = int(random.get() % 6);
+
+        int width;
+        int height;
+        int source_width = 0;
+        int source_height = 0;
+
+        switch(operation)
+        {
+
+        case 0:
+            width = bg_width;
+            height = bg_height;
+            break;
+
+        case 1:
+            width = 1;
+            height = 1;
+            break;
+
+        case 2:
+            width = random_int(bg_width, random);
+            height = 1;
+            break;
+
+        case 3:
+            width = random_int(bg_width, random);
+            height = random_int(bg_height, random);
+            break;
+
+        case 4:
+            width = random_int(max_source_width, random);
+            height = random_int(max_source_height, random);
+            break;
+
+        default:
+            source_width = 1 + random_int(max_source_width - 1, random);
+            source_height = 1 + random_int(max_source_height - 1, random);
+            width = random_int(bg_width, random);
+            height = random_int(bg_height, random);
+            break;
+        }
+
+        int x = random_int(bg_width - width, random);
+        int y = random_int(bg_height - height, random);
+
+        switch(operation)
+        {
+
+        case 0:
+            direct_colors ? bg.clear(bn::color(value)) : bg.clear(value);
+            break;
+
+        case 1:
+            direct_colors ? bg.plot(x, y, bn::color(value)) : bg.plot(x, y, value);
+            break;
+
+        case 2:
+            direct_colors ? bg.draw_hline(x, y, width, bn::color(value)) : bg.draw_hline(x, y, width, value);
+            break;
+
+        case 3:
+            direct_colors ? bg.fill_rect(x, y, width, height, bn::color(value)) :
+                    bg.fill_rect(x, y, width, height, value);
+            break;
+
+        case 4:
+            if(direct_colors)
+            {
+                bg.blit(x, y, bn::span<const bn::color>(source_colors, width * height), bn::size(width, height));
+            }
+            else
+            {
+                bg.blit(x, y, bn::span<const uint8_t>(source_indexes, width * height), bn::size(width, height));
+            }
+            break;
+
+        default:
+            if(direct_colors)
+            {
+                bg.scaled_blit(x, y, bn::size(width, height),
+                               bn::span<const bn::color>(source_colors, source_width * source_height),
+                               bn::size(source_width, source_height));
+            }
+            else
+            {
+                bg.scaled_blit(x, y, bn::size(width, height),
+                               bn::span<const uint8_t>(source_indexes, source_width * source_height),
+                               bn::size(source_width, source_height));
+            }
+            break;
+        }
+
+        for(int row = 0; row < height; ++row)
+        {
+            for(int column = 0; column < width; ++column)
+            {
+                int source_index;
+
+                if(operation < 4)
+                {
+                    source_index = -1;
+                }
+                else if(operation == 4)
+                {
+                    source_index = (row * width) + column;
+                }
+                else
+                {
+                    // Nearest neighbor sampling with 16.16 fixed point steps:
+                    unsigned x_step = (unsigned(source_width) << 16) / unsigned(width);
+                    unsigned y_step = (unsigned(source_height) << 16) / unsigned(height);
+                    int source_x = int((unsigned(column) * x_step) >> 16);
+                    int source_y = int((unsigned(row) * y_step) >> 16);
+                    source_index = (source_y * source_width) + source_x;
+                }
+
+                int expected_pixel = value;
+
+                if(source_index >= 0)
+                {
+                    expected_pixel = direct_colors ? source_colors[source_index].data() : source_indexes[source_index];
+                }
+
+                expected_pixels_ptr[((y + row) * bg_width) + x + column] = uint16_t(expected_pixel);
+            }
+        }
+    }
+
+    [[nodiscard]] int check_bitmap_bg(int config, bn::bitmap_bg& bg, bn::random& random)
+    {
+        auto dispcnt = reinterpret_cast<const volatile uint16_t*>(dispcnt_address);
+        bool flip_pages = bg.mode() != bn::bitmap_bg_mode::MODE_3;
+        bool swap_expected_pixels = flip_pages && ! bg.ewram_back_buffer();
+        int back_page = 1;
+        int errors = 0;
+
+        for(int page = 0; page < 2; ++page)
+        {
+            for(uint16_t& expected_pixel : expected_pixels[page])
+            {
+                expected_pixel = 0;
+            }
+        }
+
+        bn::core::update();
+
+        if((*dispcnt & 7) != int(bg.mode()))
+        {
+            std::printf("Config %d: invalid display mode: %d\n", config, *dispcnt & 7);
+            ++errors;
+        }
+
+        // Sprites can't use the tiles overlapped by the framebuffer:
+        if(bn::sprite_tiles::used_tiles_count() != reserved_sprite_tiles)
+        {
+            std::printf("Config %d: invalid used sprite tiles count: %d\n", config,
+                        bn::sprite_tiles::used_tiles_count());
+            ++errors;
+        }
+
+        for(int operation = 0; operation < operations_count; ++operation)
+        {
+            uint16_t* expected_pixels_ptr = expected_pixels[swap_expected_pixels ? back_page : 0];
+            draw(bg, random, expected_pixels_ptr);
+            errors += check_pixels("back buffer", config, operation, bg.back_buffer(), expected_pixels_ptr, bg);
+
+            if(operation % present_operations == present_operations - 1)
+            {
+                bg.present();
+                bn::core::update();
+
+                int displayed_page = flip_pages ? (*dispcnt >> 4) & 1 : 0;
+                auto displayed_pixels_ptr = reinterpret_cast<const uint16_t*>(
+                            vram_address + uintptr_t(displayed_page * page_size));
+                errors += check_pixels("displayed", config, operation, displayed_pixels_ptr,
+                                       expected_pixels_ptr, bg);
+
+                if(flip_pages)
+                {
+                    if(displayed_page != back_page)
+                    {
+                        std::printf("Config %d, operation %d: page not flipped\n", config, operation);
+                        ++errors;
+                    }
+
+                    back_page = 1 - displayed_page;
+                }
+            }
+
+            if(errors)
+            {
+                break;
+            }
+        }
+
+        return errors;
+    }
+}
+
+int main()
+{
+    bn::core::init();
+
+    bn::random random;
+
+    for(bn::color& palette_color : palette_colors)
+    {
+        palette_color = bn::color(int(random.get() & 0x7FFF));
+    }
+
+    for(int index = 0; index < max_source_width * max_source_height; ++index)
+    {
+        source_colors[index] = bn::color(int(random.get() & 0x7FFF));
+        source_indexes[index] = uint8_t(random.get() % 256);
+    }
+
+    bn::bg_palette_item palette_item(palette_colors, bn::bpp_mode::BPP_8);
+    int errors = 0;
+
+    for(int config = 0; config < 6; ++config)
+    {
+        bool ewram_back_buffer = config % 2;
+
+        switch(config / 2)
+        {
+
+        case 0:
+            {
+                bn::bitmap_bg bg(bn::bitmap_bg_mode::MODE_3, ewram_back_buffer);
+                errors += check_bitmap_bg(config, bg, random);
+            }
+            break;
+
+        case 1:
+            {
+                bn::bitmap_bg bg(palette_item, ewram_back_buffer);
+                errors += check_bitmap_bg(config, bg, random);
+            }
+            break;
+
+        default:
+            {
+                bn::bitmap_bg bg(bn::bitmap_bg_mode::MODE_5, ewram_back_buffer);
+                errors += check_bitmap_bg(config, bg, random);
+            }
+            break;
+        }
+
+        // Released sprite tiles are available after the next update:
+        bn::core::update();
+
+        if(bn::sprite_tiles::used_tiles_count())
+        {
+            std::printf("Config %d: reserved sprite tiles not released: %d\n", config,
+                        bn::sprite_tiles::used_tiles_count());
+            ++errors;
+        }
+    }
+
+    std::printf("Errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include <cstdio>
+#include "bn_core.h"
+#include "bn_random.h"
+#include "bn_display.h"
+#include "bn_algorithm.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_bg_palette_ptr.h"
+#include "bn_bg_palette_item.h"
+#include "bn_regular_bg_builder.h"
+#include "bn_regular_bg_map_ptr.h"
+#include "bn_regular_bg_map_item.h"
+#include "bn_regular_bg_tiles_ptr.h"
+#include "bn_regular_bg_tiles_item.h"
+
+// Creates regular BGs from random metatile maps with byte and half word indexes, checking that:
+// * regular_bg_map_item::uncompress expands metatiles in the same layout used by plain maps.
+// * Maps which are not big are expanded in VRAM in screenblock order.
+// * The visible window of big maps is expanded in VRAM after random scrolling, including jumps.
+// * Expanded cells are patched with non zero tiles and palette offsets.
+
+namespace
+{
+    constexpr const int big_map_frames = 600;
+    constexpr const int big_map_jump_frames = 50;
+    constexpr const int metatiles_count = 300;
+
+    // GBA addresses, which are mapped by the host backend:
+    constexpr const uintptr_t vram_address = 0x06000000;
+
+    constexpr const int block_size = 2048;
+
+    bn::tile offset_tiles[64];
+    bn::tile tiles[128];
+    constexpr const bn::color colors[16] = {};
+    alignas(int) bn::regular_bg_map_cell metatile_cells[metatiles_count * 4 * 4];
+    alignas(int) uint8_t metatile_byte_indexes[64 * 64];
+    alignas(int) uint16_t metatile_half_word_indexes[64 * 64];
+    alignas(int) bn::regular_bg_map_cell uncompressed_cells[256 * 256];
+
+
+    [[nodiscard]] const uint16_t* block_vram(int block)
+    {
+        return reinterpret_cast<const uint16_t*>(vram_address + uintptr_t(block * block_size));
+    }
+
+    [[nodiscard]] int expected_cell(const bn::regular_bg_map_item& item, int x, int y)
+    {
+        int metatile_size = item.metatile_size();
+        int metatile_index = ((y / metatile_size) * (item.dimensions().width() / metatile_size)) + (x / metatile_size);
+
+        if(const uint8_t* byte_indexes = item.metatile_byte_indexes_ptr())
+        {
+            metatile_index = byte_indexes[metatile_index];
+        }
+        else
+        {
+            metatile_index = item.metatile_half_word_indexes_ptr()[metatile_index];
+        }
+
+        int cell_index = (metatile_index * metatile_size * metatile_size) + ((y % metatile_size) * metatile_size) +
+                (x % metatile_size);
+        return (&item.cells_ref())[cell_index];
+    }
+
+    [[nodiscard]] int expected_vram_cell(const bn::regular_bg_map_item& item, const bn::regular_bg_map_ptr& map,
+                                         int x, int y)
+    {
+        return expected_cell(item, x, y) + map.tiles_offset() + (map.palette_banks_offset() << 12);
+    }
+
+    [[nodiscard]] int check_uncompress(int item_index, const bn::regular_bg_map_item& item)
+    {
+        bn::regular_bg_map_item uncompressed_item = item.uncompress(uncompressed_cells[0], item.dimensions());
+
+        if(uncompressed_item.metatiles() || &uncompressed_item.cells_ref() != uncompressed_cells)
+        {
+            std::printf("Item %d: invalid uncompressed item\n", item_index);
+            return 1;
+        }
+
+        int width = item.dimensions().width();
+        int height = item.dimensions().height();
+
+        for(int y = 0; y < height; ++y)
+        {
+            for(int x = 0; x < width; ++x)
+            {
+                // Maps which are not big are stored in screenblock order:
+                int cell_index = item.big() ? (y * width) + x :
+                        ((((y / 32) * (width / 32)) + (x / 32)) * 1024) + ((y % 32) * 32) + (x % 32);
+
+                if(uncompressed_cells[cell_index] != expected_cell(item, x, y))
+                {
+                    std::printf("Item %d: invalid uncompressed cell: %d - %d\n", item_index, x, y);
+                    return 1;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int check_map(int item_index, const bn::regular_bg_map_item& item, const bn::regular_bg_map_ptr& map)
+    {
+        int width = item.dimensions().width();
+        int cells_count = width * item.dimensions().height();
+        const uint16_t* vram = block_vram(map.id());
+
+        for(int cell_index = 0; cell_index < cells_count; ++cell_index)
+        {
+            int screenblock = cell_index / 1024;
+            int x = ((screenblock % (width / 32)) * 32) + (cell_index % 32);
+            int y = ((screenblock / (width / 32)) * 32) + ((cell_index % 1024) / 32);
+
+            if(vram[cell_index] != expected_vram_cell(item, map, x, y))
+            {
+                std::printf("Item %d: invalid VRAM cell: %d - %d\n", item_index, x, y);
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int check_big_map(int item_index, int frame, const bn::regular_bg_map_item& item,
+                                    const bn::regular_bg_ptr& bg)
+    {
+        const bn::regular_bg_map_ptr& map = bg.map();
+        bn::size dimensions = map.dimensions();
+
+        // Same hardware position than the one calculated by bgs_manager for BGs without camera:
+        const bn::fixed_point& position = bg.position();
+        int hw_x = -position.x().right_shift_integer() - (bn::display::width() / 2) + (dimensions.width() * 4);
+        int hw_y = -position.y().right_shift_integer() - (bn::display::height() / 2) + (dimensions.height() * 4);
+        int map_x = bn::min(hw_x >> 3, dimensions.width() - 32);
+        int map_y = bn::min(hw_y >> 3, dimensions.height() - 22);
+        const uint16_t* vram = block_vram(map.id());
+
+        for(int y = map_y; y < map_y + 22; ++y)
+        {
+            for(int x = map_x; x < map_x + 32; ++x)
+            {
+                if(vram[((y & 31) * 32) + (x & 31)] != expected_vram_cell(item, map, x, y))
+                {
+                    std::printf("Item %d, frame %d: invalid VRAM cell: %d - %d\n", item_index, frame, x, y);
+                    return 1;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int scroll_big_map(int item_index, const bn::regular_bg_map_item& item, bn::random& random,
+                                     bn::regular_bg_ptr& bg)
+    {
+        int max_x = (item.dimensions().width() * 4) - (bn::display::width() / 2);
+        int max_y = (item.dimensions().height() * 4) - (bn::display::height() / 2);
+        int errors = 0;
+
+        for(int frame = 0; frame < big_map_frames; ++frame)
+        {
+            int x;
+            int y;
+
+            if(frame % big_map_jump_frames == 0)
+            {
+                x = int(random.get() % unsigned((max_x * 2) + 1)) - max_x;
+                y = int(random.get() % unsigned((max_y * 2) + 1)) - max_y;
+            }
+            else
+            {
+                x = bn::clamp(bg.x().right_shift_integer() + int(random.get() % 19) - 9, -max_x, max_x);
+                y = bn::clamp(bg.y().right_shift_integer() + int(random.get() % 19) - 9, -max_y, max_y);
+            }
+
+            bg.set_position(x, y);
+            bn::core::update();
+            errors += check_big_map(item_index, frame, item, bg);
+        }
+
+        return errors;
+    }
+}
+
+int main()
+{
+    bn::core::init();
+
+    bn::random random;
+
+    // Offset palette and tiles, so expanded cells must be patched:
+    bn::bg_palette_ptr offset_palette = bn::bg_palette_item(colors, bn::bpp_mode::BPP_4).create_palette();
+    bn::bg_palette_ptr palette = bn::bg_palette_item(colors, bn::bpp_mode::BPP_4).create_new_palette();
+    bn::regular_bg_tiles_ptr offset_bg_tiles =
+            bn::regular_bg_tiles_item(offset_tiles, bn::bpp_mode::BPP_4).create_tiles();
+    bn::regular_bg_tiles_ptr bg_tiles = bn::regular_bg_tiles_item(tiles, bn::bpp_mode::BPP_4).create_tiles();
+
+    for(bn::regular_bg_map_cell& metatile_cell : metatile_cells)
+    {
+        metatile_cell = bn::regular_bg_map_cell(int(random.get() % 128) | (int(random.get() % 4) << 10));
+    }
+
+    for(int index = 0; index < 64 * 64; ++index)
+    {
+        metatile_byte_indexes[index] = uint8_t(random.get() % 256);
+        metatile_half_word_indexes[index] = uint16_t(random.get() % unsigned(metatiles_count));
+    }
+
+    const bn::regular_bg_map_item items[] = {
+        bn::regular_bg_map_item(metatile_cells[0], metatile_byte_indexes[0], 2, bn::size(128, 96)),
+        bn::regular_bg_map_item(metatile_cells[0], metatile_half_word_indexes[0], 4, bn::size(256, 160)),
+        bn::regular_bg_map_item(metatile_cells[0], metatile_byte_indexes[0], 4, bn::size(64, 64)),
+        bn::regular_bg_map_item(metatile_cells[0], metatile_half_word_indexes[0], 2, bn::size(32, 64)),
+    };
+
+    int errors = 0;
+
+    for(int item_index = 0; item_index < int(sizeof(items) / sizeof(items[0])); ++item_index)
+    {
+        const bn::regular_bg_map_item& item = items[item_index];
+        errors += check_uncompress(item_index, item);
+
+        bn::regular_bg_map_ptr map = item.create_map(bg_tiles, palette);
+
+        if(map.cells_ref())
+        {
+            std::printf("Item %d: cells_ref is not empty\n", item_index);
+            ++errors;
+        }
+
+        bn::regular_bg_builder builder(map);
+        bn::regular_bg_ptr bg = builder.release_build();
+        bn::core::update();
+
+        if(item.big())
+        {
+            errors += scroll_big_map(item_index, item, random, bg);
+        }
+        else
+        {
+            errors += check_map(item_index, item, map);
+        }
+    }
+
+    std::printf("Errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "bn_core.h"
+#include "bn_random.h"
+#include "bn_optional.h"
+#include "bn_display.h"
+#include "bn_algorithm.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_bg_palette_item.h"
+#include "bn_regular_bg_world.h"
+#include "bn_regular_bg_map_ptr.h"
+#include "bn_regular_bg_tiles_ptr.h"
+
+// Scrolls regular_bg_worlds built from plain and metatile chunks, with and without dynamic tiles, checking that:
+// * The visible map cells are streamed to the ring map after scrolling in every direction and after jumps.
+// * Chunks are evicted from the EWRAM cache without breaking the ring map when only 4 chunks can be cached.
+// * Dynamic tiles hold the tiles referenced by their map cells, and their slots are reference counted.
+// * Dynamic tiles displayed until the next V-Blank are not replaced by set_position.
+
+namespace
+{
+    constexpr const int scroll_frames = 1200;
+    constexpr const int direction_frames = 60;
+    constexpr const int jump_frames = 45;
+    constexpr const int max_speed = 16;
+    constexpr const int max_cached_chunks = 4;
+    constexpr const int dynamic_tiles_count = 800;
+
+    constexpr const int chunk_size = bn::regular_bg_world_item::chunk_size();
+    constexpr const int chunk_cells = chunk_size * chunk_size;
+    constexpr const int world_width = 6;
+    constexpr const int world_height = 5;
+    constexpr const int world_columns = world_width * chunk_size;
+    constexpr const int world_rows = world_height * chunk_size;
+    constexpr const int tiles_items_count = 3;
+    constexpr const int item_tiles_count = 512;
+    constexpr const int chunk_tiles_count = 96;
+    constexpr const int plain_chunks_count = 4;
+    constexpr const int metatile_chunks_count = 4;
+    constexpr const int chunks_count = plain_chunks_count + metatile_chunks_count;
+    constexpr const int metatiles_count = 64;
+    constexpr const int loaded_rows = (bn::display::height() / 8) + 2;
+
+    // GBA addresses, which are mapped by the host backend:
+    constexpr const uintptr_t vram_address = 0x06000000;
+
+    constexpr const int block_size = 2048;
+
+    bn::tile tiles[tiles_items_count][item_tiles_count];
+    constexpr const bn::color colors[16] = {};
+    alignas(int) bn::regular_bg_map_cell plain_chunk_cells[plain_chunks_count][chunk_cells];
+    alignas(int) bn::regular_bg_map_cell metatile_cells[metatile_chunks_count][metatiles_count * 2 * 2];
+    alignas(int) uint8_t metatile_indexes[metatile_chunks_count][(chunk_size / 2) * (chunk_size / 2)];
+    uint8_t chunk_tiles_indexes[chunks_count];
+    uint16_t chunk_indexes[world_width * world_height];
+    alignas(int) bn::regular_bg_map_cell world_cells[world_rows][world_columns];
+    alignas(int) bn::regular_bg_map_cell uncompressed_cells[chunk_cells];
+    bool used_world_tiles[tiles_items_count * item_tiles_count];
+
+    const bn::regular_bg_tiles_item tiles_items[] = {
+        bn::regular_bg_tiles_item(tiles[0], bn::bpp_mode::BPP_4),
+        bn::regular_bg_tiles_item(tiles[1], bn::bpp_mode::BPP_4),
+        bn::regular_bg_tiles_item(tiles[2], bn::bpp_mode::BPP_4),
+    };
+
+    const bn::regular_bg_map_item chunk_items[] = {
+        bn::regular_bg_map_item(plain_chunk_cells[0][0], bn::size(chunk_size, chunk_size)),
+        bn::regular_bg_map_item(plain_chunk_cells[1][0], bn::size(chunk_size, chunk_size)),
+        bn::regular_bg_map_item(plain_chunk_cells[2][0], bn::size(chunk_size, chunk_size)),
+        bn::regular_bg_map_item(plain_chunk_cells[3][0], bn::size(chunk_size, chunk_size)),
+        bn::regular_bg_map_item(metatile_cells[0][0], metatile_indexes[0][0], 2, bn::size(chunk_size, chunk_size)),
+        bn::regular_bg_map_item(metatile_cells[1][0], metatile_indexes[1][0], 2, bn::size(chunk_size, chunk_size)),
+        bn::regular_bg_map_item(metatile_cells[2][0], metatile_indexes[2][0], 2, bn::size(chunk_size, chunk_size)),
+        bn::regular_bg_map_item(metatile_cells[3][0], metatile_indexes[3][0], 2, bn::size(chunk_size, chunk_size)),
+    };
+
+
+    [[nodiscard]] const uint16_t* block_vram(int block)
+    {
+        return reinterpret_cast<const uint16_t*>(vram_address + uintptr_t(block * block_size));
+    }
+
+    [[nodiscard]] int tile_index(int cell)
+    {
+        return cell & 1023;
+    }
+
+    [[nodiscard]] int world_tile(int x, int y)
+    {
+        int chunk_index = chunk_indexes[((y / chunk_size) * world_width) + (x / chunk_size)];
+        return (chunk_tiles_indexes[chunk_index] * item_tiles_count) + tile_index(world_cells[y][x]);
+    }
+
+    [[nodiscard]] bn::regular_bg_map_cell random_cell(int first_tile, bn::random& random)
+    {
+        // Tile of the chunk tiles range, with random flips and palette bank:
+        int tile = first_tile + int(random.get() % unsigned(chunk_tiles_count));
+        return bn::regular_bg_map_cell(tile | (int(random.get() % 16) << 10));
+    }
+
+    void init_world(bn::random& random)
+    {
+        for(int tiles_item_index = 0; tiles_item_index < tiles_items_count; ++tiles_item_index)
+        {
+            for(bn::tile& tile : tiles[tiles_item_index])
+            {
+                for(uint32_t& data : tile.data)
+                {
+                    data = random.get();
+                }
+            }
+        }
+
+        // Each chunk references a small range of its tiles item, so dynamic tiles slots are reused:
+        for(int chunk_index = 0; chunk_index < chunks_count; ++chunk_index)
+        {
+            chunk_tiles_indexes[chunk_index] = uint8_t(random.get() % tiles_items_count);
+
+            int first_tile = int(random.get() % unsigned(item_tiles_count - chunk_tiles_count));
+
+            if(chunk_index < plain_chunks_count)
+            {
+                for(bn::regular_bg_map_cell& cell : plain_chunk_cells[chunk_index])
+                {
+                    cell = random_cell(first_tile, random);
+                }
+            }
+            else
+            {
+                int metatile_chunk_index = chunk_index - plain_chunks_count;
+
+                for(bn::regular_bg_map_cell& cell : metatile_cells[metatile_chunk_index])
+                {
+                    cell = random_cell(first_tile, random);
+                }
+
+                for(uint8_t& metatile_index : metatile_indexes[metatile_chunk_index])
+                {
+                    metatile_index = uint8_t(random.get() % metatiles_count);
+                }
+            }
+        }
+
+        for(int chunk_y = 0; chunk_y < world_height; ++chunk_y)
+        {
+            for(int chunk_x = 0; chunk_x < world_width; ++chunk_x)
+            {
+                int chunk_index = int(random.get() % chunks_count);
+                chunk_indexes[(chunk_y * world_width) + chunk_x] = uint16_t(chunk_index);
+
+                bn::regular_bg_map_item uncompressed_item = chunk_items[chunk_index].uncompress(
+                            uncompressed_cells[0], bn::size(chunk_size, chunk_size));
+                const bn::regular_bg_map_cell* chunk_cells_ptr = &uncompressed_item.cells_ref();
+
+                for(int y = 0; y < chunk_size; ++y)
+                {
+                    for(int x = 0; x < chunk_size; ++x)
+                    {
+                        world_cells[(chunk_y * chunk_size) + y][(chunk_x * chunk_size) + x] =
+                                chunk_cells_ptr[(y * chunk_size) + x];
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] int check_used_dynamic_tiles(const char* label, int frame, const bn::regular_bg_world& world)
+    {
+        const bn::point& position = world.position();
+        int map_x = position.x() / 8;
+        int map_y = position.y() / 8;
+        int used_dynamic_tiles_count = world.used_dynamic_tiles_count();
+
+        // Columns and rows outside the world keep old cells, so only a lower bound can be checked near the edges:
+        bool exact = map_x + chunk_size <= world_columns && map_y + loaded_rows <= world_rows;
+        int last_x = exact ? map_x + chunk_size - 1 : (position.x() + bn::display::width() - 1) / 8;
+        int last_y = exact ? map_y + loaded_rows - 1 : (position.y() + bn::display::height() - 1) / 8;
+        int expected_used_dynamic_tiles_count = 0;
+        std::memset(used_world_tiles, 0, sizeof(used_world_tiles));
+
+        for(int y = map_y; y <= last_y; ++y)
+        {
+            for(int x = map_x; x <= last_x; ++x)
+            {
+                bool& used_world_tile = used_world_tiles[world_tile(x, y)];
+                expected_used_dynamic_tiles_count += ! used_world_tile;
+                used_world_tile = true;
+            }
+        }
+
+        if(exact ? used_dynamic_tiles_count != expected_used_dynamic_tiles_count :
+                used_dynamic_tiles_count < expected_used_dynamic_tiles_count)
+        {
+            std::printf("%s, frame %d: invalid used dynamic tiles count: %d - %d\n", label, frame,
+                        used_dynamic_tiles_count, expected_used_dynamic_tiles_count);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int check_world(const char* label, int frame, bn::regular_bg_world& world,
+                                  const bn::point& position, bool after_update)
+    {
+        bn::regular_bg_ptr& bg = world.bg();
+        bn::regular_bg_map_ptr map = bg.map();
+        bn::regular_bg_tiles_ptr bg_tiles = bg.tiles();
+        bn::optional<bn::span<bn::tile>> dynamic_tiles = bg_tiles.vram();
+        const uint16_t* vram = block_vram(map.id());
+        int tiles_offset = map.tiles_offset();
+        int palette_offset = map.palette_banks_offset() << 12;
+        int last_x = (position.x() + bn::display::width() - 1) / 8;
+        int last_y = (position.y() + bn::display::height() - 1) / 8;
+
+        for(int y = position.y() / 8; y <= last_y; ++y)
+        {
+            for(int x = position.x() / 8; x <= last_x; ++x)
+            {
+                int vram_cell = vram[((y % chunk_size) * chunk_size) + (x % chunk_size)];
+                int expected_cell = world_cells[y][x];
+
+                if(! dynamic_tiles)
+                {
+                    if(vram_cell != ((expected_cell + tiles_offset + palette_offset) & 0xFFFF))
+                    {
+                        std::printf("%s, frame %d: invalid VRAM cell: %d - %d\n", label, frame, x, y);
+                        return 1;
+                    }
+
+                    continue;
+                }
+
+                int slot = tile_index(vram_cell) - tiles_offset;
+
+                if(slot < 0 || slot >= world.dynamic_tiles_count() ||
+                        (vram_cell & 0xFC00) != (((expected_cell & 0xFC00) + palette_offset) & 0xFFFF))
+                {
+                    std::printf("%s, frame %d: invalid VRAM cell: %d - %d\n", label, frame, x, y);
+                    return 1;
+                }
+
+                int chunk_index = chunk_indexes[((y / chunk_size) * world_width) + (x / chunk_size)];
+                const bn::tile& expected_tile = tiles[chunk_tiles_indexes[chunk_index]][tile_index(expected_cell)];
+
+                if(std::memcmp(&dynamic_tiles->at(slot), &expected_tile, sizeof(bn::tile)) != 0)
+                {
+                    std::printf("%s, frame %d: invalid dynamic tile: %d - %d\n", label, frame, x, y);
+                    return 1;
+                }
+            }
+        }
+
+        if(world.cached_chunks_count() > world.max_cached_chunks())
+        {
+            std::printf("%s, frame %d: too many cached chunks: %d\n", label, frame, world.cached_chunks_count());
+            return 1;
+        }
+
+        if(dynamic_tiles && after_update)
+        {
+            return check_used_dynamic_tiles(label, frame, world);
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int scroll_world(const char* label, bn::random& random, bn::regular_bg_world& world)
+    {
+        constexpr const bn::point directions[] = {
+            bn::point(1, 0), bn::point(1, 1), bn::point(0, 1), bn::point(-1, 1),
+            bn::point(-1, 0), bn::point(-1, -1), bn::point(0, -1), bn::point(1, -1)
+        };
+
+        int max_x = world.item().pixels_dimensions().width() - bn::display::width();
+        int max_y = world.item().pixels_dimensions().height() - bn::display::height();
+        int errors = check_world(label, -1, world, world.position(), true);
+
+        for(int frame = 0; frame < scroll_frames; ++frame)
+        {
+            bn::point old_position = world.position();
+            bn::point new_position;
+
+            if(frame % jump_frames == jump_frames - 1)
+            {
+                if(frame % (jump_frames * 2) == jump_frames - 1)
+                {
+                    new_position = bn::point(int(random.get() % unsigned(max_x + 1)),
+                                             int(random.get() % unsigned(max_y + 1)));
+                }
+                else
+                {
+                    // Jumps of 9 to 15 map cells:
+                    const bn::point& direction = directions[random.get() % 8];
+                    int distance = int(72 + (random.get() % 48));
+                    new_position = old_position + (direction * distance);
+                }
+            }
+            else
+            {
+                const bn::point& direction = directions[(frame / direction_frames) % 8];
+                int speed = int(1 + (random.get() % max_speed));
+                new_position = old_position + (direction * speed);
+            }
+
+            new_position = bn::point(bn::clamp(new_position.x(), 0, max_x), bn::clamp(new_position.y(), 0, max_y));
+            world.set_position(new_position);
+
+            // The old map cells are displayed until the next V-Blank:
+            errors += check_world(label, frame, world, old_position, false);
+
+            bn::core::update();
+            errors += check_world(label, frame, world, new_position, true);
+        }
+
+        return errors;
+    }
+}
+
+int main()
+{
+    bn::core::init();
+
+    bn::random random;
+    init_world(random);
+
+    bn::bg_palette_item palette_item(colors, bn::bpp_mode::BPP_4);
+    bn::span<const bn::regular_bg_map_item> chunk_items_span(chunk_items);
+    bn::span<const uint16_t> chunk_indexes_span(chunk_indexes);
+    bn::size dimensions(world_width, world_height);
+    int errors = 0;
+
+    {
+        bn::regular_bg_world_item item(tiles_items[0], palette_item, chunk_items_span, chunk_indexes_span,
+                                       dimensions);
+        bn::regular_bg_world world(item, bn::point(300, 200), max_cached_chunks);
+        bn::core::update();
+        errors += scroll_world("Static tiles", random, world);
+    }
+
+    {
+        bn::regular_bg_world_item item(tiles_items, palette_item, chunk_items_span, chunk_tiles_indexes,
+                                       chunk_indexes_span, dimensions);
+        bn::regular_bg_world world(item, bn::point(300, 200), max_cached_chunks, dynamic_tiles_count);
+        bn::core::update();
+        errors += scroll_world("Dynamic tiles", random, world);
+    }
+
+    std::printf("Errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2020-2021 Gustavo Valiente gustavo.valiente@protonmail.com
+ * zlib License, see LICENSE file.
+ */
+
+#include <cstdio>
+#include "bn_core.h"
+#include "bn_random.h"
+#include "bn_vector.h"
+#include "bn_optional.h"
+#include "bn_algorithm.h"
+#include "bn_sprite_ptr.h"
+#include "bn_sprite_tiles.h"
+#include "bn_sprite_builder.h"
+#include "bn_sprite_tiles_ptr.h"
+#include "bn_sprite_tiles_item.h"
+#include "bn_sprite_palette_ptr.h"
+#include "bn_sprite_palette_item.h"
+
+// Creates, destroys and defragments random sprite tiles for several seeds, checking after each frame that:
+// * The VRAM of each sprite_tiles_ptr contains its tiles, even if it has been moved by sprite_tiles::defragment.
+// * The OAM tile ids of the visible sprites point to the current location of their tiles.
+// * After defragmenting, all available tiles are contiguous.
+
+namespace
+{
+    constexpr const int seeds = 8;
+    constexpr const int frames_per_seed = 1000;
+    constexpr const int operations_per_frame = 4;
+    constexpr const int max_entries = 100;
+    constexpr const int rom_tiles_count = 2048;
+
+    // GBA addresses, which are mapped by the host backend:
+    constexpr const uintptr_t vram_tiles_address = 0x06010000;
+    constexpr const uintptr_t oam_address = 0x07000000;
+
+    bn::tile rom_tiles[rom_tiles_count];
+    constexpr const bn::color colors[16] = {};
+
+
+    class entry
+    {
+
+    public:
+        bn::sprite_tiles_ptr tiles;
+        bn::optional<bn::sprite_ptr> sprite;
+        int seed;
+        bool allocated;
+    };
+
+
+    [[nodiscard]] unsigned tile_word(int seed, int tile_index, int word_index)
+    {
+        return unsigned((seed * 7919) + (tile_index * 31) + word_index);
+    }
+
+    [[nodiscard]] bn::sprite_shape_size shape_size(int tiles_count)
+    {
+        switch(tiles_count)
+        {
+
+        case 1:
+            return bn::sprite_shape_size(bn::sprite_shape::SQUARE, bn::sprite_size::SMALL);
+
+        case 2:
+            return bn::sprite_shape_size(bn::sprite_shape::WIDE, bn::sprite_size::SMALL);
+
+        case 4:
+            return bn::sprite_shape_size(bn::sprite_shape::SQUARE, bn::sprite_size::NORMAL);
+
+        case 8:
+            return bn::sprite_shape_size(bn::sprite_shape::WIDE, bn::sprite_size::BIG);
+
+        case 16:
+            return bn::sprite_shape_size(bn::sprite_shape::SQUARE, bn::sprite_size::BIG);
+
+        case 32:
+            return bn::sprite_shape_size(bn::sprite_shape::WIDE, bn::sprite_size::HUGE);
+
+        default:
+            return bn::sprite_shape_size(bn::sprite_shape::SQUARE, bn::sprite_size::HUGE);
+        }
+    }
+
+    [[nodiscard]] bool contains(const bn::ivector<entry>& entries, const bn::sprite_tiles_ptr& tiles)
+    {
+        for(const entry& entry : entries)
+        {
+            if(entry.tiles == tiles)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Returns true if an entry has been added:
+    bool add_entry(bn::random& random, const bn::sprite_palette_ptr& palette, int seed, bn::ivector<entry>& entries,
+                   bool& defragmented, int& errors)
+    {
+        int log2_tiles_count = int(random.get() % 7);
+        int tiles_count = 1 << log2_tiles_count;
+        bool allocated = random.get() % 2;
+        bn::optional<bn::sprite_tiles_ptr> tiles;
+
+        if(allocated)
+        {
+            tiles = bn::sprite_tiles_ptr::allocate_optional(tiles_count, bn::bpp_mode::BPP_4);
+        }
+        else
+        {
+            // Each tiles count has its own ROM range, so ROM tiles are shared only if they are equal:
+            int rom_offset = (log2_tiles_count * 256) + (int(random.get() % unsigned(256 / tiles_count)) * tiles_count);
+            bn::sprite_tiles_item item(bn::span<const bn::tile>(rom_tiles + rom_offset, tiles_count),
+                                       bn::bpp_mode::BPP_4);
+            tiles = bn::sprite_tiles_ptr::create_optional(item);
+        }
+
+        if(! tiles)
+        {
+            // Pending relocations must be committed before defragmenting again:
+            if(! defragmented && bn::sprite_tiles::available_tiles_count() >= tiles_count &&
+                    bn::sprite_tiles::largest_available_tiles_count() < tiles_count)
+            {
+                bn::sprite_tiles::defragment();
+                defragmented = true;
+
+                int largest_available_tiles_count = bn::sprite_tiles::largest_available_tiles_count();
+                int available_tiles_count = bn::sprite_tiles::available_tiles_count();
+
+                if(largest_available_tiles_count != available_tiles_count)
+                {
+                    std::printf("Seed %d: fragmented after defragment: %d - %d\n", seed,
+                                largest_available_tiles_count, available_tiles_count);
+                    ++errors;
+                }
+            }
+
+            return false;
+        }
+
+        if(! allocated && contains(entries, *tiles))
+        {
+            return false;
+        }
+
+        if(allocated)
+        {
+            bn::span<bn::tile> vram = *tiles->vram();
+
+            for(int tile_index = 0; tile_index < tiles_count; ++tile_index)
+            {
+                for(int word_index = 0; word_index < 8; ++word_index)
+                {
+                    vram[tile_index].data[word_index] = tile_word(seed, tile_index, word_index);
+                }
+            }
+        }
+
+        bn::optional<bn::sprite_ptr> sprite;
+
+        if(random.get() % 2)
+        {
+            bn::sprite_builder builder(shape_size(tiles_count), *tiles, palette);
+            builder.set_position(int(random.get() % 200) - 100, int(random.get() % 140) - 70);
+            sprite = builder.release_build();
+        }
+
+        entries.push_back(entry{ bn::move(*tiles), bn::move(sprite), seed, allocated });
+        return true;
+    }
+
+    [[nodiscard]] int check_vram(int seed, int frame, const bn::ivector<entry>& entries)
+    {
+        auto vram_tiles = reinterpret_cast<const bn::tile*>(vram_tiles_address);
+        int errors = 0;
+
+        for(const entry& entry : entries)
+        {
+            int start_tile = entry.tiles.id();
+            int tiles_count = entry.tiles.tiles_count();
+            bool valid = true;
+
+            for(int tile_index = 0; tile_index < tiles_count && valid; ++tile_index)
+            {
+                for(int word_index = 0; word_index < 8 && valid; ++word_index)
+                {
+                    unsigned expected_word = entry.allocated ?
+                                tile_word(entry.seed, tile_index, word_index) :
+                                entry.tiles.tiles_ref()->data()[tile_index].data[word_index];
+                    valid = vram_tiles[start_tile + tile_index].data[word_index] == expected_word;
+                }
+            }
+
+            if(! valid)
+            {
+                std::printf("Seed %d, frame %d: invalid VRAM tiles: %d\n", seed, frame, start_tile);
+                ++errors;
+            }
+        }
+
+        return errors;
+    }
+
+    [[nodiscard]] int check_oam(int seed, int frame, const bn::ivector<entry>& entries)
+    {
+        auto oam = reinterpret_cast<const uint16_t*>(oam_address);
+        bn::vector<int, 128> expected_tile_ids;
+        bn::vector<int, 128> oam_tile_ids;
+
+        for(const entry& entry : entries)
+        {
+            if(entry.sprite)
+            {
+                expected_tile_ids.push_back(entry.tiles.id());
+            }
+        }
+
+        for(int index = 0; index < 128; ++index)
+        {
+            const uint16_t* attributes = oam + (index * 4);
+
+            // Hidden sprites are skipped:
+            if(((attributes[0] >> 8) & 3) != 2)
+            {
+                oam_tile_ids.push_back(attributes[2] & 1023);
+            }
+        }
+
+        bn::sort(expected_tile_ids.begin(), expected_tile_ids.end());
+        bn::sort(oam_tile_ids.begin(), oam_tile_ids.end());
+
+        if(expected_tile_ids != oam_tile_ids)
+        {
+            std::printf("Seed %d, frame %d: invalid OAM tile ids\n", seed, frame);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] int run_seed(int seed, const bn::sprite_palette_ptr& palette)
+    {
+        bn::random random;
+
+        for(int index = 0; index < seed * 1000; ++index)
+        {
+            (void) random.get();
+        }
+
+        bn::vector<entry, max_entries> entries;
+        int errors = 0;
+
+        for(int frame = 0; frame < frames_per_seed; ++frame)
+        {
+            bool defragmented = false;
+
+            for(int operation = 0; operation < operations_per_frame; ++operation)
+            {
+                int operation_type = int(random.get() % 10);
+
+                if(operation_type < 5 && ! entries.full())
+                {
+                    add_entry(random, palette, seed, entries, defragmented, errors);
+                }
+                else if(operation_type < 9 && ! entries.empty())
+                {
+                    entries.erase(entries.begin() + int(random.get() % unsigned(entries.size())));
+                }
+                else
+                {
+                    bn::sprite_tiles::defragment();
+                    defragmented = true;
+                }
+            }
+
+            bn::core::update();
+            errors += check_vram(seed, frame, entries);
+            errors += check_oam(seed, frame, entries);
+        }
+
+        entries.clear();
+        bn::core::update();
+        return errors;
+    }
+}
+
+int main()
+{
+    bn::core::init();
+
+    for(int tile_index = 0; tile_index < rom_tiles_count; ++tile_index)
+    {
+        for(int word_index = 0; word_index < 8; ++word_index)
+        {
+            rom_tiles[tile_index].data[word_index] = tile_word(-1, tile_index, word_index);
+        }
+    }
+
+    bn::sprite_palette_ptr palette = bn::sprite_palette_item(colors, bn::bpp_mode::BPP_4).create_palette();
+    int errors = 0;
+
+    for(int seed = 0; seed < seeds; ++seed)
+    {
+        errors += run_seed(seed, palette);
+    }
+
+    std::printf("Errors: %d\n", errors);
+    return errors ? 1 : 0;
+}